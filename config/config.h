@@ -31,6 +31,13 @@ namespace pins {
         // static constexpr uint8_t DATA = 14; 
         // static constexpr uint8_t SCK = 15;
     }
+
+    // Sensor data-ready (INT) lines, rising edge
+    namespace data_ready {
+        static constexpr uint ICM20948 = 9;
+        static constexpr uint BMP581 = 10;
+        static constexpr uint BMP390 = 8;
+    }
 }
 
 // ============================================
@@ -44,9 +51,36 @@ namespace sdcard {
     static constexpr uint8_t MOSI = 19;
 
     static constexpr uint32_t FREQ_HZ = 31250000;       // 31.25 MHz (125MHz/4)
-    static constexpr size_t FILE_BUFFER_SIZE = 512;           // Per-file buffer size
+    static constexpr size_t FILE_BUFFER_SIZE = 8192;          // Per ping-pong buffer (2 per file), whole sectors
+    static constexpr uint32_t PREALLOCATE_BYTES = 16u << 20;  // Contiguous f_expand per session file
+    static constexpr bool RUN_WRITE_BENCH = false;            // Write benchmark into debug.txt at boot
+    static constexpr bool JOURNAL_FILES = true;               // Session files use journaled blocks (journal.h)
+    static constexpr bool RECOVER_ON_MOUNT = true;            // Restore true lengths of the last session
+
+    // Periodic f_sync of session files (rate: sensors::LOG_FLUSH_RATE_HZ per file)
+    static constexpr uint32_t SYNC_BUDGET_US = 4000;          // Per sync tick (at least one file is synced)
+    static constexpr uint32_t SYNC_MAX_DEFER_MS = 2000;       // Longest a sync may be deferred by a burst
+    static constexpr size_t SYNC_BURST_ENTRIES = 64;          // Queue entries per drain that count as a burst
 
+}
 
+// ============================================
+// LOGGING PIPELINE (core 0 -> core 1)
+// ============================================
+namespace pipeline {
+    static constexpr size_t QUEUE_ENTRIES = 256;              // 64B slots -> 16KB SRAM, power of two
+}
+
+// ============================================
+// USB TELEMETRY TAP
+// ============================================
+namespace telemetry {
+    static constexpr uint8_t DEFAULT_MODE = 1;                // 0=off, 1=CSV text, 2=binary frames
+    static constexpr bool WHILE_LOGGING = false;              // Mirror during sessions (costs CPU)
+    static constexpr uint32_t DECIMATION = 10;                // Mirror 1-in-N records per stream
+    static constexpr uint32_t MAX_BYTES_PER_SEC = 8000;       // USB byte-rate budget
+    static constexpr size_t BUFFER_SIZE = 4096;               // Mirror ring, power of two
+    static constexpr uint32_t SERVICE_HZ = 50;                // USB drain rate
 }
 
 // ============================================
@@ -65,6 +99,10 @@ namespace i2c {
         static constexpr uint32_t FREQ_HZ = 400'000;          // 400kHz for sensors
     }
 
+    // Asynchronous transactions (I2CBus::submit)
+    static constexpr bool ASYNC_DMA = true;                   // DMA transfer engine (false: submit() runs blocking)
+    static constexpr size_t ASYNC_QUEUE = 8;                  // Transactions queued per bus, power of two
+    static constexpr uint32_t ASYNC_TIMEOUT_US = 20000;       // wait() aborts the bus after this
     
     // Device addresses on I2C0
     namespace addresses {
@@ -89,24 +127,34 @@ namespace i2c {
 namespace gps {
     static constexpr uint8_t RX_PIN = 12;
     static constexpr uint8_t TX_PIN = 13;
+    static constexpr uint8_t PPS_PIN = 11;                    // Receiver TIMEPULSE (rising at the UTC second)
 
     // Protocol settings
     static constexpr bool USE_BINARY_UBX = false;              // true = UBX binary, false = NMEA text
-    static constexpr uint8_t UPDATE_RATE_HZ = 1;              // Updates per second (max 5)
-    static constexpr uint32_t BAUD_RATE = 115200;             // Target baud rate (starts at 9600)
+    static constexpr uint8_t UPDATE_RATE_HZ = 10;             // Navigation rate via CFG-RATE (M8: max 10)
+    static constexpr uint32_t BAUD_RATE = 460800;             // Negotiated via CFG-PRT (factory default 9600)
+    static constexpr uint32_t ACK_TIMEOUT_MS = 300;           // Wait for ACK-ACK/ACK-NAK (or a poll reply)
     
     // Data streams to enable
     static constexpr bool ENABLE_POSITION = true;             // Position data
     static constexpr bool ENABLE_VELOCITY = true;             // Velocity data
-    static constexpr bool ENABLE_TIME = true;                 // Time data
-    static constexpr bool ENABLE_SATELLITES = false;          // Satellite info
+    static constexpr bool ENABLE_TIME = true;                 // Time data (UBX: NAV-TIMEUTC)
+    static constexpr bool ENABLE_SATELLITES = false;          // Satellite info (UBX: NAV-SAT, NAV-DOP)
     static constexpr bool ENABLE_STATUS = false;              // Navigation status
     
+    // Timepulse (PPS) clock discipline
+    static constexpr bool PPS_ENABLED = true;                 // Capture TIMEPULSE edges on PPS_PIN
+    static constexpr uint32_t PPS_PULSE_US = 100000;          // Pulse length (also lights the module LED)
+    static constexpr uint32_t CLOCK_LOCK_PULSES = 3;          // Consecutive good pulses to lock
+    static constexpr uint32_t CLOCK_OUTLIER_US = 250;         // Reject pulses this far off the prediction
+    static constexpr uint32_t CLOCK_HOLDOVER_S = 60;          // Extrapolate this long without pulses
+
     // Configuration method
-    static constexpr bool POLL_CONFIG = true;                 // true = smart config, false = force config
+    static constexpr bool POLL_CONFIG = true;                 // true = poll and change only what differs, false = send all
     
     // Buffer size
     static constexpr size_t BUFFER_SIZE = 512;                // GPS data buffer
+    static constexpr size_t RX_RING_SIZE = 4096;              // IRQ-fed UART ring, power of two (~90ms at 460800)
 }
 
 // ============================================
@@ -117,10 +165,13 @@ namespace sensors {
     static constexpr uint32_t BNO_RATE_HZ = 10;              // BNO085, MPU6050
     static constexpr uint32_t IMU_RATE_HZ = 10;                 //BNO085
     static constexpr uint32_t GPS_RATE_HZ = 1;                  // NEO6M
+    static constexpr uint32_t GPS_POLL_HZ = 50;                 // Parse the UART ring (IRQ keeps the FIFO empty)
     static constexpr uint32_t BARO_RATE_HZ = 10;                // BMP390, BME280
     static constexpr uint32_t PITOT_RATE_HZ = 20;               // Pitot tube
     static constexpr uint32_t FORCE_RATE_HZ = 20;               // HX711
     static constexpr uint32_t LOG_FLUSH_RATE_HZ = 2;            // SD card flush
+    static constexpr bool DATA_READY_IRQ = true;                // Sample on INT edges (BMP581 ODR paces the flight task)
+    static constexpr uint32_t BRINGUP_STEP_HZ = 2000;           // Device init_step() polling until all are up
 }
 
 namespace icm20948 {
@@ -141,14 +192,83 @@ namespace icm20948 {
                                         (GYRO_RANGE == 1) ? (500.0f / 32768.0f * DEG_TO_RAD) :
                                         (GYRO_RANGE == 2) ? (1000.0f / 32768.0f * DEG_TO_RAD) :
                                                             (2000.0f / 32768.0f * DEG_TO_RAD);
+
+    // On-chip FIFO: accel + gyro frames at the sample rate, drained in bursts
+    static constexpr bool FIFO_ENABLED = true;
+    static constexpr uint32_t FIFO_ODR_HZ = 1125;   // 1125 / (1 + SMPLRT_DIV): 1125, 562, 375, 281, 225, ...
+    static constexpr uint32_t FIFO_DRAIN_HZ = 50;   // 23 of the 42 frames the FIFO holds at 1125 Hz
+    static constexpr uint8_t FIFO_DLPF_CFG = 1;     // Gyro 152 Hz, accel 246 Hz bandwidth
+    static_assert(FIFO_ODR_HZ <= 1125 && 4 * FIFO_ODR_HZ <= 3 * 42 * FIFO_DRAIN_HZ,
+                  "FIFO would overflow between drains");
+    static constexpr uint32_t POLL_HZ = 100;        // Without the FIFO: imu.bin from register reads
+    static constexpr uint8_t POLL_DLPF_CFG = 4;     // Gyro 24 Hz, accel 24 Hz: below POLL_HZ / 2
+}
+
+namespace bmp581 {
+    // Oversampling as log2 (0=x1 ... 7=x128), IIR as the register code
+    // (0=bypass, 1..7 = coefficient 1, 3, 7, 15, 31, 63, 127)
+    struct Preset {
+        uint8_t osr_p;
+        uint8_t osr_t;
+        uint8_t iir_p;
+        uint8_t iir_t;
+    };
+    // (init() warns when the ODR leaves too little conversion time)
+    static constexpr Preset FAST = {1, 0, 0, 0};            // x2 / x1, unfiltered
+    static constexpr Preset STANDARD = {2, 0, 1, 0};        // x4 / x1, IIR 1
+    static constexpr Preset LOW_NOISE = {4, 1, 2, 1};       // x16 / x2, IIR 3: 80 Hz at most
+
+    static constexpr Preset PRESET = STANDARD;
+    static constexpr uint32_t ODR_HZ = 50;                  // Until the flight task sets its own rate
+
+    // On-chip FIFO: pressure-only frames at FIFO_ODR_HZ, drained in batches.
+    // The part has one output rate, so the flight task then polls instead
+    // of running on the data-ready interrupt.
+    static constexpr bool FIFO_ENABLED = false;
+    static constexpr Preset FIFO_PRESET = FAST;
+    static constexpr uint32_t FIFO_ODR_HZ = 240;
+    static constexpr uint32_t FIFO_DRAIN_HZ = 25;           // 9.6 of the 32 frames it holds at 240 Hz
+    static_assert(4 * FIFO_ODR_HZ <= 3 * 32 * FIFO_DRAIN_HZ, "FIFO would overflow between drains");
 }
 
 namespace pitot_tube {
-    static constexpr float PRESSURE_RANGE_PSI = 1.0f;  // Differential pressure range
-    static constexpr int CALIBRATION_SAMPLES = 50;     // Samples for zero calibration
+    static constexpr float PRESSURE_RANGE_PSI = 1.0f;  // Differential range: ±PRESSURE_RANGE_PSI
     static constexpr float PSI_TO_PA = 6894.76f;
     static constexpr float MS_TO_MPH = 2.237f;
-    static constexpr float STANDARD_AIR_DENSITY = 1.225f;  // kg/m³ at sea level
+    // CAS/TAS from subsonic isentropic flow rather than Bernoulli (the IAS
+    // column stays incompressible at sea-level density)
+    static constexpr bool COMPRESSIBLE_AIRSPEED = true;
+
+    // Continuous acquisition: read every conversion (one per 0.5 ms) and
+    // decimate to the pitot rate with a CIC filter, rather than one read per
+    // record. Off: a single blocking read per record.
+    static constexpr bool CONTINUOUS = true;
+    static constexpr uint32_t SAMPLE_HZ = 2000;
+    static constexpr unsigned CIC_ORDER = 2;
+    static constexpr uint32_t DECIMATION = SAMPLE_HZ / sensors::PITOT_RATE_HZ;
+    static_assert(SAMPLE_HZ % sensors::PITOT_RATE_HZ == 0, "Pitot rate must divide the sample rate");
+
+    // Background zero: readings in the first ZERO_LOCK_S are taken as at
+    // rest, later ones only within ZERO_REST_PA of the zero (about 2.5 m/s)
+    static constexpr float ZERO_LOCK_S = 2.5f;
+    static constexpr float ZERO_REST_PA = 4.0f;
+    static constexpr float ZERO_MEMORY_S = 60.0f;
+    static constexpr float ZERO_TEMPCO_PA_PER_C = 0.0f;    // Until a slope is fitted at rest
+}
+
+// ============================================
+// LOG STREAMS
+// ============================================
+// One session file per stream (registry: src/log_streams.h). Each sensor
+// has its own stream at its own rate; flight.bin is the fused IMU +
+// barometer row, written whenever the IMU reads (with the latest
+// barometer sample, baro_dt_us giving its age).
+namespace streams {
+    static constexpr bool FLIGHT_ENABLED = true;
+    static constexpr bool GPS_ENABLED = true;
+    static constexpr bool PITOT_ENABLED = true;
+    static constexpr bool IMU_ENABLED = true;                 // ICM20948 FIFO, or reads at icm20948::POLL_HZ
+    static constexpr bool BARO_ENABLED = true;                // BMP581 FIFO, or the flight task's reads
 }
 
 // ============================================
@@ -5,6 +5,7 @@
 // UART0 - GPS NEO6M
 constexpr uint8_t GPS_UART_RX = 12;
 constexpr uint8_t GPS_UART_TX = 13;
+constexpr uint8_t GPS_PPS = 11;
 
 
 // SPI0 - SD Card
@@ -21,6 +22,11 @@ constexpr uint8_t HX711_SCK = 13;
 constexpr uint8_t I2C0_SDA = 4;
 constexpr uint8_t I2C0_SCL = 5;
 
+// Sensor data-ready interrupts
+constexpr uint8_t BMP390_INT = 8;
+constexpr uint8_t ICM20948_INT = 9;
+constexpr uint8_t BMP581_INT = 10;
+
 // I2C1 - Display
 constexpr uint8_t I2C1_SDA = 6;
 constexpr uint8_t I2C1_SCL = 7;
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "register_device.h"
+#include "int_pin.h"
+
+namespace sim {
+
+// ============================================
+// BMP390
+// ============================================
+// Raw ADC model: the chip reports uncompensated 24-bit counts (pressure at
+// 0x04, temperature at 0x07, LSB first) and the host compensates them with
+// the 21 trimming bytes in NVM at 0x31. The counts are found by inverting
+// the datasheet's floating-point compensation for this part's NVM, so a
+// correct driver gets the scenario's pressure and temperature back.
+// Converts once per ODR period (200 Hz / 2^odr_sel) in normal mode; each
+// conversion sets drdy in INT_STATUS (cleared on read) and, with drdy_en in
+// INT_CTRL, pulses the pin attached with attachInt().
+class BMP390Model : public RegisterDevice {
+public:
+    static constexpr uint8_t CHIP_ID_VALUE = 0x60;
+
+    static constexpr uint8_t CHIP_ID = 0x00;
+    static constexpr uint8_t STATUS = 0x03;
+    static constexpr uint8_t DATA_0 = 0x04;         // Pressure XLSB
+    static constexpr uint8_t DATA_3 = 0x07;         // Temperature XLSB
+    static constexpr uint8_t SENSORTIME_0 = 0x0C;
+    static constexpr uint8_t INT_STATUS = 0x11;
+    static constexpr uint8_t INT_CTRL = 0x19;
+    static constexpr uint8_t PWR_CTRL = 0x1B;
+    static constexpr uint8_t OSR = 0x1C;
+    static constexpr uint8_t ODR = 0x1D;
+    static constexpr uint8_t NVM_PAR_T1 = 0x31;
+    static constexpr uint8_t CMD = 0x7E;
+
+    static constexpr uint8_t CMD_SOFT_RESET = 0xB6;
+
+    // Trimming coefficients of one part, in NVM order (T1..T3, P1..P11)
+    struct Nvm {
+        uint16_t t1 = 27748;
+        uint16_t t2 = 18713;
+        int8_t   t3 = -7;
+        int16_t  p1 = 26810;
+        int16_t  p2 = 2742;
+        int8_t   p3 = 35;
+        int8_t   p4 = 1;
+        uint16_t p5 = 4480;
+        uint16_t p6 = 30452;
+        int8_t   p7 = 3;
+        int8_t   p8 = -6;
+        int16_t  p9 = 3963;
+        int8_t   p10 = 10;
+        int8_t   p11 = -60;
+    };
+
+    explicit BMP390Model(const Scenario& scenario, uint32_t seed = 0xB390) : BMP390Model(scenario, Nvm(), seed) {}
+
+    BMP390Model(const Scenario& scenario, const Nvm& nvm, uint32_t seed = 0xB390)
+        : scenario(scenario), nvm(nvm), noise(seed) {
+        reset();
+    }
+
+    uint32_t conversions() const { return conversion_count; }
+    void attachInt(uint pin) { int_pin.attach(pin); }
+    uint32_t intPulses() const { return int_pin.pulses(); }
+    uint64_t periodUs() const { return 5000ull << std::min<uint8_t>(regs[ODR] & 0x1F, 17); }
+    double lastPressurePa() const { return last_pressure; }
+    double lastTemperatureC() const { return last_temperature; }
+
+    // Datasheet section 8.4/8.6 (floating point)
+    double compensateTemperature(double raw_t) const {
+        double p1 = raw_t - nvm.t1 * 256.0;
+        return p1 * (nvm.t2 / 1073741824.0) + p1 * p1 * (nvm.t3 / 281474976710656.0);
+    }
+
+    double compensatePressure(double raw_p, double t) const {
+        double p1 = (nvm.p1 - 16384) / 1048576.0;
+        double p2 = (nvm.p2 - 16384) / 536870912.0;
+        double p3 = nvm.p3 / 4294967296.0;
+        double p4 = nvm.p4 / 137438953472.0;
+        double p5 = nvm.p5 * 8.0;
+        double p6 = nvm.p6 / 64.0;
+        double p7 = nvm.p7 / 256.0;
+        double p8 = nvm.p8 / 32768.0;
+        double p9 = nvm.p9 / 281474976710656.0;
+        double p10 = nvm.p10 / 281474976710656.0;
+        double p11 = nvm.p11 / 36893488147419103232.0;
+
+        double out1 = p5 + p6 * t + p7 * t * t + p8 * t * t * t;
+        double out2 = raw_p * (p1 + p2 * t + p3 * t * t + p4 * t * t * t);
+        return out1 + out2 + raw_p * raw_p * (p9 + p10 * t) + raw_p * raw_p * raw_p * p11;
+    }
+
+protected:
+    void sample(uint64_t now_us) override {
+        bool normal = (regs[PWR_CTRL] & 0x30) == 0x30;
+        if (!normal) return;
+
+        uint64_t period = periodUs();
+        uint64_t index = now_us / period;
+        if (index != last_index) {
+            last_index = index;
+            convert(index * period);
+        }
+    }
+
+    uint8_t readReg(uint8_t reg) override {
+        uint8_t value = regs[reg];
+        if (reg == STATUS) regs[STATUS] &= ~0x60;  // drdy_press / drdy_temp clear on read
+        if (reg == INT_STATUS) regs[INT_STATUS] = 0;
+        return value;
+    }
+
+    void writeReg(uint8_t reg, uint8_t value) override {
+        if (reg == CMD) {
+            if (value == CMD_SOFT_RESET) reset();
+            return;
+        }
+        bool writable = reg >= INT_CTRL && !(reg >= NVM_PAR_T1 && reg < NVM_PAR_T1 + 21);
+        if (!writable) return;  // Read-only
+        regs[reg] = value;
+        publishInt();
+    }
+
+private:
+    const Scenario& scenario;
+    Nvm nvm;
+    Noise noise;
+
+    uint8_t regs[256];
+    uint64_t last_index = UINT64_MAX;
+    uint32_t conversion_count = 0;
+    double last_pressure = 0.0;
+    double last_temperature = 0.0;
+    IntPin int_pin;
+
+    void publishInt() {
+        bool on = (regs[INT_CTRL] & 0x40) && (regs[PWR_CTRL] & 0x30) == 0x30;
+        int_pin.setPeriodNs(on ? periodUs() * 1000.0 : 0.0);
+    }
+
+    // Inverse of the (monotonic) compensation by Newton's method
+    template<typename Fn>
+    static double invert(Fn&& compensate, double target, double guess) {
+        double x = guess;
+        for (int i = 0; i < 20; i++) {
+            double y = compensate(x);
+            double slope = (compensate(x + 1.0) - y);
+            if (slope == 0.0) break;
+            double step = (target - y) / slope;
+            x += step;
+            if (std::fabs(step) < 0.01) break;
+        }
+        return std::clamp(x, 0.0, 16777215.0);
+    }
+
+    void convert(uint64_t t_us) {
+        FlightState s = scenario.at(t_us);
+        conversion_count++;
+        last_temperature = s.air_temp_c + noise(0.005);
+        last_pressure = s.static_pa + noise(1.0);
+
+        double raw_t = invert([&](double raw) { return compensateTemperature(raw); }, last_temperature, 8.0e6);
+        double t = compensateTemperature(std::round(raw_t));
+        double raw_p = invert([&](double raw) { return compensatePressure(raw, t); }, last_pressure, 6.0e6);
+
+        if (regs[PWR_CTRL] & 0x01) putLE24(&regs[DATA_0], static_cast<uint32_t>(std::lround(raw_p)));
+        if (regs[PWR_CTRL] & 0x02) putLE24(&regs[DATA_3], static_cast<uint32_t>(std::lround(raw_t)));
+        putLE24(&regs[SENSORTIME_0], static_cast<uint32_t>(t_us / 39) & 0xFFFFFF);   // 25.6 kHz
+        regs[STATUS] |= 0x60;
+        regs[INT_STATUS] |= 0x08;  // drdy
+    }
+
+    void reset() {
+        memset(regs, 0, sizeof(regs));
+        regs[CHIP_ID] = CHIP_ID_VALUE;
+        regs[0x01] = 0x01;          // REV_ID
+        regs[STATUS] = 0x10;        // cmd_rdy
+        regs[OSR] = 0x02;
+        regs[ODR] = 0x00;
+        putLE24(&regs[DATA_0], 0x800000);
+        putLE24(&regs[DATA_3], 0x800000);
+
+        uint8_t* p = &regs[NVM_PAR_T1];
+        auto le16 = [&](uint16_t v) { *p++ = static_cast<uint8_t>(v); *p++ = static_cast<uint8_t>(v >> 8); };
+        auto s8 = [&](int8_t v) { *p++ = static_cast<uint8_t>(v); };
+        le16(nvm.t1); le16(nvm.t2); s8(nvm.t3);
+        le16(static_cast<uint16_t>(nvm.p1)); le16(static_cast<uint16_t>(nvm.p2)); s8(nvm.p3); s8(nvm.p4);
+        le16(nvm.p5); le16(nvm.p6); s8(nvm.p7); s8(nvm.p8);
+        le16(static_cast<uint16_t>(nvm.p9)); s8(nvm.p10); s8(nvm.p11);
+
+        last_index = UINT64_MAX;
+        publishInt();
+    }
+};
+
+} // namespace sim
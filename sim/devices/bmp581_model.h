@@ -0,0 +1,275 @@
+#pragma once
+
+#include <cmath>
+#include <deque>
+
+#include "register_device.h"
+#include "int_pin.h"
+
+namespace sim {
+
+// ============================================
+// BMP581
+// ============================================
+// Converts at the ODR selected in ODR_CONFIG while in normal mode (or once
+// per forced-mode request). Temperature is 24-bit signed in 1/65536 °C,
+// pressure 24-bit unsigned in 1/64 Pa, both LSB first from 0x1D. Pressure
+// reads 0 unless enabled in OSR_CONFIG. A new conversion sets drdy in
+// INT_STATUS, which clears on read, and pulses the pin attached with
+// attachInt() when int_en (INT_CONFIG) and drdy_data_reg_en (INT_SOURCE)
+// are set in normal mode.
+//
+// Noise falls with the square root of the oversampling. A conversion takes
+// roughly 1.35 ms + 0.65 ms per pressure and 0.35 ms per extra temperature
+// sample (an approximation of the datasheet's ODR/OSR table); in normal
+// mode an OSR that does not fit the ODR is lowered, shown in OSR_EFF with
+// odr_is_valid clear. The IIR filters (DSP_IIR) feed the data registers
+// and the FIFO as selected in DSP_CONFIG (shdw_sel_iir_t bit 3,
+// fifo_sel_iir_t bit 4, shdw_sel_iir_p bit 5, fifo_sel_iir_p bit 6; reset
+// 0x2B: compensation on, both filters to the data registers).
+//
+// FIFO: frames of pressure, temperature or both (FIFO_SEL, 3 or 6 bytes,
+// every 2^fifo_dec_sel conversions) up to 96 bytes; FIFO_COUNT holds the
+// frames and reads of FIFO_DATA pop without advancing the register
+// pointer (0x7F when empty). A full FIFO refuses new frames in
+// stop-on-full mode (FIFO_CONFIG) and drops the oldest in streaming mode,
+// and flags INT_STATUS. Writing FIFO_SEL or FIFO_CONFIG empties it.
+class BMP581Model : public RegisterDevice {
+public:
+    static constexpr uint8_t CHIP_ID_VALUE = 0x50;
+    static constexpr size_t FIFO_SIZE = 96;
+
+    static constexpr uint8_t CHIP_ID = 0x01;
+    static constexpr uint8_t INT_CONFIG = 0x14;
+    static constexpr uint8_t INT_SOURCE = 0x15;
+    static constexpr uint8_t FIFO_CONFIG = 0x16;
+    static constexpr uint8_t FIFO_COUNT = 0x17;
+    static constexpr uint8_t FIFO_SEL = 0x18;
+    static constexpr uint8_t TEMP_DATA_XLSB = 0x1D;
+    static constexpr uint8_t PRESS_DATA_XLSB = 0x20;
+    static constexpr uint8_t INT_STATUS = 0x27;
+    static constexpr uint8_t STATUS = 0x28;
+    static constexpr uint8_t FIFO_DATA = 0x29;
+    static constexpr uint8_t DSP_CONFIG = 0x30;
+    static constexpr uint8_t DSP_IIR = 0x31;
+    static constexpr uint8_t SHDW_SEL_IIR_T = 0x08;     // DSP_CONFIG bits
+    static constexpr uint8_t FIFO_SEL_IIR_T = 0x10;
+    static constexpr uint8_t SHDW_SEL_IIR_P = 0x20;
+    static constexpr uint8_t FIFO_SEL_IIR_P = 0x40;
+    static constexpr uint8_t OSR_CONFIG = 0x36;
+    static constexpr uint8_t ODR_CONFIG = 0x37;
+    static constexpr uint8_t OSR_EFF = 0x38;
+    static constexpr uint8_t CMD = 0x7E;
+
+    static constexpr uint8_t CMD_SOFT_RESET = 0xB6;
+
+    BMP581Model(const Scenario& scenario, uint32_t seed = 0xB581) : scenario(scenario), noise(seed) {
+        reset();
+    }
+
+    uint32_t conversions() const { return conversion_count; }
+    uint32_t fifoDropped() const { return fifo_dropped; }
+
+    void attachInt(uint pin) { int_pin.attach(pin); }
+    uint32_t intPulses() const { return int_pin.pulses(); }
+
+    // Conversion period in normal mode (whole µs, as sample() counts them)
+    uint64_t periodUs() const { return static_cast<uint64_t>(1e6 / odrHz(regs[ODR_CONFIG] >> 2)); }
+
+    // Output data rate for ODR_CONFIG.odr_sel (datasheet table 20)
+    static double odrHz(uint8_t odr_sel) {
+        static constexpr double TABLE[32] = {
+            240.0, 218.537, 199.111, 179.2, 160.0, 149.333, 140.0, 129.855,
+            120.0, 110.164, 100.299, 89.6, 80.0, 70.0, 60.0, 50.0,
+            45.0, 40.0, 35.0, 30.0, 25.0, 20.0, 15.0, 10.0,
+            5.0, 4.0, 3.0, 2.0, 1.0, 0.5, 0.25, 0.125,
+        };
+        return TABLE[odr_sel & 0x1F];
+    }
+
+    // Conversion time for log2 oversampling rates
+    static uint64_t conversionUs(uint8_t osr_p, uint8_t osr_t) {
+        return 1350 + 650 * (1u << osr_p) + 350 * ((1u << osr_t) - 1);
+    }
+
+protected:
+    void sample(uint64_t now_us) override {
+        uint8_t mode = regs[ODR_CONFIG] & 0x03;
+        if (mode == 0x01 || mode == 0x03) {
+            // Normal / non-stop: one conversion per ODR period, each one
+            // since the last transfer through the filters and the FIFO
+            uint64_t period = periodUs();
+            uint64_t index = now_us / period;
+            if (index == last_index) return;
+
+            uint64_t first = (last_index == UINT64_MAX) ? index : last_index + 1;
+            uint64_t frames = FIFO_SIZE / frameBytes();
+            if (!(regs[FIFO_CONFIG] & 0x20) && index - first > frames * fifoDecimation()) {
+                // Streaming: only the newest frames survive
+                uint64_t keep = index - frames * fifoDecimation();
+                if (fifoOn()) overflow(static_cast<uint32_t>((keep - first) / fifoDecimation()));
+                first = keep;
+            }
+            last_index = index;
+            for (uint64_t i = first; i <= index; i++) {
+                // Stop-on-full and full: the conversions up to the newest only
+                // update the data registers
+                if (i < index && fifoOn() && (regs[FIFO_CONFIG] & 0x20) && fifo.size() + frameBytes() > FIFO_SIZE) {
+                    overflow(static_cast<uint32_t>((index - i) / fifoDecimation()));
+                    i = index;
+                }
+                convert(i * period, i);
+            }
+        } else if (mode == 0x02) {
+            convert(now_us, conversion_count);
+            regs[ODR_CONFIG] &= ~0x03;  // Back to standby
+        }
+    }
+
+    uint8_t readReg(uint8_t reg) override {
+        if (reg == FIFO_COUNT) return static_cast<uint8_t>(fifo.size() / frameBytes());
+        if (reg == FIFO_DATA) {
+            pointer = FIFO_DATA;
+            if (fifo.empty()) return 0x7F;
+            uint8_t value = fifo.front();
+            fifo.pop_front();
+            return value;
+        }
+        uint8_t value = regs[reg];
+        if (reg == INT_STATUS) regs[INT_STATUS] = 0;
+        return value;
+    }
+
+    void writeReg(uint8_t reg, uint8_t value) override {
+        if (reg == CMD) {
+            if (value == CMD_SOFT_RESET) reset();
+            return;
+        }
+        if (reg == CHIP_ID || (reg >= TEMP_DATA_XLSB && reg <= FIFO_DATA) || reg == FIFO_COUNT || reg == OSR_EFF) {
+            return;     // Read-only
+        }
+        regs[reg] = value;
+        if (reg == FIFO_SEL || reg == FIFO_CONFIG) fifo.clear();
+        if (reg == DSP_IIR) iir_started = false;
+        if (reg == ODR_CONFIG) last_index = UINT64_MAX;
+        effectiveOsr();
+        publishInt();
+    }
+
+private:
+    const Scenario& scenario;
+    Noise noise;
+
+    uint8_t regs[256];
+    uint64_t last_index = UINT64_MAX;
+    uint32_t conversion_count = 0;
+    std::deque<uint8_t> fifo;
+    uint32_t fifo_dropped = 0;             // Frames
+    bool iir_started = false;
+    double iir_temp = 0.0;
+    double iir_press = 0.0;
+    IntPin int_pin;
+
+    void publishInt() {
+        uint8_t mode = regs[ODR_CONFIG] & 0x03;
+        bool on = (regs[INT_CONFIG] & 0x08) && (regs[INT_SOURCE] & 0x01) && (mode == 0x01 || mode == 0x03);
+        int_pin.setPeriodNs(on ? periodUs() * 1000.0 : 0.0);
+    }
+
+    // OSR_EFF: the requested oversampling, lowered until a conversion fits
+    // the normal-mode period
+    void effectiveOsr() {
+        uint8_t osr_t = regs[OSR_CONFIG] & 0x07;
+        uint8_t osr_p = (regs[OSR_CONFIG] >> 3) & 0x07;
+        bool valid = true;
+        if ((regs[ODR_CONFIG] & 0x03) == 0x01) {
+            while (conversionUs(osr_p, osr_t) > periodUs() && (osr_p || osr_t)) {
+                valid = false;
+                if (osr_p >= osr_t && osr_p) osr_p--; else osr_t--;
+            }
+        }
+        regs[OSR_EFF] = (valid ? 0x80 : 0x00) | (osr_p << 3) | osr_t;
+    }
+
+    uint8_t fifoFrame() const { return regs[FIFO_SEL] & 0x03; }
+    bool fifoOn() const { return fifoFrame() != 0; }
+    size_t frameBytes() const { return fifoFrame() == 0x03 ? 6 : 3; }
+    uint64_t fifoDecimation() const { return 1ull << ((regs[FIFO_SEL] >> 2) & 0x07); }
+
+    void overflow(uint32_t frames) {
+        regs[INT_STATUS] |= 0x02;   // fifo_full
+        fifo_dropped += frames;
+    }
+
+    // First-order IIR: y += (x - y) / (coefficient + 1)
+    static double filter(double& state, double x, uint8_t code) {
+        static constexpr double COEFFICIENT[8] = {0, 1, 3, 7, 15, 31, 63, 127};
+        state += (x - state) / (COEFFICIENT[code & 0x07] + 1.0);
+        return state;
+    }
+
+    void convert(uint64_t t_us, uint64_t index) {
+        FlightState s = scenario.at(t_us);
+        conversion_count++;
+
+        uint8_t eff = regs[OSR_EFF];
+        double temp = s.air_temp_c + noise(0.014 / std::sqrt(1u << (eff & 0x07)));
+        bool press_en = regs[OSR_CONFIG] & 0x40;
+        double press = press_en ? s.static_pa + noise(2.1 / std::sqrt(1u << ((eff >> 3) & 0x07))) : 0.0;
+
+        if (!iir_started) {
+            iir_temp = temp;
+            iir_press = press;
+            iir_started = true;
+        }
+        double temp_f = filter(iir_temp, temp, regs[DSP_IIR]);
+        double press_f = filter(iir_press, press, regs[DSP_IIR] >> 3);
+
+        uint8_t dsp = regs[DSP_CONFIG];
+        uint32_t temp_raw = static_cast<uint32_t>(std::lround(((dsp & SHDW_SEL_IIR_T) ? temp_f : temp) * 65536.0)) & 0xFFFFFF;
+        uint32_t press_raw = static_cast<uint32_t>(std::lround(((dsp & SHDW_SEL_IIR_P) ? press_f : press) * 64.0)) & 0xFFFFFF;
+        putLE24(&regs[TEMP_DATA_XLSB], temp_raw);
+        putLE24(&regs[PRESS_DATA_XLSB], press_raw);
+        regs[INT_STATUS] |= 0x01;   // drdy_data_reg
+
+        if (fifoOn() && index % fifoDecimation() == 0) {
+            uint8_t frame[6];
+            size_t len = 0;
+            if (fifoFrame() & 0x01) {
+                putLE24(frame, static_cast<uint32_t>(std::lround(((dsp & FIFO_SEL_IIR_T) ? temp_f : temp) * 65536.0)) & 0xFFFFFF);
+                len += 3;
+            }
+            if (fifoFrame() & 0x02) {
+                putLE24(frame + len, static_cast<uint32_t>(std::lround(((dsp & FIFO_SEL_IIR_P) ? press_f : press) * 64.0)) & 0xFFFFFF);
+                len += 3;
+            }
+            push(frame, len);
+        }
+    }
+
+    void push(const uint8_t* frame, size_t len) {
+        if (fifo.size() + len > FIFO_SIZE) {
+            overflow(1);
+            if (regs[FIFO_CONFIG] & 0x20) return;
+            fifo.erase(fifo.begin(), fifo.begin() + len);
+        }
+        fifo.insert(fifo.end(), frame, frame + len);
+    }
+
+    void reset() {
+        memset(regs, 0, sizeof(regs));
+        regs[CHIP_ID] = CHIP_ID_VALUE;
+        regs[INT_STATUS] = 0x10;    // por
+        regs[STATUS] = 0x02;        // status_nvm_rdy
+        regs[OSR_CONFIG] = 0x00;
+        regs[ODR_CONFIG] = 0x70;    // deep_dis=0, 1 Hz, standby
+        regs[DSP_CONFIG] = 0x2B;
+        last_index = UINT64_MAX;
+        fifo.clear();
+        iir_started = false;
+        effectiveOsr();
+        publishInt();
+    }
+};
+
+} // namespace sim
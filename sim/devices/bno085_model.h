@@ -0,0 +1,187 @@
+#pragma once
+
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "scenario.h"
+#include "runtime/sim.h"
+
+namespace sim {
+
+// ============================================
+// BNO085 (SHTP over I2C)
+// ============================================
+// Packet protocol instead of registers. Every transfer starts with a 4-byte
+// SHTP header (length incl. header, bit 15 = continuation, channel,
+// sequence). A read returns the header of the pending packet followed by
+// as much of its payload as the read asks for. The next read continues
+// with a continuation header, and an idle hub answers with a zero-length
+// header. Host writes are whole packets:
+// - channel 1 command 1 (soft reset): the hub answers "reset complete"
+// - channel 2 Set Feature (0xFD): enables a sensor report at the requested
+//   interval and is answered with Get Feature Response (0xFC)
+// Input reports go out on channel 3 behind a base-timestamp reference.
+// Accelerometer (Q8 m/s²), calibrated gyroscope (Q9 rad/s) and
+// calibrated magnetic field (Q4 µT) are modelled.
+class BNO085Model : public I2CDevice {
+public:
+    static constexpr uint8_t CHAN_COMMAND = 0;
+    static constexpr uint8_t CHAN_EXECUTABLE = 1;
+    static constexpr uint8_t CHAN_CONTROL = 2;
+    static constexpr uint8_t CHAN_INPUT = 3;
+
+    static constexpr uint8_t ACCELEROMETER = 0x01;
+    static constexpr uint8_t GYROSCOPE_CALIBRATED = 0x02;
+    static constexpr uint8_t MAGNETIC_FIELD_CALIBRATED = 0x03;
+
+    explicit BNO085Model(const Scenario& scenario, uint32_t seed = 0x0085) : scenario(scenario), noise(seed) {}
+
+    uint32_t reports() const { return report_count; }
+    uint32_t resets() const { return reset_count; }
+
+    int write(const uint8_t* src, size_t len, bool) override {
+        if (len < 4) return static_cast<int>(len);
+        uint16_t length = (src[0] | (src[1] << 8)) & 0x7FFF;
+        uint8_t chan = src[2];
+        const uint8_t* payload = src + 4;
+        size_t payload_len = std::min<size_t>(length, len) - 4;
+
+        if (chan == CHAN_EXECUTABLE && payload_len >= 1 && payload[0] == 1) {
+            reset();
+        } else if (chan == CHAN_CONTROL && payload_len >= 17 && payload[0] == 0xFD) {
+            setFeature(payload);
+        }
+        return static_cast<int>(len);
+    }
+
+    int read(uint8_t* dst, size_t len, bool) override {
+        if (pending.empty()) poll(clock::now_us());
+
+        if (pending.empty()) {
+            memset(dst, 0, len);
+            return static_cast<int>(len);
+        }
+
+        Packet& p = pending.front();
+        size_t remaining = p.payload.size() - p.offset;
+        uint16_t length = static_cast<uint16_t>(remaining + 4) | (p.offset ? 0x8000 : 0);
+        uint8_t header[4] = {static_cast<uint8_t>(length), static_cast<uint8_t>(length >> 8), p.chan, p.seq};
+
+        memcpy(dst, header, std::min<size_t>(len, 4));
+        size_t n = len > 4 ? std::min(len - 4, remaining) : 0;
+        memcpy(dst + 4, p.payload.data() + p.offset, n);
+        if (len > 4 + n) memset(dst + 4 + n, 0, len - 4 - n);
+
+        p.offset += n;
+        if (len > 4 && p.offset == p.payload.size()) pending.pop_front();
+        return static_cast<int>(len);
+    }
+
+private:
+    struct Packet {
+        uint8_t chan;
+        uint8_t seq;
+        std::vector<uint8_t> payload;
+        size_t offset = 0;
+    };
+
+    struct Feature {
+        uint32_t interval_us;
+        uint64_t next_us;
+        uint8_t seq = 0;
+    };
+
+    const Scenario& scenario;
+    Noise noise;
+
+    std::deque<Packet> pending;
+    std::map<uint8_t, Feature> features;
+    uint8_t chan_seq[6] = {};
+    uint32_t report_count = 0;
+    uint32_t reset_count = 0;
+
+    void queue(uint8_t chan, std::vector<uint8_t> payload) {
+        pending.push_back({chan, chan_seq[chan]++, std::move(payload)});
+    }
+
+    void reset() {
+        pending.clear();
+        features.clear();
+        memset(chan_seq, 0, sizeof(chan_seq));
+        reset_count++;
+        queue(CHAN_EXECUTABLE, {0x01});                 // Reset complete
+    }
+
+    void setFeature(const uint8_t* payload) {
+        uint8_t id = payload[1];
+        uint32_t interval = payload[5] | (payload[6] << 8) | (payload[7] << 16) | (static_cast<uint32_t>(payload[8]) << 24);
+        if (interval == 0) {
+            features.erase(id);
+        } else {
+            features[id] = {interval, clock::now_us() + interval};
+        }
+
+        std::vector<uint8_t> response(payload, payload + 17);
+        response[0] = 0xFC;                             // Get Feature Response
+        queue(CHAN_CONTROL, std::move(response));
+    }
+
+    // Batches every report that came due since the last poll
+    void poll(uint64_t now_us) {
+        std::vector<uint8_t> payload;
+        for (auto& [id, feature] : features) {
+            if (now_us < feature.next_us) continue;
+            uint64_t due = feature.next_us;
+            while (feature.next_us <= now_us) feature.next_us += feature.interval_us;
+
+            if (payload.empty()) {
+                uint32_t base = static_cast<uint32_t>((now_us - due) / 100);   // 100 µs units back to the sample
+                payload = {0xFB, static_cast<uint8_t>(base), static_cast<uint8_t>(base >> 8),
+                           static_cast<uint8_t>(base >> 16), static_cast<uint8_t>(base >> 24)};
+            }
+            appendReport(payload, id, feature.seq++, due);
+        }
+        if (!payload.empty()) queue(CHAN_INPUT, std::move(payload));
+    }
+
+    void appendReport(std::vector<uint8_t>& payload, uint8_t id, uint8_t seq, uint64_t t_us) {
+        FlightState s = scenario.at(t_us);
+        double v[3];
+        int q;
+        switch (id) {
+            case ACCELEROMETER:
+                for (int i = 0; i < 3; i++) v[i] = s.accel_ms2[i] + noise(0.02);
+                q = 8;
+                break;
+            case GYROSCOPE_CALIBRATED:
+                for (int i = 0; i < 3; i++) v[i] = s.gyro_rads[i] + noise(0.002);
+                q = 9;
+                break;
+            case MAGNETIC_FIELD_CALIBRATED: {
+                // 48 µT field, 63° dip, rotated by heading
+                double h = s.heading_deg * M_PI / 180.0;
+                v[0] = 21.8 * std::cos(h);
+                v[1] = 21.8 * std::sin(h);
+                v[2] = -42.8;
+                q = 4;
+                break;
+            }
+            default:
+                return;
+        }
+
+        report_count++;
+        payload.push_back(id);
+        payload.push_back(seq);
+        payload.push_back(0x03);        // Accuracy high, no extra delay
+        payload.push_back(0x00);
+        for (double value : v) {
+            long fixed = std::clamp(std::lround(value * (1 << q)), -32768l, 32767l);
+            payload.push_back(static_cast<uint8_t>(fixed));
+            payload.push_back(static_cast<uint8_t>(static_cast<uint16_t>(fixed) >> 8));
+        }
+    }
+};
+
+} // namespace sim
@@ -0,0 +1,483 @@
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <vector>
+
+#include "scenario.h"
+#include "runtime/sim.h"
+#include "pico/time.h"
+
+namespace sim {
+
+// ============================================
+// u-blox M8/M10 Class GPS Receiver
+// ============================================
+// Starts in the factory state: 9600 baud, 1 Hz, NMEA GGA/GLL/GSA/GSV/RMC/VTG.
+// Every navigation epoch it emits the enabled messages on the UART line at
+// the epoch time, whether or not the firmware is reading. UBX input is
+// parsed, and every CFG message is answered with ACK-ACK (polls with their
+// reply first):
+// - CFG-PRT polls and sets UART1; a new baud rate applies right after the
+//   ACK, which still goes out at the old rate
+// - CFG-MSG polls and sets per-message output rates (NMEA, NAV-PVT,
+//   NAV-DOP, NAV-TIMEUTC and NAV-SAT)
+// - CFG-RATE polls and sets the measurement period
+// - CFG-TP5 sets the timepulse (TIMEPULSE only, period 1 s, length given)
+// The fix becomes valid FIX_DELAY_US after power-up.
+//
+// The receiver keeps true time; the board's clock (sim::clock) may run
+// setBoardClockPpm() fast or slow against it. With attachTimepulse() the
+// pulse drives a GPIO, rising at the start of every UTC second while the
+// timepulse is active and the fix valid.
+class GpsReceiver : public UartDevice {
+public:
+    static constexpr uint32_t FIX_DELAY_US = 1'000'000;
+    static constexpr double GEOID_SEPARATION_M = 48.0;
+
+    // NMEA message ids (class 0xF0)
+    static constexpr uint8_t NMEA_GGA = 0x00, NMEA_GLL = 0x01, NMEA_GSA = 0x02;
+    static constexpr uint8_t NMEA_GSV = 0x03, NMEA_RMC = 0x04, NMEA_VTG = 0x05;
+
+    // NAV message ids (class 0x01)
+    static constexpr uint8_t NAV_DOP = 0x04, NAV_PVT = 0x07, NAV_TIMEUTC = 0x21, NAV_SAT = 0x35;
+
+    struct Stats {
+        uint32_t epochs = 0;
+        uint32_t nav_pvt = 0;
+        uint32_t nav_frames = 0;            // Every NAV message, NAV-PVT included
+        uint32_t ubx_received = 0;
+        uint32_t ubx_bad_checksum = 0;
+        uint32_t acks = 0;
+        uint32_t timepulses = 0;
+    };
+
+    GpsReceiver(const Scenario& scenario, time_t utc_start = 1748779200)   // 2025-06-01 12:00:00Z
+        : scenario(scenario), utc_start(utc_start) {
+        for (uint8_t id : {NMEA_GGA, NMEA_GLL, NMEA_GSA, NMEA_GSV, NMEA_RMC, NMEA_VTG}) {
+            rates[key(0xF0, id)] = 1;
+        }
+    }
+
+    // Before the firmware runs
+    void setBoardClockPpm(double ppm) { board_rate = 1.0 + ppm * 1e-6; }
+
+    // Drives pin from the alarm pool; the edge is placed with a busy-wait
+    void attachTimepulse(uint pin) {
+        tp_pin = pin;
+        tp_second = fromBoard(clock::now_us()) / 1'000'000 + 1;
+        tp_high = false;
+        add_alarm_at(toBoard(tp_second * 1'000'000) - TP_LEAD_US, timepulseAlarm, this, true);
+    }
+
+    // True UTC (µs since the Unix epoch) at a board time
+    int64_t utcUs(uint64_t board_us) const {
+        return static_cast<int64_t>(utc_start) * 1'000'000 + static_cast<int64_t>(fromBoard(board_us));
+    }
+
+    uint32_t measurementPeriodUs() const { return meas_period_us; }
+    uint8_t rate(uint8_t cls, uint8_t id) const {
+        auto it = rates.find(key(cls, id));
+        return it == rates.end() ? 0 : it->second;
+    }
+    const Stats& getStats() const { return stats; }
+
+    // Harness shortcut past CFG-MSG (call under uart::withDevice)
+    void setRate(uint8_t cls, uint8_t id, uint8_t every) { rates[key(cls, id)] = every; }
+
+    // ---- UartDevice ----
+
+    void received(UartPort& port, uint8_t byte) override {
+        // UBX frame: B5 62 class id len16 payload ck_a ck_b
+        if (rx.empty() && byte != 0xB5) return;
+        if (rx.size() == 1 && byte != 0x62) {
+            rx.clear();
+            return;
+        }
+        rx.push_back(byte);
+
+        if (rx.size() >= 6) {
+            size_t len = rx[4] | (rx[5] << 8);
+            if (len > 512) {
+                rx.clear();
+            } else if (rx.size() == len + 8) {
+                handleUbx(port, rx);
+                rx.clear();
+            }
+        }
+    }
+
+    void service(UartPort& port, uint64_t now_us) override {
+        while (toBoard(next_epoch_us) <= now_us) {
+            emitEpoch(port, next_epoch_us);
+            next_epoch_us += meas_period_us;
+        }
+    }
+
+protected:
+    const Scenario& scenario;
+    time_t utc_start;
+
+    std::map<uint16_t, uint8_t> rates;      // (class << 8 | id) -> every n epochs
+    uint32_t meas_period_us = 1'000'000;
+    uint64_t next_epoch_us = 0;             // True time
+    double board_rate = 1.0;                // Board µs per true µs
+    uint32_t epoch_count = 0;
+    std::vector<uint8_t> rx;
+    uint pending_baud = 0;                  // CFG-PRT: switch once the ACK is out
+    Stats stats;
+
+    // Timepulse: CFG-TP5 (UART pump) and the alarm pool share these
+    static constexpr uint64_t TP_LEAD_US = 300;     // Alarm wake-up ahead of the edge
+    std::atomic<bool> tp_active{false};
+    std::atomic<uint32_t> tp_length_us{0};          // Locked (fix valid) pulse length
+    uint tp_pin = 0;
+    uint64_t tp_second = 0;                         // Next pulse, true seconds since power-up
+    bool tp_high = false;
+
+    uint64_t toBoard(uint64_t true_us) const { return static_cast<uint64_t>(std::llround(true_us * board_rate)); }
+    uint64_t fromBoard(uint64_t board_us) const { return static_cast<uint64_t>(std::llround(board_us / board_rate)); }
+
+    static int64_t timepulseAlarm(alarm_id_t, void* self) {
+        static_cast<GpsReceiver*>(self)->timepulse();
+        return 0;
+    }
+
+    // One alarm per edge: rise at the top of the second, fall after the length
+    void timepulse() {
+        uint64_t rise = toBoard(tp_second * 1'000'000);
+        if (tp_high) {
+            gpio::drive(tp_pin, false);
+            tp_high = false;
+        } else {
+            uint32_t length = tp_length_us;
+            if (tp_active && length && tp_second * 1'000'000 >= FIX_DELAY_US) {
+                clock::spin_until(rise);
+                gpio::drive(tp_pin, true);
+                tp_high = true;
+                stats.timepulses++;
+                add_alarm_at(rise + length, timepulseAlarm, this, true);
+                return;
+            }
+        }
+        tp_second++;
+        add_alarm_at(toBoard(tp_second * 1'000'000) - TP_LEAD_US, timepulseAlarm, this, true);
+    }
+
+    static uint16_t key(uint8_t cls, uint8_t id) { return static_cast<uint16_t>(cls << 8 | id); }
+
+    bool due(uint8_t cls, uint8_t id) const {
+        uint8_t r = rate(cls, id);
+        return r != 0 && (epoch_count % r) == 0;
+    }
+
+    // ---- UBX ----
+
+    static void checksum(const uint8_t* data, size_t len, uint8_t& ck_a, uint8_t& ck_b) {
+        ck_a = ck_b = 0;
+        for (size_t i = 0; i < len; i++) {
+            ck_a += data[i];
+            ck_b += ck_a;
+        }
+    }
+
+    static std::vector<uint8_t> frame(uint8_t cls, uint8_t id, const uint8_t* payload, size_t len) {
+        std::vector<uint8_t> f(len + 8);
+        f[0] = 0xB5;
+        f[1] = 0x62;
+        f[2] = cls;
+        f[3] = id;
+        f[4] = static_cast<uint8_t>(len);
+        f[5] = static_cast<uint8_t>(len >> 8);
+        if (len) memcpy(f.data() + 6, payload, len);
+        checksum(f.data() + 2, len + 4, f[len + 6], f[len + 7]);
+        return f;
+    }
+
+    void send(UartPort& port, const std::vector<uint8_t>& bytes, uint64_t at_us = 0) {
+        port.transmit(bytes.data(), bytes.size(), at_us);
+    }
+
+    void ack(UartPort& port, uint8_t cls, uint8_t id, bool ok) {
+        uint8_t payload[2] = {cls, id};
+        send(port, frame(0x05, ok ? 0x01 : 0x00, payload, 2));
+        stats.acks++;
+    }
+
+    // Returns false to NAK. Overridden by models that understand more.
+    virtual bool handleCfg(UartPort& port, uint8_t id, const uint8_t* payload, size_t len) {
+        switch (id) {
+            case 0x00:                                  // CFG-PRT
+                if (len <= 1) {
+                    if (len == 1 && payload[0] != 1) return false;
+                    uint32_t baud = port.deviceBaud();
+                    uint8_t prt[20] = {1, 0, 0, 0, 0xC0, 0x08, 0, 0,
+                                       static_cast<uint8_t>(baud), static_cast<uint8_t>(baud >> 8),
+                                       static_cast<uint8_t>(baud >> 16), static_cast<uint8_t>(baud >> 24),
+                                       0x07, 0x00, 0x03, 0x00};
+                    send(port, frame(0x06, 0x00, prt, sizeof(prt)));
+                } else if (len == 20) {
+                    if (payload[0] != 1) return false;
+                    pending_baud = payload[8] | (payload[9] << 8) | (payload[10] << 16) |
+                                   (static_cast<uint32_t>(payload[11]) << 24);
+                }
+                return true;
+
+            case 0x01:                                  // CFG-MSG
+                if (len == 2) {
+                    uint8_t msg[8] = {payload[0], payload[1], 0, rate(payload[0], payload[1])};
+                    send(port, frame(0x06, 0x01, msg, sizeof(msg)));
+                } else if (len == 3 || len == 8) {
+                    // Rate on the current port (byte 2 for the short form, UART1 for the long)
+                    rates[key(payload[0], payload[1])] = (len == 3) ? payload[2] : payload[3];
+                }
+                return true;
+
+            case 0x08:                                  // CFG-RATE
+                if (len == 0) {
+                    uint16_t ms = static_cast<uint16_t>(meas_period_us / 1000);
+                    uint8_t r[6] = {static_cast<uint8_t>(ms), static_cast<uint8_t>(ms >> 8), 1, 0, 1, 0};
+                    send(port, frame(0x06, 0x08, r, sizeof(r)));
+                } else if (len == 6) {
+                    uint16_t ms = payload[0] | (payload[1] << 8);
+                    if (ms < 25) return false;
+                    // Epochs stay on whole multiples of the period
+                    meas_period_us = ms * 1000u;
+                    next_epoch_us = (fromBoard(clock::now_us()) / meas_period_us + 1) * meas_period_us;
+                }
+                return true;
+
+            case 0x31:                                  // CFG-TP5
+                if (len == 32) {
+                    if (payload[0] != 0) return false;  // TIMEPULSE2 not wired
+                    uint32_t period_lock, length_lock, flags;
+                    memcpy(&period_lock, payload + 12, 4);
+                    memcpy(&length_lock, payload + 20, 4);
+                    memcpy(&flags, payload + 28, 4);
+                    bool active = flags & 0x01;
+                    // Period and length in µs (isFreq, isLength), 1 s only
+                    if (active && ((flags & 0x18) != 0x10 || period_lock != 1'000'000 || length_lock >= period_lock)) {
+                        return false;
+                    }
+                    tp_length_us = length_lock;
+                    tp_active = active;
+                }
+                return true;
+
+            default:
+                return true;
+        }
+    }
+
+    void handleUbx(UartPort& port, const std::vector<uint8_t>& f) {
+        uint8_t ck_a, ck_b;
+        checksum(f.data() + 2, f.size() - 4, ck_a, ck_b);
+        if (ck_a != f[f.size() - 2] || ck_b != f[f.size() - 1]) {
+            stats.ubx_bad_checksum++;
+            return;
+        }
+        stats.ubx_received++;
+
+        uint8_t cls = f[2];
+        uint8_t id = f[3];
+        if (cls == 0x06) {
+            bool ok = handleCfg(port, id, f.data() + 6, f.size() - 8);
+            ack(port, cls, id, ok);
+            if (pending_baud) {
+                port.setDeviceBaud(pending_baud);
+                pending_baud = 0;
+            }
+        }
+    }
+
+    // ---- Epoch output ----
+
+    void emitEpoch(UartPort& port, uint64_t epoch_us) {
+        FlightState s = scenario.at(epoch_us);
+        bool fix = epoch_us >= FIX_DELAY_US;
+        uint64_t utc_ms = static_cast<uint64_t>(utc_start) * 1000 + epoch_us / 1000;
+
+        std::vector<uint8_t> out;
+        out.reserve(1024);
+        auto nmea = [&](uint8_t id, const char* body) {
+            if (!due(0xF0, id)) return;
+            uint8_t cs = 0;
+            for (const char* c = body; *c; c++) cs ^= static_cast<uint8_t>(*c);
+            char line[128];
+            int n = snprintf(line, sizeof(line), "$%s*%02X\r\n", body, cs);
+            out.insert(out.end(), line, line + n);
+        };
+
+        time_t secs = static_cast<time_t>(utc_ms / 1000);
+        struct tm utc;
+        gmtime_r(&secs, &utc);
+        // Every field is two digits; % 100 lets the compiler see that too
+        auto two = [](int v) { return static_cast<unsigned>(v) % 100; };
+        char hms[16], date[8], lat[24], lon[24];
+        snprintf(hms, sizeof(hms), "%02u%02u%02u.%02u", two(utc.tm_hour), two(utc.tm_min), two(utc.tm_sec),
+                 static_cast<unsigned>((utc_ms % 1000) / 10));
+        snprintf(date, sizeof(date), "%02u%02u%02u", two(utc.tm_mday), two(utc.tm_mon + 1), two(utc.tm_year));
+        formatCoord(lat, sizeof(lat), s.lat_deg, 2, 'N', 'S');
+        formatCoord(lon, sizeof(lon), s.lon_deg, 3, 'E', 'W');
+
+        double knots = s.airspeed_ms * 1.943844;
+        double kmh = s.airspeed_ms * 3.6;
+        char body[112];
+
+        if (fix) {
+            snprintf(body, sizeof(body), "GPGGA,%s,%s,%s,1,12,0.8,%.1f,M,%.1f,M,,", hms, lat, lon,
+                     s.altitude_m, GEOID_SEPARATION_M);
+        } else {
+            snprintf(body, sizeof(body), "GPGGA,%s,,,,,0,00,99.99,,,,,,", hms);
+        }
+        nmea(NMEA_GGA, body);
+
+        snprintf(body, sizeof(body), "GPGLL,%s,%s,%s,%c,A", fix ? lat : ",", fix ? lon : ",", hms, fix ? 'A' : 'V');
+        nmea(NMEA_GLL, body);
+
+        nmea(NMEA_GSA, fix ? "GPGSA,A,3,02,05,07,09,13,15,18,20,24,28,29,30,1.4,0.8,1.1"
+                           : "GPGSA,A,1,,,,,,,,,,,,,99.99,99.99,99.99");
+        nmea(NMEA_GSV, "GPGSV,3,1,12,02,45,120,42,05,60,045,44,07,30,300,38,09,15,250,35");
+        nmea(NMEA_GSV, "GPGSV,3,2,12,13,70,180,45,15,25,090,37,18,40,210,40,20,10,330,31");
+        nmea(NMEA_GSV, "GPGSV,3,3,12,24,55,010,43,28,20,160,36,29,35,270,39,30,50,060,41");
+
+        if (fix) {
+            snprintf(body, sizeof(body), "GPRMC,%s,A,%s,%s,%.3f,%.2f,%s,,,A", hms, lat, lon, knots, s.heading_deg, date);
+        } else {
+            snprintf(body, sizeof(body), "GPRMC,%s,V,,,,,,,%s,,,N", hms, date);
+        }
+        nmea(NMEA_RMC, body);
+
+        snprintf(body, sizeof(body), "GPVTG,%.2f,T,,M,%.3f,N,%.3f,K,%c", s.heading_deg, knots, kmh, fix ? 'A' : 'N');
+        nmea(NMEA_VTG, body);
+
+        auto nav = [&](const std::vector<uint8_t>& f) {
+            out.insert(out.end(), f.begin(), f.end());
+            stats.nav_frames++;
+        };
+        if (due(0x01, NAV_DOP)) nav(navDop(utc_ms, fix));
+        if (due(0x01, NAV_PVT)) {
+            nav(navPvt(s, utc, utc_ms, fix));
+            stats.nav_pvt++;
+        }
+        if (due(0x01, NAV_TIMEUTC)) nav(navTimeUtc(utc, utc_ms, fix));
+        if (due(0x01, NAV_SAT)) nav(navSat(utc_ms, fix));
+
+        if (!out.empty()) send(port, out, toBoard(epoch_us));
+        epoch_count++;
+        stats.epochs++;
+    }
+
+    static void formatCoord(char* dst, size_t size, double deg, int width, char pos, char neg) {
+        double a = std::fabs(deg);
+        int whole = static_cast<int>(a);
+        double minutes = (a - whole) * 60.0;
+        snprintf(dst, size, "%0*d%08.5f,%c", width, whole, minutes, deg >= 0 ? pos : neg);
+    }
+
+    // Constellation of the GSV sentences: svId, elevation, azimuth, C/N0
+    static constexpr uint16_t SATELLITES[12][4] = {
+        {2, 45, 120, 42}, {5, 60, 45, 44},  {7, 30, 300, 38},  {9, 15, 250, 35},
+        {13, 70, 180, 45}, {15, 25, 90, 37}, {18, 40, 210, 40}, {20, 10, 330, 31},
+        {24, 55, 10, 43},  {28, 20, 160, 36}, {29, 35, 270, 39}, {30, 50, 60, 41},
+    };
+
+    static uint32_t gpsTow(uint64_t utc_ms) {
+        // GPS week time: GPS epoch 1980-01-06, 18 leap seconds
+        uint64_t gps_ms = utc_ms - 315964800000ull + 18000;
+        return static_cast<uint32_t>(gps_ms % (604800ull * 1000));
+    }
+
+    static std::vector<uint8_t> navDop(uint64_t utc_ms, bool fix) {
+        uint8_t p[18] = {};
+        uint32_t tow = gpsTow(utc_ms);
+        memcpy(p, &tow, 4);
+        uint16_t dop[7] = {140, 120, 70, 110, 80, 60, 50};     // g, p, t, v, h, n, e (0.01)
+        if (!fix) std::fill(std::begin(dop), std::end(dop), 9999);
+        memcpy(p + 4, dop, sizeof(dop));
+        return frame(0x01, NAV_DOP, p, sizeof(p));
+    }
+
+    static std::vector<uint8_t> navTimeUtc(const struct tm& utc, uint64_t utc_ms, bool fix) {
+        uint8_t p[20] = {};
+        uint32_t tow = gpsTow(utc_ms);
+        uint32_t t_acc = fix ? 30 : 0xFFFFFFFF;
+        int32_t nano = static_cast<int32_t>((utc_ms % 1000) * 1000000);
+        uint16_t year = static_cast<uint16_t>(utc.tm_year + 1900);
+        memcpy(p, &tow, 4);
+        memcpy(p + 4, &t_acc, 4);
+        memcpy(p + 8, &nano, 4);
+        memcpy(p + 12, &year, 2);
+        p[14] = static_cast<uint8_t>(utc.tm_mon + 1);
+        p[15] = static_cast<uint8_t>(utc.tm_mday);
+        p[16] = static_cast<uint8_t>(utc.tm_hour);
+        p[17] = static_cast<uint8_t>(utc.tm_min);
+        p[18] = static_cast<uint8_t>(utc.tm_sec);
+        p[19] = fix ? 0x07 : 0x03;                                  // validTOW | validWKN | validUTC
+        return frame(0x01, NAV_TIMEUTC, p, sizeof(p));
+    }
+
+    static std::vector<uint8_t> navSat(uint64_t utc_ms, bool fix) {
+        std::vector<uint8_t> p(8 + 12 * std::size(SATELLITES), 0);
+        uint32_t tow = gpsTow(utc_ms);
+        memcpy(p.data(), &tow, 4);
+        p[4] = 1;                                                   // version
+        p[5] = static_cast<uint8_t>(std::size(SATELLITES));
+        for (size_t i = 0; i < std::size(SATELLITES); i++) {
+            uint8_t* sv = p.data() + 8 + 12 * i;
+            const uint16_t* sat = SATELLITES[i];
+            uint16_t azim = sat[2];
+            uint32_t flags = fix ? 0x0F : 0x04;                     // quality 7 + svUsed, or code lock only
+            sv[0] = 0;                                              // GPS
+            sv[1] = static_cast<uint8_t>(sat[0]);
+            sv[2] = static_cast<uint8_t>(sat[3]);
+            sv[3] = static_cast<uint8_t>(sat[1]);
+            memcpy(sv + 4, &azim, 2);
+            memcpy(sv + 8, &flags, 4);
+        }
+        return frame(0x01, NAV_SAT, p.data(), p.size());
+    }
+
+    std::vector<uint8_t> navPvt(const FlightState& s, const struct tm& utc, uint64_t utc_ms, bool fix) const {
+        uint8_t p[92] = {};
+        auto put32 = [&](size_t off, uint32_t v) { memcpy(p + off, &v, 4); };
+        auto put16 = [&](size_t off, uint16_t v) { memcpy(p + off, &v, 2); };
+
+        put32(0, gpsTow(utc_ms));
+        put16(4, static_cast<uint16_t>(utc.tm_year + 1900));
+        p[6] = static_cast<uint8_t>(utc.tm_mon + 1);
+        p[7] = static_cast<uint8_t>(utc.tm_mday);
+        p[8] = static_cast<uint8_t>(utc.tm_hour);
+        p[9] = static_cast<uint8_t>(utc.tm_min);
+        p[10] = static_cast<uint8_t>(utc.tm_sec);
+        p[11] = fix ? 0x07 : 0x00;                                  // validDate | validTime | fullyResolved
+        put32(12, 30);                                              // tAcc ns
+        put32(16, static_cast<uint32_t>((utc_ms % 1000) * 1000000));  // nano
+        p[20] = fix ? 3 : 0;                                        // fixType
+        p[21] = fix ? 0x01 : 0x00;                                  // gnssFixOK
+        p[23] = fix ? 12 : 0;                                       // numSV
+        if (fix) {
+            put32(24, static_cast<uint32_t>(static_cast<int32_t>(std::lround(s.lon_deg * 1e7))));
+            put32(28, static_cast<uint32_t>(static_cast<int32_t>(std::lround(s.lat_deg * 1e7))));
+            put32(32, static_cast<uint32_t>(static_cast<int32_t>(std::lround((s.altitude_m + GEOID_SEPARATION_M) * 1000))));
+            put32(36, static_cast<uint32_t>(static_cast<int32_t>(std::lround(s.altitude_m * 1000))));
+            put32(40, 1500);                                        // hAcc mm
+            put32(44, 2500);                                        // vAcc mm
+            put32(48, static_cast<uint32_t>(static_cast<int32_t>(std::lround(s.vel_ned_ms[0] * 1000))));
+            put32(52, static_cast<uint32_t>(static_cast<int32_t>(std::lround(s.vel_ned_ms[1] * 1000))));
+            put32(56, static_cast<uint32_t>(static_cast<int32_t>(std::lround(s.vel_ned_ms[2] * 1000))));
+            put32(60, static_cast<uint32_t>(static_cast<int32_t>(std::lround(s.airspeed_ms * 1000))));
+            put32(64, static_cast<uint32_t>(static_cast<int32_t>(std::lround(s.heading_deg * 1e5))));
+            put32(68, 300);                                         // sAcc mm/s
+            put32(72, 50000);                                       // headAcc 1e-5 deg
+            put16(76, 120);                                         // pDOP 0.01
+        }
+        return frame(0x01, NAV_PVT, p, sizeof(p));
+    }
+};
+
+} // namespace sim
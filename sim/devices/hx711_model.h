@@ -0,0 +1,75 @@
+#pragma once
+
+#include "register_device.h"
+
+namespace sim {
+
+// ============================================
+// HX711 Load Cell Bridge (I2C front end)
+// ============================================
+// The force plate's I2C adapter: a 24-bit two's-complement reading at
+// 0x00 (MSB first) refreshed at the HX711 rate, 10 SPS or 80 SPS with
+// CONTROL bit 0 set. Nothing converts until CONTROL has been written.
+// The plate carries LOAD_KG, so the reading follows the vertical
+// acceleration of the scenario.
+class HX711Model : public RegisterDevice {
+public:
+    static constexpr uint8_t DATA_MSB = 0x00;
+    static constexpr uint8_t CONTROL = 0x03;
+    static constexpr uint8_t TARE = 0x04;
+
+    static constexpr double LOAD_KG = 2.5;
+    static constexpr double COUNTS_PER_N = 4000.0;
+    static constexpr int32_t ZERO_COUNTS = 85000;
+
+    explicit HX711Model(const Scenario& scenario, uint32_t seed = 0x0711) : scenario(scenario), noise(seed) {}
+
+    uint32_t conversions() const { return conversion_count; }
+
+protected:
+    void sample(uint64_t now_us) override {
+        if (!configured) return;
+
+        uint64_t period = (regs[CONTROL] & 0x01) ? 12500 : 100000;
+        uint64_t index = now_us / period;
+        if (index != last_index) {
+            last_index = index;
+            convert(index * period);
+        }
+    }
+
+    uint8_t readReg(uint8_t reg) override { return regs[reg]; }
+
+    void writeReg(uint8_t reg, uint8_t value) override {
+        if (reg == CONTROL) {
+            configured = true;
+            last_index = UINT64_MAX;
+        }
+        if (reg >= CONTROL) regs[reg] = value;
+    }
+
+private:
+    const Scenario& scenario;
+    Noise noise;
+
+    uint8_t regs[256] = {};
+    bool configured = false;
+    uint64_t last_index = UINT64_MAX;
+    uint32_t conversion_count = 0;
+
+    void convert(uint64_t t_us) {
+        FlightState s = scenario.at(t_us);
+        conversion_count++;
+
+        double force = LOAD_KG * s.accel_ms2[2];
+        int32_t counts = ZERO_COUNTS + static_cast<int32_t>(std::lround(force * COUNTS_PER_N + noise(40.0)));
+        counts = std::clamp(counts, -0x800000, 0x7FFFFF);
+
+        uint32_t raw = static_cast<uint32_t>(counts) & 0xFFFFFF;
+        regs[DATA_MSB] = static_cast<uint8_t>(raw >> 16);
+        regs[DATA_MSB + 1] = static_cast<uint8_t>(raw >> 8);
+        regs[DATA_MSB + 2] = static_cast<uint8_t>(raw);
+    }
+};
+
+} // namespace sim
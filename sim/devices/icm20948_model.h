@@ -0,0 +1,222 @@
+#pragma once
+
+#include <deque>
+
+#include "register_device.h"
+#include "int_pin.h"
+
+namespace sim {
+
+// ============================================
+// ICM-20948 (accel + gyro part)
+// ============================================
+// Four 128-register user banks selected by REG_BANK_SEL (0x7F, present in
+// every bank). Comes out of reset asleep (PWR_MGMT_1 = 0x41); while asleep
+// the data registers hold their last value. Output registers are
+// big-endian and refresh at the internal sample rate with the full-scale
+// ranges set in bank 2; with FCHOICE set the rate is divided by
+// 1 + GYRO_SMPLRT_DIV. The internal oscillator may be off by
+// setOscillatorPpm().
+//
+// FIFO: with FIFO_EN in USER_CTRL and accel + gyro enabled in FIFO_EN_2,
+// every sample appends a 12-byte frame (accel, gyro) to the 512-byte FIFO.
+// FIFO_COUNTH latches the count for FIFO_COUNTL; reads of FIFO_R_W pop
+// without advancing the register pointer. A full FIFO drops new frames in
+// snapshot mode and the oldest in stream mode, and flags INT_STATUS_2
+// (cleared on read).
+//
+// INT1: with RAW_DATA_0_RDY_EN in INT_ENABLE_1 the pin attached with
+// attachInt() pulses at every sample (50 µs pulse, INT_PIN_CFG latch off).
+class ICM20948Model : public RegisterDevice {
+public:
+    static constexpr uint8_t WHO_AM_I_VALUE = 0xEA;
+    static constexpr uint32_t SAMPLE_PERIOD_NS = 888'889;  // 1.125 kHz accel / 1.1 kHz gyro
+    static constexpr size_t FIFO_SIZE = 512;
+    static constexpr size_t FRAME = 12;
+
+    // Bank 0
+    static constexpr uint8_t WHO_AM_I = 0x00;
+    static constexpr uint8_t USER_CTRL = 0x03;
+    static constexpr uint8_t PWR_MGMT_1 = 0x06;
+    static constexpr uint8_t PWR_MGMT_2 = 0x07;
+    static constexpr uint8_t INT_PIN_CFG = 0x0F;
+    static constexpr uint8_t INT_ENABLE_1 = 0x11;
+    static constexpr uint8_t INT_STATUS_2 = 0x1B;
+    static constexpr uint8_t ACCEL_XOUT_H = 0x2D;
+    static constexpr uint8_t TEMP_OUT_H = 0x39;
+    static constexpr uint8_t FIFO_EN_2 = 0x67;
+    static constexpr uint8_t FIFO_RST = 0x68;
+    static constexpr uint8_t FIFO_MODE = 0x69;
+    static constexpr uint8_t FIFO_COUNTH = 0x70;
+    static constexpr uint8_t FIFO_COUNTL = 0x71;
+    static constexpr uint8_t FIFO_R_W = 0x72;
+    static constexpr uint8_t BANK_SEL = 0x7F;
+    // Bank 2
+    static constexpr uint8_t GYRO_SMPLRT_DIV = 0x00;
+    static constexpr uint8_t GYRO_CONFIG_1 = 0x01;
+    static constexpr uint8_t ACCEL_CONFIG = 0x14;
+
+    ICM20948Model(const Scenario& scenario, uint32_t seed = 0x1C20) : scenario(scenario), noise(seed) {
+        reset();
+    }
+
+    uint32_t samples() const { return sample_count; }
+    uint32_t fifoDropped() const { return fifo_dropped; }
+
+    void setOscillatorPpm(double ppm) {
+        oscillator = 1.0 + ppm * 1e-6;
+        publishInt();
+    }
+
+    void attachInt(uint pin) { int_pin.attach(pin); }
+    uint32_t intPulses() const { return int_pin.pulses(); }
+
+    // Sample period on the true clock
+    double periodNs() const {
+        uint32_t div = (banks[2][GYRO_CONFIG_1] & 0x01) ? banks[2][GYRO_SMPLRT_DIV] : 0;
+        return SAMPLE_PERIOD_NS * (1 + div) / oscillator;
+    }
+
+protected:
+    void sample(uint64_t now_us) override {
+        bool asleep = banks[0][PWR_MGMT_1] & 0x40;
+        double period_ns = periodNs();
+        uint64_t index = static_cast<uint64_t>(now_us * 1000.0 / period_ns);
+        if (asleep || index == last_index) return;
+
+        // Every sample since the last transfer goes to the FIFO, as far as it
+        // takes them; the output registers get the newest
+        uint64_t first = (last_index == UINT64_MAX || !fifoOn()) ? index : last_index + 1;
+        if (!(banks[0][FIFO_MODE] & 0x01) && index - first > FIFO_SIZE / FRAME) {
+            // Stream mode: only the newest frames survive
+            uint64_t keep = index - FIFO_SIZE / FRAME;
+            overflow(static_cast<uint32_t>(keep - first));
+            first = keep;
+        }
+        last_index = index;
+        for (uint64_t i = first; i <= index; i++) {
+            // Snapshot mode and full: the frames up to the newest are dropped unseen
+            if (i < index && fifoOn() && (banks[0][FIFO_MODE] & 0x01) && fifo.size() + FRAME > FIFO_SIZE) {
+                overflow(static_cast<uint32_t>(index - i));
+                i = index;
+            }
+            generate(static_cast<uint64_t>(i * period_ns / 1000.0));
+            if (fifoOn()) push();
+        }
+    }
+
+    void generate(uint64_t t_us) {
+        sample_count++;
+        FlightState s = scenario.at(t_us);
+
+        // LSB per m/s² and per rad/s from the configured full-scale ranges
+        double accel_lsb = 16384.0 / (1 << ((banks[2][ACCEL_CONFIG] >> 1) & 0x03)) / 9.80665;
+        double gyro_lsb = 131.0 / (1 << ((banks[2][GYRO_CONFIG_1] >> 1) & 0x03)) * (180.0 / M_PI);
+
+        uint8_t* out = &banks[0][ACCEL_XOUT_H];
+        for (int axis = 0; axis < 3; axis++) {
+            putBE16(out + axis * 2, saturate16((s.accel_ms2[axis] + noise(0.05)) * accel_lsb));
+            putBE16(out + 6 + axis * 2, saturate16((s.gyro_rads[axis] + noise(0.002)) * gyro_lsb));
+        }
+
+        // Die temperature: 333.87 LSB/°C around 21 °C
+        putBE16(&banks[0][TEMP_OUT_H], saturate16((s.air_temp_c + 10.0 - 21.0) * 333.87));
+    }
+
+    bool fifoOn() const {
+        return (banks[0][USER_CTRL] & 0x40) && (banks[0][FIFO_EN_2] & 0x1E) == 0x1E;
+    }
+
+    void overflow(uint32_t frames) {
+        banks[0][INT_STATUS_2] |= 0x1F;
+        fifo_dropped += frames;
+    }
+
+    void push() {
+        if (fifo.size() + FRAME > FIFO_SIZE) {
+            overflow(1);
+            if (banks[0][FIFO_MODE] & 0x01) return;
+            fifo.erase(fifo.begin(), fifo.begin() + FRAME);
+        }
+        const uint8_t* out = &banks[0][ACCEL_XOUT_H];
+        fifo.insert(fifo.end(), out, out + FRAME);
+    }
+
+    uint8_t readReg(uint8_t reg) override {
+        reg &= 0x7F;
+        if (reg == BANK_SEL) return bank << 4;
+        if (bank == 0) {
+            switch (reg) {
+                case FIFO_COUNTH:
+                    count_latch = static_cast<uint16_t>(fifo.size());
+                    return static_cast<uint8_t>((count_latch >> 8) & 0x1F);
+                case FIFO_COUNTL:
+                    return static_cast<uint8_t>(count_latch);
+                case FIFO_R_W: {
+                    pointer = FIFO_R_W;
+                    if (fifo.empty()) return 0xFF;
+                    uint8_t value = fifo.front();
+                    fifo.pop_front();
+                    return value;
+                }
+                case INT_STATUS_2: {
+                    uint8_t value = banks[0][INT_STATUS_2];
+                    banks[0][INT_STATUS_2] = 0;
+                    return value;
+                }
+            }
+        }
+        return banks[bank][reg];
+    }
+
+    void writeReg(uint8_t reg, uint8_t value) override {
+        reg &= 0x7F;
+        if (reg == BANK_SEL) {
+            bank = (value >> 4) & 0x03;
+            return;
+        }
+        if (bank == 0 && reg == WHO_AM_I) return;   // Read-only
+
+        if (bank == 0 && reg == PWR_MGMT_1 && (value & 0x80)) {
+            reset();
+            return;
+        }
+        if (bank == 0 && reg == FIFO_RST && (value & 0x1F)) fifo.clear();
+        if (bank == 2 && (reg == GYRO_SMPLRT_DIV || reg == GYRO_CONFIG_1)) last_index = UINT64_MAX;
+        banks[bank][reg] = value;
+        publishInt();
+    }
+
+private:
+    const Scenario& scenario;
+    Noise noise;
+
+    uint8_t banks[4][128];
+    uint8_t bank = 0;
+    uint64_t last_index = UINT64_MAX;
+    uint32_t sample_count = 0;
+    double oscillator = 1.0;
+    std::deque<uint8_t> fifo;
+    uint16_t count_latch = 0;
+    uint32_t fifo_dropped = 0;             // Frames
+    IntPin int_pin;
+
+    void publishInt() {
+        bool on = (banks[0][INT_ENABLE_1] & 0x01) && !(banks[0][PWR_MGMT_1] & 0x40);
+        int_pin.setPeriodNs(on ? periodNs() : 0.0);
+    }
+
+    void reset() {
+        memset(banks, 0, sizeof(banks));
+        banks[0][WHO_AM_I] = WHO_AM_I_VALUE;
+        banks[0][PWR_MGMT_1] = 0x41;
+        banks[2][GYRO_CONFIG_1] = 0x01;
+        banks[2][ACCEL_CONFIG] = 0x01;
+        bank = 0;
+        last_index = UINT64_MAX;
+        fifo.clear();
+        publishInt();
+    }
+};
+
+} // namespace sim
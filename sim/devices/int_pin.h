@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cmath>
+
+#include "runtime/sim.h"
+#include "pico/time.h"
+
+namespace sim {
+
+// ============================================
+// Data-Ready Interrupt Output
+// ============================================
+// A sensor's INT line in pulse mode: high for PULSE_US at every conversion
+// instant k * period, driven from the alarm pool (exact on the virtual
+// clock). The model publishes its conversion period with setPeriodNs(),
+// 0 while the interrupt is disabled or the part is not converting; the
+// alarm reads it in IRQ context, hence the atomic.
+class IntPin {
+public:
+    static constexpr uint32_t PULSE_US = 50;
+    static constexpr uint64_t IDLE_POLL_US = 1000;     // Re-check a disabled line
+
+    void attach(uint pin) {
+        pin_num = pin;
+        schedule();
+    }
+
+    void setPeriodNs(double ns) { period_ns.store(ns); }
+    uint32_t pulses() const { return pulse_count.load(); }
+
+    // First conversion instant at or after index k, in whole µs
+    static uint64_t edgeUs(uint64_t k, double period_ns) {
+        return static_cast<uint64_t>(std::ceil(k * period_ns / 1000.0));
+    }
+
+private:
+    uint pin_num = 0;
+    std::atomic<double> period_ns{0.0};
+    std::atomic<uint32_t> pulse_count{0};
+    bool high = false;
+    bool at_edge = false;       // The pending alarm is a conversion, not an idle poll
+    uint64_t last_index = UINT64_MAX;
+
+    static int64_t alarm(alarm_id_t, void* self) {
+        static_cast<IntPin*>(self)->step();
+        return 0;
+    }
+
+    // One alarm per edge: rise at the conversion, fall after the pulse
+    void step() {
+        uint64_t now = clock::now_us();
+        if (high) {
+            gpio::drive(pin_num, false);
+            high = false;
+        } else {
+            double period = period_ns.load();
+            uint64_t k = period > 0 ? static_cast<uint64_t>(now * 1000.0 / period) : 0;
+            if (at_edge && period > 0 && k != last_index) {
+                last_index = k;
+                gpio::drive(pin_num, true);
+                high = true;
+                pulse_count++;
+                add_alarm_at(now + PULSE_US, alarm, this, true);
+                return;
+            }
+        }
+        schedule();
+    }
+
+    void schedule() {
+        double period = period_ns.load();
+        at_edge = period > 0;
+        if (!at_edge) {
+            add_alarm_in_us(IDLE_POLL_US, alarm, this, true);
+            return;
+        }
+        uint64_t k = static_cast<uint64_t>(clock::now_us() * 1000.0 / period) + 1;
+        add_alarm_at(edgeUs(k, period), alarm, this, true);
+    }
+};
+
+} // namespace sim
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "scenario.h"
+#include "runtime/sim.h"
+
+namespace sim {
+
+// ============================================
+// MS4525DO Differential Pressure Sensor
+// ============================================
+// No register map: a read returns up to 4 bytes of the latest conversion
+// (status:2 | bridge:14, temperature:11 | 5 unused). Output type A maps the
+// pressure range to 10..90 % of 14 bits. Status is 2 (stale) when no new
+// conversion finished since the previous read. Writes (read-MR commands)
+// are acknowledged and ignored.
+//
+// setZeroDrift() adds a bridge offset that moves with die temperature,
+// the die warming up above the air from the moment it is set.
+class MS4525DOModel : public I2CDevice {
+public:
+    static constexpr uint32_t CONVERSION_US = 500;
+    static constexpr uint16_t COUNTS_MIN = 1638;    // 10 %
+    static constexpr uint16_t COUNTS_MAX = 14745;   // 90 %
+    static constexpr double PSI_TO_PA = 6894.757;
+
+    // DS5AI001DP: -1..+1 psi
+    MS4525DOModel(const Scenario& scenario, double p_min_psi = -1.0, double p_max_psi = 1.0,
+                  uint32_t seed = 0x4525)
+        : scenario(scenario), noise(seed), p_min(p_min_psi), p_max(p_max_psi) {}
+
+    // Offset zero_pa + tempco * (die - 25 °C); the die settles warmup_c
+    // above the air with time constant tau_s
+    void setZeroDrift(double zero_pa, double tempco_pa_per_c, double warmup_c, double tau_s) {
+        drift = {zero_pa, tempco_pa_per_c, warmup_c, tau_s, clock::now_us()};
+    }
+
+    // Last conversion, without noise
+    double lastOffsetPa() const { return last_offset_pa; }
+    double lastDieC() const { return last_die_c; }
+
+    int write(const uint8_t*, size_t len, bool) override { return static_cast<int>(len); }
+
+    int read(uint8_t* dst, size_t len, bool) override {
+        uint64_t index = clock::now_us() / CONVERSION_US;
+        uint8_t status = 2;
+        if (index != last_index) {
+            last_index = index;
+            convert(index * CONVERSION_US);
+            status = 0;
+        }
+
+        uint8_t frame[4] = {
+            static_cast<uint8_t>((status << 6) | (bridge >> 8)),
+            static_cast<uint8_t>(bridge),
+            static_cast<uint8_t>(temperature >> 3),
+            static_cast<uint8_t>((temperature & 0x07) << 5),
+        };
+        memcpy(dst, frame, std::min<size_t>(len, sizeof(frame)));
+        for (size_t i = sizeof(frame); i < len; i++) dst[i] = 0xFF;
+        return static_cast<int>(len);
+    }
+
+private:
+    const Scenario& scenario;
+    Noise noise;
+    double p_min;
+    double p_max;
+
+    struct Drift {
+        double zero_pa = 0.0;
+        double tempco = 0.0;
+        double warmup_c = 0.0;
+        double tau_s = 1.0;
+        uint64_t since_us = 0;
+    } drift;
+    double last_offset_pa = 0.0;
+    double last_die_c = 0.0;
+
+    uint64_t last_index = UINT64_MAX;
+    uint16_t bridge = COUNTS_MIN;
+    uint16_t temperature = 0;
+
+    void convert(uint64_t t_us) {
+        FlightState s = scenario.at(t_us);
+
+        double warm_s = t_us > drift.since_us ? (t_us - drift.since_us) * 1e-6 : 0.0;
+        last_die_c = s.air_temp_c + drift.warmup_c * (1.0 - std::exp(-warm_s / drift.tau_s));
+        last_offset_pa = drift.zero_pa + drift.tempco * (last_die_c - 25.0);
+
+        double psi = (s.dynamic_pa + last_offset_pa) / PSI_TO_PA + noise(0.0004);
+        double counts = COUNTS_MIN + (psi - p_min) * (COUNTS_MAX - COUNTS_MIN) / (p_max - p_min);
+        bridge = static_cast<uint16_t>(std::clamp(std::lround(counts), 0l, 0x3FFFl));
+
+        // 11 bits over -50..150 °C
+        double t_counts = (last_die_c + 50.0) * 2047.0 / 200.0;
+        temperature = static_cast<uint16_t>(std::clamp(std::lround(t_counts), 0l, 2047l));
+    }
+};
+
+} // namespace sim
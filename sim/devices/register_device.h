@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstring>
+
+#include "runtime/sim.h"
+#include "scenario.h"
+
+namespace sim {
+
+// ============================================
+// Register-Mapped I2C Device
+// ============================================
+// The usual sensor protocol: the first byte of a write sets the register
+// pointer, further bytes are written from it on, and reads continue from
+// the pointer; both auto-increment. Models implement readReg/writeReg and
+// refresh their output registers in sample(), which runs at the start of
+// every transfer with the current time.
+class RegisterDevice : public I2CDevice {
+public:
+    int write(const uint8_t* src, size_t len, bool nostop) override {
+        (void)nostop;
+        sample(clock::now_us());
+        if (len == 0) return 0;
+
+        pointer = src[0];
+        for (size_t i = 1; i < len; i++) {
+            writeReg(pointer++, src[i]);
+        }
+        return static_cast<int>(len);
+    }
+
+    int read(uint8_t* dst, size_t len, bool nostop) override {
+        (void)nostop;
+        sample(clock::now_us());
+        for (size_t i = 0; i < len; i++) {
+            dst[i] = readReg(pointer++);
+        }
+        return static_cast<int>(len);
+    }
+
+protected:
+    uint8_t pointer = 0;
+
+    virtual void sample(uint64_t now_us) = 0;
+    virtual uint8_t readReg(uint8_t reg) = 0;
+    virtual void writeReg(uint8_t reg, uint8_t value) = 0;
+
+    static void putBE16(uint8_t* dst, int16_t value) {
+        dst[0] = static_cast<uint8_t>(static_cast<uint16_t>(value) >> 8);
+        dst[1] = static_cast<uint8_t>(value);
+    }
+
+    static void putLE24(uint8_t* dst, uint32_t value) {
+        dst[0] = static_cast<uint8_t>(value);
+        dst[1] = static_cast<uint8_t>(value >> 8);
+        dst[2] = static_cast<uint8_t>(value >> 16);
+    }
+
+    static int16_t saturate16(double value) {
+        return static_cast<int16_t>(std::clamp(std::lround(value), -32768l, 32767l));
+    }
+};
+
+} // namespace sim
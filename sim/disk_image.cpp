@@ -0,0 +1,185 @@
+// FatFs diskio on a raw image file, with the SPI SD card's write pattern
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "disk_image.h"
+#include "runtime/sim.h"
+
+extern "C" {
+    #include "ff.h"
+    #include "diskio.h"
+}
+
+namespace {
+    constexpr uint32_t SECTOR_SIZE = 512;
+
+    std::mutex disk_mutex;
+    int fd = -1;
+    LBA_t sector_count = 0;
+
+    bool timing_enabled = false;
+    sim::disk::Timing timing;
+    sim::disk::Stats stats;
+
+    // Open CMD25 run (sd_spi_if_state_t::ongoing_mlt_blk_wrt / cont_sector_wrt)
+    bool ongoing_multi = false;
+    LBA_t cont_sector = 0;
+
+    uint64_t transferUs(UINT sectors) {
+        // Data token + block + CRC per sector
+        return (static_cast<uint64_t>(sectors) * (SECTOR_SIZE + 3) * 8 * 1'000'000) / timing.spi_hz;
+    }
+
+    void charge(uint64_t us) {
+        stats.busy_us += us;
+        if (timing_enabled) sim::clock::spin_for(us);
+    }
+
+    void stopMulti() {
+        if (!ongoing_multi) return;
+        ongoing_multi = false;
+        stats.stops++;
+        charge(timing.stop_busy_us);
+    }
+}
+
+namespace sim::disk {
+
+bool open(const char* path, uint64_t bytes, bool fresh) {
+    std::lock_guard<std::mutex> l(disk_mutex);
+    if (fd >= 0) ::close(fd);
+
+    fd = ::open(path, O_RDWR | O_CREAT | (fresh ? O_TRUNC : 0), 0644);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) return false;
+    if (static_cast<uint64_t>(st.st_size) < bytes && ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        return false;
+    }
+    if (fstat(fd, &st) != 0) return false;
+
+    sector_count = static_cast<LBA_t>(st.st_size / SECTOR_SIZE);
+    ongoing_multi = false;
+    stats = {};
+    return sector_count > 0;
+}
+
+void close() {
+    std::lock_guard<std::mutex> l(disk_mutex);
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+}
+
+// Boot sector signature (FAT/exFAT volume or MBR)
+bool isFormatted() {
+    std::lock_guard<std::mutex> l(disk_mutex);
+    uint8_t sig[2] = {};
+    return fd >= 0 && pread(fd, sig, 2, 510) == 2 && sig[0] == 0x55 && sig[1] == 0xAA;
+}
+
+void setTiming(bool enabled, const Timing& t) {
+    std::lock_guard<std::mutex> l(disk_mutex);
+    timing_enabled = enabled;
+    timing = t;
+}
+
+Stats getStats() {
+    std::lock_guard<std::mutex> l(disk_mutex);
+    return stats;
+}
+
+} // namespace sim::disk
+
+// ============================================
+// FatFs diskio
+// ============================================
+extern "C" {
+
+DSTATUS disk_status(BYTE pdrv) {
+    return (pdrv == 0 && fd >= 0) ? 0 : STA_NOINIT;
+}
+
+DSTATUS disk_initialize(BYTE pdrv) {
+    return disk_status(pdrv);
+}
+
+DRESULT disk_read(BYTE pdrv, BYTE* buff, LBA_t sector, UINT count) {
+    std::lock_guard<std::mutex> l(disk_mutex);
+    if (pdrv != 0 || fd < 0) return RES_NOTRDY;
+    if (sector + count > sector_count) return RES_PARERR;
+
+    stopMulti();
+    stats.read_commands++;
+    stats.sectors_read += count;
+    charge(timing.command_us + timing.read_access_us * count + transferUs(count));
+
+    size_t len = static_cast<size_t>(count) * SECTOR_SIZE;
+    return pread(fd, buff, len, static_cast<off_t>(sector) * SECTOR_SIZE) == static_cast<ssize_t>(len)
+        ? RES_OK : RES_ERROR;
+}
+
+DRESULT disk_write(BYTE pdrv, const BYTE* buff, LBA_t sector, UINT count) {
+    std::lock_guard<std::mutex> l(disk_mutex);
+    if (pdrv != 0 || fd < 0) return RES_NOTRDY;
+    if (sector + count > sector_count) return RES_PARERR;
+
+    if (count == 1) {
+        // write_block(): CMD24, always ends a multi-block run first
+        stopMulti();
+        stats.single_writes++;
+        charge(timing.command_us + transferUs(1) + timing.single_write_busy_us);
+    } else if (ongoing_multi && cont_sector == sector) {
+        stats.continuations++;
+        charge(transferUs(count) + static_cast<uint64_t>(timing.multi_block_busy_us) * count);
+    } else {
+        stopMulti();
+        stats.multi_writes++;
+        charge(timing.command_us + transferUs(count) + static_cast<uint64_t>(timing.multi_block_busy_us) * count);
+        ongoing_multi = true;
+    }
+    if (count > 1) cont_sector = sector + count;
+    stats.sectors_written += count;
+
+    size_t len = static_cast<size_t>(count) * SECTOR_SIZE;
+    return pwrite(fd, buff, len, static_cast<off_t>(sector) * SECTOR_SIZE) == static_cast<ssize_t>(len)
+        ? RES_OK : RES_ERROR;
+}
+
+DRESULT disk_ioctl(BYTE pdrv, BYTE cmd, void* buff) {
+    std::lock_guard<std::mutex> l(disk_mutex);
+    if (pdrv != 0 || fd < 0) return RES_NOTRDY;
+
+    switch (cmd) {
+        case CTRL_SYNC:
+            stopMulti();
+            return RES_OK;
+        case GET_SECTOR_COUNT:
+            *static_cast<LBA_t*>(buff) = sector_count;
+            return RES_OK;
+        case GET_SECTOR_SIZE:
+            *static_cast<WORD*>(buff) = SECTOR_SIZE;
+            return RES_OK;
+        case GET_BLOCK_SIZE:
+            *static_cast<DWORD*>(buff) = 1;
+            return RES_OK;
+        default:
+            return RES_PARERR;
+    }
+}
+
+DWORD get_fattime(void) {
+    time_t now = time(nullptr);
+    struct tm t;
+    localtime_r(&now, &t);
+    return (static_cast<DWORD>(t.tm_year - 80) << 25) | (static_cast<DWORD>(t.tm_mon + 1) << 21) |
+           (static_cast<DWORD>(t.tm_mday) << 16) | (static_cast<DWORD>(t.tm_hour) << 11) |
+           (static_cast<DWORD>(t.tm_min) << 5) | (static_cast<DWORD>(t.tm_sec) >> 1);
+}
+
+} // extern "C"
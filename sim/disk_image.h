@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+namespace sim::disk {
+
+// ============================================
+// SD Card on a Disk Image
+// ============================================
+// FatFs diskio backed by a raw image file (one 512-byte sector per card
+// block). Writes follow the SPI driver's command pattern
+// (lib/sdcard/src/sd_driver/SPI/sd_card_spi.c):
+// - A one-sector write is CMD24 and ends any open multi-block write.
+// - A multi-sector write continues an open CMD25 when it starts at the next
+//   sector, otherwise it stops that one (CMD12 busy) and opens a new one.
+// - Reads and CTRL_SYNC stop an open multi-block write.
+//
+// With timing enabled the calling core spins for the modelled cost. The
+// cost is the SPI clock for the data plus the card's command and busy
+// times, so SDFile's flush/sync statistics are in the right ballpark.
+struct Timing {
+    uint32_t spi_hz = 31'250'000;
+    uint32_t command_us = 40;           // Command, R1 and data token turnaround
+    uint32_t read_access_us = 200;      // Until the read data token
+    uint32_t single_write_busy_us = 700;
+    uint32_t multi_block_busy_us = 40;  // Per block inside a CMD25 run
+    uint32_t stop_busy_us = 300;        // CMD12 / stop-tran token
+};
+
+struct Stats {
+    uint64_t read_commands = 0;
+    uint64_t sectors_read = 0;
+    uint64_t single_writes = 0;         // CMD24
+    uint64_t multi_writes = 0;          // CMD25 opened
+    uint64_t continuations = 0;         // Multi-sector writes that continued a CMD25
+    uint64_t stops = 0;
+    uint64_t sectors_written = 0;
+    uint64_t busy_us = 0;               // Modelled card time
+};
+
+// Opens (fresh: recreates) the image; a new image is sized to `bytes`
+bool open(const char* path, uint64_t bytes, bool fresh);
+void close();
+bool isFormatted();
+
+void setTiming(bool enabled, const Timing& timing = {});
+Stats getStats();
+
+} // namespace sim::disk
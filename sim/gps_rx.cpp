@@ -0,0 +1,200 @@
+// GPS receive path under load: GpsDriver brings the receiver model from
+// its power-up baud rate to config::gps::BAUD_RATE and UPDATE_RATE_HZ
+// through the UBX configuration exchange, then gets NAV-PVT, NAV-DOP,
+// NAV-TIMEUTC and NAV-SAT plus every NMEA sentence each epoch while the consumer parses the UART ring at the
+// scheduler's rate but periodically stalls far longer than the 32-byte RX
+// FIFO lasts.
+//
+//   gps_rx [--start-baud HZ] [--seconds S] [--stall-ms MS] [--no-nmea]
+//          [--pps] [--board-ppm PPM]
+//
+// --start-baud puts the receiver on another rate first (a warm restart of
+// the board with the receiver still configured). --pps also requires the
+// timepulse-disciplined clock to lock, with the board clock running
+// --board-ppm fast against GPS time, and to estimate that drift and the
+// UTC time closely. Configuration has to
+// succeed, and every NAV message the model sends has to arrive with a good
+// checksum and reach its handler, with no FIFO overruns, framing errors or ring drops; the exit
+// code is non-zero otherwise.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "runtime/sim.h"
+#include "scenario.h"
+#include "devices/gps_receiver.h"
+
+#include "config/config.h"
+#include "drivers/gps/gps_driver.h"
+
+namespace {
+
+void sleepUs(uint64_t us) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+
+void setOutput(sim::GpsReceiver& model, uint8_t every, bool nmea) {
+    sim::uart::withDevice(uart0, [&] {
+        for (uint8_t id : {sim::GpsReceiver::NAV_DOP, sim::GpsReceiver::NAV_PVT, sim::GpsReceiver::NAV_TIMEUTC,
+                           sim::GpsReceiver::NAV_SAT}) {
+            model.setRate(0x01, id, every);
+        }
+        for (uint8_t id : {sim::GpsReceiver::NMEA_GGA, sim::GpsReceiver::NMEA_GLL, sim::GpsReceiver::NMEA_GSA,
+                           sim::GpsReceiver::NMEA_GSV, sim::GpsReceiver::NMEA_RMC, sim::GpsReceiver::NMEA_VTG}) {
+            model.setRate(0xF0, id, nmea ? every : 0);
+        }
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint start_baud = 9600;
+    double seconds = 3.0;
+    uint32_t stall_ms = 60;
+    bool nmea = true;
+    bool pps = false;
+    double board_ppm = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--start-baud" && i + 1 < argc) start_baud = static_cast<uint>(strtoul(argv[++i], nullptr, 10));
+        else if (a == "--seconds" && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (a == "--stall-ms" && i + 1 < argc) stall_ms = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (a == "--no-nmea") nmea = false;
+        else if (a == "--pps") pps = true;
+        else if (a == "--board-ppm" && i + 1 < argc) board_ppm = atof(argv[++i]);
+        else {
+            fprintf(stderr, "usage: %s [--start-baud HZ] [--seconds S] [--stall-ms MS] [--no-nmea]\n"
+                            "          [--pps] [--board-ppm PPM]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (start_baud == 0 || seconds <= 0) return 2;
+
+    sim::clock::start();
+
+    sim::Scenario scenario;
+    sim::GpsReceiver model(scenario);
+    sim::uart::attach(uart0, &model);
+    sim::uart::port(uart0).setDeviceBaud(start_baud);
+    model.setBoardClockPpm(board_ppm);
+    model.attachTimepulse(config::gps::PPS_PIN);
+
+    uint64_t init_start = sim::clock::now_us();
+    static drivers::GpsDriver gps;
+    bool configured = gps.init(uart0, config::gps::RX_PIN, config::gps::TX_PIN, true);
+    uint64_t init_us = sim::clock::now_us() - init_start;
+
+    uint baud = sim::uart::port(uart0).hostBaud();
+    uint32_t rate_hz = 1'000'000 / model.measurementPeriodUs();
+    printf("GPS configured in %.0f ms: receiver %u -> %u baud, %u Hz, NAV-PVT every %u epoch(s)\n",
+           init_us / 1000.0, start_baud, sim::uart::port(uart0).deviceBaud(), rate_hz, model.rate(0x01, 0x07));
+    if (!configured || baud != config::gps::BAUD_RATE || sim::uart::port(uart0).deviceBaud() != baud ||
+        rate_hz != config::gps::UPDATE_RATE_HZ || model.rate(0x01, 0x07) != 1) {
+        printf("FAILED: configuration\n");
+        sim::shutdown();
+        return 1;
+    }
+
+    // Quiet line for a clean count, then the load
+    setOutput(model, 0, false);
+    sleepUs(300'000);
+    gps.update();
+
+    auto before = gps.get_stats();
+    uint32_t sent_before = model.getStats().nav_frames;
+    auto line_before = sim::uart::port(uart0).getStats();
+
+    setOutput(model, 1, nmea);
+
+    // Consumer: the scheduler's GPS task, with a long stall every 10th run
+    uint64_t period_us = 1'000'000 / config::sensors::GPS_POLL_HZ;
+    uint64_t end = sim::clock::now_us() + static_cast<uint64_t>(seconds * 1e6);
+    uint32_t runs = 0;
+    uint64_t longest_gap_us = 0;
+    uint64_t last = sim::clock::now_us();
+    while (sim::clock::now_us() < end) {
+        sleepUs((++runs % 10 == 0) ? stall_ms * 1000ull : period_us);
+        uint64_t now = sim::clock::now_us();
+        longest_gap_us = std::max(longest_gap_us, now - last);
+        last = now;
+        gps.update();
+    }
+
+    // Stop output and let the line drain before counting
+    setOutput(model, 0, false);
+    sleepUs(2'000'000 / rate_hz + 200'000);
+    gps.update();
+
+    auto after = gps.get_stats();
+    uint32_t sent = model.getStats().nav_frames - sent_before;
+    uint32_t parsed = after.ubx_frames - before.ubx_frames;
+    auto line = sim::uart::port(uart0).getStats();
+    uint64_t line_bytes = line.rx_bytes - line_before.rx_bytes;
+
+    uint32_t overruns = after.rx.overruns - before.rx.overruns;
+    uint32_t framing = after.rx.framing_errors - before.rx.framing_errors;
+    uint32_t dropped = after.rx.dropped - before.rx.dropped;
+    uint32_t bad = after.checksum_errors - before.checksum_errors;
+
+    double char_us = 10e6 / baud;
+    printf("GPS RX at %u baud, %u Hz NAV%s, %.1f s\n", baud, rate_hz, nmea ? " + NMEA" : "", seconds);
+    printf("  line:     %" PRIu64 " bytes (%.0f B/s of %.0f B/s capacity)\n",
+           line_bytes, line_bytes / seconds, baud / 10.0);
+    printf("  consumer: %" PRIu32 " runs, longest gap %.1f ms (the RX FIFO alone lasts %.2f ms)\n",
+           runs, longest_gap_us / 1000.0, sim::UartPort::FIFO_DEPTH * char_us / 1000.0);
+    printf("  ring:     high water %" PRIu32 " of %zu bytes, %" PRIu32 " IRQs\n",
+           after.rx.high_water, drivers::UartRx::RING_SIZE, after.rx.irqs - before.rx.irqs);
+    printf("  errors:   overruns %" PRIu32 ", framing %" PRIu32 ", dropped %" PRIu32 ", bad checksum %" PRIu32 "\n",
+           overruns, framing, dropped, bad);
+    printf("  NAV:      %" PRIu32 " sent, %" PRIu32 " parsed, %" PRIu32 " NMEA sentences\n",
+           sent, parsed, after.nmea_sentences - before.nmea_sentences);
+
+    // Each handler saw its message
+    const auto& data = gps.get_data();
+    bool handled = data.valid && data.num_sv == 12 && data.sats_tracked == 12 && data.cno_mean > 0 &&
+                   data.hdop > 0 && data.vdop > 0 && data.utc_valid;
+    printf("  data:     %u SVs used, %u tracked, C/N0 %u dBHz, DOP p%.2f h%.2f v%.2f, UTC %s\n",
+           data.num_sv, data.sats_tracked, data.cno_mean, data.pdop / 100.0, data.hdop / 100.0, data.vdop / 100.0,
+           data.utc_valid ? "valid" : "invalid");
+
+    bool ok = sent > 0 && parsed == sent && handled && overruns == 0 && framing == 0 && dropped == 0 && bad == 0;
+
+    // Disciplined clock against the model's true UTC
+    if (pps) {
+        uint64_t now = sim::clock::now_us();
+        const auto& clock = gps.get_clock();
+        auto cs = clock.get_stats();
+        auto ps = gps.get_pps_stats();
+        int64_t error_us = gps.utc_us(now) - model.utcUs(now);
+        double drift_error_ppm = cs.drift_ppb / 1000.0 - board_ppm;
+        bool locked = clock.quality(now) == drivers::GpsClock::Quality::LOCKED;
+        printf("  PPS:      %" PRIu32 " pulses sent, %" PRIu32 " captured, %" PRIu32 " accepted, %" PRIu32
+               " rejected, %" PRIu32 " missed, %s\n",
+               model.getStats().timepulses, ps.edges, cs.accepted, cs.rejected, cs.missed,
+               locked ? "locked" : "NOT locked");
+        printf("  clock:    drift %.3f ppm (board %.3f), jitter rms %" PRIu32 " ns max %" PRIu32 " ns, UTC error %" PRId64 " us\n",
+               cs.drift_ppb / 1000.0, board_ppm, cs.jitter_rms_ns, cs.jitter_max_ns, error_us);
+        ok = ok && locked && std::abs(drift_error_ppm) < 5.0 && std::llabs(error_us) < 100;
+
+        // Stamps taken before the latest pulse (back-dated FIFO frames,
+        // filter delay) map through the same anchor
+        int64_t utc_now = gps.utc_us(now);
+        uint64_t pulse_us = clock.boot_us(utc_now - utc_now % 1'000'000);
+        uint64_t before = pulse_us > 10'000 ? pulse_us - 10'000 : 0;
+        int64_t utc_before = before ? gps.utc_us(before) : 0;
+        if (utc_before) {
+            int64_t before_error_us = utc_before - model.utcUs(before);
+            printf("  before:   stamp 10 ms before the latest pulse, UTC error %" PRId64 " us\n", before_error_us);
+            ok = ok && std::llabs(before_error_us) < 100;
+        } else {
+            printf("  before:   stamp 10 ms before the latest pulse has no UTC\n");
+            ok = false;
+        }
+    }
+    printf("%s\n", ok ? "OK" : "FAILED");
+
+    sim::shutdown();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,686 @@
+// I2C cost of every sensor driver, measured against the device models on
+// a virtual clock: each driver is plugged into I2CBus through an
+// I2CBackend over a bus model that charges 9 bit times per byte at the
+// configured rate, then init() and a run of update() calls at the task
+// rate are replayed. Prints per-update transfers, bytes and bus time, the
+// share of the task period spent on the bus, and what the same data
+// would cost as one register-pointer write plus one burst read.
+//
+// The ICM20948 FIFO is then drained in bursts for as many drain periods
+// with its oscillator off nominal: every sample must arrive once, on a
+// reconstructed timestamp close to its true instant, and a drain skipped
+// long enough to fill the FIFO must be reported as an overflow. The same
+// goes for the BMP581 pressure FIFO, run whether or not the firmware
+// enables it.
+//
+// Before that, the flight task's reads go through the SDK instance as
+// DMA transactions: requested, overlapped with other work, collected, and
+// the cycle must come out shorter than reading first and working after.
+// The pitot then acquires continuously at its sample rate through a
+// warm-up drift and a take-off roll: no calibration wait at init, the
+// background zero locked on time and holding through the drift, TAS on
+// the scenario and the filtered noise well under a single read's.
+//
+// Before those, each data-ready capable part drives its INT pin: reads
+// released by the edge must all be fresh and stamped at the conversion,
+// over-polling must be skipped as duplicates and under-polling counted.
+//
+//   i2c_profile [--updates N] [--baud HZ]
+//
+// Exit code is non-zero when a driver fails against its model (init,
+// updates, or readings off the scenario), so this doubles as a test.
+
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "runtime/sim.h"
+#include "scenario.h"
+#include "devices/icm20948_model.h"
+#include "devices/bmp581_model.h"
+#include "devices/bmp390_model.h"
+#include "devices/ms4525do_model.h"
+#include "devices/hx711_model.h"
+#include "devices/bno085_model.h"
+#include "devices/int_pin.h"
+
+#include "config/config.h"
+#include "drivers/sensors/i2c_bus.h"
+#include "drivers/sensors/icm20948_driver.h"
+#include "drivers/sensors/bmp581_driver.h"
+#include "drivers/sensors/bmp390_driver.h"
+#include "drivers/sensors/pitot_tube.h"
+#include "drivers/sensors/hx711_driver.h"
+#include "drivers/sensors/bno085_driver.h"
+
+namespace {
+
+// Drivers -> bus model, bypassing the SDK instances
+class ModelBackend : public drivers::I2CBackend {
+public:
+    explicit ModelBackend(sim::I2CBusModel& bus) : bus(bus) {}
+
+    int write(uint8_t addr, const uint8_t* src, size_t len, bool nostop, uint32_t) override {
+        return bus.write(addr, src, len, nostop);
+    }
+
+    int read(uint8_t addr, uint8_t* dst, size_t len, bool nostop, uint32_t) override {
+        return bus.read(addr, dst, len, nostop);
+    }
+
+private:
+    sim::I2CBusModel& bus;
+};
+
+struct Driver {
+    const char* name;
+    uint8_t addr;
+    uint32_t rate_hz;
+    bool registers;                             // Register-pointer protocol (a burst read applies)
+    std::function<bool()> init;
+    std::function<bool()> update;
+    std::function<bool(uint64_t)> check;        // Last reading vs. the scenario
+};
+
+struct Result {
+    bool init_ok = false;
+    uint64_t init_us = 0;
+    uint32_t updates_ok = 0;
+    uint32_t checks_failed = 0;
+    sim::I2CBusModel::DeviceStats stats;
+};
+
+Result run(sim::I2CBusModel& bus, const Driver& d, uint32_t updates) {
+    Result r;
+    bus.resetStats();
+    uint64_t start = sim::clock::now_us();
+    r.init_ok = d.init();
+    r.init_us = sim::clock::now_us() - start;
+    if (!r.init_ok) return r;
+
+    bus.resetStats();
+    uint64_t period = 1'000'000 / d.rate_hz;
+    uint64_t next = sim::clock::now_us() + period;
+    for (uint32_t i = 0; i < updates; i++) {
+        sim::clock::spin_until(next);
+        next += period;
+        if (d.update()) {
+            r.updates_ok++;
+            if (d.check && !d.check(sim::clock::now_us())) r.checks_failed++;
+        }
+    }
+    r.stats = bus.stats(d.addr);
+    return r;
+}
+
+bool near(double value, double truth, double tolerance) { return std::fabs(value - truth) <= tolerance; }
+
+// Data-ready interrupts: paced by the edges every conversion is read once,
+// stamped at its conversion instant; polled faster than the output rate the
+// repeats are skipped, slower the unread conversions are counted as missed.
+struct Edges {
+    bool seen = false;
+    static void notify(void* self, uint64_t) { static_cast<Edges*>(self)->seen = true; }
+};
+
+struct DataReadyCase {
+    const char* name;
+    uint pin;
+    std::function<bool(uint, drivers::DataReady::Notify, void*)> enable;
+    std::function<bool()> update;
+    std::function<uint64_t()> stamp;                // Timestamp of the last reading
+    std::function<drivers::SampleStats()> stats;
+    std::function<double()> period_ns;              // Model's conversion period
+    Edges edges = {};                               // Stays armed after the run
+};
+
+int runDataReady(DataReadyCase& c, uint32_t updates) {
+    constexpr uint64_t POLL_STEP_US = 10;
+    Edges& edges = c.edges;
+    if (!c.enable(c.pin, Edges::notify, &edges)) {
+        printf("%-9s data-ready enable failed\n", c.name);
+        return 1;
+    }
+    double period_ns = c.period_ns();
+    auto period_us = static_cast<uint64_t>(period_ns / 1000.0);
+
+    // Drop whatever was pending from before
+    sim::clock::spin_for(2 * period_us);
+    edges.seen = false;
+    c.update();
+    auto base = c.stats();
+
+    // Released by the edge
+    uint32_t fresh = 0, off_edge = 0;
+    for (uint32_t i = 0; i < updates; i++) {
+        uint64_t deadline = sim::clock::now_us() + 2 * period_us;
+        while (!edges.seen && sim::clock::now_us() < deadline) sim::clock::spin_for(POLL_STEP_US);
+        edges.seen = false;
+        if (!c.update()) continue;
+        fresh++;
+        uint64_t t = c.stamp();
+        auto k = static_cast<uint64_t>(std::llround(t * 1000.0 / period_ns));
+        if (t != sim::IntPin::edgeUs(k, period_ns)) off_edge++;
+    }
+    auto paced = c.stats();
+
+    // Polled at 4x and at 1/2 the output rate
+    uint32_t over_ok = 0;
+    for (uint32_t i = 0; i < updates; i++) {
+        sim::clock::spin_for(period_us / 4);
+        over_ok += c.update();
+    }
+    auto over = c.stats();
+    for (uint32_t i = 0; i < updates / 4; i++) {
+        sim::clock::spin_for(2 * period_us);
+        c.update();
+    }
+    auto under = c.stats();
+
+    uint32_t paced_edges = paced.edges - base.edges;
+    uint32_t over_dup = over.duplicates - paced.duplicates;
+    uint32_t under_missed = under.missed - over.missed;
+    printf("%-9s %8.0f us: paced %" PRIu32 "/%" PRIu32 " fresh (%" PRIu32 " edges, %" PRIu32 " off the edge), "
+           "4x poll %" PRIu32 " dup, 1/2x poll %" PRIu32 " missed\n",
+           c.name, period_ns / 1000.0, fresh, updates, paced_edges, off_edge, over_dup, under_missed);
+
+    int failures = 0;
+    if (fresh != updates || off_edge > 0) failures++;
+    if (paced.missed != base.missed || paced.duplicates != base.duplicates) failures++;
+    if (over_ok + over_dup != updates || over_dup < updates / 2) failures++;
+    if (under_missed + 2 < updates / 4) failures++;
+    return failures;
+}
+
+// ICM20948 FIFO burst drains: returns the number of failed checks
+int runFifo(sim::I2CBusModel& bus, sim::ICM20948Model& model, drivers::ICM20948& icm,
+            const sim::Scenario& scenario, uint32_t drains) {
+    using config::icm20948::FIFO_DRAIN_HZ;
+    using config::icm20948::FIFO_ODR_HZ;
+    constexpr double OSCILLATOR_PPM = 2000.0;     // Within the part's tolerance
+    constexpr uint64_t STALL_US = 100'000;         // More than a full FIFO at 1125 Hz
+
+    // Each anchor is good to half a period, so the period check needs the
+    // clock's full baseline (8192 frames, 7.3 s) first
+    drains = std::max<uint32_t>(drains, 8 * FIFO_DRAIN_HZ);
+
+    model.setOscillatorPpm(OSCILLATOR_PPM);
+    if (!icm.enable_fifo(FIFO_ODR_HZ)) {
+        printf("ICM20948 FIFO: enable failed\n");
+        return 1;
+    }
+
+    bus.resetStats();
+    drivers::icm20948_sample samples[drivers::ICM20948::FIFO_FRAMES];
+    double period_ns = model.periodNs();
+    uint64_t period_us = 1'000'000 / FIFO_DRAIN_HZ;
+    uint64_t start = sim::clock::now_us();
+    uint64_t next = start + period_us;
+
+    std::vector<uint64_t> times;
+    uint32_t off_scenario = 0;
+    int failures = 0;
+
+    for (uint32_t i = 0; i < drains; i++) {
+        sim::clock::spin_until(next);
+        next += period_us;
+        size_t n = icm.read_fifo(samples, drivers::ICM20948::FIFO_FRAMES);
+        for (size_t k = 0; k < n; k++) {
+            const auto& s = samples[k];
+            if (!times.empty() && s.time_us <= times.back()) failures++;
+            if (!near(s.accel_z, scenario.at(s.time_us).accel_ms2[2], 1.5)) off_scenario++;
+            times.push_back(s.time_us);
+        }
+    }
+    uint64_t received = times.size();
+
+    // Samples are consecutive while nothing overflows, so sample j is the
+    // device's sample first + j; judge the timestamps once the sample clock
+    // has had a second to settle
+    size_t settled = std::min<size_t>(static_cast<size_t>(1e9 / period_ns), times.size());
+    double offset = 0.0;
+    for (size_t j = settled; j < times.size(); j++) offset += times[j] * 1000.0 - j * period_ns;
+    double first = std::round(offset / std::max<size_t>(times.size() - settled, 1) / period_ns);
+    double max_error_us = 0.0;
+    for (size_t j = settled; j < times.size(); j++) {
+        double truth_us = (first + j) * period_ns / 1000.0;
+        max_error_us = std::max(max_error_us, std::fabs(times[j] - truth_us));
+    }
+    uint64_t elapsed = sim::clock::now_us() - start;
+    auto bus_stats = bus.stats(config::i2c::addresses::ICM20948_ADDR);
+    auto stats = icm.get_fifo_stats();
+
+    // Leave it alone long enough to fill, then drain what is left
+    uint32_t dropped_before = model.fifoDropped();
+    sim::clock::spin_until(next + STALL_US);
+    for (int i = 0; i < 3; i++) {
+        icm.read_fifo(samples, drivers::ICM20948::FIFO_FRAMES);
+        sim::clock::spin_for(period_us);
+    }
+    auto after = icm.get_fifo_stats();
+    uint32_t dropped = model.fifoDropped() - dropped_before;
+
+    double expected = elapsed * 1000.0 / period_ns;
+    double per_drain_us = static_cast<double>(bus_stats.bus_us) / std::max<uint32_t>(drains, 1);
+    printf("\nICM20948 FIFO at %" PRIu32 " Hz, drained at %" PRIu32 " Hz (oscillator %+.0f ppm):\n",
+           FIFO_ODR_HZ, FIFO_DRAIN_HZ, OSCILLATOR_PPM);
+    printf("  %" PRIu64 " samples of %.0f, high water %" PRIu32 "/%zu bytes, %.1f us of I2C per drain (%.2f%%)\n",
+           received, expected, stats.high_water, drivers::ICM20948::FIFO_SIZE, per_drain_us,
+           per_drain_us * FIFO_DRAIN_HZ / 1e4);
+    printf("  period %" PRIu32 " ns (true %.0f), timestamp error max %.1f us, %" PRIu32 " off the scenario\n",
+           stats.period_ns, period_ns, max_error_us, off_scenario);
+    printf("  %" PRIu64 " ms stall: %" PRIu32 " overflow(s), %" PRIu32 " lost (device dropped %" PRIu32 ")\n",
+           STALL_US / 1000, after.overflows - stats.overflows, after.lost - stats.lost, dropped);
+
+    if (std::fabs(received - expected) > drivers::ICM20948::FIFO_FRAMES) failures++;
+    if (stats.overflows != 0 || dropped_before != 0) failures++;
+    if (std::fabs(stats.period_ns - period_ns) > period_ns * 2e-4) failures++;
+    if (max_error_us > period_ns / 4000.0) failures++;
+    if (off_scenario > 0) failures++;
+    if (after.overflows == stats.overflows || after.lost - stats.lost + 2 < dropped ||
+        after.lost - stats.lost > dropped + 2) failures++;
+    return failures;
+}
+
+// BMP581 FIFO batches: returns the number of failed checks
+int runBaroFifo(sim::I2CBusModel& bus, sim::BMP581Model& model, drivers::BMP581& bmp581,
+                const sim::Scenario& scenario, uint32_t drains) {
+    using config::bmp581::FIFO_DRAIN_HZ;
+    using config::bmp581::FIFO_ODR_HZ;
+    constexpr uint64_t STALL_US = 200'000;         // More than a full FIFO at 240 Hz
+
+    if (!bmp581.enable_fifo(FIFO_ODR_HZ)) {
+        printf("BMP581 FIFO: enable failed\n");
+        return 1;
+    }
+
+    bus.resetStats();
+    drivers::bmp581_sample samples[drivers::BMP581::FIFO_FRAMES];
+    double period_ns = model.periodUs() * 1000.0;
+    uint64_t period_us = 1'000'000 / FIFO_DRAIN_HZ;
+    uint64_t start = sim::clock::now_us();
+    uint64_t next = start + period_us;
+
+    std::vector<uint64_t> times;
+    uint32_t off_scenario = 0;
+    int failures = 0;
+
+    for (uint32_t i = 0; i < drains; i++) {
+        sim::clock::spin_until(next);
+        next += period_us;
+        size_t n = bmp581.read_fifo(samples, drivers::BMP581::FIFO_FRAMES);
+        for (size_t k = 0; k < n; k++) {
+            const auto& s = samples[k];
+            if (!times.empty() && s.time_us <= times.back()) failures++;
+            if (!near(s.pressure, scenario.at(s.time_us).static_pa, 20.0)) off_scenario++;
+            times.push_back(s.time_us);
+        }
+    }
+    uint64_t received = times.size();
+
+    // Conversions land on multiples of the period: judge each timestamp
+    // against the nearest once the period estimate has had a second
+    size_t settled = std::min<size_t>(static_cast<size_t>(1e9 / period_ns), times.size());
+    double max_error_us = 0.0;
+    for (size_t j = settled; j < times.size(); j++) {
+        double truth_us = std::round(times[j] * 1000.0 / period_ns) * period_ns / 1000.0;
+        max_error_us = std::max(max_error_us, std::fabs(times[j] - truth_us));
+    }
+    uint64_t elapsed = sim::clock::now_us() - start;
+    auto bus_stats = bus.stats(config::i2c::addresses::BMP581_ADDR);
+    auto stats = bmp581.get_fifo_stats();
+
+    // Leave it alone long enough to fill, then drain what is left
+    uint32_t dropped_before = model.fifoDropped();
+    sim::clock::spin_until(next + STALL_US);
+    for (int i = 0; i < 3; i++) {
+        bmp581.read_fifo(samples, drivers::BMP581::FIFO_FRAMES);
+        sim::clock::spin_for(period_us);
+    }
+    auto after = bmp581.get_fifo_stats();
+    uint32_t dropped = model.fifoDropped() - dropped_before;
+
+    double expected = elapsed * 1000.0 / period_ns;
+    double per_drain_us = static_cast<double>(bus_stats.bus_us) / std::max<uint32_t>(drains, 1);
+    double per_sample_us = bus.transferUs(1) + bus.transferUs(drivers::BMP581::FIFO_FRAME);
+    printf("\nBMP581 FIFO at %" PRIu32 " Hz, drained at %" PRIu32 " Hz:\n", FIFO_ODR_HZ, FIFO_DRAIN_HZ);
+    printf("  %" PRIu64 " samples of %.0f, high water %" PRIu32 "/%zu frames, %.1f us of I2C per drain "
+           "(%.1f us read one by one)\n",
+           received, expected, stats.high_water, drivers::BMP581::FIFO_FRAMES, per_drain_us,
+           per_sample_us * FIFO_ODR_HZ / FIFO_DRAIN_HZ);
+    printf("  period %" PRIu32 " ns (true %.0f), timestamp error max %.1f us, %" PRIu32 " off the scenario\n",
+           stats.period_ns, period_ns, max_error_us, off_scenario);
+    printf("  %" PRIu64 " ms stall: %" PRIu32 " overflow(s), %" PRIu32 " lost (device dropped %" PRIu32 ")\n",
+           STALL_US / 1000, after.overflows - stats.overflows, after.lost - stats.lost, dropped);
+
+    if (std::fabs(received - expected) > drivers::BMP581::FIFO_FRAMES) failures++;
+    if (stats.overflows != 0 || dropped_before != 0) failures++;
+    // Anchors good to half a 4 ms period over a few seconds of baseline
+    if (std::fabs(stats.period_ns - period_ns) > period_ns * 1e-3) failures++;
+    if (max_error_us > period_ns / 4000.0) failures++;
+    if (off_scenario > 0) failures++;
+    if (after.overflows == stats.overflows || after.lost - stats.lost + 2 < dropped ||
+        after.lost - stats.lost > dropped + 2) failures++;
+    return failures;
+}
+
+// Asynchronous DMA transactions on the SDK instance: the flight task's two
+// parts read with update() and then some CPU work, against request(), the
+// same work while the reads run, collect(). Returns the failed checks.
+int runAsync(sim::ICM20948Model& icm_model, sim::BMP581Model& bmp581_model,
+             const sim::Scenario& scenario, uint baud, uint32_t cycles) {
+    using namespace config::i2c::addresses;
+    constexpr uint64_t WORK_US = 150;             // Formatting and logging the previous cycle
+
+    sim::I2CBusModel& sdk_bus = sim::i2c::bus(i2c0);
+    sdk_bus.attach(ICM20948_ADDR, &icm_model);
+    sdk_bus.attach(BMP581_ADDR, &bmp581_model);
+
+    drivers::I2CBus bus;
+    drivers::ICM20948 icm;
+    drivers::BMP581 bmp581;
+    if (!bus.init(i2c0, config::i2c::bus0::SDA, config::i2c::bus0::SCL, baud) ||
+        !icm.init(&bus) || !bmp581.init(&bus)) {
+        printf("\nasync: init failed\n");
+        return 1;
+    }
+
+    uint32_t off_scenario = 0;
+    uint32_t read_failures = 0;
+    auto check = [&] {
+        uint64_t now = sim::clock::now_us();
+        if (!near(icm.get_data().accel_z, scenario.at(now).accel_ms2[2], 1.5) ||
+            !near(bmp581.get_data().pressure, scenario.at(now).static_pa, 20.0)) off_scenario++;
+    };
+
+    // Same period either way; the cycle is from the first read to the data
+    uint64_t period = 1'000'000 / config::sensors::RAW_DATA_HZ;
+    auto cycle = [&](const std::function<bool()>& body) {
+        uint64_t total = 0;
+        uint64_t next = sim::clock::now_us() + period;
+        for (uint32_t i = 0; i < cycles; i++) {
+            sim::clock::spin_until(next);
+            next += period;
+            uint64_t start = sim::clock::now_us();
+            if (body()) {
+                check();
+            } else {
+                read_failures++;
+            }
+            total += sim::clock::now_us() - start;
+        }
+        return static_cast<double>(total) / cycles;
+    };
+
+    double blocking_us = cycle([&] {
+        bool ok = icm.update() && bmp581.update();
+        sim::clock::spin_for(WORK_US);
+        return ok;
+    });
+    bus.reset_stats();
+    double overlapped_us = cycle([&] {
+        bool ok = icm.request() && bmp581.request();
+        sim::clock::spin_for(WORK_US);
+        return icm.collect() && bmp581.collect() && ok;
+    });
+    auto stats = bus.get_async_stats();
+
+    printf("\nasync DMA transactions, ICM20948 + BMP581 with %" PRIu64 " us of other work:\n", WORK_US);
+    printf("  update() then work %.1f us, request() / work / collect() %.1f us (%.1f us saved)\n",
+           blocking_us, overlapped_us, blocking_us - overlapped_us);
+    printf("  %" PRIu32 " transactions, %" PRIu32 " errors, depth %" PRIu32 ", wait %" PRIu32 "/%" PRIu32
+           " us, bus %" PRIu32 "/%" PRIu32 " us (mean/max), %" PRIu32 " off the scenario\n",
+           stats.completed, stats.errors, stats.max_depth, stats.mean_wait_us(), stats.max_wait_us,
+           stats.mean_bus_us(), stats.max_bus_us, off_scenario);
+
+    int failures = 0;
+    if (read_failures > 0 || off_scenario > 0) failures++;
+    if (stats.completed != 2 * cycles || stats.errors || stats.rejected || stats.aborted) failures++;
+    if (stats.max_depth < 2) failures++;                  // Both parts queued back to back
+    // The bus time hides behind the work
+    if (overlapped_us > blocking_us - WORK_US / 2) failures++;
+    return failures;
+}
+
+// Continuous pitot acquisition: acquire() at the sample rate as DMA
+// transactions on the SDK instance (i2c1: runAsync() keeps i2c0's IRQ),
+// parked while the die warms up and drags the bridge zero with it, then
+// the take-off roll. Init must not wait for a calibration, the background
+// zero must lock on time and hold the parked output near zero through the
+// warm-up, the filtered TAS must follow the scenario at the records'
+// timestamps, and averaging must beat a single read. Returns the failed
+// checks.
+int runPitot(uint baud) {
+    using namespace config::pitot_tube;
+    using config::i2c::addresses::PITOT;
+    using config::sensors::PITOT_RATE_HZ;
+    constexpr double REST_S = 20.0;
+    constexpr double SINGLE_S = 2.0;                // Blocking reads for the raw noise
+    constexpr double ZERO_PA = 8.0, TEMPCO_PA_PER_C = 1.5, WARMUP_C = 4.0, WARMUP_TAU_S = 8.0;
+
+    uint64_t t0 = sim::clock::now_us();
+    uint64_t rest_end_us = t0 + static_cast<uint64_t>((SINGLE_S + REST_S) * 1e6);
+    sim::Scenario scenario(rest_end_us * 1e-6);
+    sim::MS4525DOModel model(scenario, -PRESSURE_RANGE_PSI, PRESSURE_RANGE_PSI, 0x5a17);
+    sim::i2c::bus(i2c1).attach(PITOT, &model);
+
+    drivers::I2CBus bus;
+    drivers::PitotTube single, pitot;
+    uint64_t start = sim::clock::now_us();
+    bool init_ok = bus.init(i2c1, config::i2c::bus1::SDA, config::i2c::bus1::SCL, baud) &&
+                   single.init(&bus, PRESSURE_RANGE_PSI) && pitot.init(&bus, PRESSURE_RANGE_PSI);
+    uint64_t init_us = sim::clock::now_us() - start;
+    if (!init_ok) {
+        printf("\npitot: init failed\n");
+        return 1;
+    }
+
+    // One conversion per read: successive differences leave the noise
+    auto noise = [](const std::vector<double>& v) {
+        double sum = 0.0;
+        for (size_t i = 1; i < v.size(); i++) sum += (v[i] - v[i - 1]) * (v[i] - v[i - 1]);
+        return v.size() > 1 ? std::sqrt(sum / (2.0 * (v.size() - 1))) : 0.0;
+    };
+    std::vector<double> raw_pa;
+    for (uint64_t next = sim::clock::now_us(); sim::clock::now_us() < t0 + SINGLE_S * 1e6; next += 10'000) {
+        sim::clock::spin_until(next);
+        if (single.update()) raw_pa.push_back(single.get_data().pressure_psi * PSI_TO_PA);
+    }
+
+    // Drift from here on
+    model.setZeroDrift(ZERO_PA, TEMPCO_PA_PER_C, WARMUP_C, WARMUP_TAU_S);
+    uint64_t acquire_start = sim::clock::now_us();
+    uint64_t end = rest_end_us + static_cast<uint64_t>((sim::Scenario::ROLL_S + 1.0) * 1e6);
+    uint64_t period = 1'000'000 / SAMPLE_HZ;
+    uint32_t outputs = 0;
+    double lock_s = -1.0, rest_max_pa = 0.0, tas_max_ms = 0.0;
+    std::vector<double> rest_pa;
+    for (uint64_t next = acquire_start; next < end; next += period) {
+        sim::clock::spin_until(next);
+        if (!pitot.acquire()) continue;
+        outputs++;
+
+        auto d = pitot.get_data();
+        sim::FlightState s = scenario.at(d.time.us);
+        pitot.set_static(static_cast<float>(s.static_pa), static_cast<float>(s.air_temp_c));
+        if (!d.zeroed) continue;
+        if (lock_s < 0.0) lock_s = (sim::clock::now_us() - acquire_start) * 1e-6;
+
+        if (s.airspeed_ms == 0.0) {
+            rest_max_pa = std::max(rest_max_pa, std::fabs(d.pressure_psi * PSI_TO_PA * 1.0));
+            if (d.time.us + 5'000'000 > rest_end_us) rest_pa.push_back(d.pressure_psi * PSI_TO_PA);
+        } else if (s.airspeed_ms > 10.0) {
+            tas_max_ms = std::max(tas_max_ms, std::fabs(d.tas_ms - s.airspeed_ms));
+        }
+    }
+    double seconds = (end - acquire_start) * 1e-6;
+    uint32_t expected = static_cast<uint32_t>(seconds * PITOT_RATE_HZ);
+    auto stats = pitot.get_sample_stats();
+    auto zero = pitot.get_zero_stats();
+    double raw_noise = noise(raw_pa), filtered_noise = noise(rest_pa);
+
+    printf("\npitot continuous at %" PRIu32 " Hz, CIC order %u / %" PRIu32 ", %.0f s parked with a %.1f C warm-up:\n",
+           SAMPLE_HZ, CIC_ORDER, DECIMATION, REST_S, WARMUP_C);
+    printf("  init %" PRIu64 " us, zero locked at %.2f s (%.2f Pa, %.2f Pa/C vs %.2f), parked within %.2f Pa\n",
+           init_us, lock_s, zero.zero_pa, zero.slope_pa_per_c, TEMPCO_PA_PER_C, rest_max_pa);
+    printf("  %" PRIu32 "/%" PRIu32 " outputs, %" PRIu32 " stale, %" PRIu32 " missed, TAS within %.3f m/s above 10 m/s\n",
+           outputs, expected, stats.duplicates, stats.missed, tas_max_ms);
+    printf("  noise %.3f Pa single read, %.3f Pa filtered (%.1fx)\n",
+           raw_noise, filtered_noise, filtered_noise > 0.0 ? raw_noise / filtered_noise : 0.0);
+
+    int failures = 0;
+    if (init_us > 10'000) failures++;                          // No blocking calibration
+    if (lock_s < 0.0 || lock_s > ZERO_LOCK_S + 0.5) failures++;
+    if (rest_max_pa > 1.5) failures++;
+    if (tas_max_ms > 0.3) failures++;
+    if (outputs + 2 < expected || outputs > expected + 1) failures++;
+    if (raw_pa.empty() || rest_pa.empty() || filtered_noise * 4.0 > raw_noise) failures++;
+    return failures;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    using namespace config::i2c::addresses;
+    using namespace config::sensors;
+
+    uint32_t updates = 200;
+    uint baud = config::i2c::bus0::DATA_RATE;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--updates" && i + 1 < argc) updates = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (a == "--baud" && i + 1 < argc) baud = static_cast<uint>(strtoul(argv[++i], nullptr, 10));
+        else {
+            fprintf(stderr, "usage: %s [--updates N] [--baud HZ]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (updates == 0 || baud == 0) return 2;
+
+    sim::clock::useVirtual();
+
+    sim::Scenario scenario(0.5);
+    sim::ICM20948Model icm_model(scenario);
+    sim::BMP581Model bmp581_model(scenario);
+    sim::BMP390Model bmp390_model(scenario);
+    sim::MS4525DOModel pitot_model(scenario);
+    sim::HX711Model hx711_model(scenario);
+    sim::BNO085Model bno085_model(scenario);
+
+    sim::I2CBusModel bus;
+    bus.setBaudrate(baud);
+    bus.attach(ICM20948_ADDR, &icm_model);
+    bus.attach(BMP581_ADDR, &bmp581_model);
+    bus.attach(BMP390_ADDR, &bmp390_model);
+    bus.attach(PITOT, &pitot_model);
+    bus.attach(HX711, &hx711_model);
+    bus.attach(BNO085_ADDR, &bno085_model);
+
+    ModelBackend backend(bus);
+    drivers::I2CBus i2c_bus;
+    i2c_bus.init(&backend);
+
+    drivers::ICM20948 icm;
+    drivers::BMP581 bmp581;
+    drivers::BMP390 bmp390;
+    drivers::PitotTube pitot;
+    drivers::HX711 hx711;
+    drivers::BNO085 bno085;
+
+    std::vector<Driver> list = {
+        {"ICM20948", ICM20948_ADDR, RAW_DATA_HZ, true,
+         [&] { return icm.init(&i2c_bus); }, [&] { return icm.update(); },
+         [&](uint64_t t) {
+             auto d = icm.get_data();
+             return near(d.accel_z, scenario.at(t).accel_ms2[2], 1.5);
+         }},
+        {"BMP581", BMP581_ADDR, RAW_DATA_HZ, true,
+         [&] { return bmp581.init(&i2c_bus); }, [&] { return bmp581.update(); },
+         [&](uint64_t t) { return near(bmp581.get_data().pressure, scenario.at(t).static_pa, 20.0); }},
+        {"BMP390", BMP390_ADDR, BARO_RATE_HZ, true,
+         [&] { return bmp390.init(&i2c_bus); }, [&] { return bmp390.update(); },
+         [&](uint64_t) {
+             auto d = bmp390.get_data();
+             return near(d.pressure, bmp390_model.lastPressurePa(), 5.0) &&
+                    near(d.temperature, bmp390_model.lastTemperatureC(), 0.05);
+         }},
+        {"MS4525DO", PITOT, PITOT_RATE_HZ, false,
+         [&] { return pitot.init(&i2c_bus, 1.0f); }, [&] { return pitot.update(); },
+         nullptr},
+        {"HX711", HX711, FORCE_RATE_HZ, true,
+         [&] { return hx711.init(&i2c_bus); }, [&] { return hx711.update(); },
+         nullptr},
+        {"BNO085", BNO085_ADDR, BNO_RATE_HZ, false,
+         [&] { return bno085.init(&i2c_bus); }, [&] { return bno085.update(); },
+         nullptr},
+    };
+
+    printf("I2C at %u Hz, %u updates per driver (virtual time)\n\n", baud, updates);
+    printf("%-9s %5s %9s %6s %6s %8s %8s %8s %7s %9s\n",
+           "driver", "rate", "init_us", "ok", "xfer", "bytes", "bus_us", "burst_us", "share", "checks");
+
+    int failures = 0;
+    double flight_us = 0.0;
+    for (const auto& d : list) {
+        Result r = run(bus, d, updates);
+        if (!r.init_ok) {
+            printf("%-9s  init failed\n", d.name);
+            failures++;
+            continue;
+        }
+
+        double n = std::max<uint32_t>(r.updates_ok, 1);
+        double per_update_us = r.stats.bus_us / n;
+        char burst[16] = "-";
+        if (d.registers) {
+            double burst_us = bus.transferUs(1) + bus.transferUs(static_cast<size_t>(r.stats.bytes_read / n));
+            snprintf(burst, sizeof(burst), "%.1f", burst_us);
+        }
+        double share = per_update_us * d.rate_hz / 1e4;     // % of the task period
+        if (d.addr == ICM20948_ADDR || d.addr == BMP581_ADDR) flight_us += per_update_us;
+
+        printf("%-9s %5" PRIu32 " %9" PRIu64 " %6" PRIu32 " %6.1f %8.1f %8.1f %8s %6.2f%% %9s\n",
+               d.name, d.rate_hz, r.init_us, r.updates_ok, r.stats.transfers / n,
+               (r.stats.bytes_read + r.stats.bytes_written) / n, per_update_us, burst, share,
+               r.checks_failed ? "FAIL" : (d.check ? "ok" : "-"));
+
+        if (r.updates_ok < updates * 9 / 10 || r.checks_failed > 0) failures++;
+    }
+
+    printf("\nflight task (ICM20948 + BMP581): %.1f us of I2C per iteration, %.2f%% of its period\n",
+           flight_us, flight_us * RAW_DATA_HZ / 1e4);
+
+    // Pace the rest at the flight rate where the part has a choice, the
+    // IMU at its register-read rate
+    bmp581.set_odr(RAW_DATA_HZ);
+    icm.set_odr(config::icm20948::POLL_HZ, config::icm20948::POLL_DLPF_CFG);
+    std::vector<DataReadyCase> interrupts = {
+        {"ICM20948", config::pins::data_ready::ICM20948,
+         [&](uint pin, auto fn, void* ctx) { return icm.enable_data_ready(pin, fn, ctx); },
+         [&] { return icm.update(); }, [&] { return icm.get_data().time.us; },
+         [&] { return icm.get_sample_stats(); }, [&] { return icm_model.periodNs(); }},
+        {"BMP581", config::pins::data_ready::BMP581,
+         [&](uint pin, auto fn, void* ctx) { return bmp581.enable_data_ready(pin, fn, ctx); },
+         [&] { return bmp581.update(); }, [&] { return bmp581.get_data().time.us; },
+         [&] { return bmp581.get_sample_stats(); }, [&] { return bmp581_model.periodUs() * 1000.0; }},
+        {"BMP390", config::pins::data_ready::BMP390,
+         [&](uint pin, auto fn, void* ctx) { return bmp390.enable_data_ready(pin, fn, ctx); },
+         [&] { return bmp390.update(); }, [&] { return bmp390.get_data().time.us; },
+         [&] { return bmp390.get_sample_stats(); }, [&] { return bmp390_model.periodUs() * 1000.0; }},
+    };
+    icm_model.attachInt(config::pins::data_ready::ICM20948);
+    bmp581_model.attachInt(config::pins::data_ready::BMP581);
+    bmp390_model.attachInt(config::pins::data_ready::BMP390);
+
+    printf("\ndata-ready interrupts:\n");
+    for (auto& c : interrupts) failures += runDataReady(c, std::min<uint32_t>(updates, 100));
+
+    failures += runAsync(icm_model, bmp581_model, scenario, baud, updates);
+    failures += runPitot(baud);
+
+    if (config::icm20948::FIFO_ENABLED) failures += runFifo(bus, icm_model, icm, scenario, updates);
+    failures += runBaroFifo(bus, bmp581_model, bmp581, scenario, updates);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct i2c_inst i2c_inst_t;
+
+extern i2c_inst_t* const i2c0;
+extern i2c_inst_t* const i2c1;
+
+uint i2c_init(i2c_inst_t* i2c, uint baudrate);
+void i2c_deinit(i2c_inst_t* i2c);
+uint i2c_set_baudrate(i2c_inst_t* i2c, uint baudrate);
+uint i2c_get_index(i2c_inst_t* i2c);
+uint i2c_get_dreq(i2c_inst_t* i2c, bool is_tx);
+
+// Return bytes transferred, PICO_ERROR_GENERIC on address NAK
+int i2c_write_blocking(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t* i2c, uint8_t addr, uint8_t* dst, size_t len, bool nostop);
+int i2c_write_timeout_us(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t len, bool nostop, uint timeout_us);
+int i2c_read_timeout_us(i2c_inst_t* i2c, uint8_t addr, uint8_t* dst, size_t len, bool nostop, uint timeout_us);
+
+// DW_apb_i2c register bits (hardware/regs/i2c.h)
+#define I2C_IC_DATA_CMD_CMD_BITS 0x00000100
+#define I2C_IC_DATA_CMD_STOP_BITS 0x00000200
+#define I2C_IC_DATA_CMD_RESTART_BITS 0x00000400
+#define I2C_IC_INTR_MASK_M_TX_ABRT_BITS 0x00000040
+#define I2C_IC_INTR_MASK_M_STOP_DET_BITS 0x00000200
+#define I2C_IC_INTR_STAT_R_TX_ABRT_BITS 0x00000040
+#define I2C_IC_INTR_STAT_R_STOP_DET_BITS 0x00000200
+#define I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS 0x00000040
+#define I2C_IC_RAW_INTR_STAT_STOP_DET_BITS 0x00000200
+
+#ifdef __cplusplus
+}
+
+// Register block of one controller, as far as the drivers touch it. The
+// controller model behind it runs the command words a DMA channel writes
+// to DATA_CMD (see sim::I2CBusModel); INTR_STAT/RAW_INTR_STAT report
+// STOP_DET and TX_ABRT for the last such transaction.
+namespace sim {
+    struct I2CReg {
+        i2c_inst_t* i2c;
+        uint32_t (*read)(i2c_inst_t* i2c, const I2CReg& reg);
+        void (*write)(i2c_inst_t* i2c, const I2CReg& reg, uint32_t value);
+        operator uint32_t() const { return read(i2c, *this); }
+        I2CReg& operator=(uint32_t value) {
+            write(i2c, *this, value);
+            return *this;
+        }
+    };
+}
+
+typedef struct i2c_hw {
+    sim::I2CReg enable;
+    sim::I2CReg tar;
+    sim::I2CReg data_cmd;
+    sim::I2CReg intr_mask;
+    sim::I2CReg intr_stat;
+    sim::I2CReg raw_intr_stat;
+    sim::I2CReg clr_tx_abrt;
+    sim::I2CReg clr_stop_det;
+} i2c_hw_t;
+
+i2c_hw_t* i2c_get_hw(i2c_inst_t* i2c);
+#endif
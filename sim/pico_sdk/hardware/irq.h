@@ -0,0 +1,24 @@
+#pragma once
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TIMER0_IRQ_0 0
+#define DMA_IRQ_0 10
+#define DMA_IRQ_1 11
+#define UART0_IRQ 33
+#define UART1_IRQ 34
+#define I2C0_IRQ 36
+#define I2C1_IRQ 37
+
+typedef void (*irq_handler_t)(void);
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+void irq_set_enabled(uint num, bool enabled);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "pico/types.h"
+
+#define RESET_USBCTRL 24
+
+static inline void reset_block_num(uint block_num) { (void)block_num; }
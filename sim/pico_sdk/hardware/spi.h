@@ -0,0 +1,18 @@
+#pragma once
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The SD card is simulated below FatFs (sim/disk_image.cpp); SPI
+// instances only exist so the configuration compiles
+typedef struct spi_inst spi_inst_t;
+
+extern spi_inst_t* const spi0;
+extern spi_inst_t* const spi1;
+
+#ifdef __cplusplus
+}
+#endif
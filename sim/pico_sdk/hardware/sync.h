@@ -0,0 +1,22 @@
+#pragma once
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Interrupt masking maps to a lock shared with the simulated IRQ sources
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+
+void __wfi(void);       // Sleep until an "interrupt" fires (also while masked)
+void __wfe(void);       // Sleep until an event or interrupt
+void __sev(void);       // Signal an event to all cores
+
+static inline void __dmb(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __compiler_memory_barrier(void) { __atomic_signal_fence(__ATOMIC_SEQ_CST); }
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "pico/types.h"
+#include "hardware/irq.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct uart_inst uart_inst_t;
+
+extern uart_inst_t* const uart0;
+extern uart_inst_t* const uart1;
+
+// PL011 register bits (hardware/regs/uart.h)
+#define UART_UARTDR_DATA_BITS 0x000000ff
+#define UART_UARTDR_FE_BITS 0x00000100
+#define UART_UARTDR_PE_BITS 0x00000200
+#define UART_UARTDR_BE_BITS 0x00000400
+#define UART_UARTDR_OE_BITS 0x00000800
+#define UART_UARTFR_BUSY_BITS 0x00000008
+#define UART_UARTFR_RXFE_BITS 0x00000010
+#define UART_UARTFR_TXFF_BITS 0x00000020
+
+#define UART_IRQ_NUM(uart) (UART0_IRQ + uart_get_index(uart))
+
+typedef enum {
+    UART_PARITY_NONE,
+    UART_PARITY_EVEN,
+    UART_PARITY_ODD,
+} uart_parity_t;
+
+uint uart_init(uart_inst_t* uart, uint baudrate);
+void uart_deinit(uart_inst_t* uart);
+uint uart_set_baudrate(uart_inst_t* uart, uint baudrate);
+void uart_set_format(uart_inst_t* uart, uint data_bits, uint stop_bits, uart_parity_t parity);
+void uart_set_fifo_enabled(uart_inst_t* uart, bool enabled);
+void uart_set_irq_enables(uart_inst_t* uart, bool rx_has_data, bool tx_needs_data);
+uint uart_get_index(uart_inst_t* uart);
+
+bool uart_is_readable(uart_inst_t* uart);
+bool uart_is_writable(uart_inst_t* uart);
+char uart_getc(uart_inst_t* uart);
+void uart_putc_raw(uart_inst_t* uart, char c);
+void uart_read_blocking(uart_inst_t* uart, uint8_t* dst, size_t len);
+void uart_write_blocking(uart_inst_t* uart, const uint8_t* src, size_t len);
+void uart_tx_wait_blocking(uart_inst_t* uart);
+
+#ifdef __cplusplus
+}
+
+// Register block of one UART, as far as the drivers touch it. Reads have
+// the hardware's side effects: reading DR pops the RX FIFO (data in bits
+// 7:0, the character's error flags above), FR reports RXFE, TXFF and BUSY
+// (a character still on the TX line).
+namespace sim {
+    struct UartReg {
+        uart_inst_t* uart;
+        uint32_t (*read)(uart_inst_t* uart);
+        operator uint32_t() const { return read(uart); }
+    };
+}
+
+typedef struct uart_hw {
+    sim::UartReg dr;
+    sim::UartReg fr;
+} uart_hw_t;
+
+uart_hw_t* uart_get_hw(uart_inst_t* uart);
+#endif
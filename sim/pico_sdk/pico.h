@@ -0,0 +1,18 @@
+#pragma once
+
+// ============================================
+// Host Pico SDK Shim
+// ============================================
+// Declares the subset of the Pico SDK the firmware uses, with the same
+// header paths, so src/ and config/ compile unchanged on the host. The
+// implementations live in sim/runtime/ and route to the simulated devices.
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Board (pico2)
+#define PICO_DEFAULT_LED_PIN 25
+
+#define __not_in_flash_func(func_name) func_name
+#define __time_critical_func(func_name) func_name
+#define __isr
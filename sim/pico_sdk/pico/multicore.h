@@ -0,0 +1,15 @@
+#pragma once
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Core 1 is a host thread
+void multicore_launch_core1(void (*entry)(void));
+void multicore_reset_core1(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 0 for the firmware's main thread, 1 inside multicore_launch_core1()
+uint get_core_num(void);
+
+static inline void tight_loop_contents(void) {}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "pico.h"
+#include "pico/types.h"
+#include "pico/platform.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+#include "hardware/uart.h"
+#include "hardware/sync.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ---- stdio (USB CDC goes to the host's stdout when "connected") ----
+bool stdio_init_all(void);
+bool stdio_usb_connected(void);
+int getchar_timeout_us(uint32_t timeout_us);
+int putchar_raw(int c);
+void stdio_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
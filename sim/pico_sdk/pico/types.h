@@ -0,0 +1,16 @@
+#pragma once
+
+#include "pico.h"
+
+typedef unsigned int uint;
+
+// Microseconds since boot (the SDK's non-debug representation)
+typedef uint64_t absolute_time_t;
+
+enum pico_error_codes {
+    PICO_OK = 0,
+    PICO_ERROR_NONE = 0,
+    PICO_ERROR_TIMEOUT = -1,
+    PICO_ERROR_GENERIC = -2,
+    PICO_ERROR_NO_DATA = -3,
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+// Configuration types of the SPI SD driver (lib/sdcard/src/sd_driver). The
+// simulated card sits below FatFs, so only what SDCard fills in is kept.
+#include "pico/types.h"
+#include "hardware/spi.h"
+
+#include "ff.h"
+#include "diskio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum { SD_IF_NONE, SD_IF_SPI, SD_IF_SDIO } sd_if_t;
+
+typedef struct spi_t {
+    spi_inst_t* hw_inst;
+    uint miso_gpio;
+    uint mosi_gpio;
+    uint sck_gpio;
+    uint baud_rate;
+} spi_t;
+
+typedef struct sd_spi_if_t {
+    spi_t* spi;
+    uint ss_gpio;
+} sd_spi_if_t;
+
+typedef struct sd_card_t {
+    sd_if_t type;
+    sd_spi_if_t* spi_if_p;
+} sd_card_t;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t tud_cdc_write_available(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,146 @@
+// DMA channels: claimed, configured and handed to the peripheral models
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+
+#include "sim.h"
+#include "hardware/dma.h"
+
+namespace {
+    struct Channel {
+        bool claimed = false;
+        bool busy = false;
+        uint32_t ctrl = 0;
+        sim::dma::Transfer transfer = {};
+    };
+
+    std::mutex dma_mutex;
+    Channel channels[NUM_DMA_CHANNELS];
+    std::map<uint, std::function<void(const sim::dma::Transfer&)>> servers;
+
+    uint dreqOf(uint32_t ctrl) { return (ctrl >> 8) & 0xFF; }
+
+    void copy(const sim::dma::Transfer& t) {
+        auto* dst = reinterpret_cast<volatile uint8_t*>(t.write);
+        auto* src = reinterpret_cast<const volatile uint8_t*>(t.read);
+        for (uint i = 0; i < t.count; i++) {
+            for (uint b = 0; b < t.size; b++) dst[b] = src[b];
+            if (t.write_incr) dst += t.size;
+            if (t.read_incr) src += t.size;
+        }
+    }
+}
+
+namespace sim::dma {
+
+void serve(uint dreq, const std::function<void(const Transfer&)>& handler) {
+    std::lock_guard<std::mutex> l(dma_mutex);
+    servers[dreq] = handler;
+}
+
+bool armed(uint dreq, Transfer& out) {
+    std::lock_guard<std::mutex> l(dma_mutex);
+    for (const Channel& c : channels) {
+        if (c.busy && dreqOf(c.ctrl) == dreq) {
+            out = c.transfer;
+            return true;
+        }
+    }
+    return false;
+}
+
+void finish(uint channel) {
+    std::lock_guard<std::mutex> l(dma_mutex);
+    if (channel < NUM_DMA_CHANNELS) channels[channel].busy = false;
+}
+
+} // namespace sim::dma
+
+// ============================================
+// SDK: dma
+// ============================================
+extern "C" {
+
+int dma_claim_unused_channel(bool required) {
+    std::lock_guard<std::mutex> l(dma_mutex);
+    for (uint i = 0; i < NUM_DMA_CHANNELS; i++) {
+        if (!channels[i].claimed) {
+            channels[i].claimed = true;
+            return static_cast<int>(i);
+        }
+    }
+    if (required) {
+        fprintf(stderr, "[SIMDMA][XX] No free DMA channel\n");
+        std::abort();
+    }
+    return -1;
+}
+
+void dma_channel_unclaim(uint channel) {
+    std::lock_guard<std::mutex> l(dma_mutex);
+    if (channel < NUM_DMA_CHANNELS) channels[channel] = {};
+}
+
+// SDK defaults: 32-bit, read increment, no write increment, unpaced
+dma_channel_config dma_channel_get_default_config(uint) {
+    return {DMA_SIZE_32 | (1u << 2) | (static_cast<uint32_t>(DREQ_FORCE) << 8)};
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config* c, enum dma_channel_transfer_size size) {
+    c->ctrl = (c->ctrl & ~0x3u) | size;
+}
+
+void channel_config_set_read_increment(dma_channel_config* c, bool incr) {
+    c->ctrl = (c->ctrl & ~(1u << 2)) | (incr ? 1u << 2 : 0);
+}
+
+void channel_config_set_write_increment(dma_channel_config* c, bool incr) {
+    c->ctrl = (c->ctrl & ~(1u << 3)) | (incr ? 1u << 3 : 0);
+}
+
+void channel_config_set_dreq(dma_channel_config* c, uint dreq) {
+    c->ctrl = (c->ctrl & ~0xFF00u) | ((dreq & 0xFF) << 8);
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config* config, volatile void* write_addr,
+                           const volatile void* read_addr, uint transfer_count, bool trigger) {
+    if (channel >= NUM_DMA_CHANNELS) return;
+
+    sim::dma::Transfer t = {
+        .channel = channel,
+        .size = 1u << (config->ctrl & 0x3),
+        .write = write_addr,
+        .read = read_addr,
+        .count = transfer_count,
+        .read_incr = (config->ctrl & (1u << 2)) != 0,
+        .write_incr = (config->ctrl & (1u << 3)) != 0,
+    };
+    uint dreq = dreqOf(config->ctrl);
+    std::function<void(const sim::dma::Transfer&)> server;
+    {
+        std::lock_guard<std::mutex> l(dma_mutex);
+        Channel& c = channels[channel];
+        c.ctrl = config->ctrl;
+        c.transfer = t;
+        c.busy = trigger && dreq != DREQ_FORCE;
+        auto it = servers.find(dreq);
+        if (c.busy && it != servers.end()) server = it->second;
+    }
+
+    if (!trigger) return;
+    if (dreq == DREQ_FORCE) {
+        copy(t);
+    } else if (server) {
+        server(t);
+    }
+}
+
+bool dma_channel_is_busy(uint channel) {
+    std::lock_guard<std::mutex> l(dma_mutex);
+    return channel < NUM_DMA_CHANNELS && channels[channel].busy;
+}
+
+void dma_channel_abort(uint channel) { sim::dma::finish(channel); }
+
+} // extern "C"
@@ -0,0 +1,122 @@
+// GPIO pins: pulls, outputs, external drivers and edge IRQs
+#include <atomic>
+
+#include "sim.h"
+#include "hardware/gpio.h"
+
+namespace {
+    enum Pull : int8_t { PULL_NONE = 0, PULL_UP = 1, PULL_DOWN = 2 };
+
+    struct Pin {
+        std::atomic<bool> is_output{false};
+        std::atomic<bool> out_level{false};
+        std::atomic<int8_t> pull{PULL_NONE};
+        std::atomic<int8_t> driven{-1};     // -1: not driven externally
+        std::atomic<uint32_t> irq_mask{0};
+    };
+
+    Pin pins[NUM_BANK0_GPIOS];
+    std::atomic<gpio_irq_callback_t> irq_callback{nullptr};
+
+    bool level(uint gpio) {
+        const Pin& p = pins[gpio];
+        int8_t driven = p.driven.load();
+        if (driven >= 0) return driven;
+        if (p.is_output.load()) return p.out_level.load();
+        return p.pull.load() == PULL_UP;
+    }
+
+    bool valid(uint gpio) { return gpio < NUM_BANK0_GPIOS; }
+
+    // Runs the shared GPIO callback as an IRQ if the edge is enabled
+    void edge(uint gpio, bool before, bool after) {
+        if (before == after) return;
+
+        uint32_t event = after ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+        gpio_irq_callback_t callback = irq_callback.load();
+        if (callback && (pins[gpio].irq_mask.load() & event)) {
+            sim::irq::raise([=] { callback(gpio, event); });
+        }
+    }
+}
+
+namespace sim::gpio {
+
+void drive(uint pin, bool value) {
+    if (!valid(pin)) return;
+    bool before = level(pin);
+    pins[pin].driven.store(value);
+    edge(pin, before, level(pin));
+}
+
+void release(uint pin) {
+    if (!valid(pin)) return;
+    bool before = level(pin);
+    pins[pin].driven.store(-1);
+    edge(pin, before, level(pin));
+}
+
+bool output(uint pin) {
+    return valid(pin) && pins[pin].is_output.load() && pins[pin].out_level.load();
+}
+
+} // namespace sim::gpio
+
+// ============================================
+// SDK: gpio
+// ============================================
+extern "C" {
+
+void gpio_init(uint gpio) {
+    if (!valid(gpio)) return;
+    pins[gpio].is_output.store(false);
+    pins[gpio].out_level.store(false);
+}
+
+void gpio_deinit(uint gpio) { gpio_init(gpio); }
+
+void gpio_set_function(uint, enum gpio_function) {}
+
+void gpio_set_dir(uint gpio, bool out) {
+    if (valid(gpio)) pins[gpio].is_output.store(out);
+}
+
+void gpio_pull_up(uint gpio) {
+    if (valid(gpio)) pins[gpio].pull.store(PULL_UP);
+}
+
+void gpio_pull_down(uint gpio) {
+    if (valid(gpio)) pins[gpio].pull.store(PULL_DOWN);
+}
+
+void gpio_disable_pulls(uint gpio) {
+    if (valid(gpio)) pins[gpio].pull.store(PULL_NONE);
+}
+
+void gpio_set_drive_strength(uint, enum gpio_drive_strength) {}
+
+bool gpio_get(uint gpio) { return valid(gpio) && level(gpio); }
+
+void gpio_put(uint gpio, bool value) {
+    if (valid(gpio)) pins[gpio].out_level.store(value);
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled) {
+    if (!valid(gpio)) return;
+    if (enabled) {
+        pins[gpio].irq_mask.fetch_or(event_mask);
+    } else {
+        pins[gpio].irq_mask.fetch_and(~event_mask);
+    }
+}
+
+void gpio_set_irq_callback(gpio_irq_callback_t callback) { irq_callback.store(callback); }
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback) {
+    gpio_set_irq_enabled(gpio, event_mask, enabled);
+    if (enabled) gpio_set_irq_callback(callback);
+}
+
+void gpio_acknowledge_irq(uint, uint32_t) {}
+
+} // extern "C"
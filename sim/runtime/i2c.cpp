@@ -0,0 +1,239 @@
+// I2C controllers: SDK instances backed by bus models with attached devices
+#include <atomic>
+#include <vector>
+
+#include "sim.h"
+#include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "pico/time.h"
+
+struct i2c_inst {
+    uint index;
+    sim::I2CBusModel bus;
+    i2c_hw_t hw;
+
+    // Controller registers
+    std::atomic<uint32_t> enable{0};
+    std::atomic<uint32_t> tar{0};
+    std::atomic<uint32_t> intr_mask{0};
+    std::atomic<uint32_t> raw_intr_stat{0};
+
+    // DMA transaction on the bus until busy_until_us
+    std::atomic<uint64_t> busy_until_us{0};
+    alarm_id_t done_alarm = 0;
+    uint tx_channel = 0;
+    int rx_channel = -1;
+    bool nak = false;
+};
+
+namespace {
+    uint32_t readReg(i2c_inst_t* i2c, const sim::I2CReg& reg);
+    void writeReg(i2c_inst_t* i2c, const sim::I2CReg& reg, uint32_t value);
+
+    constexpr i2c_hw_t registers(i2c_inst_t* i2c) {
+        sim::I2CReg r = {i2c, readReg, writeReg};
+        return {r, r, r, r, r, r, r, r};
+    }
+
+    i2c_inst buses[2] = {{0, {}, registers(&buses[0])}, {1, {}, registers(&buses[1])}};
+
+    uint dreq(i2c_inst_t* i2c, bool is_tx) { return DREQ_I2C0_TX + 2 * i2c->index + (is_tx ? 0 : 1); }
+
+    // Reads have the controller's side effects: the CLR registers clear
+    uint32_t readReg(i2c_inst_t* i2c, const sim::I2CReg& reg) {
+        const i2c_hw_t& hw = i2c->hw;
+        if (&reg == &hw.enable) return i2c->enable;
+        if (&reg == &hw.tar) return i2c->tar;
+        if (&reg == &hw.intr_mask) return i2c->intr_mask;
+        if (&reg == &hw.intr_stat) return i2c->raw_intr_stat & i2c->intr_mask;
+        if (&reg == &hw.raw_intr_stat) return i2c->raw_intr_stat;
+        if (&reg == &hw.clr_tx_abrt) i2c->raw_intr_stat &= ~I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;
+        if (&reg == &hw.clr_stop_det) i2c->raw_intr_stat &= ~I2C_IC_RAW_INTR_STAT_STOP_DET_BITS;
+        return 0;
+    }
+
+    void writeReg(i2c_inst_t* i2c, const sim::I2CReg& reg, uint32_t value) {
+        const i2c_hw_t& hw = i2c->hw;
+        if (&reg == &hw.enable) i2c->enable = value & 1;
+        if (&reg == &hw.tar) i2c->tar = value & 0x3FF;
+        if (&reg == &hw.intr_mask) i2c->intr_mask = value;
+    }
+
+    // Blocking calls queue behind a DMA transaction on the bus
+    void waitBus(i2c_inst_t* i2c) {
+        uint64_t until = i2c->busy_until_us;
+        if (until) sim::clock::spin_until(until);
+    }
+
+    // Alarm (IRQ context) at the end of a DMA transaction
+    int64_t dmaDone(alarm_id_t, void* user_data) {
+        auto* i2c = static_cast<i2c_inst_t*>(user_data);
+        sim::dma::finish(i2c->tx_channel);
+        if (!i2c->nak && i2c->rx_channel >= 0) sim::dma::finish(static_cast<uint>(i2c->rx_channel));
+
+        i2c->raw_intr_stat = I2C_IC_RAW_INTR_STAT_STOP_DET_BITS | (i2c->nak ? I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS : 0);
+        i2c->busy_until_us = 0;
+        i2c->done_alarm = 0;
+        if (i2c->raw_intr_stat & i2c->intr_mask) sim::irq::trigger(I2C0_IRQ + i2c->index);
+        return 0;
+    }
+
+    // The TX channel was triggered: run its command words. Data words
+    // (the register pointer) go first, the reads after them; the bytes
+    // read land in the armed RX channel.
+    void runDma(i2c_inst_t* i2c, const sim::dma::Transfer& tx) {
+        if (i2c->done_alarm) cancel_alarm(i2c->done_alarm);     // Aborted one still pending
+
+        std::vector<uint8_t> out;
+        size_t reads = 0;
+        bool stop = false;
+        auto* src = static_cast<const volatile uint8_t*>(tx.read);
+        for (uint i = 0; i < tx.count; i++) {
+            uint32_t word = 0;
+            for (uint b = 0; b < std::min(tx.size, 4u); b++) word |= static_cast<uint32_t>(src[b]) << (8 * b);
+            if (tx.read_incr) src += tx.size;
+
+            if (word & I2C_IC_DATA_CMD_CMD_BITS) {
+                reads++;
+            } else {
+                out.push_back(static_cast<uint8_t>(word));
+            }
+            stop = word & I2C_IC_DATA_CMD_STOP_BITS;
+        }
+
+        uint8_t addr = static_cast<uint8_t>(i2c->tar & 0x7F);
+        uint64_t owed = 0;
+        bool nak = !out.empty() && i2c->bus.write(addr, out.data(), out.size(), reads > 0 || !stop, &owed) < 0;
+
+        sim::dma::Transfer rx = {};
+        bool rx_armed = reads > 0 && sim::dma::armed(dreq(i2c, false), rx);
+        if (!nak && reads > 0) {
+            std::vector<uint8_t> in(reads);
+            nak = i2c->bus.read(addr, in.data(), reads, !stop, &owed) < 0;
+            auto* dst = static_cast<volatile uint8_t*>(rx.write);
+            for (size_t i = 0; rx_armed && !nak && i < std::min<size_t>(reads, rx.count); i++) {
+                *dst = in[i];
+                if (rx.write_incr) dst += rx.size;
+            }
+        }
+
+        uint64_t now = sim::clock::now_us();
+        i2c->raw_intr_stat = 0;
+        i2c->tx_channel = tx.channel;
+        i2c->rx_channel = rx_armed ? static_cast<int>(rx.channel) : -1;
+        i2c->nak = nak;
+        i2c->busy_until_us = now + owed;
+        i2c->done_alarm = add_alarm_at(now + owed, dmaDone, i2c, true);
+    }
+}
+
+i2c_inst_t* const i2c0 = &buses[0];
+i2c_inst_t* const i2c1 = &buses[1];
+
+namespace sim {
+
+// ============================================
+// I2CBusModel
+// ============================================
+void I2CBusModel::attach(uint8_t addr, I2CDevice* device) {
+    if (addr < 128) devices[addr] = device;
+}
+
+uint64_t I2CBusModel::transferUs(size_t len) const {
+    if (baud_hz == 0) return 0;
+    uint64_t bits = 9 * (1 + static_cast<uint64_t>(len)) + 2;
+    return overhead_us + (bits * 1'000'000 + baud_hz - 1) / baud_hz;
+}
+
+I2CBusModel::DeviceStats I2CBusModel::total() const {
+    DeviceStats sum;
+    for (const auto& d : ledger) {
+        sum.transfers += d.transfers;
+        sum.bytes_written += d.bytes_written;
+        sum.bytes_read += d.bytes_read;
+        sum.naks += d.naks;
+        sum.bus_us += d.bus_us;
+    }
+    return sum;
+}
+
+// Charges the bus time (a NAK costs the address byte only) and returns
+// the addressed device, if any
+I2CDevice* I2CBusModel::charge(uint8_t addr, size_t len, bool read, uint64_t* owed_us) {
+    if (baud_hz == 0 || addr >= 128) return nullptr;
+
+    I2CDevice* device = devices[addr];
+    DeviceStats& d = ledger[addr];
+    uint64_t us = transferUs(device ? len : 0);
+    d.transfers++;
+    d.bus_us += us;
+    if (device) {
+        (read ? d.bytes_read : d.bytes_written) += len;
+    } else {
+        d.naks++;
+    }
+    if (owed_us) {
+        *owed_us += us;
+    } else {
+        clock::spin_for(us);
+    }
+    return device;
+}
+
+int I2CBusModel::write(uint8_t addr, const uint8_t* src, size_t len, bool nostop, uint64_t* owed_us) {
+    I2CDevice* device = charge(addr, len, false, owed_us);
+    return device ? device->write(src, len, nostop) : PICO_ERROR_GENERIC;
+}
+
+int I2CBusModel::read(uint8_t addr, uint8_t* dst, size_t len, bool nostop, uint64_t* owed_us) {
+    I2CDevice* device = charge(addr, len, true, owed_us);
+    return device ? device->read(dst, len, nostop) : PICO_ERROR_GENERIC;
+}
+
+namespace i2c {
+    I2CBusModel& bus(i2c_inst_t* i2c) { return i2c->bus; }
+}
+
+} // namespace sim
+
+// ============================================
+// SDK: i2c
+// ============================================
+extern "C" {
+
+uint i2c_init(i2c_inst_t* i2c, uint baudrate) {
+    sim::dma::serve(dreq(i2c, true), [i2c](const sim::dma::Transfer& tx) { runDma(i2c, tx); });
+    return i2c_set_baudrate(i2c, baudrate);
+}
+void i2c_deinit(i2c_inst_t* i2c) { i2c->bus.setBaudrate(0); }
+
+uint i2c_set_baudrate(i2c_inst_t* i2c, uint baudrate) {
+    i2c->bus.setBaudrate(baudrate);
+    return baudrate;
+}
+
+uint i2c_get_index(i2c_inst_t* i2c) { return i2c->index; }
+uint i2c_get_dreq(i2c_inst_t* i2c, bool is_tx) { return dreq(i2c, is_tx); }
+
+int i2c_write_blocking(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t len, bool nostop) {
+    waitBus(i2c);
+    return i2c->bus.write(addr, src, len, nostop);
+}
+
+int i2c_read_blocking(i2c_inst_t* i2c, uint8_t addr, uint8_t* dst, size_t len, bool nostop) {
+    waitBus(i2c);
+    return i2c->bus.read(addr, dst, len, nostop);
+}
+
+int i2c_write_timeout_us(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t len, bool nostop, uint) {
+    return i2c_write_blocking(i2c, addr, src, len, nostop);
+}
+
+int i2c_read_timeout_us(i2c_inst_t* i2c, uint8_t addr, uint8_t* dst, size_t len, bool nostop, uint) {
+    return i2c_read_blocking(i2c, addr, dst, len, nostop);
+}
+
+} // extern "C"
+
+i2c_hw_t* i2c_get_hw(i2c_inst_t* i2c) { return &i2c->hw; }
@@ -0,0 +1,239 @@
+#pragma once
+
+// Host runtime behind the Pico SDK shim (sim/pico_sdk). Devices and the
+// harness use this; firmware code only ever sees the SDK calls.
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+#include "pico/types.h"
+#include "hardware/i2c.h"
+#include "hardware/uart.h"
+
+namespace sim {
+
+// Thrown by reset_usb_boot(): the firmware asked to leave, end the run
+struct Reboot {};
+
+// ============================================
+// Clock
+// ============================================
+// Real monotonic time since start(); time_us_64() on every core. In
+// virtual mode (single-threaded runs only: no core 1) time stands still
+// until something waits, sleeps or charges bus time, and then jumps, so a
+// run measures modelled cost rather than host speed. Alarms due on the
+// way fire in order on the waiting thread, each at its exact target.
+namespace clock {
+    void start();
+    void useVirtual();
+    bool isVirtual();
+    uint64_t now_us();
+    void spin_until(uint64_t target_us);    // Busy-waits (sub-ms accurate)
+    void spin_for(uint64_t us);
+}
+
+// ============================================
+// Interrupts
+// ============================================
+// Alarm callbacks and GPIO edges run as "IRQs": on the runtime's own
+// threads, holding the lock taken by save_and_disable_interrupts(), and
+// waking __wfi()/__wfe() sleepers afterwards.
+namespace irq {
+    void raise(const std::function<void()>& handler);
+    void trigger(uint num);                 // Runs the irq_set_exclusive_handler() handler if enabled
+}
+
+// Stops the alarm thread and joins core 1 (after the firmware returned)
+void shutdown();
+void stopAlarms();
+
+// ============================================
+// GPIO
+// ============================================
+// Input pins read their pull unless something external drives them.
+namespace gpio {
+    void drive(uint pin, bool level);       // External driver (switches, INT pins)
+    void release(uint pin);                 // Back to the pull level
+    bool output(uint pin);                  // Level the firmware puts on an output
+}
+
+// ============================================
+// I2C
+// ============================================
+// One device per address per bus. Transfers return the byte count, or
+// PICO_ERROR_GENERIC for an address NAK, like the SDK.
+class I2CDevice {
+public:
+    virtual ~I2CDevice() = default;
+    virtual int write(const uint8_t* src, size_t len, bool nostop) = 0;
+    virtual int read(uint8_t* dst, size_t len, bool nostop) = 0;
+};
+
+// A bus segment with its devices. Every transfer is charged to the clock:
+// 9 bit times per byte (address byte included) plus START and STOP/repeated
+// START at the bus rate, and a fixed controller overhead. The per-address
+// ledger says how much bus time each device costs.
+class I2CBusModel {
+public:
+    struct DeviceStats {
+        uint64_t transfers = 0;
+        uint64_t bytes_written = 0;
+        uint64_t bytes_read = 0;
+        uint64_t naks = 0;
+        uint64_t bus_us = 0;
+    };
+
+    uint32_t overhead_us = 2;               // SDK call, FIFO setup, completion polling
+
+    void attach(uint8_t addr, I2CDevice* device);
+    void setBaudrate(uint baud) { baud_hz = baud; }
+    uint baudrate() const { return baud_hz; }
+
+    // With owed_us the bus time is added there instead of being spent
+    // (DMA transactions complete that much later, from an alarm)
+    int write(uint8_t addr, const uint8_t* src, size_t len, bool nostop, uint64_t* owed_us = nullptr);
+    int read(uint8_t addr, uint8_t* dst, size_t len, bool nostop, uint64_t* owed_us = nullptr);
+
+    // Bus time of one transfer of `len` data bytes
+    uint64_t transferUs(size_t len) const;
+
+    const DeviceStats& stats(uint8_t addr) const { return ledger[addr & 0x7F]; }
+    DeviceStats total() const;
+    void resetStats() { ledger = {}; }
+
+private:
+    uint baud_hz = 0;                       // 0: controller not initialised
+    std::array<I2CDevice*, 128> devices{};
+    std::array<DeviceStats, 128> ledger{};
+
+    I2CDevice* charge(uint8_t addr, size_t len, bool read, uint64_t* owed_us);
+};
+
+// The SDK instances also run DMA transactions: the TX channel's command
+// words (register pointer or data, then read commands) go out at once on
+// the model, the reads land in the armed RX channel, and STOP_DET (or
+// TX_ABRT on a NAK) follows one bus time later with the I2C IRQ. Blocking
+// calls made meanwhile wait for the bus.
+namespace i2c {
+    I2CBusModel& bus(i2c_inst_t* i2c);      // The model behind an SDK instance
+}
+
+// ============================================
+// DMA
+// ============================================
+// A channel paced by a peripheral's DREQ is handed to that peripheral's
+// model when triggered; the model moves the data and ends the channel with
+// finish() when the transfer would have. Unpaced (DREQ_FORCE) channels
+// copy at once.
+namespace dma {
+    struct Transfer {
+        uint channel;
+        uint size;                          // Bytes per element
+        volatile void* write;
+        const volatile void* read;
+        uint count;
+        bool read_incr;
+        bool write_incr;
+    };
+
+    void serve(uint dreq, const std::function<void(const Transfer&)>& handler);
+    bool armed(uint dreq, Transfer& out);   // Triggered and not finished
+    void finish(uint channel);
+}
+
+// ============================================
+// UART
+// ============================================
+// Bytes sent by a device become readable one character time (10 bits at
+// the device's baud rate) apart and land in the 32-byte RX FIFO; if the
+// firmware does not drain it in time the excess is dropped and counted as
+// an overrun (flagged OE on the next character). A character that arrives
+// while the UART is set to another baud rate than it was sent at is
+// garbage with a framing error.
+//
+// From uart_init() on, a runtime alarm services the device every
+// millisecond and raises the UART IRQ like the PL011 with
+// uart_set_irq_enables(): RX level (4 characters, the SDK's 1/8 setting)
+// or RX timeout (32 bit times without a new character).
+class UartDevice;
+
+class UartPort {
+public:
+    static constexpr size_t FIFO_DEPTH = 32;
+    static constexpr size_t RX_IRQ_LEVEL = 4;
+
+    struct Stats {
+        uint64_t rx_bytes = 0;
+        uint64_t tx_bytes = 0;
+        uint64_t overruns = 0;
+        uint64_t framing_errors = 0;
+    };
+
+    // Device side: queue bytes on the line, starting at `at_us` (0 or past:
+    // now) or after anything still in flight
+    void transmit(const uint8_t* data, size_t len, uint64_t at_us = 0);
+    void setDeviceBaud(uint baud) {
+        std::lock_guard<std::mutex> l(lock);
+        device_baud = baud;
+    }
+    uint deviceBaud() const {
+        std::lock_guard<std::mutex> l(lock);
+        return device_baud;
+    }
+    uint hostBaud() const {
+        std::lock_guard<std::mutex> l(lock);
+        return host_baud;
+    }
+
+    Stats getStats() const;
+
+private:
+    friend struct UartAccess;
+
+    mutable std::mutex lock;
+    std::recursive_mutex device_lock;       // Device callbacks (firmware thread vs. the IRQ pump)
+    UartDevice* device = nullptr;
+    uint host_baud = 0;
+    uint device_baud = 9600;
+    bool fifo_enabled = true;
+    bool rx_irq = false;
+    int32_t pump_alarm = 0;
+
+    struct Timed { uint64_t at_us; uint baud; uint8_t byte; };
+    std::deque<Timed> line;                 // In flight towards the FIFO
+    std::deque<uint16_t> fifo;              // UARTDR words: data | error flags
+    uint64_t rx_line_free_us = 0;
+    uint64_t tx_line_free_us = 0;
+    uint64_t last_rx_us = 0;                // Arrival of the newest FIFO character
+    bool overrun_pending = false;
+    uint64_t irq_horizon_us = 0;            // While a late IRQ is replayed: its time
+    Stats stats;
+
+    void settle(uint64_t now);              // Move arrived bytes into the FIFO
+    uint64_t nextIrqUs() const;             // When the RX IRQ asserts (UINT64_MAX: not before new data)
+};
+
+class UartDevice {
+public:
+    virtual ~UartDevice() = default;
+    virtual void received(UartPort& port, uint8_t byte) = 0;    // Firmware -> device
+    virtual void service(UartPort& port, uint64_t now_us) = 0;  // Emit anything due
+};
+
+namespace uart {
+    void attach(uart_inst_t* uart, UartDevice* device);
+    UartPort& port(uart_inst_t* uart);
+    void withDevice(uart_inst_t* uart, const std::function<void()>& fn);   // Serialised with the IRQ pump
+}
+
+// ============================================
+// Stdio
+// ============================================
+namespace stdio {
+    void setUsbConnected(bool connected);   // Telemetry tap output goes to stdout
+}
+
+} // namespace sim
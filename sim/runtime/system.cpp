@@ -0,0 +1,121 @@
+// Cores, stdio/USB, bootrom and RNG
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <thread>
+
+#include "sim.h"
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "pico/bootrom.h"
+#include "pico/rand.h"
+#include "hardware/irq.h"
+#include "hardware/spi.h"
+#include "tusb.h"
+
+namespace {
+    thread_local uint core_num = 0;
+    std::thread core1;
+
+    std::atomic<bool> usb_connected{false};
+
+    constexpr uint IRQ_COUNT = 64;
+    std::atomic<irq_handler_t> irq_handlers[IRQ_COUNT];
+    std::atomic<bool> irq_enabled[IRQ_COUNT];
+
+    std::mutex rand_mutex;
+    std::mt19937_64 rand_engine{std::random_device{}()};
+}
+
+namespace sim {
+
+void shutdown() {
+    stopAlarms();
+    if (core1.joinable()) core1.join();
+}
+
+namespace irq {
+    void trigger(uint num) {
+        if (num >= IRQ_COUNT || !irq_enabled[num].load()) return;
+        irq_handler_t handler = irq_handlers[num].load();
+        if (handler) raise([handler] { handler(); });
+    }
+}
+
+namespace stdio {
+    void setUsbConnected(bool connected) { usb_connected.store(connected); }
+}
+
+} // namespace sim
+
+// Configuration only: the SD card is simulated below FatFs
+struct spi_inst { uint index; };
+static spi_inst spis[2] = {{0}, {1}};
+spi_inst_t* const spi0 = &spis[0];
+spi_inst_t* const spi1 = &spis[1];
+
+extern "C" {
+
+// ============================================
+// SDK: platform / multicore
+// ============================================
+uint get_core_num(void) { return core_num; }
+
+void multicore_launch_core1(void (*entry)(void)) {
+    if (core1.joinable()) core1.join();
+    core1 = std::thread([entry] {
+        core_num = 1;
+        entry();
+    });
+}
+
+void multicore_reset_core1(void) {}
+
+// ============================================
+// SDK: irq
+// ============================================
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    if (num < IRQ_COUNT) irq_handlers[num].store(handler);
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+    if (num < IRQ_COUNT) irq_enabled[num].store(enabled);
+}
+
+// ============================================
+// SDK: bootrom
+// ============================================
+void reset_usb_boot(uint32_t, uint32_t) {
+    fflush(stdout);
+    throw sim::Reboot{};
+}
+
+// ============================================
+// SDK: rand (journal file ids must differ between runs on one image)
+// ============================================
+uint64_t get_rand_64(void) {
+    std::lock_guard<std::mutex> l(rand_mutex);
+    return rand_engine();
+}
+
+uint32_t get_rand_32(void) { return static_cast<uint32_t>(get_rand_64()); }
+
+// ============================================
+// SDK: stdio
+// ============================================
+bool stdio_init_all(void) {
+    setvbuf(stdout, nullptr, _IOLBF, 0);
+    return true;
+}
+
+bool stdio_usb_connected(void) { return usb_connected.load(); }
+
+int getchar_timeout_us(uint32_t) { return PICO_ERROR_TIMEOUT; }
+
+int putchar_raw(int c) { return putchar(c); }
+
+void stdio_flush(void) { fflush(stdout); }
+
+uint32_t tud_cdc_write_available(void) { return usb_connected.load() ? 64 : 0; }
+
+} // extern "C"
@@ -0,0 +1,335 @@
+// Clock, interrupt masking, events, sleeping and the alarm pool
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <thread>
+
+#include "sim.h"
+#include "pico/stdlib.h"
+#include "pico/time.h"
+#include "hardware/sync.h"
+
+namespace {
+    using steady = std::chrono::steady_clock;
+
+    steady::time_point epoch = steady::now();
+
+    std::atomic<bool> virtual_mode{false};
+    std::atomic<uint64_t> virtual_us{0};
+
+    steady::time_point toTimePoint(uint64_t us) {
+        return epoch + std::chrono::microseconds(us);
+    }
+
+    // ---- Interrupt lock (save_and_disable_interrupts) ----
+    std::recursive_mutex irq_mutex;
+    std::condition_variable_any irq_cv;
+    thread_local int mask_depth = 0;
+
+    // ---- Event registers (one per core) ----
+    std::mutex event_mutex;
+    std::condition_variable event_cv;
+    bool event_flag[2] = {false, false};
+
+    void signalEvent() {
+        {
+            std::lock_guard<std::mutex> l(event_mutex);
+            event_flag[0] = event_flag[1] = true;
+        }
+        event_cv.notify_all();
+    }
+
+    // ---- Alarm pool ----
+    struct Alarm {
+        uint64_t target_us;
+        alarm_callback_t callback;
+        void* user_data;
+    };
+
+    std::mutex pool_mutex;
+    std::condition_variable pool_cv;
+    std::map<alarm_id_t, Alarm> alarms;
+    alarm_id_t next_alarm_id = 1;
+    alarm_id_t firing_id = 0;
+    std::thread::id firing_thread;
+    bool firing_cancelled = false;
+    bool pool_stopping = false;
+    std::thread pool_thread;
+
+    std::map<alarm_id_t, Alarm>::iterator earliestAlarm() {
+        auto next = alarms.end();
+        for (auto it = alarms.begin(); it != alarms.end(); ++it) {
+            if (next == alarms.end() || it->second.target_us < next->second.target_us) next = it;
+        }
+        return next;
+    }
+
+    // Runs one due alarm as an IRQ and reschedules it if asked (pool_mutex held on entry and exit)
+    void fireAlarm(std::unique_lock<std::mutex>& l, std::map<alarm_id_t, Alarm>::iterator next) {
+        alarm_id_t id = next->first;
+        Alarm alarm = next->second;
+        alarms.erase(next);
+        firing_id = id;
+        firing_thread = std::this_thread::get_id();
+        firing_cancelled = false;
+        l.unlock();
+
+        int64_t reschedule = 0;
+        sim::irq::raise([&] { reschedule = alarm.callback(id, alarm.user_data); });
+
+        l.lock();
+        firing_id = 0;
+        if (reschedule != 0 && !firing_cancelled) {
+            // >0: relative to now, <0: relative to the previous target
+            alarm.target_us = (reschedule > 0) ? sim::clock::now_us() + reschedule
+                                               : alarm.target_us - reschedule;
+            alarms[id] = alarm;
+        }
+        pool_cv.notify_all();
+    }
+
+    // Real time only; on the virtual clock alarms fire from advanceVirtual()
+    void alarmLoop() {
+        std::unique_lock<std::mutex> l(pool_mutex);
+
+        while (!pool_stopping) {
+            auto next = earliestAlarm();
+
+            if (next == alarms.end() || virtual_mode) {
+                pool_cv.wait(l);
+                continue;
+            }
+
+            if (next->second.target_us > sim::clock::now_us()) {
+                pool_cv.wait_until(l, toTimePoint(next->second.target_us));
+                continue;
+            }
+
+            fireAlarm(l, next);
+        }
+    }
+
+    // Virtual clock: move to target_us, firing the alarms due on the way
+    // in order, each with the clock at its own target, on the calling thread
+    void advanceVirtual(uint64_t target_us) {
+        std::unique_lock<std::mutex> l(pool_mutex);
+        while (true) {
+            auto next = earliestAlarm();
+            if (next == alarms.end() || next->second.target_us > target_us) break;
+
+            uint64_t now = virtual_us;
+            uint64_t at = next->second.target_us;
+            while (now < at && !virtual_us.compare_exchange_weak(now, at)) {}
+            fireAlarm(l, next);
+        }
+        l.unlock();
+
+        uint64_t now = virtual_us;
+        while (now < target_us && !virtual_us.compare_exchange_weak(now, target_us)) {}
+    }
+
+    uint64_t nextAlarmUs() {
+        std::lock_guard<std::mutex> l(pool_mutex);
+        auto next = earliestAlarm();
+        return next == alarms.end() ? UINT64_MAX : next->second.target_us;
+    }
+
+    int64_t repeatingCallback(alarm_id_t, void* user_data) {
+        auto* rt = static_cast<repeating_timer_t*>(user_data);
+        bool keep = rt->callback(rt);
+        return keep ? rt->delay_us : 0;
+    }
+}
+
+namespace sim {
+
+// ============================================
+// Clock
+// ============================================
+namespace clock {
+    void start() { epoch = steady::now(); }
+
+    void useVirtual() {
+        virtual_us = 0;
+        virtual_mode = true;
+    }
+
+    bool isVirtual() { return virtual_mode; }
+
+    uint64_t now_us() {
+        if (virtual_mode) return virtual_us;
+        return std::chrono::duration_cast<std::chrono::microseconds>(steady::now() - epoch).count();
+    }
+
+    void spin_until(uint64_t target_us) {
+        if (virtual_mode) {
+            advanceVirtual(target_us);
+            return;
+        }
+        while (now_us() < target_us) {
+            std::this_thread::yield();
+        }
+    }
+
+    void spin_for(uint64_t us) { spin_until(now_us() + us); }
+}
+
+namespace irq {
+    void raise(const std::function<void()>& handler) {
+        {
+            std::lock_guard<std::recursive_mutex> l(irq_mutex);
+            mask_depth++;
+            handler();
+            mask_depth--;
+        }
+        irq_cv.notify_all();
+        signalEvent();
+    }
+}
+
+void stopAlarms() {
+    {
+        std::lock_guard<std::mutex> l(pool_mutex);
+        pool_stopping = true;
+        alarms.clear();
+    }
+    pool_cv.notify_all();
+    if (pool_thread.joinable()) pool_thread.join();
+}
+
+} // namespace sim
+
+// ============================================
+// SDK: time
+// ============================================
+extern "C" {
+
+uint64_t time_us_64(void) { return sim::clock::now_us(); }
+uint32_t time_us_32(void) { return static_cast<uint32_t>(sim::clock::now_us()); }
+
+void busy_wait_us(uint64_t delay_us) { sim::clock::spin_for(delay_us); }
+void busy_wait_us_32(uint32_t delay_us) { sim::clock::spin_for(delay_us); }
+void busy_wait_ms(uint32_t delay_ms) { sim::clock::spin_for(static_cast<uint64_t>(delay_ms) * 1000); }
+
+absolute_time_t get_absolute_time(void) { return sim::clock::now_us(); }
+absolute_time_t make_timeout_time_us(uint64_t us) { return sim::clock::now_us() + us; }
+absolute_time_t make_timeout_time_ms(uint32_t ms) { return sim::clock::now_us() + static_cast<uint64_t>(ms) * 1000; }
+
+void sleep_until(absolute_time_t target) {
+    if (sim::clock::isVirtual()) {
+        sim::clock::spin_until(target);
+        return;
+    }
+    std::this_thread::sleep_until(toTimePoint(target));
+}
+void sleep_us(uint64_t us) { sleep_until(sim::clock::now_us() + us); }
+void sleep_ms(uint32_t ms) { sleep_until(sim::clock::now_us() + static_cast<uint64_t>(ms) * 1000); }
+
+bool best_effort_wfe_or_timeout(absolute_time_t timeout_timestamp) {
+    if (sim::clock::isVirtual()) {
+        sim::clock::spin_until(timeout_timestamp);
+        return true;
+    }
+    uint core = get_core_num() & 1;
+    std::unique_lock<std::mutex> l(event_mutex);
+    bool woken = event_cv.wait_until(l, toTimePoint(timeout_timestamp), [&] { return event_flag[core]; });
+    if (woken) event_flag[core] = false;
+    return sim::clock::now_us() >= timeout_timestamp;
+}
+
+// ---- Alarms ----
+alarm_id_t add_alarm_at(absolute_time_t time, alarm_callback_t callback, void* user_data, bool fire_if_past) {
+    std::lock_guard<std::mutex> l(pool_mutex);
+    if (pool_stopping) return PICO_ERROR_GENERIC;
+    if (time <= sim::clock::now_us() && !fire_if_past) return 0;
+    if (!pool_thread.joinable() && !virtual_mode) pool_thread = std::thread(alarmLoop);
+
+    alarm_id_t id = next_alarm_id++;
+    alarms[id] = Alarm{time, callback, user_data};
+    pool_cv.notify_all();
+    return id;
+}
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void* user_data, bool fire_if_past) {
+    return add_alarm_at(sim::clock::now_us() + us, callback, user_data, fire_if_past);
+}
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void* user_data, bool fire_if_past) {
+    return add_alarm_in_us(static_cast<uint64_t>(ms) * 1000, callback, user_data, fire_if_past);
+}
+
+bool cancel_alarm(alarm_id_t alarm_id) {
+    std::unique_lock<std::mutex> l(pool_mutex);
+    bool found = alarms.erase(alarm_id) > 0;
+
+    if (firing_id == alarm_id) {
+        firing_cancelled = true;
+        found = true;
+        // Wait out a callback running on another thread (cancel from inside it is fine)
+        if (std::this_thread::get_id() != firing_thread) {
+            pool_cv.wait(l, [&] { return firing_id != alarm_id; });
+        }
+    }
+    return found;
+}
+
+// ---- Repeating timers ----
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void* user_data, repeating_timer_t* out) {
+    out->delay_us = delay_us;
+    out->callback = callback;
+    out->user_data = user_data;
+    out->alarm_id = add_alarm_in_us(static_cast<uint64_t>(delay_us < 0 ? -delay_us : delay_us),
+                                    repeatingCallback, out, true);
+    return out->alarm_id > 0;
+}
+
+bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t callback, void* user_data, repeating_timer_t* out) {
+    return add_repeating_timer_us(static_cast<int64_t>(delay_ms) * 1000, callback, user_data, out);
+}
+
+bool cancel_repeating_timer(repeating_timer_t* timer) {
+    bool found = timer->alarm_id > 0 && cancel_alarm(timer->alarm_id);
+    timer->alarm_id = 0;
+    return found;
+}
+
+// ============================================
+// SDK: sync
+// ============================================
+uint32_t save_and_disable_interrupts(void) {
+    irq_mutex.lock();
+    return static_cast<uint32_t>(mask_depth++);
+}
+
+void restore_interrupts(uint32_t) {
+    mask_depth--;
+    irq_mutex.unlock();
+}
+
+// Like the core: wakes on a pending "IRQ" even with interrupts masked. On
+// the virtual clock that is the next alarm (the only IRQ source there)
+void __wfi(void) {
+    if (sim::clock::isVirtual()) {
+        uint64_t now = sim::clock::now_us();
+        advanceVirtual(std::min(nextAlarmUs(), now + 1000));
+        return;
+    }
+    if (mask_depth > 0) {
+        irq_cv.wait_for(irq_mutex, std::chrono::milliseconds(1));
+    } else {
+        std::unique_lock<std::recursive_mutex> l(irq_mutex);
+        irq_cv.wait_for(l, std::chrono::milliseconds(1));
+    }
+}
+
+void __wfe(void) {
+    uint core = get_core_num() & 1;
+    std::unique_lock<std::mutex> l(event_mutex);
+    event_cv.wait_for(l, std::chrono::milliseconds(1), [&] { return event_flag[core]; });
+    event_flag[core] = false;
+}
+
+void __sev(void) { signalEvent(); }
+
+} // extern "C"
@@ -0,0 +1,304 @@
+// UARTs: timed RX line into a 32-byte FIFO, FIFO-limited TX (blocking
+// writes, or FIFO-full and busy flags to poll), RX level/timeout interrupts
+#include <thread>
+
+#include "sim.h"
+#include "pico/time.h"
+#include "hardware/uart.h"
+
+struct uart_inst {
+    uint index;
+    sim::UartPort port;
+    uart_hw_t hw;
+};
+
+namespace {
+    uint32_t readDr(uart_inst_t* uart);
+    uint32_t readFr(uart_inst_t* uart);
+
+    uart_inst uarts[2] = {{0, {}, {{&uarts[0], readDr}, {&uarts[0], readFr}}},
+                          {1, {}, {{&uarts[1], readDr}, {&uarts[1], readFr}}}};
+
+    // 8N1: 10 bit times per character
+    uint64_t charTimeUs(uint baud) { return baud ? (10'000'000ull + baud - 1) / baud : 0; }
+
+    // RX timeout: 32 bit times
+    uint64_t rxTimeoutUs(uint baud) { return baud ? (32'000'000ull + baud - 1) / baud : 0; }
+
+    constexpr uint64_t SERVICE_US = 1000;
+}
+
+uart_inst_t* const uart0 = &uarts[0];
+uart_inst_t* const uart1 = &uarts[1];
+
+namespace sim {
+
+// Private access for the SDK functions below
+struct UartAccess {
+    static UartPort& port(uart_inst_t* uart) { return uart->port; }
+    static void attach(UartPort& p, UartDevice* device) { p.device = device; }
+
+    static void withDevice(UartPort& p, const std::function<void()>& fn) {
+        std::lock_guard<std::recursive_mutex> d(p.device_lock);
+        fn();
+    }
+
+    static void service(UartPort& p) {
+        std::lock_guard<std::recursive_mutex> d(p.device_lock);
+        if (p.device) p.device->service(p, clock::now_us());
+    }
+
+    static bool readable(UartPort& p) {
+        service(p);
+        std::lock_guard<std::mutex> l(p.lock);
+        p.settle(clock::now_us());
+        return !p.fifo.empty();
+    }
+
+    // UARTDR read: data and error flags, or 0 on an empty FIFO
+    static uint32_t pop(UartPort& p) {
+        std::lock_guard<std::mutex> l(p.lock);
+        p.settle(clock::now_us());
+        if (p.fifo.empty()) return 0;
+        uint16_t word = p.fifo.front();
+        p.fifo.pop_front();
+        p.stats.rx_bytes++;
+        return word;
+    }
+
+    static void init(UartPort& p, uint baud) {
+        {
+            std::lock_guard<std::mutex> l(p.lock);
+            p.host_baud = baud;
+            p.line.clear();
+            p.fifo.clear();
+            p.overrun_pending = false;
+            if (p.pump_alarm > 0 || baud == 0) return;
+            p.pump_alarm = -1;
+        }
+        alarm_id_t id = add_alarm_in_us(SERVICE_US, pump, &p, true);
+        std::lock_guard<std::mutex> l(p.lock);
+        p.pump_alarm = id;
+    }
+
+    static void setIrq(UartPort& p, bool rx) {
+        std::lock_guard<std::mutex> l(p.lock);
+        p.rx_irq = rx;
+    }
+
+    // Runtime alarm (IRQ context): lets the device emit, then raises the
+    // UART IRQ while it is asserted and sleeps until it next could be.
+    // When the host woke this thread late, the interrupts that were due in
+    // the meantime are replayed at their own times (the FIFO only holds
+    // what had arrived by then), so host scheduling jitter does not turn
+    // into overruns; on the chip IRQ latency is microseconds.
+    static int64_t pump(alarm_id_t, void* user_data) {
+        UartPort& p = *static_cast<UartPort*>(user_data);
+        uint irq = UART0_IRQ + static_cast<uint>(&p == &uarts[1].port);
+        service(p);
+
+        uint64_t next = 0;
+        for (int i = 0; i < 256; i++) {
+            uint64_t now = clock::now_us();
+            {
+                std::lock_guard<std::mutex> l(p.lock);
+                next = p.nextIrqUs();
+                if (next > now) {
+                    p.settle(now);
+                    break;
+                }
+                p.irq_horizon_us = std::max<uint64_t>(next, 1);
+            }
+            sim::irq::trigger(irq);
+
+            std::lock_guard<std::mutex> l(p.lock);
+            p.irq_horizon_us = 0;
+        }
+
+        uint64_t now = clock::now_us();
+        uint64_t wait = next > now ? next - now : 1;
+        return static_cast<int64_t>(std::min(wait, SERVICE_US));
+    }
+
+    static void setBaud(UartPort& p, uint baud) {
+        std::lock_guard<std::mutex> l(p.lock);
+        p.host_baud = baud;
+    }
+
+    static void setFifo(UartPort& p, bool enabled) {
+        std::lock_guard<std::mutex> l(p.lock);
+        p.fifo_enabled = enabled;
+    }
+
+    // Blocks while the TX FIFO is full, then hands the byte to the device
+    static void put(UartPort& p, uint8_t byte) {
+        uint64_t start;
+        uint64_t char_us;
+        bool matched;
+        {
+            std::lock_guard<std::mutex> l(p.lock);
+            char_us = charTimeUs(p.host_baud);
+            start = std::max(clock::now_us(), p.tx_line_free_us);
+            p.tx_line_free_us = start + char_us;
+            matched = (p.host_baud == p.device_baud);
+            p.stats.tx_bytes++;
+        }
+
+        uint64_t fifo_span = UartPort::FIFO_DEPTH * char_us;
+        if (start > fifo_span) clock::spin_until(start - fifo_span);
+
+        std::lock_guard<std::recursive_mutex> d(p.device_lock);
+        if (matched && p.device) p.device->received(p, byte);
+    }
+
+    // TX FIFO not full: fewer than FIFO_DEPTH characters waiting behind the
+    // one on the line, so put() would not block
+    static bool writable(UartPort& p) {
+        std::lock_guard<std::mutex> l(p.lock);
+        return p.tx_line_free_us <= clock::now_us() + UartPort::FIFO_DEPTH * charTimeUs(p.host_baud);
+    }
+
+    static bool txBusy(UartPort& p) {
+        std::lock_guard<std::mutex> l(p.lock);
+        return p.tx_line_free_us > clock::now_us();
+    }
+
+    static void drainTx(UartPort& p) {
+        uint64_t done;
+        {
+            std::lock_guard<std::mutex> l(p.lock);
+            done = p.tx_line_free_us;
+        }
+        clock::spin_until(done);
+    }
+};
+
+void UartPort::settle(uint64_t now) {
+    if (irq_horizon_us) now = std::min(now, irq_horizon_us);
+    size_t depth = fifo_enabled ? FIFO_DEPTH : 1;
+    while (!line.empty() && line.front().at_us <= now) {
+        if (fifo.size() < depth) {
+            uint16_t word = line.front().byte;
+            if (line.front().baud != host_baud) {
+                // Sampled at the wrong rate: garbage with a framing error
+                word = ((word * 37u + 11u) & 0xFF) | UART_UARTDR_FE_BITS;
+                stats.framing_errors++;
+            }
+            if (overrun_pending) word |= UART_UARTDR_OE_BITS;
+            overrun_pending = false;
+            fifo.push_back(word);
+            last_rx_us = line.front().at_us;
+        } else {
+            stats.overruns++;
+            overrun_pending = true;
+        }
+        line.pop_front();
+    }
+}
+
+uint64_t UartPort::nextIrqUs() const {
+    if (!rx_irq) return UINT64_MAX;
+    if (fifo.size() >= RX_IRQ_LEVEL) return 0;
+
+    size_t needed = RX_IRQ_LEVEL - fifo.size();
+    if (line.size() >= needed) return line[needed - 1].at_us;
+    if (!line.empty()) return line.back().at_us + rxTimeoutUs(host_baud);
+    if (!fifo.empty()) return last_rx_us + rxTimeoutUs(host_baud);
+    return UINT64_MAX;
+}
+
+void UartPort::transmit(const uint8_t* data, size_t len, uint64_t at_us) {
+    std::lock_guard<std::mutex> l(lock);
+    uint64_t char_us = charTimeUs(device_baud);
+    // Never in the past: bytes the device "sent" before anyone serviced it
+    // would otherwise land in the FIFO at once
+    uint64_t t = std::max({at_us, clock::now_us(), rx_line_free_us});
+
+    for (size_t i = 0; i < len; i++) {
+        t += char_us;
+        line.push_back({t, device_baud, data[i]});
+    }
+    rx_line_free_us = t;
+}
+
+UartPort::Stats UartPort::getStats() const {
+    std::lock_guard<std::mutex> l(lock);
+    return stats;
+}
+
+} // namespace sim
+
+namespace {
+    uint32_t readDr(uart_inst_t* uart) { return sim::UartAccess::pop(uart->port); }
+    uint32_t readFr(uart_inst_t* uart) {
+        using sim::UartAccess;
+        return (UartAccess::readable(uart->port) ? 0 : UART_UARTFR_RXFE_BITS) |
+               (UartAccess::writable(uart->port) ? 0 : UART_UARTFR_TXFF_BITS) |
+               (UartAccess::txBusy(uart->port) ? UART_UARTFR_BUSY_BITS : 0);
+    }
+}
+
+namespace sim {
+
+namespace uart {
+    void attach(uart_inst_t* u, UartDevice* device) { UartAccess::attach(u->port, device); }
+    UartPort& port(uart_inst_t* u) { return UartAccess::port(u); }
+
+    void withDevice(uart_inst_t* u, const std::function<void()>& fn) { UartAccess::withDevice(u->port, fn); }
+}
+
+} // namespace sim
+
+// ============================================
+// SDK: uart
+// ============================================
+uart_hw_t* uart_get_hw(uart_inst_t* uart) { return &uart->hw; }
+
+extern "C" {
+
+using sim::UartAccess;
+
+uint uart_init(uart_inst_t* uart, uint baudrate) {
+    UartAccess::init(uart->port, baudrate);
+    return baudrate;
+}
+
+void uart_deinit(uart_inst_t* uart) { UartAccess::init(uart->port, 0); }
+
+uint uart_set_baudrate(uart_inst_t* uart, uint baudrate) {
+    UartAccess::setBaud(uart->port, baudrate);
+    return baudrate;
+}
+
+void uart_set_format(uart_inst_t*, uint, uint, uart_parity_t) {}
+void uart_set_fifo_enabled(uart_inst_t* uart, bool enabled) { UartAccess::setFifo(uart->port, enabled); }
+void uart_set_irq_enables(uart_inst_t* uart, bool rx_has_data, bool) { UartAccess::setIrq(uart->port, rx_has_data); }
+uint uart_get_index(uart_inst_t* uart) { return uart->index; }
+
+bool uart_is_readable(uart_inst_t* uart) { return UartAccess::readable(uart->port); }
+bool uart_is_writable(uart_inst_t* uart) { return UartAccess::writable(uart->port); }
+
+char uart_getc(uart_inst_t* uart) {
+    while (!UartAccess::readable(uart->port)) {
+        std::this_thread::yield();
+    }
+    return static_cast<char>(UartAccess::pop(uart->port) & UART_UARTDR_DATA_BITS);
+}
+
+void uart_read_blocking(uart_inst_t* uart, uint8_t* dst, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = static_cast<uint8_t>(uart_getc(uart));
+    }
+}
+
+void uart_putc_raw(uart_inst_t* uart, char c) { UartAccess::put(uart->port, static_cast<uint8_t>(c)); }
+
+void uart_write_blocking(uart_inst_t* uart, const uint8_t* src, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        UartAccess::put(uart->port, src[i]);
+    }
+}
+
+void uart_tx_wait_blocking(uart_inst_t* uart) { UartAccess::drainTx(uart->port); }
+
+} // extern "C"
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace sim {
+
+// ============================================
+// Flight Scenario
+// ============================================
+// Closed-form truth that every device model samples, so a run is
+// reproducible and the logged values can be checked against it:
+//   [0, ground_s)             parked, engine vibration only
+//   [ground_s, +ROLL_S)       take-off roll, constant acceleration east
+//   [.. , ..)                 climbing left-hand circle at CLIMB_MS up to CRUISE_AGL_M
+// Attitude is level apart from a small pitch/roll oscillation (gyro and
+// accel see it; the position track ignores it).
+struct FlightState {
+    double altitude_m;          // MSL
+    double airspeed_ms;         // True airspeed (no wind: also ground speed)
+    double heading_deg;         // Track over ground, 0 = north
+    double vel_ned_ms[3];
+    double lat_deg;
+    double lon_deg;
+    double accel_ms2[3];        // Specific force, chip frame (x fwd, y left, z up: +g at rest)
+    double gyro_rads[3];        // Chip frame, counter-clockwise positive
+    double air_temp_c;          // Outside air temperature (ISA)
+    double static_pa;           // ISA static pressure
+    double dynamic_pa;          // Pitot differential (impact) pressure, isentropic
+    bool moving;
+};
+
+class Scenario {
+public:
+    static constexpr double FIELD_MSL_M = 120.0;
+    static constexpr double ORIGIN_LAT = 47.397742;
+    static constexpr double ORIGIN_LON = 8.545594;
+    static constexpr double ROLL_S = 5.0;
+    static constexpr double ROLL_ACCEL = 4.0;           // m/s² -> 20 m/s at rotation
+    static constexpr double CLIMB_MS = 4.0;
+    static constexpr double TURN_DEG_S = 3.0;
+    static constexpr double CRUISE_AGL_M = 300.0;
+
+    explicit Scenario(double ground_s = 3.0) : ground_s(ground_s) {}
+
+    FlightState at(uint64_t t_us) const {
+        constexpr double G = 9.80665;
+        constexpr double DEG = M_PI / 180.0;
+        constexpr double EARTH_R = 6371000.0;
+
+        double t = t_us * 1e-6;
+        double roll_end = ground_s + ROLL_S;
+        double rotate_speed = ROLL_ACCEL * ROLL_S;
+
+        FlightState s = {};
+        double east = 0.0, north = 0.0, agl = 0.0, long_accel = 0.0;
+        double turn_rate = 0.0;
+
+        if (t < ground_s) {
+            s.heading_deg = 90.0;
+        } else if (t < roll_end) {
+            double dt = t - ground_s;
+            s.airspeed_ms = ROLL_ACCEL * dt;
+            s.heading_deg = 90.0;
+            east = 0.5 * ROLL_ACCEL * dt * dt;
+            long_accel = ROLL_ACCEL;
+        } else {
+            double dt = t - roll_end;
+            double omega = TURN_DEG_S * DEG;
+            double radius = rotate_speed / omega;
+            double angle = omega * dt;
+
+            s.airspeed_ms = rotate_speed;
+            s.heading_deg = 90.0 - TURN_DEG_S * dt;     // Left turn
+            east = 0.5 * ROLL_ACCEL * ROLL_S * ROLL_S + radius * std::sin(angle);
+            north = radius * (1.0 - std::cos(angle));
+            agl = std::min(CLIMB_MS * dt, CRUISE_AGL_M);
+            turn_rate = omega;                          // Left turn: +z
+            s.vel_ned_ms[2] = (agl < CRUISE_AGL_M) ? -CLIMB_MS : 0.0;
+        }
+
+        s.heading_deg = std::fmod(std::fmod(s.heading_deg, 360.0) + 360.0, 360.0);
+        s.moving = t >= ground_s;
+        s.altitude_m = FIELD_MSL_M + agl;
+        s.vel_ned_ms[0] = s.airspeed_ms * std::cos(s.heading_deg * DEG);
+        s.vel_ned_ms[1] = s.airspeed_ms * std::sin(s.heading_deg * DEG);
+        s.lat_deg = ORIGIN_LAT + (north / EARTH_R) / DEG;
+        s.lon_deg = ORIGIN_LON + (east / (EARTH_R * std::cos(ORIGIN_LAT * DEG))) / DEG;
+
+        // Body rates: turn plus a 1.3 Hz pitch/roll wobble once moving, and
+        // a small 27 Hz vibration throughout
+        double wobble = s.moving ? 0.15 : 0.0;
+        double vib = 0.02 * std::sin(2 * M_PI * 27.0 * t);
+        s.gyro_rads[0] = wobble * std::sin(2 * M_PI * 1.3 * t) + vib;
+        s.gyro_rads[1] = wobble * std::cos(2 * M_PI * 1.3 * t) - vib;
+        s.gyro_rads[2] = turn_rate + 0.5 * vib;
+
+        double centripetal = s.airspeed_ms * turn_rate;    // Towards the inside (left)
+        s.accel_ms2[0] = long_accel + 0.2 * vib * G;
+        s.accel_ms2[1] = centripetal;
+        s.accel_ms2[2] = G + 2.0 * vib * G;
+
+        // ISA troposphere
+        s.air_temp_c = 15.0 - 0.0065 * s.altitude_m;
+        s.static_pa = 101325.0 * std::pow(1.0 - 2.25577e-5 * s.altitude_m, 5.25588);
+        double mach = s.airspeed_ms / std::sqrt(1.4 * 287.05 * (s.air_temp_c + 273.15));
+        s.dynamic_pa = s.static_pa * (std::pow(1.0 + 0.2 * mach * mach, 3.5) - 1.0);
+        return s;
+    }
+
+private:
+    double ground_s;
+};
+
+// Deterministic noise source for the models (xorshift32)
+class Noise {
+public:
+    explicit Noise(uint32_t seed) : state(seed ? seed : 1) {}
+
+    // Uniform in [-amplitude, amplitude]
+    double operator()(double amplitude) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return amplitude * ((state / 4294967295.0) * 2.0 - 1.0);
+    }
+
+private:
+    uint32_t state;
+};
+
+} // namespace sim
@@ -0,0 +1,314 @@
+// Runs the recorder firmware (src/main.cpp) on the host against the SDK shim:
+// SD card on a disk image, sensors and GPS from scripted device models.
+//
+//   air_data_system_sim [--image PATH] [--image-mb N] [--fresh] [--exfat]
+//                       [--seconds S] [--no-sd-timing] [--usb] [--dump-debug]
+//
+// The script holds the logging toggle on for S seconds, switches it off and
+// double-presses the button so the firmware shuts down. Afterwards the
+// newest session is read back from the image. Exit code is 0 when every
+// session file holds records and the firmware reported no write errors.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "runtime/sim.h"
+#include "disk_image.h"
+#include "scenario.h"
+#include "devices/icm20948_model.h"
+#include "devices/bmp581_model.h"
+#include "devices/ms4525do_model.h"
+#include "devices/gps_receiver.h"
+
+#include "config/config.h"
+#include "log_records.h"
+#include "log_streams.h"
+#include "drivers/sdcard/journal.h"
+
+extern "C" {
+    #include "ff.h"
+}
+
+int ads_main();     // src/main.cpp, renamed for this target
+
+namespace {
+
+struct Options {
+    const char* image = "sim.img";
+    uint64_t image_mb = 256;
+    bool fresh = false;
+    bool exfat = false;
+    double seconds = 10.0;
+    bool sd_timing = true;
+    bool usb = false;
+    bool dump_debug = false;
+};
+
+bool parse(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        bool has_value = i + 1 < argc;
+        if (a == "--image" && has_value) opt.image = argv[++i];
+        else if (a == "--image-mb" && has_value) opt.image_mb = strtoull(argv[++i], nullptr, 10);
+        else if (a == "--seconds" && has_value) opt.seconds = strtod(argv[++i], nullptr);
+        else if (a == "--fresh") opt.fresh = true;
+        else if (a == "--exfat") opt.exfat = true;
+        else if (a == "--no-sd-timing") opt.sd_timing = false;
+        else if (a == "--usb") opt.usb = true;
+        else if (a == "--dump-debug") opt.dump_debug = true;
+        else return false;
+    }
+    return opt.seconds > 0 && opt.image_mb >= 8;
+}
+
+bool format(bool exfat) {
+    static BYTE work[FF_MAX_SS * 8];
+    MKFS_PARM parm = {static_cast<BYTE>(exfat ? FM_EXFAT : FM_FAT32), 0, 0, 0, 0};
+    FRESULT res = f_mkfs("", &parm, work, sizeof(work));
+    if (res != FR_OK) {
+        fprintf(stderr, "[SIMHST][XX] f_mkfs failed (%d)\n", res);
+        return false;
+    }
+    return true;
+}
+
+// Toggle on for the run, then off and a double press (shutdown request).
+// Presses are held well past the session manager's polling period.
+void script(double seconds, std::atomic<bool>& done) {
+    using namespace config::system;
+    using namespace std::chrono;
+
+    sim::gpio::drive(TOGGLE_PIN, false);
+    auto end = steady_clock::now() + duration<double>(seconds);
+    while (steady_clock::now() < end && !done) std::this_thread::sleep_for(milliseconds(10));
+    sim::gpio::release(TOGGLE_PIN);
+
+    std::this_thread::sleep_for(milliseconds(500));
+    for (int press = 0; press < 2 && !done; press++) {
+        sim::gpio::drive(BUTTON_PIN, false);
+        std::this_thread::sleep_for(milliseconds(60));
+        sim::gpio::release(BUTTON_PIN);
+        std::this_thread::sleep_for(milliseconds(90));
+    }
+}
+
+// ============================================
+// Read-back
+// ============================================
+struct FileReport {
+    std::string name;
+    uint64_t bytes = 0;
+    uint64_t records = 0;
+    bool valid = false;
+};
+
+bool readAll(const char* path, std::vector<uint8_t>& data) {
+    FIL fil;
+    if (f_open(&fil, path, FA_READ) != FR_OK) return false;
+    data.resize(f_size(&fil));
+    UINT br = 0;
+    FRESULT res = data.empty() ? FR_OK : f_read(&fil, data.data(), static_cast<UINT>(data.size()), &br);
+    f_close(&fil);
+    return res == FR_OK && br == data.size();
+}
+
+FileReport inspect(const char* folder, const char* name) {
+    using namespace logging::records;
+
+    FileReport report;
+    report.name = name;
+
+    char path[64];
+    snprintf(path, sizeof(path), "%s/%s", folder, name);
+    std::vector<uint8_t> data;
+    if (!readAll(path, data)) return report;
+    report.bytes = data.size();
+
+    if (data.size() >= drivers::journal::HEADER_SIZE && drivers::journal::check(data.data(), 0, 0)) {
+        std::vector<uint8_t> payload(data.size());
+        size_t payload_size = 0;
+        drivers::journal::unwrap(data.data(), data.size(), payload.data(), &payload_size);
+        payload.resize(payload_size);
+        data.swap(payload);
+    }
+
+    FileHeader header = {};
+    if (data.size() < sizeof(header)) return report;
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != MAGIC) return report;
+
+    visit(header.file_type, [&](auto schema) {
+        using Record = typename decltype(schema)::Record;
+        if (header.record_size != sizeof(Record)) return;
+        report.records = (data.size() - header.header_size) / sizeof(Record);
+        report.valid = true;
+    });
+    return report;
+}
+
+int newestSession() {
+    DIR dir;
+    FILINFO fno;
+    int newest = -1;
+    if (f_opendir(&dir, "/") != FR_OK) return -1;
+    while (f_readdir(&dir, &fno) == FR_OK && fno.fname[0]) {
+        if (!(fno.fattrib & AM_DIR)) continue;
+        char* end = nullptr;
+        long n = strtol(fno.fname, &end, 10);
+        if (*end == '\0' && n > newest) newest = static_cast<int>(n);
+    }
+    f_closedir(&dir);
+    return newest;
+}
+
+// Debug lines of this run (after the last start marker); counts error tags
+int reportDebug(bool dump) {
+    std::vector<uint8_t> data;
+    if (!readAll("debug.txt", data)) {
+        printf("[SIMHST][XX] debug.txt missing\n");
+        return 1;
+    }
+    std::string text(data.begin(), data.end());
+    size_t start = text.rfind("----- STARTED -----");
+    if (start != std::string::npos) text = text.substr(start);
+
+    int errors = 0;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t eol = text.find('\n', pos);
+        if (eol == std::string::npos) eol = text.size();
+        std::string line = text.substr(pos, eol - pos);
+        pos = eol + 1;
+
+        bool error = line.find("][XX]") != std::string::npos;
+        errors += error;
+        bool summary = line.starts_with("[SCHEDR]") || line.starts_with("[SDFILE]") ||
+                       line.starts_with("[PIPELN]") || line.starts_with("[TELEMT]") ||
+                       line.starts_with("[BOOTUP]");
+        if (dump || error || summary) printf("  %s\n", line.c_str());
+    }
+    return errors;
+}
+
+int report(const Options& opt) {
+    static FATFS fs;
+    if (!sim::disk::open(opt.image, opt.image_mb << 20, false) || f_mount(&fs, "", 1) != FR_OK) {
+        printf("[SIMHST][XX] Cannot remount %s\n", opt.image);
+        return 1;
+    }
+
+    int failures = 0;
+    int session = newestSession();
+    if (session < 0) {
+        printf("[SIMHST][XX] No session folder on the image\n");
+        failures++;
+    } else {
+        char folder[16];
+        snprintf(folder, sizeof(folder), "%d", session);
+        printf("[SIMHST][--] Session %d:\n", session);
+        for (const auto& file : logging::streams::FILES) {
+            if (!file.enabled) continue;
+            FileReport f = inspect(folder, file.filename);
+            printf("  %-11s %8" PRIu64 " bytes %7" PRIu64 " records%s\n", f.name.c_str(), f.bytes, f.records,
+                   f.valid ? "" : "  INVALID");
+            if (!f.valid || f.records == 0) failures++;
+        }
+    }
+
+    printf("[SIMHST][--] debug.txt (this run):\n");
+    failures += reportDebug(opt.dump_debug);
+
+    f_mount(nullptr, "", 0);
+    sim::disk::close();
+    return failures;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse(argc, argv, opt)) {
+        fprintf(stderr, "usage: %s [--image PATH] [--image-mb N] [--fresh] [--exfat] [--seconds S]\n"
+                        "          [--no-sd-timing] [--usb] [--dump-debug]\n", argv[0]);
+        return 2;
+    }
+
+    sim::clock::start();
+
+    if (!sim::disk::open(opt.image, opt.image_mb << 20, opt.fresh)) {
+        perror(opt.image);
+        return 1;
+    }
+    if (!sim::disk::isFormatted() && !format(opt.exfat)) return 1;
+    sim::disk::setTiming(opt.sd_timing);
+    sim::stdio::setUsbConnected(opt.usb);
+
+    // Devices
+    using namespace config::i2c::addresses;
+    sim::Scenario scenario;
+    sim::ICM20948Model icm(scenario);
+    sim::BMP581Model bmp(scenario);
+    sim::MS4525DOModel pitot(scenario);
+    sim::GpsReceiver gps(scenario);
+    sim::i2c::bus(i2c0).attach(ICM20948_ADDR, &icm);
+    sim::i2c::bus(i2c0).attach(BMP581_ADDR, &bmp);
+    sim::i2c::bus(i2c0).attach(PITOT, &pitot);
+    sim::uart::attach(uart0, &gps);
+    gps.attachTimepulse(config::gps::PPS_PIN);
+    icm.attachInt(config::pins::data_ready::ICM20948);
+    bmp.attachInt(config::pins::data_ready::BMP581);
+
+    // Generous upper bound: boot, the run, shutdown and final syncs
+    std::atomic<bool> done = false;
+    double limit_s = opt.seconds + 30.0;
+    std::thread watchdog([&] {
+        auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(limit_s);
+        while (!done) {
+            if (std::chrono::steady_clock::now() > end) {
+                fprintf(stderr, "[SIMHST][XX] Firmware did not shut down within %.0f s\n", limit_s);
+                fflush(stdout);
+                _Exit(3);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+    });
+    std::thread driver(script, opt.seconds, std::ref(done));
+
+    int result = 0;
+    try {
+        result = ads_main();
+    } catch (const sim::Reboot&) {
+        // EndProcess() -> reset_usb_boot()
+    }
+    done = true;
+    driver.join();
+    sim::shutdown();
+    watchdog.join();
+
+    auto disk = sim::disk::getStats();
+    auto uart = sim::uart::port(uart0).getStats();
+    printf("[SIMHST][--] SD: %" PRIu64 " sectors written (%" PRIu64 " CMD24, %" PRIu64 " CMD25 + %" PRIu64
+           " continued, %" PRIu64 " stops), %" PRIu64 " sectors read, %.1f ms card busy\n",
+           disk.sectors_written, disk.single_writes, disk.multi_writes, disk.continuations, disk.stops,
+           disk.sectors_read, disk.busy_us / 1000.0);
+    printf("[SIMHST][--] GPS UART: %" PRIu64 " rx, %" PRIu64 " tx, %" PRIu64 " overruns, %" PRIu64
+           " framing errors, %" PRIu32 " epochs\n",
+           uart.rx_bytes, uart.tx_bytes, uart.overruns, uart.framing_errors, gps.getStats().epochs);
+    for (uint8_t addr : {ICM20948_ADDR, BMP581_ADDR, PITOT}) {
+        const auto& bus = sim::i2c::bus(i2c0).stats(addr);
+        printf("[SIMHST][--] I2C 0x%02X: %" PRIu64 " transfers, %" PRIu64 " bytes, %.1f ms bus time\n",
+               addr, bus.transfers, bus.bytes_written + bus.bytes_read, bus.bus_us / 1000.0);
+    }
+    sim::disk::close();
+
+    int failures = report(opt);
+    if (result != 0) failures++;
+    printf("[SIMHST][%s] %d problem(s)\n", failures ? "XX" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+// Project Omni-Header
+#include "config/all_headers.h"
+
+#include "drivers/init_step.h"
+
+namespace scheduling {
+
+// ============================================
+// Parallel Device Bring-up
+// ============================================
+// Steps every device's init_step() from one poll (a low-priority
+// scheduler task), so resets, settle times and configuration replies all
+// overlap. A device that is done gets its completion time recorded and its
+// on_done callback run at once, which is where its tasks get activated:
+// each sensor starts sampling as soon as it alone is up.
+//
+// report() prints the boot timeline, one line per device.
+class BootSequencer {
+public:
+    static constexpr size_t MAX_DEVICES = 6;
+
+    using StepFn = std::function<drivers::InitStep(uint64_t now_us)>;
+    using DoneFn = std::function<void(bool ok)>;
+
+    // Register a device (before the first poll()). Returns false when full.
+    bool add(const char* name, StepFn step, DoneFn on_done = nullptr) {
+        if (device_count >= MAX_DEVICES) return false;
+        devices[device_count++] = {name, std::move(step), std::move(on_done)};
+        return true;
+    }
+
+    // Steps the devices that are due. Returns true once all are done.
+    bool poll(uint64_t now_us) {
+        if (start_us == 0) start_us = now_us;
+
+        bool all_done = true;
+        for (size_t i = 0; i < device_count; i++) {
+            Device& d = devices[i];
+            if (!d.step.pending()) continue;
+            if (now_us >= d.step.next_us) {
+                d.step = d.fn(now_us);
+                if (!d.step.pending()) {
+                    d.done_us = time_us_64();
+                    if (d.on_done) d.on_done(d.step.state == drivers::InitStep::State::READY);
+                    continue;
+                }
+            }
+            all_done = false;
+        }
+        return all_done;
+    }
+
+    // Emits the start, one line per device and the total. print(format, ...)
+    // must behave like printf; lines fit a 62-character text slot.
+    template<typename Print>
+    void report(Print&& print) const {
+        print("[BOOTUP][--] Bring-up started at %" PRIu32 "ms\n", ms(start_us));
+
+        uint64_t last_us = start_us;
+        size_t ready = 0;
+        for (size_t i = 0; i < device_count; i++) {
+            const Device& d = devices[i];
+            if (d.step.pending()) {
+                print("[BOOTUP][XX] %s still pending\n", d.name);
+                continue;
+            }
+            bool ok = d.step.state == drivers::InitStep::State::READY;
+            print("[BOOTUP][%s] %s %s at %" PRIu32 "ms\n", ok ? "OK" : "XX", d.name, ok ? "ready" : "failed", ms(d.done_us));
+            ready += ok;
+            last_us = std::max(last_us, d.done_us);
+        }
+        print("[BOOTUP][--] %u/%u devices up in %" PRIu32 "ms\n",
+              static_cast<unsigned>(ready), static_cast<unsigned>(device_count), ms(last_us - start_us));
+    }
+
+private:
+    struct Device {
+        const char* name = nullptr;
+        StepFn fn;
+        DoneFn on_done;
+        drivers::InitStep step = drivers::InitStep::at(0);
+        uint64_t done_us = 0;
+    };
+
+    static uint32_t ms(uint64_t us) { return static_cast<uint32_t>(us / 1000); }
+
+    Device devices[MAX_DEVICES];
+    size_t device_count = 0;
+    uint64_t start_us = 0;
+};
+
+} // namespace scheduling
@@ -0,0 +1,52 @@
+#pragma once
+
+// Project Omni-Header
+#include "config/all_headers.h"
+
+namespace drivers {
+
+// ============================================
+// Shared GPIO Edge IRQ
+// ============================================
+// The SDK has a single GPIO callback per core, so every edge consumer
+// (timepulse, sensor data-ready lines) registers its pin here instead and
+// the one callback dispatches by pin. Handlers run in IRQ context; attach
+// all pins from the core that should take the interrupts.
+class GpioIrq {
+public:
+    using Handler = void (*)(void* context, uint gpio, uint32_t events);
+
+    // False if the pin is out of range or already taken by someone else
+    static bool attach(uint pin, uint32_t events, Handler handler, void* context) {
+        if (pin >= NUM_BANK0_GPIOS) return false;
+        Slot& slot = slots[pin];
+        if (slot.handler && slot.context != context) return false;
+
+        slot.handler = handler;
+        slot.context = context;
+        gpio_set_irq_enabled_with_callback(pin, events, true, dispatch);
+        return true;
+    }
+
+    static void detach(uint pin, uint32_t events) {
+        if (pin >= NUM_BANK0_GPIOS) return;
+        gpio_set_irq_enabled(pin, events, false);
+        slots[pin] = Slot{nullptr, nullptr};
+    }
+
+private:
+    struct Slot {
+        Handler handler;
+        void* context;
+    };
+
+    static inline Slot slots[NUM_BANK0_GPIOS] = {};
+
+    static void dispatch(uint gpio, uint32_t events) {
+        if (gpio >= NUM_BANK0_GPIOS) return;
+        const Slot& slot = slots[gpio];
+        if (slot.handler) slot.handler(slot.context, gpio, events);
+    }
+};
+
+} // namespace drivers
@@ -0,0 +1,192 @@
+#pragma once
+
+// NOTE: Pico SDK free so the model can be exercised on the host as well.
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+namespace drivers {
+
+// ============================================
+// GPS-Disciplined Clock
+// ============================================
+// Maps the boot microsecond counter (time_us_64) to UTC microseconds.
+//
+// Each timepulse marks the start of a UTC second and is timestamped in
+// boot µs by its edge IRQ. The clock is anchored at the latest accepted
+// pulse, and the rate error of the board crystal (drift) is estimated
+// from the pulse spacing through a first-order filter. Between pulses, and
+// for up to HOLDOVER_US after the last one, boot µs extrapolate from the
+// anchor with the drift taken out.
+//
+// A pulse whose arrival misses the prediction by more than OUTLIER_US (a
+// glitch, or a second mislabelled) is rejected once locked, and
+// LOCK_PULSES rejections in a row restart acquisition. Without any pulses the clock can be
+// set coarsely from the GPS time messages (millisecond class accuracy, the
+// serial latency included), which a pulse always overrides.
+template<uint32_t LOCK_PULSES, uint32_t OUTLIER_US, uint32_t HOLDOVER_S>
+class DisciplinedClock {
+public:
+    enum class Quality : uint8_t { NONE, COARSE, HOLDOVER, LOCKED };
+
+    static constexpr uint64_t HOLDOVER_US = HOLDOVER_S * 1'000'000ull;
+    static constexpr int32_t MAX_DRIFT_PPB = 1'000'000;        // 1000 ppm: beyond any crystal
+    static constexpr size_t JITTER_WINDOW = 16;
+
+    struct Stats {
+        uint32_t pulses = 0;                // Timepulses offered
+        uint32_t accepted = 0;
+        uint32_t rejected = 0;              // Outliers while locked
+        uint32_t missed = 0;                // Seconds without a pulse between accepted ones
+        uint32_t reacquisitions = 0;
+        int32_t drift_ppb = 0;              // Boot clock rate error, positive = runs fast
+        int32_t last_residual_ns = 0;       // Latest pulse against the prediction
+        uint32_t jitter_rms_ns = 0;         // Over the last JITTER_WINDOW residuals
+        uint32_t jitter_max_ns = 0;         // Largest residual while locked
+    };
+
+    // A timepulse at boot_us marking the start of UTC second utc_s
+    void pulse(uint64_t boot_us, int64_t utc_s) {
+        stats.pulses++;
+
+        if (!in_holdover(boot_us) || utc_s <= anchor_utc_s) {
+            acquire(boot_us, utc_s);
+            return;
+        }
+
+        int64_t seconds = utc_s - anchor_utc_s;
+        int64_t interval_us = static_cast<int64_t>(boot_us - anchor_boot_us);
+
+        // Prediction from the current model, in ns
+        int64_t expected_ns = seconds * 1'000'000'000ll + seconds * static_cast<int64_t>(drift_ppb);
+        int64_t residual_ns = interval_us * 1000 - expected_ns;
+
+        if (in_row >= LOCK_PULSES && std::llabs(residual_ns) > OUTLIER_US * 1000ll) {
+            stats.rejected++;
+            if (++outliers >= LOCK_PULSES) acquire(boot_us, utc_s);
+            return;
+        }
+        outliers = 0;
+
+        // Rate over the interval; the first measurement is taken as is
+        int64_t measured_ppb = (interval_us * 1000 - seconds * 1'000'000'000ll) / seconds;
+        if (measured_ppb > MAX_DRIFT_PPB || measured_ppb < -MAX_DRIFT_PPB) {
+            acquire(boot_us, utc_s);
+            return;
+        }
+        if (!has_drift) {
+            drift_ppb = static_cast<int32_t>(measured_ppb);
+            has_drift = true;
+        } else {
+            drift_ppb += static_cast<int32_t>((measured_ppb - drift_ppb) / DRIFT_GAIN);
+        }
+
+        if (in_row >= LOCK_PULSES) record_residual(residual_ns);
+        stats.missed += static_cast<uint32_t>(seconds - 1);
+        stats.accepted++;
+        in_row++;
+        anchor_boot_us = boot_us;
+        anchor_utc_s = utc_s;
+        coarse_set = false;
+        stats.drift_ppb = drift_ppb;
+    }
+
+    // GPS time message: UTC utc_us was current at boot_us (serial latency
+    // and all). Used only while there is no pulse anchor.
+    void coarse(uint64_t boot_us, int64_t utc_us) {
+        if (in_holdover(boot_us)) return;
+        coarse_set = true;
+        coarse_boot_us = boot_us;
+        coarse_utc_us = utc_us;
+    }
+
+    // UTC µs since the Unix epoch for a boot timestamp, 0 when unknown
+    int64_t utc_us(uint64_t boot_us) const {
+        if (in_holdover(boot_us)) {
+            int64_t dt = static_cast<int64_t>(boot_us - anchor_boot_us);
+            return anchor_utc_s * 1'000'000 + dt - dt * drift_ppb / 1'000'000'000;
+        }
+        if (coarse_set) {
+            return coarse_utc_us + static_cast<int64_t>(boot_us - coarse_boot_us);
+        }
+        return 0;
+    }
+
+    // Inverse of utc_us(): the boot timestamp of a UTC instant, 0 when unknown
+    uint64_t boot_us(int64_t utc_us) const {
+        if (anchored) {
+            int64_t dt = utc_us - anchor_utc_s * 1'000'000;
+            uint64_t boot = anchor_boot_us + static_cast<uint64_t>(dt + dt * drift_ppb / 1'000'000'000);
+            if (in_holdover(boot)) return boot;
+        }
+        if (coarse_set) {
+            return coarse_boot_us + static_cast<uint64_t>(utc_us - coarse_utc_us);
+        }
+        return 0;
+    }
+
+    Quality quality(uint64_t now_us) const {
+        if (in_holdover(now_us)) {
+            int64_t dt = static_cast<int64_t>(now_us - anchor_boot_us);
+            return (in_row >= LOCK_PULSES && dt < 2'000'000) ? Quality::LOCKED : Quality::HOLDOVER;
+        }
+        return coarse_set ? Quality::COARSE : Quality::NONE;
+    }
+
+    const Stats& get_stats() const { return stats; }
+
+private:
+    static constexpr int32_t DRIFT_GAIN = 8;
+
+    // Within HOLDOVER_US of the anchor either way: stamps taken before the
+    // latest pulse (back-dated FIFO frames, filter delay) still map through it
+    bool in_holdover(uint64_t boot_us) const {
+        int64_t dt = static_cast<int64_t>(boot_us - anchor_boot_us);
+        return anchored && dt >= -static_cast<int64_t>(HOLDOVER_US) && dt <= static_cast<int64_t>(HOLDOVER_US);
+    }
+
+    bool anchored = false;
+    bool has_drift = false;
+    uint64_t anchor_boot_us = 0;
+    int64_t anchor_utc_s = 0;
+    int32_t drift_ppb = 0;
+    uint32_t in_row = 0;                    // Pulses accepted since acquisition
+    uint32_t outliers = 0;                  // Rejected in a row
+
+    bool coarse_set = false;
+    uint64_t coarse_boot_us = 0;
+    int64_t coarse_utc_us = 0;
+
+    int32_t residuals[JITTER_WINDOW] = {};
+    size_t residual_count = 0;
+    Stats stats;
+
+    // Start over at this pulse; the drift estimate survives
+    void acquire(uint64_t boot_us, int64_t utc_s) {
+        if (anchored) stats.reacquisitions++;
+        anchored = true;
+        anchor_boot_us = boot_us;
+        anchor_utc_s = utc_s;
+        in_row = 1;
+        outliers = 0;
+        residual_count = 0;
+        coarse_set = false;
+        stats.accepted++;
+    }
+
+    void record_residual(int64_t residual_ns) {
+        int32_t r = static_cast<int32_t>(residual_ns);
+        residuals[residual_count++ % JITTER_WINDOW] = r;
+        stats.last_residual_ns = r;
+        stats.jitter_max_ns = std::max<uint32_t>(stats.jitter_max_ns, static_cast<uint32_t>(std::abs(r)));
+
+        size_t n = std::min(residual_count, JITTER_WINDOW);
+        double sum = 0;
+        for (size_t i = 0; i < n; i++) sum += static_cast<double>(residuals[i]) * residuals[i];
+        stats.jitter_rms_ns = static_cast<uint32_t>(std::sqrt(sum / n));
+    }
+};
+
+} // namespace drivers
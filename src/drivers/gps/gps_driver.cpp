@@ -3,301 +3,703 @@
 
 namespace drivers {
 
+// UBX classes and message ids
+namespace ubx {
+    static constexpr uint8_t NAV = 0x01;
+    static constexpr uint8_t ACK = 0x05;
+    static constexpr uint8_t CFG = 0x06;
+    static constexpr uint8_t NMEA = 0xF0;
+
+    static constexpr uint8_t NAV_DOP = 0x04;
+    static constexpr uint8_t NAV_PVT = 0x07;
+    static constexpr uint8_t NAV_TIMEUTC = 0x21;
+    static constexpr uint8_t NAV_SAT = 0x35;
+    static constexpr uint8_t ACK_NAK = 0x00;
+    static constexpr uint8_t ACK_ACK = 0x01;
+    static constexpr uint8_t CFG_PRT = 0x00;
+    static constexpr uint8_t CFG_MSG = 0x01;
+    static constexpr uint8_t CFG_RATE = 0x08;
+    static constexpr uint8_t CFG_TP5 = 0x31;
+
+    static constexpr uint8_t NMEA_GGA = 0x00, NMEA_GLL = 0x01, NMEA_GSA = 0x02;
+    static constexpr uint8_t NMEA_GSV = 0x03, NMEA_RMC = 0x04, NMEA_VTG = 0x05;
+
+    static constexpr uint8_t PORT_UART1 = 1;
+}
+
+// NAV messages enabled in UBX mode
+static constexpr bool UBX_PVT = config::gps::ENABLE_POSITION || config::gps::ENABLE_VELOCITY;
+static constexpr bool UBX_TIMEUTC = config::gps::ENABLE_TIME;
+static constexpr bool UBX_SAT_DOP = config::gps::ENABLE_SATELLITES;
+
+// Bytes per epoch (frames incl. 8 bytes framing; NAV-SAT with 32 SVs, or
+// three NMEA sentences) must fit the line with room to spare
+static constexpr uint32_t EPOCH_BYTES = config::gps::USE_BINARY_UBX
+    ? (UBX_PVT ? 100 : 0) + (UBX_TIMEUTC ? 28 : 0) + (UBX_SAT_DOP ? 26 + 16 + 12 * 32 : 0)
+    : 256;
+static_assert(config::gps::BAUD_RATE / 10 >= 2u * EPOCH_BYTES * config::gps::UPDATE_RATE_HZ,
+              "GPS baud rate too low for the navigation rate");
+
+// Handlers for each verified frame; poll replies that match none go to the
+// configuration request in flight
+constexpr std::array<GpsDriver::UbxHandler, 6> GpsDriver::UBX_HANDLERS = {{
+    {ubx::NAV, ubx::NAV_DOP, 18, &GpsDriver::on_nav_dop},
+    {ubx::NAV, ubx::NAV_PVT, 92, &GpsDriver::on_nav_pvt},
+    {ubx::NAV, ubx::NAV_TIMEUTC, 20, &GpsDriver::on_nav_timeutc},
+    {ubx::NAV, ubx::NAV_SAT, 8, &GpsDriver::on_nav_sat},
+    {ubx::ACK, ubx::ACK_NAK, 2, &GpsDriver::on_ack},
+    {ubx::ACK, ubx::ACK_ACK, 2, &GpsDriver::on_ack},
+}};
 bool GpsDriver::init(uart_inst_t* u, uint rx_pin, uint tx_pin, bool ubx_protocol) {
+    begin_init(u, rx_pin, tx_pin, ubx_protocol);
+    return InitStep::run([this](uint64_t now_us) { return init_step(now_us); });
+}
+
+void GpsDriver::begin_init(uart_inst_t* u, uint rx_pin, uint tx_pin, bool ubx_protocol) {
     uart = u;
     use_ubx = ubx_protocol;
+    boot = {};
+    tx_len = tx_sent = 0;
+    timepulse_pending = false;
     
-    // Initialize UART
-    uart_init(uart, 9600);
+    // Initialize UART (factory default; configuration finds the actual rate)
+    baud = uart_init(uart, 9600);
     gpio_set_function(tx_pin, GPIO_FUNC_UART);
     gpio_set_function(rx_pin, GPIO_FUNC_UART);
     uart_set_format(uart, 8, 1, UART_PARITY_NONE);
+
+    // Receive by interrupt from here on, ACKs to the configuration included
+    if (!rx.start(uart)) {
+        printf("GPS UART receiver already in use.\n");
+        return;
+    }
     
-    sleep_ms(100);
-    
-    // Common disable messages
-    uint8_t disable_gll[] = {0xB5,0x62,0x06,0x01,0x03,0x00,0xF0,0x01,0x00,0xFB,0x11};
-    uint8_t disable_gsa[] = {0xB5,0x62,0x06,0x01,0x03,0x00,0xF0,0x02,0x00,0xFC,0x13};
-    uint8_t disable_gsv[] = {0xB5,0x62,0x06,0x01,0x03,0x00,0xF0,0x03,0x00,0xFD,0x15};
-    
-    if (use_ubx) {
-        // Disable all NMEA
-        uint8_t disable_gga[] = {0xB5,0x62,0x06,0x01,0x03,0x00,0xF0,0x00,0x00,0xFA,0x0F};
-        uint8_t disable_rmc[] = {0xB5,0x62,0x06,0x01,0x03,0x00,0xF0,0x04,0x00,0xFE,0x17};
-        uint8_t disable_vtg[] = {0xB5,0x62,0x06,0x01,0x03,0x00,0xF0,0x05,0x00,0xFF,0x19};
-        uint8_t enable_pvt[]  = {0xB5,0x62,0x06,0x01,0x03,0x00,0x01,0x07,0x01,0x13,0x51};
-        
-        uart_write_blocking(uart, disable_gga, sizeof(disable_gga));
-        sleep_ms(10);
-        uart_write_blocking(uart, disable_gll, sizeof(disable_gll));
-        sleep_ms(10);
-        uart_write_blocking(uart, disable_gsa, sizeof(disable_gsa));
-        sleep_ms(10);
-        uart_write_blocking(uart, disable_gsv, sizeof(disable_gsv));
-        sleep_ms(10);
-        uart_write_blocking(uart, disable_rmc, sizeof(disable_rmc));
-        sleep_ms(10);
-        uart_write_blocking(uart, disable_vtg, sizeof(disable_vtg));
-        sleep_ms(10);
-        uart_write_blocking(uart, enable_pvt, sizeof(enable_pvt));
-        sleep_ms(10);
+    boot.phase = InitPhase::SETTLE;
+    boot.settle_until_us = time_us_64() + 100'000;
+}
+
+bool GpsDriver::update() {
+    pump_tx();
+    if (timepulse_pending) {
+        Reply reply = poll_transact();
+        if (reply != Reply::PENDING) {
+            timepulse_pending = false;
+            printf("[GPSCFG][%s] CFG-TP5 %s\n", reply == Reply::ACK ? "OK" : "XX",
+                   reply == Reply::ACK ? "acknowledged" : "not acknowledged");
+        }
     } else {
-        // Enable only GGA, RMC, VTG for NMEA
-        uint8_t enable_gga[] = {0xB5,0x62,0x06,0x01,0x03,0x00,0xF0,0x00,0x01,0xFB,0x10};
-        uint8_t enable_rmc[] = {0xB5,0x62,0x06,0x01,0x03,0x00,0xF0,0x04,0x01,0xFF,0x18};
-        uint8_t enable_vtg[] = {0xB5,0x62,0x06,0x01,0x03,0x00,0xF0,0x05,0x01,0x00,0x1A};
-        
-        // Disable unwanted
-        uart_write_blocking(uart, disable_gll, sizeof(disable_gll));
-        sleep_ms(10);
-        uart_write_blocking(uart, disable_gsa, sizeof(disable_gsa));
-        sleep_ms(10);
-        uart_write_blocking(uart, disable_gsv, sizeof(disable_gsv));
-        sleep_ms(10);
-        
-        // Enable wanted
-        uart_write_blocking(uart, enable_gga, sizeof(enable_gga));
-        sleep_ms(10);
-        uart_write_blocking(uart, enable_rmc, sizeof(enable_rmc));
-        sleep_ms(10);
-        uart_write_blocking(uart, enable_vtg, sizeof(enable_vtg));
-        sleep_ms(10);
+        drain();
     }
+    discipline_clock();
+    return data.valid;
+}
 
-    sleep_ms(10);
-    set_led_enabled(false);
-    sleep_ms(10);
+// ============================================
+// Time Keeping
+// ============================================
+// A GPS time message says which UTC second the next pulses belong to; it
+// arrives tens of milliseconds after its epoch, well within the half
+// second that labelling a pulse by rounding can tolerate.
+void GpsDriver::set_time_reference(uint32_t unix_time, int32_t nano) {
+    time_rx_us = time_us_64();
+    time_utc_us = static_cast<int64_t>(unix_time) * 1'000'000 + nano / 1000;
+    time_known = true;
+    clock.coarse(time_rx_us, time_utc_us);
 
-    printf("GPS initialized.\n");
-    return true;
+    // The epoch on the boot clock: exact once pulses discipline the clock,
+    // the parse time (latency 0) before that
+    uint64_t epoch_us = clock.boot_us(time_utc_us);
+    if (epoch_us == 0 || epoch_us > time_rx_us) epoch_us = time_rx_us;
+    data.time = {epoch_us, static_cast<uint32_t>(time_rx_us - epoch_us)};
 }
 
-bool GpsDriver::update() {
-    while (uart_is_readable(uart)) {
-        uint8_t byte = uart_getc(uart);
-        
-        if (use_ubx) {
-            // UBX protocol parsing
-            if (buf_pos == 0 && byte != 0xB5) continue;
-            if (buf_pos == 1 && byte != 0x62) { buf_pos = 0; continue; }
-            
-            buffer[buf_pos++] = byte;
-            
-            if (buf_pos >= 6) {
-                uint16_t len = buffer[4] | (buffer[5] << 8);
-                if (buf_pos >= len + 8) {
-                    // Check message class and ID for NAV-PVT
-                    if (buffer[2] == 0x01 && buffer[3] == 0x07) {
-                        if (utils::verify_ubx_checksum(buffer, len + 8)) {
-                            parse_nav_pvt(buffer + 6, len);
-                        }
-                    }
-                    buf_pos = 0;
-                }
-            }
-            
-            if (buf_pos >= BUFFER_SIZE) buf_pos = 0;
+void GpsDriver::discipline_clock() {
+    uint64_t boot_us;
+    while (pps.pop(boot_us)) {
+        if (!time_known) continue;
+        int64_t utc_us = time_utc_us + static_cast<int64_t>(boot_us - time_rx_us);
+        clock.pulse(boot_us, (utc_us + 500'000) / 1'000'000);
+    }
+}
+
+// ============================================
+// UBX Configuration
+// ============================================
+// Nothing is assumed about the receiver: the baud rate it listens on is
+// found by polling CFG-PRT, and with POLL_CONFIG every setting is polled
+// first and only changed when it differs. Every change waits for its
+// ACK-ACK / ACK-NAK instead of a fixed delay. init_step() queues one
+// exchange and returns; later calls feed it to the TX FIFO and parse what
+// arrived until the reply is in, and the phase it belonged to sends the
+// next one. Nothing here waits on the line: a CFG-PRT frame alone takes
+// 30 ms at 9600 baud.
+static constexpr uint BAUD_CANDIDATES[] = {config::gps::BAUD_RATE, 9600, 38400, 115200, 57600, 230400, 460800};
+static constexpr uint64_t REPLY_POLL_US = 500;
+static constexpr uint64_t BAUD_SETTLE_US = 2000;    // After a rate change, before listening again
+
+InitStep GpsDriver::init_step(uint64_t now_us) {
+    switch (boot.phase) {
+    case InitPhase::DONE:
+        return InitStep::done(boot.ok);
+
+    case InitPhase::SETTLE:
+        if (now_us < boot.settle_until_us) return InitStep::at(boot.settle_until_us);
+        boot.ok = true;
+        boot.index = 0;
+        probe_baud();
+        break;
+
+    case InitPhase::BAUD_DRAIN:
+        // The queued frame leaves at the old rate, then the UART switches
+        drain();
+        if (!pump_tx()) return InitStep::at(now_us + REPLY_POLL_US);
+        baud = uart_set_baudrate(uart, boot.next_baud);
+        boot.settle_until_us = now_us + BAUD_SETTLE_US;
+        boot.phase = InitPhase::BAUD_SETTLE;
+        return InitStep::at(boot.settle_until_us);
+
+    case InitPhase::BAUD_SETTLE:
+        if (now_us < boot.settle_until_us) return InitStep::at(boot.settle_until_us);
+        baud_changed();
+        break;
+
+    default: {
+        Reply reply = poll_transact();
+        if (reply == Reply::PENDING) return InitStep::at(now_us + REPLY_POLL_US);
+        on_init_reply(reply);
+        break;
+    }
+    }
+    if (boot.phase == InitPhase::DONE) return InitStep::done(boot.ok);
+    return InitStep::at(now_us + REPLY_POLL_US);
+}
+
+void GpsDriver::on_init_reply(Reply reply) {
+    using namespace config::gps;
+    bool acked = reply == Reply::ACK;
+
+    switch (boot.phase) {
+    case InitPhase::PROBE:
+        if (!acked || !request.replied || request.reply_len < 20) {
+            boot.index++;
+            probe_baud();
+        } else if ((boot.found_baud = BAUD_CANDIDATES[boot.index]) != BAUD_RATE) {
+            // CFG-PRT with the polled port settings and the new rate. The
+            // receiver switches as soon as it has the message, so the ACK
+            // may be lost; the change is confirmed by polling again.
+            uint8_t prt[20];
+            memcpy(prt, request.reply, sizeof(prt));
+            prt[8] = static_cast<uint8_t>(BAUD_RATE);
+            prt[9] = static_cast<uint8_t>(BAUD_RATE >> 8);
+            prt[10] = static_cast<uint8_t>(BAUD_RATE >> 16);
+            prt[11] = static_cast<uint8_t>(BAUD_RATE >> 24);
+            begin_transact(ubx::CFG, ubx::CFG_PRT, prt, sizeof(prt), reply_timeout_ms());
+            boot.phase = InitPhase::BAUD_SET;
         } else {
-            // NMEA protocol parsing
-            if (byte == '$') {
-                nmea_pos = 0;
-            }
-            
-            if (nmea_pos < sizeof(nmea_line) - 1) {
-                nmea_line[nmea_pos++] = byte;
-                
-                if (byte == '\n') {
-                    nmea_line[nmea_pos] = '\0';
-                    printf(nmea_line);
-                    parse_nmea_sentence(nmea_line);
-                    nmea_pos = 0;
-                }
-            } else {
-                nmea_pos = 0;
+            next_message();
+        }
+        break;
+
+    case InitPhase::BAUD_SET:
+        change_baud(BAUD_RATE, InitPhase::BAUD_CONFIRM);
+        break;
+
+    case InitPhase::BAUD_CONFIRM:
+        if (acked) {
+            printf("[GPSCFG][OK] Baud rate %u -> %u\n", boot.found_baud, (uint)BAUD_RATE);
+            next_message();
+        } else {
+            // Not confirmed: back to the old rate
+            printf("[GPSCFG][XX] Baud rate change to %u failed, staying at %u\n", (uint)BAUD_RATE, boot.found_baud);
+            boot.ok = false;
+            change_baud(boot.found_baud, InitPhase::MESSAGE_POLL);
+        }
+        break;
+
+    case InitPhase::MESSAGE_POLL: {
+        // Reply: class, id, rate on each of the six ports
+        MessageRate m = message_rate(boot.index);
+        if (acked && request.replied && request.reply_len >= 8 && request.reply[2 + ubx::PORT_UART1] == m.rate) {
+            boot.index++;
+            next_message();
+        } else {
+            set_message_rate(m);
+        }
+        break;
+    }
+
+    case InitPhase::MESSAGE_SET:
+        if (!acked) {
+            MessageRate m = message_rate(boot.index);
+            printf("[GPSCFG][XX] CFG-MSG %02X-%02X not acknowledged\n", m.cls, m.id);
+            boot.ok = false;
+        }
+        boot.index++;
+        next_message();
+        break;
+
+    case InitPhase::RATE_POLL:
+        if (acked && request.replied && request.reply_len >= 6) {
+            if (memcmp(request.reply, boot.rate, 4) == 0) {
+                nav_rate_done(true);
+                break;
             }
+            memcpy(boot.rate + 4, request.reply + 4, 2);      // Keep the time reference
         }
+        set_nav_rate();
+        break;
+
+    case InitPhase::RATE_SET:
+        nav_rate_done(acked);
+        break;
+
+    case InitPhase::TIMEPULSE:
+        if (!acked) printf("[GPSCFG][XX] CFG-TP5 not acknowledged\n");
+        finish_init(boot.ok);
+        break;
+
+    case InitPhase::SETTLE:
+    case InitPhase::BAUD_DRAIN:
+    case InitPhase::BAUD_SETTLE:
+    case InitPhase::DONE:
+        break;
     }
-    
-    return data.valid;
 }
 
-bool GpsDriver::parse_nav_pvt(const uint8_t* payload, size_t len) {
-    if (len < 92) return false;  // NAV-PVT is 92 bytes
-    
-    // Direct field extraction from NAV-PVT message
-    uint16_t year = payload[4] | (payload[5] << 8);
-    uint8_t month = payload[6];
-    uint8_t day = payload[7];
-    uint8_t hour = payload[8];
-    uint8_t min = payload[9];
-    uint8_t sec = payload[10];
-    
-    uint8_t fix_type = payload[20];
-    uint8_t flags = payload[21];
-    
-    data.lon = *reinterpret_cast<const int32_t*>(payload + 24) / 1e7;
-    data.lat = *reinterpret_cast<const int32_t*>(payload + 28) / 1e7;
-    data.height = *reinterpret_cast<const int32_t*>(payload + 32);
-    data.hMSL = *reinterpret_cast<const int32_t*>(payload + 36);
-    data.hAcc = *reinterpret_cast<const uint32_t*>(payload + 40);
-    data.vAcc = *reinterpret_cast<const uint32_t*>(payload + 44);
-    data.velN = *reinterpret_cast<const int32_t*>(payload + 48);
-    data.velE = *reinterpret_cast<const int32_t*>(payload + 52);
-    data.velD = *reinterpret_cast<const int32_t*>(payload + 56);
-    data.gSpeed = *reinterpret_cast<const int32_t*>(payload + 60);
-    data.heading = *reinterpret_cast<const int32_t*>(payload + 64);
-    data.sAcc = *reinterpret_cast<const uint32_t*>(payload + 68);
-    data.headingAcc = *reinterpret_cast<const uint32_t*>(payload + 72);
-    
+// CFG-PRT poll at the next candidate rate, skipping repeats
+void GpsDriver::probe_baud() {
+    for (; boot.index < std::size(BAUD_CANDIDATES); boot.index++) {
+        uint candidate = BAUD_CANDIDATES[boot.index];
+        if (std::find(BAUD_CANDIDATES, BAUD_CANDIDATES + boot.index, candidate) != BAUD_CANDIDATES + boot.index) continue;
+
+        change_baud(candidate, InitPhase::PROBE);
+        return;
+    }
+    printf("[GPSCFG][XX] No UBX reply at any baud rate\n");
+    finish_init(false);
+}
+
+// Output messages before the navigation rate, so the line never carries
+// the full NMEA set at the higher rate
+GpsDriver::MessageRate GpsDriver::message_rate(size_t i) const {
+    const MessageRate messages[MESSAGE_COUNT] = {
+        {ubx::NMEA, ubx::NMEA_GGA, static_cast<uint8_t>(use_ubx ? 0 : 1)},
+        {ubx::NMEA, ubx::NMEA_GLL, 0},
+        {ubx::NMEA, ubx::NMEA_GSA, 0},
+        {ubx::NMEA, ubx::NMEA_GSV, 0},
+        {ubx::NMEA, ubx::NMEA_RMC, static_cast<uint8_t>(use_ubx ? 0 : 1)},
+        {ubx::NMEA, ubx::NMEA_VTG, static_cast<uint8_t>(use_ubx ? 0 : 1)},
+        {ubx::NAV, ubx::NAV_PVT, static_cast<uint8_t>(use_ubx && UBX_PVT ? 1 : 0)},
+        {ubx::NAV, ubx::NAV_TIMEUTC, static_cast<uint8_t>(use_ubx && UBX_TIMEUTC ? 1 : 0)},
+        {ubx::NAV, ubx::NAV_DOP, static_cast<uint8_t>(use_ubx && UBX_SAT_DOP ? 1 : 0)},
+        {ubx::NAV, ubx::NAV_SAT, static_cast<uint8_t>(use_ubx && UBX_SAT_DOP ? 1 : 0)},
+    };
+    return messages[i];
+}
+
+void GpsDriver::next_message() {
+    if (boot.index >= MESSAGE_COUNT) {
+        // measRate (ms), navRate (cycles per solution), timeRef (1 = GPS)
+        uint16_t meas_ms = static_cast<uint16_t>(1000 / config::gps::UPDATE_RATE_HZ);
+        uint8_t rate[6] = {static_cast<uint8_t>(meas_ms), static_cast<uint8_t>(meas_ms >> 8), 1, 0, 1, 0};
+        memcpy(boot.rate, rate, sizeof(rate));
+
+        if constexpr (config::gps::POLL_CONFIG) {
+            begin_transact(ubx::CFG, ubx::CFG_RATE, nullptr, 0, reply_timeout_ms());
+            boot.phase = InitPhase::RATE_POLL;
+        } else {
+            set_nav_rate();
+        }
+        return;
+    }
+
+    MessageRate m = message_rate(boot.index);
+    if constexpr (config::gps::POLL_CONFIG) {
+        uint8_t poll[2] = {m.cls, m.id};
+        begin_transact(ubx::CFG, ubx::CFG_MSG, poll, sizeof(poll), reply_timeout_ms());
+        boot.phase = InitPhase::MESSAGE_POLL;
+    } else {
+        set_message_rate(m);
+    }
+}
+
+void GpsDriver::set_message_rate(const MessageRate& m) {
+    uint8_t set[3] = {m.cls, m.id, m.rate};
+    begin_transact(ubx::CFG, ubx::CFG_MSG, set, sizeof(set), reply_timeout_ms());
+    boot.phase = InitPhase::MESSAGE_SET;
+}
+
+void GpsDriver::set_nav_rate() {
+    begin_transact(ubx::CFG, ubx::CFG_RATE, boot.rate, sizeof(boot.rate), reply_timeout_ms());
+    boot.phase = InitPhase::RATE_SET;
+}
+
+void GpsDriver::nav_rate_done(bool ok) {
+    using config::gps::UPDATE_RATE_HZ;
+    if (ok) {
+        printf("[GPSCFG][OK] Navigation rate %u Hz\n", (uint)UPDATE_RATE_HZ);
+    } else {
+        printf("[GPSCFG][XX] CFG-RATE %u Hz not acknowledged\n", (uint)UPDATE_RATE_HZ);
+        boot.ok = false;
+    }
+
+    // The timepulse drives the module LED as well; off unless it is captured
+    if (!boot.ok) {
+        finish_init(false);
+        return;
+    }
+    uint8_t tp5[32];
+    timepulse_config(config::gps::PPS_ENABLED, tp5);
+    begin_transact(ubx::CFG, ubx::CFG_TP5, tp5, sizeof(tp5), reply_timeout_ms());
+    boot.phase = InitPhase::TIMEPULSE;
+}
+
+void GpsDriver::finish_init(bool ok) {
+    if (config::gps::PPS_ENABLED && !pps.start(config::gps::PPS_PIN)) {
+        printf("[GPSPPS][XX] Timepulse capture already in use\n");
+    }
+
+    // Probing at the wrong baud rates leaves framing errors behind
+    rx.reset_stats();
+
+    boot.ok = ok;
+    boot.phase = InitPhase::DONE;
+    printf("GPS initialized.\n");
+}
+
+// Switches the UART once everything queued has gone out (BAUD_DRAIN) and
+// the line has settled (BAUD_SETTLE), then continues in `then`: PROBE and
+// BAUD_CONFIRM poll the port at the new rate, anything else carries on
+// with the output messages
+void GpsDriver::change_baud(uint rate, InitPhase then) {
+    boot.next_baud = rate;
+    boot.after_baud = then;
+    boot.phase = InitPhase::BAUD_DRAIN;
+}
+
+// Drops what arrived at the previous rate
+void GpsDriver::baud_changed() {
+    drain();
+    parser.reset();
+    rx.discard();
+    nmea_pos = 0;
+
+    if (boot.after_baud == InitPhase::PROBE || boot.after_baud == InitPhase::BAUD_CONFIRM) {
+        uint8_t port = ubx::PORT_UART1;
+        begin_transact(ubx::CFG, ubx::CFG_PRT, &port, 1, reply_timeout_ms());
+        boot.phase = boot.after_baud;
+    } else {
+        next_message();
+    }
+}
+
+// A reply queues behind whatever the receiver is already sending: allow
+// for a full epoch of output (about 1KB) at the current rate
+uint32_t GpsDriver::reply_timeout_ms() const {
+    return config::gps::ACK_TIMEOUT_MS + 10'240'000u / std::max(baud, 1u);
+}
+
+// Sends one UBX message; poll_transact() then waits for its ACK-ACK or
+// ACK-NAK (a poll's reply comes first)
+void GpsDriver::begin_transact(uint8_t cls, uint8_t id, const uint8_t* payload, uint16_t len, uint32_t timeout_ms) {
+    request = {};
+    request.cls = cls;
+    request.id = id;
+    request.active = true;
+    if (!send_ubx(cls, id, payload, len)) request.active = false;
+    request.deadline_us = time_us_64() + timeout_ms * 1000ull;
+}
+
+// Sends and parses; PENDING until the ACK arrives or the timeout expires
+GpsDriver::Reply GpsDriver::poll_transact() {
+    if (!request.active) return Reply::TIMEOUT;
+    pump_tx();
+    drain();
+
+    Reply result = Reply::PENDING;
+    if (request.acked || request.naked) {
+        result = request.acked ? Reply::ACK : Reply::NAK;
+    } else if (time_us_64() >= request.deadline_us) {
+        result = Reply::TIMEOUT;
+    }
+    if (result != Reply::PENDING) request.active = false;
+    return result;
+}
+
+// Queues one frame and starts it on its way; false when it does not fit
+bool GpsDriver::send_ubx(uint8_t cls, uint8_t id, const uint8_t* payload, uint16_t len) {
+    if (tx_len + len + 8u > sizeof(tx_queue)) return false;
+
+    uint8_t* frame = tx_queue + tx_len;
+    frame[0] = 0xB5;
+    frame[1] = 0x62;
+    frame[2] = cls;
+    frame[3] = id;
+    frame[4] = static_cast<uint8_t>(len);
+    frame[5] = static_cast<uint8_t>(len >> 8);
+    if (len) memcpy(frame + 6, payload, len);
+    utils::ubx_checksum(frame, len + 8, frame[len + 6], frame[len + 7]);
+    tx_len += len + 8u;
+
+    pump_tx();
+    return true;
+}
+
+// Moves queued bytes into the TX FIFO while it has room. True once the
+// queue is empty and the last character has left the line.
+bool GpsDriver::pump_tx() {
+    while (tx_sent < tx_len && uart_is_writable(uart)) {
+        uart_putc_raw(uart, static_cast<char>(tx_queue[tx_sent++]));
+    }
+    if (tx_sent < tx_len) return false;
+
+    tx_len = tx_sent = 0;
+    return !(uart_get_hw(uart)->fr & UART_UARTFR_BUSY_BITS);
+}
+
+// ============================================
+// Parsing
+// ============================================
+void GpsDriver::drain() {
+    // UBX frames are recognised in either mode (ACKs and poll replies) and
+    // parsed in place in the ring; NMEA sentences are assembled from the
+    // bytes between them
+    parser.parse(rx,
+        [this](const ubx::Frame& frame) { handle_ubx(frame); },
+        [this](std::span<const uint8_t> other) {
+            if (use_ubx) return;
+            for (uint8_t byte : other) parse_nmea_byte(byte);
+        });
+}
+
+void GpsDriver::parse_nmea_byte(uint8_t byte) {
+    if (byte == '$') {
+        nmea_pos = 0;
+    }
+
+    if (nmea_pos < sizeof(nmea_line) - 1) {
+        nmea_line[nmea_pos++] = byte;
+
+        if (byte == '\n') {
+            nmea_line[nmea_pos] = '\0';
+            parse_nmea_sentence(nmea_line, nmea_pos);
+            nmea_pos = 0;
+        }
+    } else {
+        nmea_pos = 0;
+    }
+}
+
+void GpsDriver::handle_ubx(const ubx::Frame& frame) {
+    static_assert([] {
+        for (size_t i = 1; i < UBX_HANDLERS.size(); i++) {
+            int prev = (UBX_HANDLERS[i - 1].cls << 8) | UBX_HANDLERS[i - 1].id;
+            int key = (UBX_HANDLERS[i].cls << 8) | UBX_HANDLERS[i].id;
+            if (key <= prev) return false;
+        }
+        return true;
+    }(), "UBX handler table must be sorted by class and id, without duplicates");
+
+    for (const auto& handler : UBX_HANDLERS) {
+        if (handler.cls > frame.cls || (handler.cls == frame.cls && handler.id > frame.id)) break;
+        if (handler.cls == frame.cls && handler.id == frame.id) {
+            if (frame.length >= handler.min_length) (this->*handler.handle)(frame);
+            return;
+        }
+    }
+
+    if (request.active && frame.cls == request.cls && frame.id == request.id) {
+        request.reply_len = std::min<size_t>(frame.length, sizeof(request.reply));
+        frame.copy(0, request.reply, request.reply_len);
+        request.replied = true;
+    }
+}
+
+void GpsDriver::on_nav_pvt(const ubx::Frame& frame) {
+    uint16_t year = frame.u16(4);
+    uint8_t month = frame.u8(6);
+    uint8_t day = frame.u8(7);
+    uint8_t hour = frame.u8(8);
+    uint8_t min = frame.u8(9);
+    uint8_t sec = frame.u8(10);
+
+    uint8_t fix_type = frame.u8(20);
+    uint8_t flags = frame.u8(21);
+
+    data.num_sv = frame.u8(23);
+    data.lon_e7 = frame.i32(24);
+    data.lat_e7 = frame.i32(28);
+    data.height = frame.i32(32);
+    data.hMSL = frame.i32(36);
+    data.hAcc = frame.u32(40);
+    data.vAcc = frame.u32(44);
+    data.velN = frame.i32(48);
+    data.velE = frame.i32(52);
+    data.velD = frame.i32(56);
+    data.gSpeed = frame.i32(60);
+    data.heading = frame.i32(64);
+    data.sAcc = frame.u32(68);
+    data.headingAcc = frame.u32(72);
+    data.pdop = frame.u16(76);
+
     // Convert GPS time to Unix time
     data.unix_time = utils::gps_to_unix_time(year, month, day, hour, min, sec);
-    
+    data.utc_nano = frame.i32(16);
+    if ((frame.u8(11) & 0x03) == 0x03) {        // validDate, validTime
+        set_time_reference(data.unix_time, data.utc_nano);
+    }
+
     // Check fix validity
     data.valid = (fix_type >= 2) && (flags & 0x01);
-    
-    return true;
 }
 
-bool GpsDriver::parse_nmea_sentence(const char* sentence) {
-    if (!sentence || sentence[0] != '$') return false;
-    
-    // Verify checksum
-    if (!utils::verify_nmea_checksum(sentence)) return false;
-    
-    if (std::strncmp(sentence, "$GPGGA", 6) == 0 || std::strncmp(sentence, "$GNGGA", 6) == 0) {
-        return parse_gga(sentence);
-    } else if (std::strncmp(sentence, "$GPRMC", 6) == 0 || std::strncmp(sentence, "$GNRMC", 6) == 0) {
-        return parse_rmc(sentence);
-    } else if (std::strncmp(sentence, "$GPVTG", 6) == 0 || std::strncmp(sentence, "$GNVTG", 6) == 0) {
-        return parse_vtg(sentence);
+// 8-byte header, then 12 bytes per satellite: gnssId, svId, cno, elev,
+// azim, prRes, flags (bit 3: used for navigation)
+void GpsDriver::on_nav_sat(const ubx::Frame& frame) {
+    size_t count = std::min<size_t>(frame.u8(5), (frame.length - 8u) / 12u);
+    uint8_t tracked = 0, used = 0;
+    uint32_t cno_sum = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t sv = 8 + 12 * i;
+        uint8_t cno = frame.u8(sv + 2);
+        if (cno) tracked++;
+        if (frame.u32(sv + 8) & 0x08) {
+            used++;
+            cno_sum += cno;
+        }
     }
-    
-    return false;
+    data.sats_tracked = tracked;
+    data.cno_mean = used ? static_cast<uint8_t>(cno_sum / used) : 0;
 }
 
-bool GpsDriver::parse_gga(const char* sentence) {
-    char field[32];
-    
-    // Field 2,3: Latitude
-    if (utils::extract_nmea_field(sentence, 2, field, sizeof(field)) && field[0]) {
-        char dir[2];
-        if (utils::extract_nmea_field(sentence, 3, dir, sizeof(dir))) {
-            data.lat = utils::parse_nmea_coordinate(field, dir[0]);
-        }
+void GpsDriver::on_nav_dop(const ubx::Frame& frame) {
+    data.pdop = frame.u16(6);
+    data.vdop = frame.u16(10);
+    data.hdop = frame.u16(12);
+}
+
+void GpsDriver::on_nav_timeutc(const ubx::Frame& frame) {
+    uint8_t valid = frame.u8(19);
+    data.utc_valid = (valid & 0x04);            // validUTC
+    if (!data.utc_valid) return;
+
+    data.utc_nano = frame.i32(8);
+    data.unix_time = utils::gps_to_unix_time(frame.u16(12), frame.u8(14), frame.u8(15),
+                                             frame.u8(16), frame.u8(17), frame.u8(18));
+    set_time_reference(data.unix_time, data.utc_nano);
+}
+
+void GpsDriver::on_ack(const ubx::Frame& frame) {
+    if (request.active && frame.u8(0) == request.cls && frame.u8(1) == request.id) {
+        request.acked = (frame.id == ubx::ACK_ACK);
+        request.naked = (frame.id == ubx::ACK_NAK);
     }
-    
-    // Field 4,5: Longitude
-    if (utils::extract_nmea_field(sentence, 4, field, sizeof(field)) && field[0]) {
-        char dir[2];
-        if (utils::extract_nmea_field(sentence, 5, dir, sizeof(dir))) {
-            data.lon = utils::parse_nmea_coordinate(field, dir[0]);
-        }
+}
+
+bool GpsDriver::parse_nmea_sentence(const char* line, size_t len) {
+    // Split and checksum in one pass
+    nmea::Sentence sentence;
+    if (!sentence.tokenize(line, len)) {
+        checksum_errors++;
+        return false;
     }
-    
+    nmea_sentences++;
+
+    std::string_view type = sentence.type();
+    if (type == "GGA") return parse_gga(sentence);
+    if (type == "RMC") return parse_rmc(sentence);
+    if (type == "VTG") return parse_vtg(sentence);
+    return false;
+}
+
+// Fields that are empty (no fix yet) leave the previous value in place
+bool GpsDriver::parse_gga(const nmea::Sentence& s) {
+    // Fields 2-5: Latitude, longitude
+    nmea::parse_coordinate(s.field(2), s.field(3), data.lat_e7);
+    nmea::parse_coordinate(s.field(4), s.field(5), data.lon_e7);
+
     // Field 6: Fix quality
-    if (utils::extract_nmea_field(sentence, 6, field, sizeof(field))) {
-        int fix = std::atoi(field);
-        data.valid = (fix >= 1);
-    }
-    
-    // Field 9,10: Altitude (MSL)
-    if (utils::extract_nmea_field(sentence, 9, field, sizeof(field)) && field[0]) {
-        double alt = std::atof(field);
-        data.hMSL = static_cast<int32_t>(alt * 1000);
+    std::string_view quality = s.field(6);
+    data.valid = quality.size() == 1 && quality[0] >= '1' && quality[0] <= '9';
+
+    // Field 7, 8: Satellites used, HDOP
+    int32_t value;
+    if (nmea::parse_fixed<0>(s.field(7), value)) data.num_sv = static_cast<uint8_t>(value);
+    if (nmea::parse_fixed<2>(s.field(8), value)) data.hdop = static_cast<uint16_t>(value);
+
+    // Field 9: Altitude (MSL)
+    if (nmea::parse_fixed<3>(s.field(9), data.hMSL)) {
         data.height = data.hMSL;  // Approximation
     }
-    
+
     return true;
 }
 
-bool GpsDriver::parse_rmc(const char* sentence) {
-    char field[32];
-    
-    // Field 1: Time (HHMMSS.sss)
-    uint8_t hour = 0, min = 0, sec = 0;
-    if (utils::extract_nmea_field(sentence, 1, field, sizeof(field)) && field[0]) {
-        hour = (field[0] - '0') * 10 + (field[1] - '0');
-        min = (field[2] - '0') * 10 + (field[3] - '0');
-        sec = (field[4] - '0') * 10 + (field[5] - '0');
-    }
-    
-    // Field 9: Date (DDMMYY)
-    uint8_t day = 0, month = 0;
-    uint16_t year = 0;
-    if (utils::extract_nmea_field(sentence, 9, field, sizeof(field)) && field[0]) {
-        day = (field[0] - '0') * 10 + (field[1] - '0');
-        month = (field[2] - '0') * 10 + (field[3] - '0');
-        year = 2000 + (field[4] - '0') * 10 + (field[5] - '0');
-        
+bool GpsDriver::parse_rmc(const nmea::Sentence& s) {
+    // Field 1, 9: Time (hhmmss.ss), date (ddmmyy)
+    uint8_t hour, min, sec, day, month;
+    uint16_t year;
+    if (nmea::parse_time(s.field(1), hour, min, sec) && nmea::parse_date(s.field(9), year, month, day)) {
         data.unix_time = utils::gps_to_unix_time(year, month, day, hour, min, sec);
+
+        // Fraction of the second after "hhmmss"
+        int32_t ms = 0;
+        std::string_view time = s.field(1);
+        if (time.size() > 6) nmea::parse_fixed<3>(time.substr(6), ms);
+        data.utc_nano = ms * 1'000'000;
+        set_time_reference(data.unix_time, data.utc_nano);
     }
-    
+
     // Field 7: Speed in knots
-    if (utils::extract_nmea_field(sentence, 7, field, sizeof(field)) && field[0]) {
-        double knots = std::atof(field);
-        data.gSpeed = static_cast<int32_t>(knots * 514.444);  // knots to mm/s
-    }
-    
+    nmea::parse_knots_mm_s(s.field(7), data.gSpeed);
+
     // Field 8: Course
-    if (utils::extract_nmea_field(sentence, 8, field, sizeof(field)) && field[0]) {
-        double course = std::atof(field);
-        data.heading = static_cast<int32_t>(course * 1e5);
-    }
-    
+    nmea::parse_fixed<5>(s.field(8), data.heading);
+
     return true;
 }
 
-bool GpsDriver::parse_vtg(const char* sentence) {
-    char field[32];
-    
+bool GpsDriver::parse_vtg(const nmea::Sentence& s) {
     // Field 1: Course
-    if (utils::extract_nmea_field(sentence, 1, field, sizeof(field)) && field[0]) {
-        double course = std::atof(field);
-        data.heading = static_cast<int32_t>(course * 1e5);
-    }
-    
+    nmea::parse_fixed<5>(s.field(1), data.heading);
+
     // Field 7: Speed in km/h
-    if (utils::extract_nmea_field(sentence, 7, field, sizeof(field)) && field[0]) {
-        double kmh = std::atof(field);
-        data.gSpeed = static_cast<int32_t>(kmh * 277.778);  // km/h to mm/s
-    }
-    
+    nmea::parse_kmh_mm_s(s.field(7), data.gSpeed);
+
     return true;
 }
 
-void GpsDriver::set_led_enabled(bool enabled) {
+// CFG-TP5, timepulse 0: a PPS_PULSE_US pulse rising at the top of each UTC
+// second once locked to GNSS time, and no pulse before that (a free-running
+// pulse would be labelled with the wrong second). The same pin lights the
+// module LED, so disabling it also turns the LED off.
+void GpsDriver::timepulse_config(bool enabled, uint8_t (&tp5)[32]) {
+    // active, lockGnssFreq, lockedOtherSet, isLength, alignToTow, rising
+    uint32_t flags = enabled ? 0x77 : 0x00;
+    uint32_t period_us = 1'000'000;
+    uint32_t pulse_us = enabled ? config::gps::PPS_PULSE_US : 0;
 
-    uint8_t cfg_tp5_enable[] = {
-        0xB5, 0x62, 0x06, 0x31, 0x20, 0x00, 0x00, 0x01,
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x42,
-        0x0F, 0x00, 0x00, 0x00, 0x00, 0x00, 0xA0, 0x86, 
-        0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x11, 0x0E
+    memset(tp5, 0, sizeof(tp5));
+    tp5[0] = 0;                                 // tpIdx: TIMEPULSE
+    tp5[1] = 1;                                 // version
+    auto put_u32 = [&](size_t at, uint32_t value) {
+        for (size_t i = 0; i < 4; i++) tp5[at + i] = static_cast<uint8_t>(value >> (8 * i));
     };
+    put_u32(8, period_us);                      // freqPeriod (no lock)
+    put_u32(12, period_us);                     // freqPeriodLock
+    put_u32(16, 0);                             // pulseLenRatio (no lock): no pulse
+    put_u32(20, pulse_us);                      // pulseLenRatioLock
+    put_u32(28, flags);
+}
 
-    uint8_t cfg_tp5_disable[] = {
-        0xB5, 0x62, 0x06, 0x31, 0x20, 0x00, 0x00, 0x01,
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x99, 0x7B
-    };
-    
-    uint8_t cfg_tp5[40] = {};
-    memcpy(cfg_tp5, (enabled ? cfg_tp5_enable : cfg_tp5_disable), 40);
-
-    // Calculate UBX checksum
-    uint8_t ck_a = 0, ck_b = 0;
-    for (size_t i = 2; i < sizeof(cfg_tp5) - 2; i++) {
-        ck_a += cfg_tp5[i];
-        ck_b += ck_a;
-    }
-    cfg_tp5[sizeof(cfg_tp5) - 2] = ck_a;
-    cfg_tp5[sizeof(cfg_tp5) - 1] = ck_b;
-    
-    // Send the configuration message
-    uart_write_blocking(uart, cfg_tp5, sizeof(cfg_tp5));
-    sleep_ms(50);
+bool GpsDriver::set_timepulse_enabled(bool enabled) {
+    if (!uart || boot.phase != InitPhase::DONE || request.active) return false;
+
+    uint8_t tp5[32];
+    timepulse_config(enabled, tp5);
+    begin_transact(ubx::CFG, ubx::CFG_TP5, tp5, sizeof(tp5), reply_timeout_ms());
+    timepulse_pending = request.active;
+    return timepulse_pending;
 }
 
-} // namespace drivers
\ No newline at end of file
+} // namespace drivers
@@ -3,13 +3,22 @@
 // Project Omni-Header
 #include "config/all_headers.h"
 
+#include "config/config.h"
+#include "drivers/init_step.h"
+#include "drivers/timestamp.h"
+#include "disciplined_clock.h"
+#include "pps_capture.h"
+#include "uart_rx.h"
+#include "nmea_parser.h"
+#include "ubx_parser.h"
+
 namespace drivers {
 
 struct GpsData {
     bool valid = false;
     uint32_t unix_time = 0;     // Unix epoch seconds
-    double lon = 0;             // degrees
-    double lat = 0;             // degrees
+    int32_t lon_e7 = 0;         // degrees * 1e7
+    int32_t lat_e7 = 0;         // degrees * 1e7
     int32_t height = 0;         // mm above ellipsoid
     int32_t hMSL = 0;           // mm above mean sea level
     uint32_t hAcc = 0;          // mm horizontal accuracy
@@ -18,38 +27,162 @@ struct GpsData {
     int32_t velE = 0;           // mm/s east
     int32_t velD = 0;           // mm/s down
     int32_t gSpeed = 0;         // mm/s ground speed
-    float heading = 0;          // degrees * 1e5
+    int32_t heading = 0;        // degrees * 1e5
     uint32_t sAcc = 0;          // mm/s speed accuracy
     uint32_t headingAcc = 0;    // degrees * 1e5 heading accuracy
+    uint8_t num_sv = 0;         // satellites used in the solution
+    uint8_t sats_tracked = 0;   // satellites with signal (NAV-SAT)
+    uint8_t cno_mean = 0;       // dBHz mean C/N0 of the used satellites (NAV-SAT)
+    uint16_t pdop = 0;          // position DOP * 100
+    uint16_t hdop = 0;          // horizontal DOP * 100 (NAV-DOP)
+    uint16_t vdop = 0;          // vertical DOP * 100 (NAV-DOP)
+    bool utc_valid = false;     // UTC fully resolved (NAV-TIMEUTC)
+    int32_t utc_nano = 0;       // ns fraction of unix_time, -1e9..1e9
+    Timestamp time;             // navigation epoch in boot µs; latency: epoch to parse
 };
 
+using GpsClock = DisciplinedClock<config::gps::CLOCK_LOCK_PULSES, config::gps::CLOCK_OUTLIER_US,
+                                   config::gps::CLOCK_HOLDOVER_S>;
+
 class GpsDriver {
+public:
+    struct Stats {
+        UartRx::Stats rx;
+        uint32_t ubx_frames = 0;        // Checksum-verified UBX frames
+        uint32_t nmea_sentences = 0;    // Checksum-verified NMEA sentences
+        uint32_t checksum_errors = 0;
+    };
+
 private:
-    static constexpr size_t BUFFER_SIZE = 512;
     uart_inst_t* uart = nullptr;
-    uint8_t buffer[BUFFER_SIZE];
-    size_t buf_pos = 0;
+    uint baud = 0;
+    UartRx rx;
+    ubx::Parser parser;
+    uint32_t nmea_sentences = 0;
+    uint32_t checksum_errors = 0;           // NMEA
     GpsData data;
+
+    // Time: the latest GPS time message and when it was parsed label the
+    // timepulses, which discipline the clock
+    PpsCapture pps;
+    GpsClock clock;
+    bool time_known = false;
+    int64_t time_utc_us = 0;
+    uint64_t time_rx_us = 0;
     bool use_ubx = false;
     
     // NMEA parsing state
     char nmea_line[256];
     size_t nmea_pos = 0;
+
+    // Outgoing UBX bytes, moved into the 32-character TX FIFO as it has
+    // room each time the driver is polled, so sending never waits on the line
+    uint8_t tx_queue[128];
+    size_t tx_len = 0;
+    size_t tx_sent = 0;
+
+    // UBX request in flight (configuration): its ACK and poll reply
+    enum class Reply : uint8_t { PENDING, TIMEOUT, ACK, NAK };
+    struct Request {
+        bool active = false;
+        uint8_t cls = 0;
+        uint8_t id = 0;
+        bool acked = false;
+        bool naked = false;
+        bool replied = false;
+        uint8_t reply[32];
+        size_t reply_len = 0;
+        uint64_t deadline_us = 0;
+    };
+    Request request;
+    bool timepulse_pending = false;         // set_timepulse_enabled() awaiting its ACK
+
+    // UBX configuration, stepped by init_step(): one exchange in flight at
+    // a time, each phase handling the reply to its own
+    enum class InitPhase : uint8_t {
+        SETTLE, BAUD_DRAIN, BAUD_SETTLE, PROBE, BAUD_SET, BAUD_CONFIRM,
+        MESSAGE_POLL, MESSAGE_SET, RATE_POLL, RATE_SET, TIMEPULSE, DONE
+    };
+    struct Bringup {
+        InitPhase phase = InitPhase::DONE;
+        uint64_t settle_until_us = 0;
+        size_t index = 0;               // Baud rate candidate, then output message
+        uint found_baud = 0;
+        uint next_baud = 0;             // Baud rate change in progress
+        InitPhase after_baud = InitPhase::DONE;
+        uint8_t rate[6] = {};           // CFG-RATE payload
+        bool ok = false;
+    };
+    Bringup boot;
+
+    struct MessageRate { uint8_t cls, id, rate; };
+    static constexpr size_t MESSAGE_COUNT = 10;
+    MessageRate message_rate(size_t i) const;
+    void on_init_reply(Reply reply);
+    void probe_baud();
+    void next_message();
+    void set_message_rate(const MessageRate& m);
+    void set_nav_rate();
+    void nav_rate_done(bool ok);
+    void finish_init(bool ok);
+
+    void change_baud(uint rate, InitPhase then);
+    void baud_changed();
+    uint32_t reply_timeout_ms() const;
+    void begin_transact(uint8_t cls, uint8_t id, const uint8_t* payload, uint16_t len, uint32_t timeout_ms);
+    Reply poll_transact();
+    bool send_ubx(uint8_t cls, uint8_t id, const uint8_t* payload, uint16_t len);
+    bool pump_tx();
+    static void timepulse_config(bool enabled, uint8_t (&tp5)[32]);
     
+    // UBX dispatch: sorted by (class, id), checked at compile time
+    struct UbxHandler {
+        uint8_t cls;
+        uint8_t id;
+        uint16_t min_length;
+        void (GpsDriver::*handle)(const ubx::Frame&);
+    };
+    static const std::array<UbxHandler, 6> UBX_HANDLERS;
+
     // Parsing functions
-    bool parse_nav_pvt(const uint8_t* payload, size_t len);
-    bool parse_nmea_sentence(const char* sentence);
-    bool parse_gga(const char* sentence);
-    bool parse_rmc(const char* sentence);
-    bool parse_vtg(const char* sentence);
+    void drain();
+    void parse_nmea_byte(uint8_t byte);
+    void handle_ubx(const ubx::Frame& frame);
+    void on_nav_pvt(const ubx::Frame& frame);
+    void on_nav_sat(const ubx::Frame& frame);
+    void on_nav_dop(const ubx::Frame& frame);
+    void on_nav_timeutc(const ubx::Frame& frame);
+    void on_ack(const ubx::Frame& frame);
+    void set_time_reference(uint32_t unix_time, int32_t nano);
+    void discipline_clock();
+    bool parse_nmea_sentence(const char* line, size_t len);
+    bool parse_gga(const nmea::Sentence& s);
+    bool parse_rmc(const nmea::Sentence& s);
+    bool parse_vtg(const nmea::Sentence& s);
     
 public:
     bool init(uart_inst_t* u, uint rx_pin, uint tx_pin, bool ubx_protocol = true);
+    void begin_init(uart_inst_t* u, uint rx_pin, uint tx_pin, bool ubx_protocol = true);
+    InitStep init_step(uint64_t now_us);        // After begin_init(), until it is done
     bool update();
     const GpsData& get_data() const { return data; }
     void clear() { data.valid = false; }
     void reset() { data = GpsData(); }
-    void set_led_enabled(bool enabled);
+
+    // Starts a CFG-TP5 change; update() completes it and reports the
+    // outcome. False during bring-up or while another exchange is in flight.
+    bool set_timepulse_enabled(bool enabled);
+    bool timepulse_busy() const { return timepulse_pending; }
+
+    // UTC µs since the Unix epoch for a time_us_64() stamp (0 while unknown)
+    int64_t utc_us(uint64_t boot_us) const { return clock.utc_us(boot_us); }
+    const GpsClock& get_clock() const { return clock; }
+    PpsCapture::Stats get_pps_stats() const { return pps.get_stats(); }
+
+    Stats get_stats() const {
+        const auto& ubx_stats = parser.get_stats();
+        return {rx.get_stats(), ubx_stats.frames, nmea_sentences, ubx_stats.checksum_errors + checksum_errors};
+    }
 };
 
 } // namespace drivers
\ No newline at end of file
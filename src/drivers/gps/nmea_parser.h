@@ -0,0 +1,196 @@
+#pragma once
+
+// NOTE: Pico SDK free so it can be benchmarked on the host.
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace drivers::nmea {
+
+// ============================================
+// NMEA Sentence Tokenizer
+// ============================================
+// One pass over "$<fields>*hh": commas are recorded as field boundaries
+// while the XOR checksum accumulates, so a sentence is split and verified
+// without re-scanning it per field. Fields are views into the line.
+class Sentence {
+public:
+    static constexpr size_t MAX_FIELDS = 32;    // GSV carries 20
+
+    // False when the line is malformed or the checksum does not match. A
+    // trailing CR/LF after the checksum is ignored.
+    bool tokenize(const char* line, size_t len) {
+        count = 0;
+        if (len < 4 || line[0] != '$') return false;
+
+        uint8_t sum = 0;
+        size_t fields = 0;
+        bounds[0] = 1;
+        size_t i = 1;
+        for (; i < len; i++) {
+            char c = line[i];
+            if (c == '*') break;
+            if (static_cast<uint8_t>(c) < 0x20 || c == '$') return false;   // Line break lost in transit
+            if (c == ',') {
+                if (++fields == MAX_FIELDS) return false;
+                bounds[fields] = static_cast<uint16_t>(i + 1);
+            }
+            sum ^= static_cast<uint8_t>(c);
+        }
+        if (i + 2 >= len) return false;                                     // No "*hh"
+
+        int hi = hex(line[i + 1]);
+        int lo = hex(line[i + 2]);
+        if (hi < 0 || lo < 0 || sum != ((hi << 4) | lo)) return false;
+
+        bounds[fields + 1] = static_cast<uint16_t>(i + 1);
+        count = fields + 1;
+        text = line;
+        return true;
+    }
+
+    size_t size() const { return count; }
+
+    // Field 0 is the address ("GPGGA"); missing fields are empty
+    std::string_view field(size_t index) const {
+        if (index >= count) return {};
+        return {text + bounds[index], static_cast<size_t>(bounds[index + 1] - 1 - bounds[index])};
+    }
+
+    // Sentence formatter without the talker ("GGA" for $GPGGA and $GNGGA)
+    std::string_view type() const {
+        std::string_view address = field(0);
+        return address.size() == 5 ? address.substr(2) : address;
+    }
+
+private:
+    const char* text = nullptr;
+    uint16_t bounds[MAX_FIELDS + 1];            // Start of each field, plus one past the last
+    size_t count = 0;
+
+    static int hex(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    }
+};
+
+// ============================================
+// Fixed-Point Field Parsers
+// ============================================
+// No floating point: decimals become integers at a fixed scale, rounded
+// half away from zero at the last kept digit. All return false for an
+// empty or malformed field and leave the output alone.
+
+// "[-]123.456" * 10^Decimals
+template<unsigned Decimals>
+inline bool parse_fixed(std::string_view s, int32_t& out) {
+    bool negative = !s.empty() && s[0] == '-';
+    if (negative || (!s.empty() && s[0] == '+')) s.remove_prefix(1);
+    if (s.empty()) return false;
+
+    int64_t value = 0;
+    unsigned whole = 0, decimals = 0;
+    bool point = false, digits = false, round_up = false;
+    for (char c : s) {
+        if (c == '.' && !point) {
+            point = true;
+            continue;
+        }
+        if (c < '0' || c > '9') return false;
+        digits = true;
+        if (!point) {
+            if (++whole > 9) return false;
+            value = value * 10 + (c - '0');
+        } else if (decimals < Decimals) {
+            value = value * 10 + (c - '0');
+            decimals++;
+        } else if (decimals == Decimals) {
+            round_up = (c >= '5');
+            decimals++;
+        }
+    }
+    if (!digits) return false;
+    for (; decimals < Decimals; decimals++) value *= 10;
+    if (round_up) value++;
+    if (value > INT32_MAX) return false;
+
+    out = static_cast<int32_t>(negative ? -value : value);
+    return true;
+}
+
+// "dddmm.mmmmm" plus hemisphere to degrees * 1e7
+inline bool parse_coordinate(std::string_view value, std::string_view hemisphere, int32_t& out_e7) {
+    size_t point = value.find('.');
+    if (point == std::string_view::npos) point = value.size();
+    if (point < 3 || point > 5 || hemisphere.size() != 1) return false;
+
+    int32_t degrees = 0;
+    for (char c : value.substr(0, point - 2)) {
+        if (c < '0' || c > '9') return false;
+        degrees = degrees * 10 + (c - '0');
+    }
+
+    int32_t minutes_e7;
+    if (!parse_fixed<7>(value.substr(point - 2), minutes_e7) || minutes_e7 < 0 || minutes_e7 >= 600'000'000) {
+        return false;
+    }
+
+    int32_t e7 = degrees * 10'000'000 + (minutes_e7 + 30) / 60;
+    switch (hemisphere[0]) {
+        case 'N': case 'E': break;
+        case 'S': case 'W': e7 = -e7; break;
+        default: return false;
+    }
+    if (e7 > 1'800'000'000 || e7 < -1'800'000'000) return false;
+
+    out_e7 = e7;
+    return true;
+}
+
+// Two decimal digits at s[at]
+inline bool parse_2digits(std::string_view s, size_t at, uint8_t& out) {
+    if (s.size() < at + 2 || s[at] < '0' || s[at] > '9' || s[at + 1] < '0' || s[at + 1] > '9') return false;
+    out = static_cast<uint8_t>((s[at] - '0') * 10 + (s[at + 1] - '0'));
+    return true;
+}
+
+// "hhmmss[.ss]"
+inline bool parse_time(std::string_view s, uint8_t& hour, uint8_t& min, uint8_t& sec) {
+    uint8_t h, m, c;
+    if (!parse_2digits(s, 0, h) || !parse_2digits(s, 2, m) || !parse_2digits(s, 4, c)) return false;
+    if (h > 23 || m > 59 || c > 60) return false;
+    hour = h;
+    min = m;
+    sec = c;
+    return true;
+}
+
+// "ddmmyy" (years 2000-2099)
+inline bool parse_date(std::string_view s, uint16_t& year, uint8_t& month, uint8_t& day) {
+    uint8_t d, m, y;
+    if (s.size() != 6 || !parse_2digits(s, 0, d) || !parse_2digits(s, 2, m) || !parse_2digits(s, 4, y)) return false;
+    if (d < 1 || d > 31 || m < 1 || m > 12) return false;
+    year = static_cast<uint16_t>(2000 + y);
+    month = m;
+    day = d;
+    return true;
+}
+
+// Speeds in mm/s from the knots and km/h fields (three decimals kept)
+inline bool parse_knots_mm_s(std::string_view s, int32_t& mm_s) {
+    int32_t knots_e3;
+    if (!parse_fixed<3>(s, knots_e3)) return false;
+    mm_s = static_cast<int32_t>((static_cast<int64_t>(knots_e3) * 1852 + 1800) / 3600);   // 1 kn = 1852 m/h
+    return true;
+}
+
+inline bool parse_kmh_mm_s(std::string_view s, int32_t& mm_s) {
+    int32_t kmh_e3;
+    if (!parse_fixed<3>(s, kmh_e3)) return false;
+    mm_s = static_cast<int32_t>((static_cast<int64_t>(kmh_e3) * 10 + 18) / 36);
+    return true;
+}
+
+} // namespace drivers::nmea
@@ -0,0 +1,85 @@
+#pragma once
+
+// Project Omni-Header
+#include "config/all_headers.h"
+#include "config/config.h"
+
+// Project
+#include "drivers/gpio_irq.h"
+
+namespace drivers {
+
+// ============================================
+// Timepulse (PPS) Edge Capture
+// ============================================
+// The receiver's timepulse rises at the top of every UTC second. The GPIO
+// edge IRQ stamps it with time_us_64() before anything else runs, so the
+// stamp is off only by the interrupt entry latency (well under a
+// microsecond at 150 MHz); the consumer picks the stamps up whenever it
+// runs. The edge IRQ is taken on the core that calls start().
+class PpsCapture {
+public:
+    static constexpr size_t QUEUE_SIZE = 8;     // Seconds the consumer may fall behind
+
+    struct Stats {
+        uint32_t edges = 0;
+        uint32_t dropped = 0;                   // Queue full
+    };
+
+    bool start(uint pin) {
+        gpio_init(pin);
+        gpio_set_dir(pin, GPIO_IN);
+        gpio_pull_down(pin);
+        if (!GpioIrq::attach(pin, GPIO_IRQ_EDGE_RISE, on_edge, this)) return false;
+        _pin = pin;
+        _started = true;
+        return true;
+    }
+
+    void stop() {
+        if (!_started) return;
+        GpioIrq::detach(_pin, GPIO_IRQ_EDGE_RISE);
+        _started = false;
+    }
+
+    // Oldest unread edge timestamp (boot µs)
+    bool pop(uint64_t& boot_us) {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) return false;
+        boot_us = _stamps[tail % QUEUE_SIZE];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    Stats get_stats() const {
+        uint32_t status = save_and_disable_interrupts();
+        Stats copy = _stats;
+        restore_interrupts(status);
+        return copy;
+    }
+
+private:
+    uint _pin = 0;
+    bool _started = false;
+    uint64_t _stamps[QUEUE_SIZE];
+    std::atomic<uint32_t> _head{0};             // IRQ
+    std::atomic<uint32_t> _tail{0};             // Consumer
+    Stats _stats;
+
+    static void on_edge(void* context, uint, uint32_t events) {
+        uint64_t now = time_us_64();
+        auto* self = static_cast<PpsCapture*>(context);
+        if (!(events & GPIO_IRQ_EDGE_RISE)) return;
+
+        self->_stats.edges++;
+        uint32_t head = self->_head.load(std::memory_order_relaxed);
+        if (head - self->_tail.load(std::memory_order_acquire) >= QUEUE_SIZE) {
+            self->_stats.dropped++;
+            return;
+        }
+        self->_stamps[head % QUEUE_SIZE] = now;
+        self->_head.store(head + 1, std::memory_order_release);
+    }
+};
+
+} // namespace drivers
@@ -0,0 +1,156 @@
+#pragma once
+
+// Project Omni-Header
+#include "config/all_headers.h"
+#include "config/config.h"
+
+namespace drivers {
+
+// ============================================
+// Interrupt-Driven UART Receiver
+// ============================================
+// The RX FIFO is 32 characters deep, which at 460800 baud is under 0.7 ms
+// of data. The RX level/timeout interrupt moves every character into a
+// RING_SIZE byte ring as it arrives, so the consumer only has to keep up on
+// average and can take the buffered bytes in contiguous spans.
+//
+// Each UARTDR read carries the character's error flags: FIFO overruns (a
+// loss before the IRQ got to the FIFO), framing/parity errors and breaks
+// are counted, bytes that arrived damaged are discarded, and characters
+// that find the ring full are counted as dropped.
+//
+// One IRQ producer, one consumer on the same core; the indices are
+// free-running and each side writes only its own.
+class UartRx {
+public:
+    static constexpr size_t RING_SIZE = config::gps::RX_RING_SIZE;
+    static_assert(std::has_single_bit(RING_SIZE), "Ring size must be a power of two");
+
+    struct Stats {
+        uint32_t bytes = 0;             // Characters stored in the ring
+        uint32_t irqs = 0;
+        uint32_t overruns = 0;          // RX FIFO overflowed before the IRQ ran
+        uint32_t framing_errors = 0;
+        uint32_t parity_errors = 0;
+        uint32_t breaks = 0;
+        uint32_t dropped = 0;           // Ring full (consumer too slow)
+        uint32_t high_water = 0;        // Most bytes waiting in the ring
+    };
+
+    ~UartRx() { stop(); }
+
+    bool start(uart_inst_t* uart) {
+        uint index = uart_get_index(uart);
+        if (active[index] && active[index] != this) return false;
+
+        _uart = uart;
+        active[index] = this;
+        uart_set_fifo_enabled(uart, true);
+
+        // Drop whatever queued up before the handler existed
+        while (uart_is_readable(uart)) {
+            uart_getc(uart);
+        }
+
+        uint irq = UART_IRQ_NUM(uart);
+        irq_set_exclusive_handler(irq, index ? on_irq<1> : on_irq<0>);
+        irq_set_enabled(irq, true);
+        uart_set_irq_enables(uart, true, false);
+        return true;
+    }
+
+    void stop() {
+        if (!_uart) return;
+        uint index = uart_get_index(_uart);
+        uart_set_irq_enables(_uart, false, false);
+        irq_set_enabled(UART_IRQ_NUM(_uart), false);
+        active[index] = nullptr;
+        _uart = nullptr;
+    }
+
+    // Free-running indices: bytes [read_index, write_index) are unread and
+    // stay put until released, so a parser can look back into them
+    uint32_t read_index() const { return _tail.load(std::memory_order_relaxed); }
+    uint32_t write_index() const { return _head.load(std::memory_order_acquire); }
+
+    // Contiguous run of [from, to), cut short at the ring's wrap point
+    std::span<const uint8_t> span(uint32_t from, uint32_t to) const {
+        uint32_t offset = from & MASK;
+        return {_ring + offset, std::min<size_t>(to - from, RING_SIZE - offset)};
+    }
+
+    // Hands everything before `to` back to the IRQ
+    void release(uint32_t to) {
+        _tail.store(to, std::memory_order_release);
+    }
+
+    // Drops everything received so far
+    void discard() { release(write_index()); }
+
+    size_t available() const {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_relaxed);
+    }
+
+    void reset_stats() {
+        uint32_t status = save_and_disable_interrupts();
+        _stats = {};
+        restore_interrupts(status);
+    }
+
+    Stats get_stats() const {
+        uint32_t status = save_and_disable_interrupts();
+        Stats copy = _stats;
+        restore_interrupts(status);
+        return copy;
+    }
+
+private:
+    static constexpr uint32_t MASK = RING_SIZE - 1;
+
+    static inline UartRx* active[2] = {};
+
+    uart_inst_t* _uart = nullptr;
+    uint8_t _ring[RING_SIZE];
+    std::atomic<uint32_t> _head{0};     // IRQ
+    std::atomic<uint32_t> _tail{0};     // Consumer
+    Stats _stats;
+
+    template<uint Index>
+    static void on_irq() {
+        if (active[Index]) active[Index]->service();
+    }
+
+    // IRQ: empty the FIFO, which also clears the level/timeout interrupt
+    void service() {
+        uart_hw_t* hw = uart_get_hw(_uart);
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        uint32_t tail = _tail.load(std::memory_order_acquire);
+        _stats.irqs++;
+
+        while (!(hw->fr & UART_UARTFR_RXFE_BITS)) {
+            uint32_t dr = hw->dr;
+            if (dr & UART_UARTDR_OE_BITS) _stats.overruns++;
+            if (dr & UART_UARTDR_BE_BITS) {
+                _stats.breaks++;
+                continue;
+            }
+            if (dr & (UART_UARTDR_FE_BITS | UART_UARTDR_PE_BITS)) {
+                if (dr & UART_UARTDR_FE_BITS) _stats.framing_errors++;
+                if (dr & UART_UARTDR_PE_BITS) _stats.parity_errors++;
+                continue;
+            }
+            if (head - tail >= RING_SIZE) {
+                _stats.dropped++;
+                continue;
+            }
+            _ring[head & MASK] = static_cast<uint8_t>(dr);
+            head++;
+            _stats.bytes++;
+        }
+
+        _head.store(head, std::memory_order_release);
+        _stats.high_water = std::max(_stats.high_water, head - tail);
+    }
+};
+
+} // namespace drivers
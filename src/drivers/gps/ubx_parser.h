@@ -0,0 +1,249 @@
+#pragma once
+
+// NOTE: Pico SDK free so it can be fuzzed and benchmarked on the host.
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+namespace drivers::ubx {
+
+// ============================================
+// UBX Frame (zero-copy view)
+// ============================================
+// The payload stays where it was received. In a ring it can wrap, so it is
+// up to two spans; the accessors read little-endian fields across the
+// seam. Valid only inside the parser's frame callback.
+struct Frame {
+    uint8_t cls = 0;
+    uint8_t id = 0;
+    uint16_t length = 0;                    // Payload bytes
+    uint32_t offset = 0;                    // Buffer index of the 0xB5 sync byte
+    std::span<const uint8_t> first;
+    std::span<const uint8_t> second;
+
+    uint8_t u8(size_t off) const {
+        return off < first.size() ? first[off] : second[off - first.size()];
+    }
+    uint16_t u16(size_t off) const { return static_cast<uint16_t>(u8(off) | (u8(off + 1) << 8)); }
+    uint32_t u32(size_t off) const { return u16(off) | (static_cast<uint32_t>(u16(off + 2)) << 16); }
+    int8_t i8(size_t off) const { return static_cast<int8_t>(u8(off)); }
+    int16_t i16(size_t off) const { return static_cast<int16_t>(u16(off)); }
+    int32_t i32(size_t off) const { return static_cast<int32_t>(u32(off)); }
+
+    void copy(size_t off, void* dst, size_t n) const {
+        uint8_t* out = static_cast<uint8_t*>(dst);
+        for (size_t i = 0; i < n; i++) out[i] = u8(off + i);
+    }
+};
+
+// A receive buffer addressed by free-running 32-bit indices (UartRx, or a
+// plain array on the host). span() returns the contiguous run starting at
+// `from`, cut at `to` or at the buffer's wrap point; release() hands
+// everything before `to` back to the producer.
+template<typename T>
+concept ByteSource = requires(T& buf, uint32_t i) {
+    { buf.read_index() } -> std::convertible_to<uint32_t>;
+    { buf.write_index() } -> std::convertible_to<uint32_t>;
+    { buf.span(i, i) } -> std::convertible_to<std::span<const uint8_t>>;
+    buf.release(i);
+};
+
+// ============================================
+// Streaming UBX Parser
+// ============================================
+// State machine over the receive buffer: sync (B5 62), class, id, length,
+// payload, checksum. The Fletcher checksum is accumulated as bytes arrive
+// (whole contiguous runs at a time for the payload), so a frame is
+// verified the moment its last byte is in. Bytes of a frame in progress
+// are not released, which makes the payload spans handed to on_frame()
+// point into the buffer itself, and lets a frame that fails (bad checksum,
+// implausible length) be rescanned from the byte after its sync byte: a
+// corrupt or truncated frame never takes a good one behind it down too.
+//
+// Bytes outside frames (NMEA sentences, noise) go to on_other() in order,
+// each exactly once.
+class Parser {
+public:
+    static constexpr uint8_t SYNC_1 = 0xB5;
+    static constexpr uint8_t SYNC_2 = 0x62;
+    static constexpr uint16_t MAX_PAYLOAD = 1024;   // Longer is noise (NAV-SAT with 84 SVs is 1016)
+
+    struct Stats {
+        uint32_t frames = 0;
+        uint32_t checksum_errors = 0;
+        uint32_t oversize = 0;              // Length field above MAX_PAYLOAD
+        uint32_t other_bytes = 0;           // Handed to on_other()
+    };
+
+    // Parses everything the buffer holds. on_frame(const Frame&) gets each
+    // verified frame, on_other(std::span<const uint8_t>) the bytes between.
+    template<ByteSource Buffer, typename OnFrame, typename OnOther>
+    void parse(Buffer& buf, OnFrame&& on_frame, OnOther&& on_other) {
+        if (!resume) {
+            pos = buf.read_index();
+            resume = true;
+        }
+
+        uint32_t end = buf.write_index();
+        while (pos != end) {
+            if (state == State::SYNC_1) {
+                // Fast path: hand over everything up to the next sync byte
+                std::span<const uint8_t> run = buf.span(pos, end);
+                const void* hit = memchr(run.data(), SYNC_1, run.size());
+                size_t n = hit ? static_cast<size_t>(static_cast<const uint8_t*>(hit) - run.data()) : run.size();
+                if (n) {
+                    on_other(run.first(n));
+                    stats.other_bytes += n;
+                    pos += n;
+                }
+                if (hit) {
+                    start = pos++;
+                    state = State::SYNC_2;
+                }
+                continue;
+            }
+
+            if (state == State::PAYLOAD) {
+                std::span<const uint8_t> run = buf.span(pos, pos + std::min<uint32_t>(end - pos, length - received));
+                for (uint8_t byte : run) {
+                    ck_a += byte;
+                    ck_b += ck_a;
+                }
+                received += run.size();
+                pos += run.size();
+                if (received == length) state = State::CK_A;
+                continue;
+            }
+
+            uint8_t byte = buf.span(pos, pos + 1)[0];
+            pos++;
+
+            switch (state) {
+                case State::SYNC_2:
+                    if (byte == SYNC_2) {
+                        ck_a = ck_b = 0;
+                        state = State::CLASS;
+                    } else {
+                        resync(buf, on_other);
+                    }
+                    break;
+
+                case State::CLASS:
+                    cls = byte;
+                    checksum(byte);
+                    state = State::ID;
+                    break;
+
+                case State::ID:
+                    id = byte;
+                    checksum(byte);
+                    state = State::LENGTH_1;
+                    break;
+
+                case State::LENGTH_1:
+                    length = byte;
+                    checksum(byte);
+                    state = State::LENGTH_2;
+                    break;
+
+                case State::LENGTH_2:
+                    length |= static_cast<uint16_t>(byte << 8);
+                    checksum(byte);
+                    received = 0;
+                    if (length > MAX_PAYLOAD) {
+                        stats.oversize++;
+                        resync(buf, on_other);
+                    } else {
+                        state = length ? State::PAYLOAD : State::CK_A;
+                    }
+                    break;
+
+                case State::CK_A:
+                    if (byte == ck_a) {
+                        state = State::CK_B;
+                    } else {
+                        stats.checksum_errors++;
+                        resync(buf, on_other);
+                    }
+                    break;
+
+                case State::CK_B:
+                    if (byte == ck_b) {
+                        deliver(buf, on_frame);
+                    } else {
+                        stats.checksum_errors++;
+                        resync(buf, on_other);
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        // Keep a frame in progress; everything else can go
+        buf.release(state == State::SYNC_1 ? pos : start);
+    }
+
+    // Forget any frame in progress; the next parse() starts at the
+    // buffer's read index
+    void reset() {
+        state = State::SYNC_1;
+        resume = false;
+    }
+
+    const Stats& get_stats() const { return stats; }
+
+private:
+    enum class State : uint8_t { SYNC_1, SYNC_2, CLASS, ID, LENGTH_1, LENGTH_2, PAYLOAD, CK_A, CK_B };
+
+    State state = State::SYNC_1;
+    bool resume = false;
+    uint32_t pos = 0;                       // Next byte to examine
+    uint32_t start = 0;                     // Sync byte of the frame in progress
+    uint8_t cls = 0;
+    uint8_t id = 0;
+    uint16_t length = 0;
+    uint16_t received = 0;
+    uint8_t ck_a = 0;
+    uint8_t ck_b = 0;
+    Stats stats;
+
+    void checksum(uint8_t byte) {
+        ck_a += byte;
+        ck_b += ck_a;
+    }
+
+    // Not a frame after all: its sync byte is ordinary data, and scanning
+    // resumes right behind it
+    template<typename Buffer, typename OnOther>
+    void resync(Buffer& buf, OnOther& on_other) {
+        on_other(buf.span(start, start + 1));
+        stats.other_bytes++;
+        pos = start + 1;
+        state = State::SYNC_1;
+    }
+
+    template<typename Buffer, typename OnFrame>
+    void deliver(Buffer& buf, OnFrame& on_frame) {
+        Frame frame;
+        frame.cls = cls;
+        frame.id = id;
+        frame.length = length;
+        frame.offset = start;
+        uint32_t payload = start + 6;
+        frame.first = buf.span(payload, payload + length);
+        if (frame.first.size() < length) {
+            frame.second = buf.span(payload + static_cast<uint32_t>(frame.first.size()), payload + length);
+        }
+
+        stats.frames++;
+        on_frame(frame);
+        state = State::SYNC_1;
+    }
+};
+
+} // namespace drivers::ubx
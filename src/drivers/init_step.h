@@ -0,0 +1,43 @@
+#pragma once
+
+// Project Omni-Header
+#include "config/all_headers.h"
+
+namespace drivers {
+
+// ============================================
+// Stepwise Device Bring-up
+// ============================================
+// A driver's init_step(now_us) does whatever its bring-up can do right
+// now and returns at once: done, failed, or the time to be called again
+// (a reset to wait out, a reply still on its way). Nothing sleeps longer
+// than a register write or a UART rate change takes, so one loop brings
+// every device up at the same time and the slowest part sets the boot
+// time rather than the sum of them. Driver init() calls keep their
+// blocking behaviour through run().
+struct InitStep {
+    enum class State : uint8_t { PENDING, READY, FAILED };
+
+    State state = State::PENDING;
+    uint64_t next_us = 0;       // PENDING: call again at or after this time
+
+    static constexpr InitStep at(uint64_t us) { return {State::PENDING, us}; }
+    static constexpr InitStep ready() { return {State::READY, 0}; }
+    static constexpr InitStep failed() { return {State::FAILED, 0}; }
+    static constexpr InitStep done(bool ok) { return ok ? ready() : failed(); }
+
+    bool pending() const { return state == State::PENDING; }
+
+    // Blocking bring-up: steps until done, sleeping in between
+    template<typename Step>
+    static bool run(Step&& step) {
+        for (;;) {
+            uint64_t now = time_us_64();
+            InitStep s = step(now);
+            if (!s.pending()) return s.state == State::READY;
+            if (s.next_us > now) sleep_us(s.next_us - now);
+        }
+    }
+};
+
+} // namespace drivers
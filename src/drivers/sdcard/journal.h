@@ -0,0 +1,175 @@
+#pragma once
+
+// NOTE: Pico SDK free (FatFs + crc16 only) so the host tools and the
+// recovery test can use it as well.
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+extern "C" {
+    #include "ff.h"
+    #include "crc.h"
+}
+
+namespace drivers::journal {
+
+// ============================================
+// Journaled Block Format
+// ============================================
+// A journaled file is a sequence of 512-byte blocks, one per sector. Each
+// block starts with a BlockHeader followed by up to PAYLOAD_SIZE bytes of
+// the logical byte stream (file header + records). Only the last block of
+// the file may be partial.
+//
+// Blocks are tied to their file by a random file_id and to their position
+// by seq (block index), and protected by a crc16 over everything after the
+// crc field. Stale sectors left in a preallocated area by an older file can
+// therefore never validate, and the written part of a file is always a
+// valid prefix: after a power cut the true length is found by a binary
+// search for the first invalid block, without walking the card.
+static constexpr size_t BLOCK_SIZE = 512;
+static_assert(BLOCK_SIZE == FF_MAX_SS, "Journal blocks must match the sector size");
+
+struct __attribute__((packed)) BlockHeader {
+    uint16_t crc;           // crc16 over length..payload end
+    uint16_t length;        // Payload bytes in this block
+    uint32_t file_id;       // Random per file, never 0
+    uint32_t seq;           // Block index within the file
+};
+static_assert(sizeof(BlockHeader) == 12);
+
+static constexpr size_t HEADER_SIZE = sizeof(BlockHeader);
+static constexpr size_t PAYLOAD_SIZE = BLOCK_SIZE - HEADER_SIZE;
+
+// Fill in the header of a block whose payload is already in place
+inline void seal(uint8_t* block, uint32_t file_id, uint32_t seq, uint16_t length) {
+    BlockHeader header = {0, length, file_id, seq};
+    memcpy(block, &header, HEADER_SIZE);
+
+    header.crc = crc16(block + sizeof(header.crc), HEADER_SIZE - sizeof(header.crc) + length);
+    memcpy(block, &header.crc, sizeof(header.crc));
+}
+
+// Validates a block read back from disk; file_id 0 accepts any file
+inline bool check(const uint8_t* block, uint32_t file_id, uint32_t seq, BlockHeader* out = nullptr) {
+    BlockHeader header;
+    memcpy(&header, block, HEADER_SIZE);
+
+    if (header.length == 0 || header.length > PAYLOAD_SIZE) return false;
+    if (header.file_id == 0 || (file_id != 0 && header.file_id != file_id)) return false;
+    if (header.seq != seq) return false;
+    if (header.crc != crc16(block + sizeof(header.crc), HEADER_SIZE - sizeof(header.crc) + header.length)) {
+        return false;
+    }
+
+    if (out) *out = header;
+    return true;
+}
+
+// ============================================
+// Recovery
+// ============================================
+struct Recovery {
+    bool journaled;         // Block 0 is a valid journal block
+    uint32_t blocks;        // Valid blocks found
+    FSIZE_t old_size;       // Directory entry size before recovery
+    FSIZE_t new_size;       // True data length (file truncated to this)
+};
+
+// Restores the true length of a journaled file by truncating it after its
+// last valid block. Files that are not journaled are left untouched.
+//
+// The search runs on a read-only handle: a power cut inside f_truncate can
+// leave the FAT chain shorter than the directory entry, and FatFs fails
+// (and poisons the FIL) on reads past it, while a writable handle would
+// silently extend the chain on f_lseek. Unreadable blocks count as invalid.
+inline FRESULT recover(const TCHAR* path, Recovery& result) {
+    static uint8_t block[BLOCK_SIZE];
+    FIL fil;
+
+    FRESULT fr = f_open(&fil, path, FA_READ);
+    if (fr != FR_OK) return fr;
+
+    result = {false, 0, f_size(&fil), f_size(&fil)};
+
+    auto readBlock = [&](uint32_t index) -> bool {
+        UINT read = 0;
+        if (f_lseek(&fil, static_cast<FSIZE_t>(index) * BLOCK_SIZE) == FR_OK &&
+            f_read(&fil, block, BLOCK_SIZE, &read) == FR_OK) {
+            memset(block + read, 0, BLOCK_SIZE - read);
+            return true;
+        }
+        f_close(&fil);
+        f_open(&fil, path, FA_READ);
+        return false;
+    };
+
+    uint32_t total = static_cast<uint32_t>((result.old_size + BLOCK_SIZE - 1) / BLOCK_SIZE);
+
+    BlockHeader header;
+    if (total == 0 || !readBlock(0) || !check(block, 0, 0, &header)) {
+        f_close(&fil);
+        return FR_OK;
+    }
+
+    uint32_t file_id = header.file_id;
+    result.journaled = true;
+
+    // Invariant: block `valid` checks out, block `invalid` does not (or is past the end)
+    uint32_t valid = 0;
+    uint32_t invalid = total;
+    uint16_t valid_length = header.length;
+
+    while (invalid - valid > 1) {
+        uint32_t mid = valid + (invalid - valid) / 2;
+
+        if (readBlock(mid) && check(block, file_id, mid, &header)) {
+            valid = mid;
+            valid_length = header.length;
+        } else {
+            invalid = mid;
+        }
+    }
+    f_close(&fil);
+
+    result.blocks = valid + 1;
+    result.new_size = static_cast<FSIZE_t>(valid) * BLOCK_SIZE + HEADER_SIZE + valid_length;
+    if (result.new_size >= result.old_size) return FR_OK;
+
+    fr = f_open(&fil, path, FA_WRITE);
+    if (fr != FR_OK) return fr;
+
+    fr = f_lseek(&fil, result.new_size);
+    if (fr == FR_OK) fr = f_truncate(&fil);
+
+    FRESULT close_fr = f_close(&fil);
+    return (fr != FR_OK) ? fr : close_fr;
+}
+
+// Extracts the payload stream from a journaled image in memory. Stops at
+// the first invalid block; returns the number of blocks consumed.
+inline size_t unwrap(const uint8_t* data, size_t size, uint8_t* out, size_t* out_size) {
+    size_t blocks = 0;
+    size_t written = 0;
+    uint32_t file_id = 0;
+
+    for (size_t offset = 0; offset + HEADER_SIZE <= size; offset += BLOCK_SIZE) {
+        uint8_t block[BLOCK_SIZE] = {};
+        memcpy(block, data + offset, std::min(BLOCK_SIZE, size - offset));
+
+        BlockHeader header;
+        if (!check(block, file_id, static_cast<uint32_t>(blocks), &header)) break;
+        if (offset + HEADER_SIZE + header.length > size) break;
+
+        file_id = header.file_id;
+        memcpy(out + written, block + HEADER_SIZE, header.length);
+        written += header.length;
+        blocks++;
+    }
+
+    *out_size = written;
+    return blocks;
+}
+
+} // namespace drivers::journal
@@ -0,0 +1,92 @@
+#pragma once
+
+// Project Omni-Header
+#include "config/all_headers.h"
+
+#include "sdcard.h"
+
+namespace drivers {
+
+// ============================================
+// SD Write Throughput Benchmark
+// ============================================
+// Writes BENCH_BYTES to a scratch file in fixed-size chunks, the way SDFile
+// flushes, and reports sustained MB/s plus the worst single f_write latency
+// for each chunk size with and without f_expand preallocation. The 512 B
+// unallocated case is the old SDFile behaviour (one CMD24 per flush).
+//
+// Enabled by config::sdcard::RUN_WRITE_BENCH; results go to `report`.
+class SDBench {
+public:
+    static constexpr size_t BENCH_BYTES = 2u << 20;
+    static constexpr size_t MAX_CHUNK = 32768;
+    static constexpr const char* SCRATCH_FILE = "bench.tmp";
+
+    struct Result {
+        size_t chunk;
+        bool preallocated;
+        float mbs;
+        uint32_t worst_us;
+        bool ok;
+    };
+
+private:
+    static inline uint8_t chunk_buffer[MAX_CHUNK];
+
+    static Result runCase(size_t chunk, bool preallocate) {
+        Result r = {chunk, false, 0.0f, 0, false};
+
+        FIL fil;
+        if (f_open(&fil, SCRATCH_FILE, FA_WRITE | FA_CREATE_ALWAYS) != FR_OK) {
+            return r;
+        }
+
+        if (preallocate) {
+            r.preallocated = (f_expand(&fil, BENCH_BYTES, 1) == FR_OK);
+        }
+
+        bool ok = true;
+        uint64_t start = time_us_64();
+
+        for (size_t done = 0; ok && done < BENCH_BYTES; done += chunk) {
+            uint64_t t0 = time_us_64();
+            UINT written;
+            ok = (f_write(&fil, chunk_buffer, chunk, &written) == FR_OK && written == chunk);
+            r.worst_us = std::max(r.worst_us, static_cast<uint32_t>(time_us_64() - t0));
+        }
+
+        ok = ok && (f_sync(&fil) == FR_OK);
+        uint64_t elapsed = time_us_64() - start;
+
+        f_close(&fil);
+        f_unlink(SCRATCH_FILE);
+
+        r.mbs = elapsed ? static_cast<float>(BENCH_BYTES) / elapsed : 0.0f;
+        r.ok = ok;
+        return r;
+    }
+
+public:
+    static void run(SDFile& report) {
+        static constexpr size_t CHUNKS[] = {512, 4096, 16384, MAX_CHUNK};
+
+        for (size_t i = 0; i < MAX_CHUNK; i++) {
+            chunk_buffer[i] = static_cast<uint8_t>(i);
+        }
+
+        report.write("[SDBNCH][--] %u KB per case, buffer=%u\n",
+                     (unsigned)(BENCH_BYTES / 1024), (unsigned)config::sdcard::FILE_BUFFER_SIZE);
+
+        for (size_t chunk : CHUNKS) {
+            for (bool prealloc : {false, true}) {
+                Result r = runCase(chunk, prealloc);
+                report.write("[SDBNCH][%s] chunk=%u prealloc=%d rate=%.2fMB/s worst=%" PRIu32 "us\n",
+                             r.ok ? "OK" : "XX", (unsigned)r.chunk, r.preallocated, r.mbs, r.worst_us);
+            }
+        }
+
+        report.sync();
+    }
+};
+
+} // namespace drivers
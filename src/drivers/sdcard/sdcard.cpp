@@ -1,6 +1,8 @@
 #include "sdcard.h"
 #include "config/config.h"
 
+#include "pico/rand.h"
+
 // C interface for FatFS library
 extern "C" {
     size_t sd_get_num() { 
@@ -65,9 +67,64 @@ bool SDCard::mount() {
     
     FRESULT result = f_mount(&fs, "", 1);
     mounted = (result == FR_OK);
+    cluster_bytes = mounted ? static_cast<uint32_t>(fs.csize) * FF_MAX_SS : 0;
+    
+    if (mounted && config::sdcard::RECOVER_ON_MOUNT) {
+        recoverLastSession();
+    }
+    
     return mounted;
 }
 
+// Whole buffers tile whole clusters (both are powers-of-two multiples of
+// the sector on a standard format, but the card decides the cluster)
+bool SDCard::buffersClusterAligned() const {
+    constexpr uint32_t buffer = config::sdcard::FILE_BUFFER_SIZE;
+    if (cluster_bytes == 0) return false;
+    return (cluster_bytes % buffer == 0) || (buffer % cluster_bytes == 0);
+}
+
+// A session cut short by power loss leaves its journaled files at their
+// preallocated size with stale data past the last written block; find the
+// true lengths (journal::recover) and truncate. Only the newest session
+// can be affected, since every earlier one was closed by a later boot.
+void SDCard::recoverLastSession() {
+    uint64_t start = time_us_64();
+    recovery = {-1, 0, 0, 0, 0};
+    
+    recovery.session = findHighestNumberedFolder();
+    if (recovery.session < 0) return;
+    
+    char folder[16];
+    snprintf(folder, sizeof(folder), "%d", recovery.session);
+    
+    DIR dir;
+    FILINFO fno;
+    if (f_opendir(&dir, folder) != FR_OK) return;
+    
+    while (f_readdir(&dir, &fno) == FR_OK && fno.fname[0] != 0) {
+        if (fno.fattrib & AM_DIR) continue;
+        
+        // Room for the longest LFN; a path that still does not fit is skipped
+        // rather than truncated into another file's name
+        char path[sizeof(folder) + 1 + sizeof(fno.fname)];
+        int len = snprintf(path, sizeof(path), "%s/%s", folder, fno.fname);
+        if (len < 0 || static_cast<size_t>(len) >= sizeof(path)) continue;
+        
+        journal::Recovery result;
+        if (journal::recover(path, result) == FR_OK && result.journaled) {
+            recovery.files++;
+            if (result.new_size < result.old_size) {
+                recovery.repaired++;
+                recovery.trimmed_bytes += result.old_size - result.new_size;
+            }
+        }
+    }
+    
+    f_closedir(&dir);
+    recovery.time_us = static_cast<uint32_t>(time_us_64() - start);
+}
+
 void SDCard::shutdown() {
     if (open_files > 0) {
         // Force close all files (emergency shutdown)
@@ -163,7 +220,7 @@ void SDCard::unregisterFile() {
 // ============================================
 
 SDFile::SDFile() {
-    memset(buffer, 0, BUFFER_SIZE);
+    memset(buffers, 0, sizeof(buffers));
 }
 
 SDFile::~SDFile() {
@@ -172,21 +229,51 @@ SDFile::~SDFile() {
     }
 }
 
-bool SDFile::flushBuffer() {
-    if (buffer_pos == 0) return true;
+bool SDFile::writeOut(uint8_t* data, size_t len, FSIZE_t offset) {
+    // (Re)seal every block being written; offset is sector aligned here
+    if (journal_id) {
+        for (size_t pos = 0; pos < len; pos += SECTOR_SIZE) {
+            size_t block_len = std::min(len - pos, SECTOR_SIZE);
+            journal::seal(data + pos, journal_id, static_cast<uint32_t>((offset + pos) / SECTOR_SIZE),
+                          static_cast<uint16_t>(block_len - journal::HEADER_SIZE));
+        }
+    }
     
+    uint64_t start = time_us_64();
     UINT written;
-    FRESULT fr = f_write(&fil, buffer, buffer_pos, &written);
+    FRESULT fr = f_write(&fil, data, len, &written);
+    uint32_t elapsed = static_cast<uint32_t>(time_us_64() - start);
     
-    if (fr != FR_OK || written != buffer_pos) {
-        return false;
-    }
+    stats.flushes++;
+    stats.bytes += written;
+    stats.flush_us += elapsed;
+    stats.max_flush_us = std::max(stats.max_flush_us, elapsed);
+    
+    return (fr == FR_OK && written == len);
+}
+
+bool SDFile::writePending() {
+    if (pending_len == 0) return true;
+    
+    if (!writeOut(buffers[active ^ 1], pending_len, buffer_offset - pending_len)) return false;
+    
+    pending_len = 0;
+    return true;
+}
+
+// Synchronous: handed-off buffer first, then the active one
+bool SDFile::flushBuffer() {
+    if (!writePending()) return false;
+    if (buffer_pos == 0) return true;
+    
+    if (!writeOut(activeBuffer(), buffer_pos, buffer_offset)) return false;
     
+    buffer_offset += buffer_pos;
     buffer_pos = 0;
     return true;
 }
 
-bool SDFile::open(const char* path, bool append) {
+bool SDFile::open(const char* path, bool append, FSIZE_t preallocate, bool journaled) {
     if (is_open) close();
     
     auto& sd = SDCard::instance();
@@ -206,7 +293,17 @@ bool SDFile::open(const char* path, bool append) {
         sd.unregisterFile();
     }
     
+    stats = {};
+    active = 0;
+    pending_len = 0;
+    journal_id = (is_open && journaled && !append) ? (get_rand_32() | 1) : 0;
+    if (is_open && !append && preallocate > 0) {
+        // Falls back to normal cluster-by-cluster growth if no contiguous space
+        stats.preallocated = (f_expand(&fil, preallocate, 1) == FR_OK);
+    }
+    
     buffer_pos = 0;
+    buffer_offset = is_open ? f_tell(&fil) : 0;
     return is_open;
 }
 
@@ -223,30 +320,42 @@ bool SDFile::write(const char* format, ...) {
     
     if (len < 0) return false;
     
-    // Print the formatted string to console
-    printf("%s", temp);
-    
     // Handle case where string is larger than temp buffer
     if (len >= sizeof(temp)) {
         // Truncate to fit - could alternatively dynamically allocate
         len = sizeof(temp) - 1;
     }
     
-    // Write the formatted string
-    const uint8_t* src = reinterpret_cast<const uint8_t*>(temp);
+    return writeBytes(temp, len);
+}
+
+bool SDFile::writeBytes(const void* data, size_t len) {
+    if (!is_open) return false;
+    
+    const uint8_t* src = static_cast<const uint8_t*>(data);
     size_t bytes_to_write = len;
     
     while (bytes_to_write > 0) {
-        size_t space = BUFFER_SIZE - buffer_pos;
+        // Journaled: reserve the block header when a new sector starts, and
+        // copy no further than the end of the current sector
+        if (journal_id && (buffer_offset + buffer_pos) % SECTOR_SIZE == 0) {
+            buffer_pos += journal::HEADER_SIZE;
+        }
+        
+        size_t limit = fillLimit();
+        size_t space = limit - buffer_pos;
+        if (journal_id) {
+            space = std::min(space, SECTOR_SIZE - (buffer_offset + buffer_pos) % SECTOR_SIZE);
+        }
         size_t to_copy = (bytes_to_write < space) ? bytes_to_write : space;
         
-        memcpy(buffer + buffer_pos, src, to_copy);
+        memcpy(activeBuffer() + buffer_pos, src, to_copy);
         buffer_pos += to_copy;
         src += to_copy;
         bytes_to_write -= to_copy;
         
-        if (buffer_pos >= BUFFER_SIZE) {
-            if (!flushBuffer()) return false;
+        if (buffer_pos >= limit) {
+            if (!flushAsync()) return false;
         }
     }
     
@@ -256,9 +365,59 @@ bool SDFile::write(const char* format, ...) {
 bool SDFile::sync() {
     if (!is_open) return false;
     
+    uint64_t start = time_us_64();
+    
+    // The partial last sector is written now but also kept in the buffer,
+    // and the file pointer rewound to it, so the next flush starts on a
+    // sector boundary again and rewrites that sector as part of its run.
+    size_t buffered = buffer_pos;
+    FSIZE_t end = buffer_offset + buffered;
+    size_t keep = std::min<size_t>(end % SECTOR_SIZE, buffered);
+    
     if (!flushBuffer()) return false;
     
-    return (f_sync(&fil) == FR_OK);
+    bool ok = (f_sync(&fil) == FR_OK);
+    
+    if (keep > 0) {
+        memmove(activeBuffer(), activeBuffer() + buffered - keep, keep);
+        buffer_pos = keep;
+        buffer_offset = end - keep;
+        ok = ok && (f_lseek(&fil, buffer_offset) == FR_OK);
+    }
+    
+    uint32_t elapsed = static_cast<uint32_t>(time_us_64() - start);
+    stats.syncs++;
+    stats.sync_us += elapsed;
+    stats.max_sync_us = std::max(stats.max_sync_us, elapsed);
+    
+    return ok;
+}
+
+bool SDFile::flushAsync() {
+    if (!is_open) return false;
+    
+    // Hand off whole sectors only; a partial last sector carries over
+    size_t tail = std::min<size_t>((buffer_offset + buffer_pos) % SECTOR_SIZE, buffer_pos);
+    size_t handoff = buffer_pos - tail;
+    if (handoff == 0) return true;
+    
+    // Both buffers full: the caller has to wait for the card after all
+    if (pending_len > 0) {
+        stats.stalls++;
+        if (!writePending()) return false;
+    }
+    
+    memcpy(buffers[active ^ 1], activeBuffer() + handoff, tail);
+    pending_len = handoff;
+    buffer_offset += handoff;
+    buffer_pos = tail;
+    active ^= 1;
+    return true;
+}
+
+bool SDFile::poll() {
+    if (!is_open) return true;
+    return writePending();
 }
 
 bool SDFile::close() {
@@ -266,6 +425,9 @@ bool SDFile::close() {
     
     if (!flushBuffer()) return false;
     
+    // Release the unused tail of the preallocation
+    if (stats.preallocated && f_truncate(&fil) != FR_OK) return false;
+    
     is_open = false;
     FRESULT result = f_close(&fil);
     
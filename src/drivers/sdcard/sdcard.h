@@ -3,6 +3,9 @@
 // Project Omni-Header
 #include "config/all_headers.h"
 
+#include "config/config.h"
+#include "journal.h"
+
 extern "C" {
     #include "ff.h"
     #include "f_util.h"
@@ -18,6 +21,16 @@ class SDFile;
 // Simplified SD Card Driver (Singleton)
 // ============================================
 class SDCard {
+public:
+    // Result of the journal scan of the last session done by mount()
+    struct RecoveryReport {
+        int session;                // Folder scanned (-1 = none)
+        uint8_t files;              // Journaled files found
+        uint8_t repaired;           // Files cut back to their true length
+        uint64_t trimmed_bytes;     // Stale preallocated bytes removed
+        uint32_t time_us;
+    };
+
 private:
     // SD Card structures - statically allocated
     spi_t spi_config;
@@ -27,11 +40,15 @@ private:
     
     bool initialized = false;
     bool mounted = false;
+    uint32_t cluster_bytes = 0;     // Allocation unit of the mounted volume
     
     // Track open files
     static constexpr size_t MAX_FILES = 8;
     uint8_t open_files = 0;
     
+    RecoveryReport recovery = {-1, 0, 0, 0, 0};
+    void recoverLastSession();
+    
     // Private constructor for singleton
     SDCard();
     
@@ -61,6 +78,12 @@ public:
     // Status
     bool isMounted() const { return mounted; }
     bool isInitialized() const { return initialized; }
+    const RecoveryReport& getRecoveryReport() const { return recovery; }
+    uint32_t getClusterBytes() const { return cluster_bytes; }
+
+    // A file buffer flushed at a buffer boundary also ends on a cluster
+    // boundary (the card's format sets the cluster; 0 until mounted)
+    bool buffersClusterAligned() const;
     sd_card_t* getCardPtr() { return initialized ? &sd_card : nullptr; }
     
     // Internal use by SDFile
@@ -73,16 +96,71 @@ public:
 // ============================================
 // Simplified File Class
 // ============================================
+// Writes are staged in a FILE_BUFFER_SIZE buffer whose start is kept on a
+// sector boundary of the file, so every flush hands FatFs whole sectors and
+// goes out as one CMD25 multi-block write instead of per-sector CMD24s.
+//
+// Files opened with a preallocation are expanded contiguously (f_expand) up
+// front; consecutive flushes then land on consecutive sectors, the SPI
+// driver keeps its multi-block transaction open between them and no FAT
+// updates happen while logging. close() truncates back to the real length.
+//
+// There are two such buffers per file (ping-pong). A full buffer is only
+// handed off (flushAsync) and the caller keeps appending to the other one;
+// the hand-off is written out by poll(), which the owner calls once it has
+// nothing more urgent to do. The caller only waits on the card when both
+// buffers are full, which is counted as a stall.
+//
+// Journaled files (see journal.h) reserve a block header at the start of
+// every sector and seal it (length, seq, crc) each time the sector is
+// written, so SDCard::mount() can find their true length after a power cut.
 class SDFile {
+public:
+    // Write timing, to size FILE_BUFFER_SIZE against the card in use
+    struct Stats {
+        uint32_t flushes;           // Buffer writes handed to FatFs
+        uint32_t syncs;
+        uint64_t bytes;             // Bytes flushed (sync tails count again when rewritten)
+        uint64_t flush_us;          // Total time inside f_write
+        uint32_t max_flush_us;      // Worst single flush
+        uint64_t sync_us;           // Total time inside sync()
+        uint32_t max_sync_us;       // Worst sync() including its flush
+        uint32_t stalls;            // Appends that had to wait for the previous buffer
+        bool preallocated;          // f_expand succeeded at open
+
+        // MB/s while the card is being written (idle time excluded)
+        float throughput_mbs() const { return flush_us ? static_cast<float>(bytes) / flush_us : 0.0f; }
+        uint32_t mean_sync_us() const { return syncs ? static_cast<uint32_t>(sync_us / syncs) : 0; }
+    };
+
 private:
     FIL fil;
     bool is_open = false;
     
-    // Single write buffer
-    static constexpr size_t BUFFER_SIZE = 512;
-    uint8_t buffer[BUFFER_SIZE];
+    // Sector-aligned ping-pong write buffers. The cluster size is only
+    // known once the card is mounted; SDCard checks it there.
+    static constexpr size_t SECTOR_SIZE = FF_MAX_SS;
+    static constexpr size_t BUFFER_SIZE = config::sdcard::FILE_BUFFER_SIZE;
+    static_assert(BUFFER_SIZE >= SECTOR_SIZE && BUFFER_SIZE % SECTOR_SIZE == 0,
+                  "FILE_BUFFER_SIZE must be a multiple of the sector size");
+
+    alignas(4) uint8_t buffers[2][BUFFER_SIZE];
+    uint8_t active = 0;             // Buffer being appended to
     size_t buffer_pos = 0;
+    FSIZE_t buffer_offset = 0;      // File offset of the active buffer's first byte
+    size_t pending_len = 0;         // Bytes handed off in the other buffer (0 = none)
+    uint32_t journal_id = 0;        // Journal file_id (0 = plain file)
+    
+    Stats stats = {};
     
+    // Bytes the buffer may hold before the flush point (only short of
+    // BUFFER_SIZE when an append started mid-sector)
+    size_t fillLimit() const { return BUFFER_SIZE - (buffer_offset % SECTOR_SIZE); }
+    
+    uint8_t* activeBuffer() { return buffers[active]; }
+    
+    bool writeOut(uint8_t* data, size_t len, FSIZE_t offset);
+    bool writePending();
     bool flushBuffer();
     
 public:
@@ -96,13 +174,29 @@ public:
     SDFile& operator=(SDFile&&) = delete;
     
     // File operations
-    bool open(const char* path, bool append = false);
+    bool open(const char* path, bool append = false, FSIZE_t preallocate = 0, bool journaled = false);
     bool write(const char* format, ...);
+    bool writeBytes(const void* data, size_t len);
     bool sync();
+    
+    // Hand the active buffer to poll() and continue in the other one
+    bool flushAsync();
+    // Write out a handed-off buffer, if any. Returns false on a write error.
+    bool poll();
+    bool isFlushPending() const { return pending_len > 0; }
+    
+    // Append one fixed-size binary record (see log_records.h)
+    template<typename T>
+    bool writeRecord(const T& record) {
+        static_assert(std::is_trivially_copyable_v<T>, "Records must be trivially copyable");
+        return writeBytes(&record, sizeof(T));
+    }
     bool close();
     
     // Status
     bool isOpen() const { return is_open; }
+    bool isJournaled() const { return journal_id != 0; }
+    const Stats& getStats() const { return stats; }
 };
 
 } // namespace drivers
@@ -0,0 +1,102 @@
+#pragma once
+
+// NOTE: Pico SDK free so host tools and the simulator can use it as well.
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "table_math.h"
+
+namespace drivers {
+
+struct airspeeds {
+    float ias_ms;       // Indicated: sqrt(2 qc / rho0)
+    float cas_ms;       // Calibrated
+    float tas_ms;       // True
+    float mach;
+};
+
+namespace air_data {
+
+// qc / p at Mach 1: 1.2^3.5 - 1; faster reads as Mach 1
+constexpr float QC_P_MAX = 0.8929f;
+
+// M = sqrt(x) g(x) for x = qc / p: g is smooth down to x = 0, sqrt is not
+constexpr double mach_factor(double x) {
+    if (x <= 0.0) return table_math::sqrt(10.0 / 7.0);
+    return table_math::sqrt(5.0 * (table_math::pow(1.0 + x, 2.0 / 7.0) - 1.0) / x);
+}
+
+inline constexpr table_math::Table<129> MACH_FACTOR{0.0, QC_P_MAX / 128.0, mach_factor};
+
+} // namespace air_data
+
+// ============================================
+// Air Data
+// ============================================
+// Airspeeds from the pitot's impact pressure qc and the static pressure
+// and temperature from the barometer. IAS is the incompressible Bernoulli
+// speed at sea-level density (what PitotTube always reported); CAS and TAS
+// follow the model:
+//   INCOMPRESSIBLE  CAS = IAS, TAS = sqrt(2 qc / rho), rho = p / (R T)
+//   COMPRESSIBLE    subsonic isentropic flow:
+//                   M = sqrt(5 ((qc / p + 1)^(2/7) - 1)), TAS = M a,
+//                   CAS = a0 M at sea level (qc / p0)
+// The incompressible TAS reads 1.1 % fast at Mach 0.3, 3.2 % at Mach 0.5.
+// The static terms are folded in set_static() at the barometer's rate, so
+// a sample costs the same every time: a few multiplies, two sqrtf and two
+// table lookups. Until set_static() the standard sea level is assumed.
+class AirData {
+public:
+    enum class Model : uint8_t { INCOMPRESSIBLE, COMPRESSIBLE };
+
+    static constexpr double P0_PA = 101325.0;
+    static constexpr double T0_K = 288.15;
+    static constexpr double R = 287.05;                     // J/(kg K), dry air
+    static constexpr double GAMMA = 1.4;
+    static constexpr double RHO0 = P0_PA / (R * T0_K);      // 1.225 kg/m³
+    static constexpr double A0_MS = table_math::sqrt(GAMMA * R * T0_K);
+
+    explicit AirData(Model model) : model(model) {
+        set_static(static_cast<float>(P0_PA), static_cast<float>(T0_K - 273.15));
+    }
+
+    // Static pressure (Pa) and air temperature (°C); false if implausible
+    bool set_static(float pressure_pa, float temperature_c) {
+        float t_k = temperature_c + 273.15f;
+        if (!(pressure_pa > 1000.0f && t_k > 150.0f)) return false;
+        inv_p = 1.0f / pressure_pa;
+        speed_of_sound = sqrtf(static_cast<float>(GAMMA * R) * t_k);
+        inv_speed_of_sound = 1.0f / speed_of_sound;
+        tas_scale = static_cast<float>(2.0 * R) * t_k * inv_p;
+        return true;
+    }
+
+    Model get_model() const { return model; }
+
+    airspeeds compute(float qc_pa) const {
+        if (!(qc_pa > 0.0f)) return {};
+        float ias = sqrtf(qc_pa * static_cast<float>(2.0 / RHO0));
+        if (model == Model::INCOMPRESSIBLE) {
+            float tas = sqrtf(qc_pa * tas_scale);
+            return {ias, ias, tas, tas * inv_speed_of_sound};
+        }
+        float mach_0 = mach(qc_pa * static_cast<float>(1.0 / P0_PA));
+        float m = mach(qc_pa * inv_p);
+        return {ias, static_cast<float>(A0_MS) * mach_0, m * speed_of_sound, m};
+    }
+
+private:
+    Model model;
+    float inv_p = 0.0f;
+    float speed_of_sound = 0.0f;
+    float inv_speed_of_sound = 0.0f;
+    float tas_scale = 0.0f;             // 2 R T / p
+
+    static float mach(float qc_p) {
+        qc_p = std::min(qc_p, air_data::QC_P_MAX);
+        return sqrtf(qc_p) * air_data::MACH_FACTOR(qc_p);
+    }
+};
+
+} // namespace drivers
@@ -0,0 +1,116 @@
+#pragma once
+
+// NOTE: Pico SDK free so host tools and the simulator can use it as well.
+#include <cstddef>
+#include <cstdint>
+
+namespace drivers {
+
+// Calibration data structure
+struct bmp390_calib {
+    uint16_t T1;
+    uint16_t T2;
+    int8_t   T3;
+    int16_t  P1;
+    int16_t  P2;
+    int8_t   P3;
+    int8_t   P4;
+    uint16_t P5;
+    uint16_t P6;
+    int8_t   P7;
+    int8_t   P8;
+    int16_t  P9;
+    int8_t   P10;
+    int8_t   P11;
+};
+
+// ============================================
+// BMP390 Fixed-Point Compensation
+// ============================================
+// Bosch's 64-bit integer formulation (BMP3 API, BMP3_64BIT_COMPENSATION):
+// temperature in 0.01 °C, pressure in 0.01 Pa. The terms that only depend
+// on the calibration are scaled once in set_calibration(); what is left
+// per sample is the same arithmetic in the same order, so the results are
+// bit for bit those of the reference formulation (tools/
+// bmp390_compensation_bench checks that, and the distance to the
+// datasheet's floating point formulation).
+class BMP390Compensation {
+public:
+    static constexpr size_t NVM_SIZE = 21;
+
+    // NVM_PAR_T1 onwards, little-endian
+    static constexpr bmp390_calib parse(const uint8_t* nvm) {
+        return {
+            .T1 = static_cast<uint16_t>((nvm[1] << 8) | nvm[0]),
+            .T2 = static_cast<uint16_t>((nvm[3] << 8) | nvm[2]),
+            .T3 = static_cast<int8_t>(nvm[4]),
+            .P1 = static_cast<int16_t>((nvm[6] << 8) | nvm[5]),
+            .P2 = static_cast<int16_t>((nvm[8] << 8) | nvm[7]),
+            .P3 = static_cast<int8_t>(nvm[9]),
+            .P4 = static_cast<int8_t>(nvm[10]),
+            .P5 = static_cast<uint16_t>((nvm[12] << 8) | nvm[11]),
+            .P6 = static_cast<uint16_t>((nvm[14] << 8) | nvm[13]),
+            .P7 = static_cast<int8_t>(nvm[15]),
+            .P8 = static_cast<int8_t>(nvm[16]),
+            .P9 = static_cast<int16_t>((nvm[18] << 8) | nvm[17]),
+            .P10 = static_cast<int8_t>(nvm[19]),
+            .P11 = static_cast<int8_t>(nvm[20]),
+        };
+    }
+
+    constexpr void set_calibration(const bmp390_calib& c) {
+        calib = c;
+        t1_offset = static_cast<int64_t>(256) * c.T1;
+        t2_gain = static_cast<int64_t>(c.T2) * 262144;
+        p5_offset = static_cast<int64_t>(c.P5) * 140737488355328;
+        p6_offset = static_cast<int64_t>(c.P6) * 4194304;
+        p1_gain = static_cast<int64_t>(c.P1 - 16384) * 70368744177664;
+        p2_gain = static_cast<int64_t>(c.P2 - 16384) * 2097152;
+        p9_term = static_cast<int64_t>(65536) * c.P9;
+    }
+
+    const bmp390_calib& calibration() const { return calib; }
+
+    // 0.01 °C; keeps t_fine for the next pressure()
+    constexpr int64_t temperature(uint32_t raw_temp) {
+        int64_t partial_data1 = raw_temp - t1_offset;
+        int64_t partial_data4 = partial_data1 * partial_data1 * calib.T3;
+        t_fine = (t2_gain * partial_data1 + partial_data4) / 4294967296;
+        return (t_fine * 25) / 16384;
+    }
+
+    // 0.01 Pa at the last temperature()
+    constexpr uint64_t pressure(uint32_t raw_press) const {
+        int64_t t = t_fine;
+        int64_t partial_data1 = t * t;
+        int64_t partial_data3 = ((partial_data1 / 64) * t) / 256;
+        int64_t offset = p5_offset + (calib.P8 * partial_data3) / 32 + (calib.P7 * partial_data1) * 16 +
+                         p6_offset * t;
+        int64_t sensitivity = p1_gain + (calib.P4 * partial_data3) / 32 + (calib.P3 * partial_data1) * 4 +
+                              p2_gain * t;
+
+        int64_t linear = (sensitivity / 16777216) * raw_press;
+        int64_t partial_data4 = ((calib.P10 * t + p9_term) * raw_press) / 8192;
+        // Divided by 10 and multiplied back to keep raw * partial_data4 in range
+        int64_t quadratic = ((raw_press * (partial_data4 / 10)) / 512) * 10;
+        int64_t raw_squared = static_cast<int64_t>(static_cast<uint64_t>(raw_press) * raw_press);
+        int64_t cubic = (((calib.P11 * raw_squared) / 65536) * raw_press) / 128;
+        int64_t sum = offset / 4 + linear + quadratic + cubic;
+        return (static_cast<uint64_t>(sum) * 25) / 1099511627776;
+    }
+
+private:
+    bmp390_calib calib = {};
+    int64_t t_fine = 0;
+
+    // Calibration-only terms
+    int64_t t1_offset = 0;
+    int64_t t2_gain = 0;
+    int64_t p5_offset = 0;
+    int64_t p6_offset = 0;
+    int64_t p1_gain = 0;
+    int64_t p2_gain = 0;
+    int64_t p9_term = 0;
+};
+
+} // namespace drivers
@@ -1,96 +1,130 @@
 #include "bmp581_driver.h"
 #include "config/config.h"
+#include "pressure_altitude.h"
 
 namespace drivers {
 
 bool BMP581::init(I2CBus* bus) {
-    using config::i2c::addresses::BMP581_ADDR;
+    begin_init(bus);
+    return InitStep::run([this](uint64_t now_us) { return init_step(now_us); });
+}
+
+void BMP581::begin_init(I2CBus* bus) {
     this->i2c_bus = bus;
-    
-    // Check if device is present
-    if (!i2c_bus->device_present(BMP581_ADDR)) {
-        printf("BMP581: Device not found at address 0x%02X\n", BMP581_ADDR);
-        return false;
-    }
-    
-    // Check chip ID (should be 0x50 for BMP581)
-    uint8_t chip_id;
-    if (!i2c_bus->read_register(BMP581_ADDR, BMP581_REG_CHIP_ID, &chip_id, 1)) {
-        printf("BMP581: Failed to read chip ID\n");
-        return false;
-    }
-    
-    if (chip_id != 0x50) {
-        printf("BMP581: Wrong chip ID: 0x%02X (expected 0x50)\n", chip_id);
-        return false;
-    }
-    
-    // Perform soft reset (0xB6 is the standard Bosch reset command)
-    if (!i2c_bus->write_register(BMP581_ADDR, BMP581_REG_CMD, 0xB6)) {
-        printf("BMP581: Failed to reset\n");
-        return false;
-    }
-    sleep_ms(10);  // Wait for reset to complete
-    
-    // OSR register: x2 oversampling for temperature and pressure, enable pressure
-    // Bit 6 = pressure enable, Bits [5:3] = temp OSR, [2:0] = press OSR, 001 = x2
-    if (!i2c_bus->write_register(BMP581_ADDR, BMP581_REG_OSR_CONFIG, 0x49)) {  // 0x40 | 0x09
-        printf("BMP581: Failed to configure oversampling\n");
-        return false;
+    initialized = false;
+    init_phase = InitPhase::RESET;
+    init_wait_until_us = 0;
+}
+
+// Reset (10 ms), configure, then the first measurement (50 ms)
+InitStep BMP581::init_step(uint64_t now_us) {
+    using config::i2c::addresses::BMP581_ADDR;
+
+    if (init_phase == InitPhase::DONE) return InitStep::done(initialized);
+    if (now_us < init_wait_until_us) return InitStep::at(init_wait_until_us);
+    auto wait = [&](InitPhase next, uint64_t us) {
+        init_phase = next;
+        init_wait_until_us = now_us + us;
+        return InitStep::at(init_wait_until_us);
+    };
+    auto fail = [this] {
+        init_phase = InitPhase::DONE;
+        return InitStep::failed();
+    };
+
+    switch (init_phase) {
+    case InitPhase::RESET: {
+        // Check if device is present
+        if (!i2c_bus->device_present(BMP581_ADDR)) {
+            printf("BMP581: Device not found at address 0x%02X\n", BMP581_ADDR);
+            return fail();
+        }
+        
+        // Check chip ID (should be 0x50 for BMP581)
+        uint8_t chip_id;
+        if (!i2c_bus->read_register(BMP581_ADDR, BMP581_REG_CHIP_ID, &chip_id, 1)) {
+            printf("BMP581: Failed to read chip ID\n");
+            return fail();
+        }
+        
+        if (chip_id != 0x50) {
+            printf("BMP581: Wrong chip ID: 0x%02X (expected 0x50)\n", chip_id);
+            return fail();
+        }
+        
+        // Perform soft reset (0xB6 is the standard Bosch reset command)
+        if (!i2c_bus->write_register(BMP581_ADDR, BMP581_REG_CMD, 0xB6)) {
+            printf("BMP581: Failed to reset\n");
+            return fail();
+        }
+        return wait(InitPhase::CONFIGURE, 10'000);     // Wait for reset to complete
     }
-    
-    // ODR register: 50Hz output data rate (normal/continuous mode)
-    // 0xBD = 0x80 | 0x3C | 0x01 (Deep disable + 50Hz + Normal mode)
-    if (!i2c_bus->write_register(BMP581_ADDR, BMP581_REG_ODR_CONFIG, 0xBD)) {
-        printf("BMP581: Failed to configure output data rate\n");
-        return false;
+
+    case InitPhase::CONFIGURE:
+        if (!configure(config::bmp581::PRESET, config::bmp581::ODR_HZ)) return fail();
+        return wait(InitPhase::SETTLE, 50'000);        // Sensor to stabilize and first measurement
+
+    case InitPhase::SETTLE:
+    case InitPhase::DONE:
+        break;
     }
     
-    sleep_ms(50);  // Wait for sensor to stabilize and first measurement
-    
+    init_phase = InitPhase::DONE;
     initialized = true;
     _data.valid = false;
     _data_ready = false;
     
     printf("BMP581: Initialized successfully\n");
-    return true;
+    return InitStep::ready();
 }
 
 bool BMP581::update() {
-    using config::i2c::addresses::BMP581_ADDR;
-
-    if (!initialized) {
+    if (!request()) {
         _data_ready = false;
         return false;
     }
+    return collect();
+}
+
+bool BMP581::request() {
+    using config::i2c::addresses::BMP581_ADDR;
+
+    if (!initialized || _requested) return false;
     
-    // In normal mode, the sensor continuously updates at the configured ODR
-    // No need to check data ready status - just read the latest values
-    
-    // Read temperature data (3 bytes)
-    uint8_t temp_data[3];
-    if (!i2c_bus->read_register(BMP581_ADDR, BMP581_REG_TEMP_DATA, temp_data, 3)) {
+    // In normal mode, the sensor continuously updates at the configured ODR.
+    // Without the INT pin just read the latest values; with it, only a new
+    // conversion is read
+    if (data_ready.active() && !data_ready.take(_edge_us)) return false;
+
+    // Temperature and pressure are adjacent: one 6-byte burst
+    if (!i2c_bus->read_register_async(_read, BMP581_ADDR, BMP581_REG_TEMP_DATA, _raw, sizeof(_raw))) return false;
+    _requested = true;
+    return true;
+}
+
+bool BMP581::collect() {
+    if (!_requested) {
         _data_ready = false;
         return false;
     }
-    
-    // Read pressure data (3 bytes)
-    uint8_t press_data[3];
-    if (!i2c_bus->read_register(BMP581_ADDR, BMP581_REG_PRESS_DATA, press_data, 3)) {
+    _requested = false;
+    if (!i2c_bus->wait(_read)) {
         _data_ready = false;
         return false;
     }
+    _data.time = data_ready.active() ? Timestamp::since_edge(_edge_us, _read.end_us)
+                                     : Timestamp::midpoint(_read.start_us, _read.end_us);
     
     // Convert temperature (24-bit signed, LSB first in registers)
-    int32_t raw_temp = utils::merge_bytes<int32_t>(temp_data[2], temp_data[1], temp_data[0]);
+    int32_t raw_temp = utils::merge_bytes<int32_t>(_raw[2], _raw[1], _raw[0]);
     _data.temperature = raw_temp / 65536.0f;
     
     // Convert pressure (24-bit unsigned, LSB first in registers)
-    uint32_t raw_press = (uint32_t)press_data[0] | ((uint32_t)press_data[1] << 8) | ((uint32_t)press_data[2] << 16);
+    uint32_t raw_press = (uint32_t)_raw[3] | ((uint32_t)_raw[4] << 8) | ((uint32_t)_raw[5] << 16);
     _data.pressure = raw_press / 64.0f;
     
     // Calculate altitude using standard atmosphere model
-    _data.altitude = calculate_altitude(_data.pressure);
+    _data.altitude = pressure_altitude(_data.pressure);
     
     _data.valid = true;
     _data_ready = true;
@@ -98,6 +132,160 @@ bool BMP581::update() {
     return true;
 }
 
+// odr_sel for the whole-Hz rates of the datasheet's ODR table
+bool BMP581::odr_select(uint32_t hz, uint8_t& sel) {
+    static constexpr struct { uint16_t hz; uint8_t sel; } RATES[] = {
+        {240, 0x00}, {160, 0x04}, {140, 0x06}, {120, 0x08}, {80, 0x0C}, {70, 0x0D},
+        {60, 0x0E}, {50, 0x0F}, {45, 0x10}, {40, 0x11}, {35, 0x12}, {30, 0x13},
+        {25, 0x14}, {20, 0x15}, {15, 0x16}, {10, 0x17}, {5, 0x18}, {4, 0x19},
+        {3, 0x1A}, {2, 0x1B}, {1, 0x1C},
+    };
+
+    for (const auto& rate : RATES) {
+        if (rate.hz != hz) continue;
+        sel = rate.sel;
+        return true;
+    }
+    printf("BMP581: No %lu Hz output data rate\n", (unsigned long)hz);
+    return false;
+}
+
+// OSR and IIR only take in standby. Both IIR outputs feed the data
+// registers and the FIFO; the rest of DSP_CONFIG (compensation enables) is
+// kept as read. If the oversampling does not fit the ODR the part runs at
+// a lower effective OSR and clears odr_is_valid.
+bool BMP581::configure(const config::bmp581::Preset& preset, uint32_t odr_hz) {
+    using config::i2c::addresses::BMP581_ADDR;
+    constexpr uint8_t IIR_ROUTING = BMP581_DSP_SHDW_SEL_IIR_T | BMP581_DSP_FIFO_SEL_IIR_T |
+                                    BMP581_DSP_SHDW_SEL_IIR_P | BMP581_DSP_FIFO_SEL_IIR_P;
+
+    uint8_t sel;
+    if (!i2c_bus || !odr_select(odr_hz, sel)) return false;
+
+    uint8_t odr = 0x80 | (sel << 2);    // Deep standby disabled
+    uint8_t dsp = 0;
+    bool ok = i2c_bus->write_register(BMP581_ADDR, BMP581_REG_ODR_CONFIG, odr) &&           // Standby
+        i2c_bus->read_register(BMP581_ADDR, BMP581_REG_DSP_CONFIG, &dsp, 1) &&
+        i2c_bus->write_register(BMP581_ADDR, BMP581_REG_DSP_CONFIG, dsp | IIR_ROUTING) &&
+        i2c_bus->write_register(BMP581_ADDR, BMP581_REG_DSP_IIR, (preset.iir_p << 3) | preset.iir_t) &&
+        i2c_bus->write_register(BMP581_ADDR, BMP581_REG_OSR_CONFIG, 0x40 | (preset.osr_p << 3) | preset.osr_t) &&
+        i2c_bus->write_register(BMP581_ADDR, BMP581_REG_ODR_CONFIG, odr | 0x01);            // Normal mode
+    if (!ok) {
+        printf("BMP581: Failed to configure oversampling and output data rate\n");
+        return false;
+    }
+
+    uint8_t eff;
+    if (i2c_bus->read_register(BMP581_ADDR, BMP581_REG_OSR_EFF, &eff, 1) && !(eff & 0x80)) {
+        printf("BMP581: x%u pressure oversampling too slow for %lu Hz, runs at x%u\n",
+               1u << preset.osr_p, (unsigned long)odr_hz, 1u << ((eff >> 3) & 0x07));
+    }
+    return true;
+}
+
+bool BMP581::set_odr(uint32_t hz) {
+    using config::i2c::addresses::BMP581_ADDR;
+
+    uint8_t sel;
+    if (!initialized || !odr_select(hz, sel)) return false;
+    // Deep standby disabled, normal mode
+    return i2c_bus->write_register(BMP581_ADDR, BMP581_REG_ODR_CONFIG, 0x80 | (sel << 2) | 0x01);
+}
+
+// INT active high, push-pull, pulsed, on data-register ready
+bool BMP581::enable_data_ready(uint pin, DataReady::Notify notify, void* context) {
+    using config::i2c::addresses::BMP581_ADDR;
+
+    if (!initialized || !data_ready.start(pin, notify, context)) return false;
+
+    bool ok = i2c_bus->write_register(BMP581_ADDR, BMP581_REG_INT_SOURCE, 0x01) &&   // drdy_data_reg_en
+              i2c_bus->write_register(BMP581_ADDR, BMP581_REG_INT_CONFIG, 0x0A);     // int_en | int_pol
+    if (!ok) {
+        data_ready.stop();
+        printf("BMP581: Failed to enable the data-ready interrupt\n");
+        return false;
+    }
+    return true;
+}
+
+// ============================================
+// FIFO Batch Mode
+// ============================================
+// Pressure-only frames, 32 deep. Stop-on-full: a full FIFO refuses new
+// conversions instead of overwriting the oldest, so what it holds stays in
+// sequence with the previous drain and resumes as soon as it is read. The
+// data registers keep updating alongside.
+bool BMP581::enable_fifo(uint32_t odr_hz) {
+    using config::i2c::addresses::BMP581_ADDR;
+
+    if (!initialized) return false;
+
+    // FIFO settings only take in standby; configure() ends in normal mode
+    bool ok = i2c_bus->write_register(BMP581_ADDR, BMP581_REG_ODR_CONFIG, 0x80) &&
+        i2c_bus->write_register(BMP581_ADDR, BMP581_REG_FIFO_SEL, 0x02) &&        // Pressure, no decimation
+        i2c_bus->write_register(BMP581_ADDR, BMP581_REG_FIFO_CONFIG, 0x20) &&     // Stop-on-full
+        configure(config::bmp581::FIFO_PRESET, odr_hz);
+    if (!ok) {
+        printf("BMP581: Failed to enable the FIFO\n");
+        return false;
+    }
+
+    fifo_clock.start(static_cast<uint32_t>(1'000'000'000ull / odr_hz));
+    fifo_enabled = true;
+    printf("BMP581: FIFO at %lu Hz\n", (unsigned long)odr_hz);
+    return true;
+}
+
+// One FIFO_COUNT read, one burst of whole frames (FIFO_DATA does not
+// advance the register pointer), timed by the FIFO sample clock.
+size_t BMP581::read_fifo(bmp581_sample* out, size_t max) {
+    using config::i2c::addresses::BMP581_ADDR;
+
+    if (!fifo_enabled) return 0;
+
+    uint8_t count_raw;
+    uint64_t start = time_us_64();
+    if (!i2c_bus->read_register(BMP581_ADDR, BMP581_REG_FIFO_COUNT, &count_raw, 1)) return 0;
+    uint64_t count_ns = Timestamp::midpoint(start, time_us_64()).us * 1000;
+
+    size_t frames = std::min<size_t>(count_raw & 0x3F, FIFO_FRAMES);
+    bool overflow = frames == FIFO_FRAMES;
+    size_t n = std::min(frames, max);
+
+    uint8_t raw[FIFO_FRAMES * FIFO_FRAME];
+    if (n && !i2c_bus->read_register(BMP581_ADDR, BMP581_REG_FIFO_DATA, raw, n * FIFO_FRAME)) {
+        fifo_clock.restart();
+        return 0;
+    }
+
+    fifo_stats.drains++;
+    fifo_stats.high_water = std::max<uint32_t>(fifo_stats.high_water, frames);
+    if (frames == 0) return 0;
+
+    // Newest frame in the FIFO
+    uint64_t newest_ns = fifo_clock.place(frames, count_ns, overflow, fifo_stats.lost);
+    int64_t period = fifo_clock.period_ns();
+
+    for (size_t i = 0; i < n; i++) {
+        const uint8_t* f = raw + i * FIFO_FRAME;
+        uint32_t raw_press = (uint32_t)f[0] | ((uint32_t)f[1] << 8) | ((uint32_t)f[2] << 16);
+        out[i] = {
+            .time_us = (newest_ns - (frames - 1 - i) * period) / 1000,
+            .pressure = raw_press / 64.0f,
+        };
+    }
+    fifo_clock.consumed(newest_ns, frames, n);
+    fifo_stats.samples += n;
+    fifo_stats.period_ns = fifo_clock.period_ns();
+
+    // Taking frames again from the read on; the gap was counted above
+    if (overflow) {
+        fifo_stats.overflows++;
+        fifo_clock.restart();
+    }
+    return n;
+}
+
 bmp581_data BMP581::get_data() {
     return _data;
 }
@@ -106,9 +294,4 @@ void BMP581::clear() {
     _data_ready = false;
 }
 
-float BMP581::calculate_altitude(float pressure) {
-    const float sea_level_pressure = 101325.0f;  // Pa
-    return 44330.0f * (1.0f - powf(pressure / sea_level_pressure, 0.1903f));
-}
-
 } // namespace drivers
\ No newline at end of file
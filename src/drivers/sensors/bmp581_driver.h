@@ -5,38 +5,90 @@
 
 // Project
 #include "i2c_bus.h"
+#include "data_ready.h"
+#include "fifo_clock.h"
+#include "drivers/init_step.h"
+#include "drivers/timestamp.h"
 
 namespace drivers {
 
 // Register addresses
 #define BMP581_REG_CHIP_ID      0x01
 #define BMP581_REG_CHIP_STATUS  0x11
-#define BMP581_REG_TEMP_DATA    0x1D  // 3 bytes
+#define BMP581_REG_INT_CONFIG   0x14
+#define BMP581_REG_INT_SOURCE   0x15
+#define BMP581_REG_FIFO_CONFIG  0x16
+#define BMP581_REG_FIFO_COUNT   0x17
+#define BMP581_REG_FIFO_SEL     0x18
+#define BMP581_REG_TEMP_DATA    0x1D  // 3 bytes, pressure follows
 #define BMP581_REG_PRESS_DATA   0x20  // 3 bytes
 #define BMP581_REG_INT_STATUS   0x27
 #define BMP581_REG_STATUS       0x28  // Data ready status
+#define BMP581_REG_FIFO_DATA    0x29
+#define BMP581_REG_DSP_CONFIG   0x30
+#define BMP581_REG_DSP_IIR      0x31
 #define BMP581_REG_PWR_CTRL     0x33
 #define BMP581_REG_OSR_CONFIG   0x36
 #define BMP581_REG_ODR_CONFIG   0x37
 #define BMP581_REG_OSR_EFF      0x38
 #define BMP581_REG_CMD          0x7E  // Command register for soft reset
 
+// DSP_CONFIG: comp_pt_en (bits 1:0), iir_flush_forced_en, then which of the
+// data registers (shadow) and the FIFO take each IIR output
+#define BMP581_DSP_SHDW_SEL_IIR_T   0x08
+#define BMP581_DSP_FIFO_SEL_IIR_T   0x10
+#define BMP581_DSP_SHDW_SEL_IIR_P   0x20
+#define BMP581_DSP_FIFO_SEL_IIR_P   0x40
+
 // Sensor data structure
 struct bmp581_data {
     float temperature;  // Celsius
     float pressure;     // Pascals
     float altitude;     // Meters
+    Timestamp time;     // Midpoint of the burst read, or the data-ready edge
     bool valid;
 };
 
+// One FIFO frame (pressure only)
+struct bmp581_sample {
+    uint64_t time_us;   // Reconstructed conversion instant (boot µs)
+    float pressure;     // Pascals
+};
+
+struct bmp581_fifo_stats {
+    uint32_t drains = 0;
+    uint32_t samples = 0;
+    uint32_t overflows = 0;     // FIFO found full: conversions were refused
+    uint32_t lost = 0;          // Estimated conversions refused
+    uint32_t high_water = 0;    // Frames
+    uint32_t period_ns = 0;     // Measured conversion period
+};
+
 class BMP581 {
 private:
     I2CBus* i2c_bus;
     bool initialized;
     bmp581_data _data;
     bool _data_ready;
-    
-    float calculate_altitude(float pressure);
+    DataReady data_ready;
+
+    // Asynchronous temperature + pressure burst (request() -> collect())
+    I2CTransaction _read;
+    uint8_t _raw[6];
+    uint64_t _edge_us = 0;
+    bool _requested = false;
+
+    // FIFO sample clock: the period is measured over 1.1 to 8.5 s at 240 Hz
+    bool fifo_enabled = false;
+    FifoClock fifo_clock{256, 2048};
+    bmp581_fifo_stats fifo_stats;
+
+    // Stepwise bring-up (init_step())
+    enum class InitPhase : uint8_t { RESET, CONFIGURE, SETTLE, DONE };
+    InitPhase init_phase = InitPhase::DONE;
+    uint64_t init_wait_until_us = 0;
+
+    static bool odr_select(uint32_t hz, uint8_t& sel);
 
 public:
     BMP581() : i2c_bus(nullptr), initialized(false), _data_ready(false) {
@@ -44,9 +96,33 @@ public:
     }
     
     bool init(I2CBus* bus);
+    void begin_init(I2CBus* bus);           // Then init_step() until it is done
+    InitStep init_step(uint64_t now_us);
     bool update();              // Reads from sensor, returns true if new data
     bmp581_data get_data();     // Returns cached data
     void clear();               // Clears data ready flag
+
+    // update() in two halves around other work: request() queues the burst
+    // read on the bus and returns, collect() waits for it and converts
+    bool request();
+    bool collect();
+
+    // Oversampling and IIR from a preset, normal mode at odr_hz (init()
+    // applies config::bmp581::PRESET)
+    bool configure(const config::bmp581::Preset& preset, uint32_t odr_hz);
+    bool set_odr(uint32_t hz);  // Normal mode at hz (one of the datasheet rates)
+
+    // INT pulses at every conversion; update() then reads only fresh samples
+    bool enable_data_ready(uint pin, DataReady::Notify notify = nullptr, void* context = nullptr);
+    SampleStats get_sample_stats() const { return data_ready.get_stats(); }
+
+    // ---- FIFO batch mode ----
+    static constexpr size_t FIFO_FRAME = 3;                 // Pressure, LSB first
+    static constexpr size_t FIFO_FRAMES = 32;               // Most a drain returns
+
+    bool enable_fifo(uint32_t odr_hz);                      // After init(); config::bmp581::FIFO_PRESET
+    size_t read_fifo(bmp581_sample* out, size_t max);       // Oldest first
+    const bmp581_fifo_stats& get_fifo_stats() const { return fifo_stats; }
 };
 
 } // namespace drivers
\ No newline at end of file
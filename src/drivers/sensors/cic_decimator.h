@@ -0,0 +1,65 @@
+#pragma once
+
+// NOTE: Pico SDK free so host tools and the simulator can use it as well.
+#include <bit>
+#include <cstdint>
+
+namespace drivers {
+
+// ============================================
+// CIC Decimator
+// ============================================
+// Cascaded integrator-comb filter: ORDER running sums at the input rate,
+// ORDER first differences at 1/RATIO of it, so a moving average of
+// RATIO samples convolved with itself ORDER times for an add per stage and
+// no multiplies. The sums wrap in 32 bits; that is exact as long as the
+// output fits (INPUT_BITS + ORDER * log2(RATIO) bits), which the
+// static_assert holds the parameters to. Linear phase: an output describes
+// the input ORDER * (RATIO - 1) / 2 samples before the newest one.
+template<unsigned ORDER, uint32_t RATIO, unsigned INPUT_BITS = 16>
+class CicDecimator {
+    static_assert(ORDER >= 1 && RATIO >= 2);
+    static_assert(INPUT_BITS + ORDER * std::bit_width(RATIO - 1) <= 32, "CIC output overflows 32 bits");
+
+public:
+    static constexpr uint32_t gain() {
+        uint32_t g = 1;
+        for (unsigned i = 0; i < ORDER; i++) g *= RATIO;
+        return g;
+    }
+
+    // Input samples between the newest one and the instant an output describes
+    static constexpr float group_delay() { return ORDER * (RATIO - 1) / 2.0f; }
+
+    void reset() { *this = CicDecimator{}; }
+
+    // Takes one input sample; every RATIO-th returns true with out, in input
+    // units. The first ORDER - 1 outputs still include the zeros the filter
+    // started from and are held back.
+    bool push(uint16_t x, float& out) {
+        uint32_t acc = x;
+        for (auto& s : integrators) acc = s += acc;
+        if (++phase < RATIO) return false;
+        phase = 0;
+
+        for (auto& d : combs) {
+            uint32_t previous = d;
+            d = acc;
+            acc -= previous;
+        }
+        if (warmup < ORDER - 1) {
+            warmup++;
+            return false;
+        }
+        out = static_cast<float>(acc) * (1.0f / gain());
+        return true;
+    }
+
+private:
+    uint32_t integrators[ORDER] = {};
+    uint32_t combs[ORDER] = {};
+    uint32_t phase = 0;
+    unsigned warmup = 0;
+};
+
+} // namespace drivers
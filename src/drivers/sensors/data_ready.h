@@ -0,0 +1,102 @@
+#pragma once
+
+// Project Omni-Header
+#include "config/all_headers.h"
+
+// Project
+#include "drivers/gpio_irq.h"
+
+namespace drivers {
+
+// Per-sensor sample accounting, with or without an INT pin
+struct SampleStats {
+    uint32_t edges = 0;         // Data-ready interrupts
+    uint32_t missed = 0;        // Samples replaced by a newer one before they were read
+    uint32_t duplicates = 0;    // Reads skipped (or found stale) because nothing new was converted
+};
+
+// ============================================
+// Sensor Data-Ready Interrupt
+// ============================================
+// The sensor pulses its INT pin when a new sample lands in its output
+// registers. The edge IRQ stamps it with time_us_64() and marks it
+// pending; the driver claims it with take() before reading, so every read
+// returns a fresh sample stamped at the instant it was converted. With
+// nothing pending the read would return the previous sample again and is
+// skipped. An edge that finds the previous one still pending means a
+// sample was never read.
+//
+// The optional notify hook runs in the IRQ right after the stamp, e.g. to
+// release the task that performs the read.
+class DataReady {
+public:
+    using Notify = void (*)(void* context, uint64_t edge_us);
+
+    // INT configured active high, pulsed, push-pull on the sensor side
+    bool start(uint pin, Notify notify = nullptr, void* context = nullptr) {
+        gpio_init(pin);
+        gpio_set_dir(pin, GPIO_IN);
+        gpio_pull_down(pin);
+        _notify = notify;
+        _context = context;
+        if (!GpioIrq::attach(pin, GPIO_IRQ_EDGE_RISE, on_edge, this)) return false;
+        _pin = pin;
+        _active = true;
+        return true;
+    }
+
+    void stop() {
+        if (!_active) return;
+        GpioIrq::detach(_pin, GPIO_IRQ_EDGE_RISE);
+        _active = false;
+    }
+
+    bool active() const { return _active; }
+
+    // Claims the newest unread edge; false (counted as a duplicate) if none
+    bool take(uint64_t& edge_us) {
+        uint32_t status = save_and_disable_interrupts();
+        bool fresh = _pending;
+        _pending = false;
+        edge_us = _edge_us;
+        restore_interrupts(status);
+
+        if (!fresh) _duplicates++;
+        return fresh;
+    }
+
+    SampleStats get_stats() const {
+        uint32_t status = save_and_disable_interrupts();
+        SampleStats copy = {_edges, _missed, _duplicates};
+        restore_interrupts(status);
+        return copy;
+    }
+
+private:
+    uint _pin = 0;
+    bool _active = false;
+    Notify _notify = nullptr;
+    void* _context = nullptr;
+
+    // IRQ side
+    volatile bool _pending = false;
+    volatile uint64_t _edge_us = 0;
+    uint32_t _edges = 0;
+    uint32_t _missed = 0;
+
+    uint32_t _duplicates = 0;   // Consumer side
+
+    static void on_edge(void* context, uint, uint32_t events) {
+        uint64_t now = time_us_64();
+        auto* self = static_cast<DataReady*>(context);
+        if (!(events & GPIO_IRQ_EDGE_RISE)) return;
+
+        self->_edges++;
+        if (self->_pending) self->_missed++;
+        self->_edge_us = now;
+        self->_pending = true;
+        if (self->_notify) self->_notify(self->_context, now);
+    }
+};
+
+} // namespace drivers
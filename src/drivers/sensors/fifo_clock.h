@@ -0,0 +1,95 @@
+#pragma once
+
+// NOTE: Pico SDK free so host tools and the simulator can use it as well.
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace drivers {
+
+// ============================================
+// FIFO Sample Clock
+// ============================================
+// Times for the frames of an on-chip FIFO drained in bursts, the sensor
+// running on its own oscillator. The frames follow the previously
+// delivered one at the measured period, and the newest frame, latched on
+// average half a period before the count was read, pulls the clock towards
+// it. That anchor is only good to half a period either way, so the period
+// is taken from the anchors over a long baseline rather than from drain to
+// drain: at least min_frames and at most (a sliding) window frames.
+class FifoClock {
+public:
+    constexpr FifoClock(uint32_t min_frames, uint32_t window) : min_frames(min_frames), window(window) {}
+
+    void start(uint32_t nominal_ns) {
+        nominal_ns_ = nominal_ns;
+        period_ns_ = nominal_ns;
+        synced = false;
+    }
+
+    // Next drain starts over (after the FIFO was reset)
+    void restart() { synced = false; }
+
+    // The FIFO held `frames` when its count was read at count_ns; `full`:
+    // it had stopped taking frames, the ones it refused are added to lost.
+    // Returns the newest frame's time; frame i is at
+    // newest - (frames - 1 - i) * period_ns().
+    uint64_t place(size_t frames, uint64_t count_ns, bool full, uint32_t& lost) {
+        int64_t period = period_ns_;
+        uint64_t anchor_ns = count_ns - period / 2;
+        uint64_t newest_ns = anchor_ns;
+        bool rebase = true;
+        if (synced) {
+            uint64_t predicted_ns = last_ns + frames * period;
+            int64_t error = static_cast<int64_t>(anchor_ns - predicted_ns);
+            if (full) {
+                newest_ns = predicted_ns;
+                if (error > 0) lost += static_cast<uint32_t>((error + period / 2) / period);
+            } else if (error > -2 * period && error < 2 * period) {
+                newest_ns = predicted_ns + error / 8;
+                rebase = false;
+
+                base_frames += static_cast<uint32_t>(frames - pending);
+                if (base_frames >= min_frames) {
+                    period = static_cast<int64_t>(anchor_ns - base_ns) / base_frames;
+                    period = std::clamp<int64_t>(period, nominal_ns_ - nominal_ns_ / 20,
+                                                 nominal_ns_ + nominal_ns_ / 20);
+                    period_ns_ = static_cast<uint32_t>(period);
+                }
+                // Slide the baseline along the measured period
+                if (base_frames > window) {
+                    base_ns += (base_frames - window) * period;
+                    base_frames = window;
+                }
+            }
+        }
+        if (rebase) {
+            base_ns = anchor_ns;
+            base_frames = 0;
+        }
+        return newest_ns;
+    }
+
+    // n of the placed frames were delivered, the rest wait for the next drain
+    void consumed(uint64_t newest_ns, size_t frames, size_t n) {
+        last_ns = newest_ns - (frames - n) * period_ns_;
+        pending = static_cast<uint32_t>(frames - n);
+        synced = true;
+    }
+
+    uint32_t period_ns() const { return period_ns_; }
+
+private:
+    uint32_t min_frames;
+    uint32_t window;
+
+    bool synced = false;
+    uint64_t last_ns = 0;           // Newest frame delivered
+    uint32_t period_ns_ = 0;
+    uint32_t nominal_ns_ = 0;
+    uint32_t pending = 0;           // Frames the last drain left in the FIFO
+    uint64_t base_ns = 0;           // Period baseline: an earlier newest frame...
+    uint32_t base_frames = 0;       // ...and the frames since
+};
+
+} // namespace drivers
@@ -2,39 +2,317 @@
 
 // Project Omni-Header
 #include "config/all_headers.h"
+#include "config/config.h"
 
 namespace drivers {
 
+// ============================================
+// I2C Transaction
+// ============================================
+// One register transfer for the asynchronous queue (I2CBus::submit()):
+// the register pointer, then len bytes read into data (READ) or written
+// from it (WRITE); RECEIVE reads with no pointer, for parts without a
+// register map (MS4525DO). The descriptor and its buffer belong to the
+// bus until busy clears; done runs in the completion IRQ. The bus fills
+// in the result and when the transaction was queued, got the bus and
+// finished.
+struct I2CTransaction {
+    static constexpr size_t MAX_LEN = 64;
+
+    enum class Op : uint8_t { READ, WRITE, RECEIVE };
+    using Callback = void (*)(I2CTransaction& t);
+
+    uint8_t addr = 0;
+    uint8_t reg = 0;
+    Op op = Op::READ;
+    uint8_t* data = nullptr;
+    size_t len = 0;
+    Callback done = nullptr;
+    void* context = nullptr;
+
+    volatile bool busy = false;
+    int result = 0;             // Bytes transferred, or a negative PICO_ERROR_* code
+    uint64_t queued_us = 0;
+    uint64_t start_us = 0;
+    uint64_t end_us = 0;
+
+    bool ok() const { return !busy && result == (int)len; }
+    uint32_t wait_us() const { return static_cast<uint32_t>(start_us - queued_us); }
+    uint32_t bus_us() const { return static_cast<uint32_t>(end_us - start_us); }
+};
+
+// ============================================
+// I2C Backend
+// ============================================
+// The transport under I2CBus. On the board this is the RP2350 controller
+// through the SDK; host builds plug in their own (device models on a
+// virtual clock) without touching the drivers. Return values follow the
+// SDK: bytes transferred, or a negative PICO_ERROR_* code. A timeout of 0
+// means blocking.
+class I2CBackend {
+public:
+    virtual ~I2CBackend() = default;
+
+    virtual int write(uint8_t addr, const uint8_t* src, size_t len, bool nostop, uint32_t timeout_us) = 0;
+    virtual int read(uint8_t addr, uint8_t* dst, size_t len, bool nostop, uint32_t timeout_us) = 0;
+
+    // Starts a transaction and returns; complete(owner, result) follows
+    // once it is off the bus (the board backend: from the I2C IRQ). Without
+    // a transfer engine it runs right here, blocking.
+    using Complete = void (*)(void* owner, int result);
+
+    virtual void start(const I2CTransaction& t, Complete complete, void* owner) {
+        complete(owner, run_blocking(t));
+    }
+
+    // Drops the transaction in flight; its completion never comes
+    virtual void abort() {}
+
+protected:
+    int run_blocking(const I2CTransaction& t) {
+        if (t.op == I2CTransaction::Op::RECEIVE) return read(t.addr, t.data, t.len, false, 0);
+        if (t.op == I2CTransaction::Op::READ) {
+            if (write(t.addr, &t.reg, 1, true, 0) < 1) return PICO_ERROR_GENERIC;
+            return read(t.addr, t.data, t.len, false, 0);
+        }
+
+        uint8_t buf[I2CTransaction::MAX_LEN + 1];
+        buf[0] = t.reg;
+        memcpy(buf + 1, t.data, t.len);
+        int written = write(t.addr, buf, t.len + 1, false, 0);
+        return written > 0 ? written - 1 : written;
+    }
+};
+
+class PicoI2CBackend : public I2CBackend {
+public:
+    explicit PicoI2CBackend(i2c_inst_t* i2c = nullptr) : _i2c(i2c) {}
+
+    int write(uint8_t addr, const uint8_t* src, size_t len, bool nostop, uint32_t timeout_us) override {
+        return timeout_us ? i2c_write_timeout_us(_i2c, addr, src, len, nostop, timeout_us)
+                          : i2c_write_blocking(_i2c, addr, src, len, nostop);
+    }
+
+    int read(uint8_t addr, uint8_t* dst, size_t len, bool nostop, uint32_t timeout_us) override {
+        return timeout_us ? i2c_read_timeout_us(_i2c, addr, dst, len, nostop, timeout_us)
+                          : i2c_read_blocking(_i2c, addr, dst, len, nostop);
+    }
+
+    i2c_inst_t* get() { return _i2c; }
+
+    // ---- DMA transfer engine ----
+    // The TX channel feeds IC_DATA_CMD with command words (register
+    // pointer, then read commands or data, RESTART before the first read
+    // and STOP on the last) and the RX channel empties the RX FIFO into
+    // the buffer, both paced by the controller's DREQs. STOP_DET or
+    // TX_ABRT (address NAK) ends the transaction in the I2C IRQ, which is
+    // unmasked only while one is in flight so the SDK's blocking calls,
+    // which poll the same flags, are unaffected.
+
+    // Claims two channels and the controller's IRQ; false leaves start() blocking
+    bool enable_dma() {
+        if (has_dma()) return true;
+        uint index = i2c_get_index(_i2c);
+        if (irq_owner[index]) return false;
+
+        int tx = dma_claim_unused_channel(false);
+        int rx = dma_claim_unused_channel(false);
+        if (tx < 0 || rx < 0) {
+            if (tx >= 0) dma_channel_unclaim(tx);
+            if (rx >= 0) dma_channel_unclaim(rx);
+            return false;
+        }
+        _tx_dma = tx;
+        _rx_dma = rx;
+
+        _tx_config = dma_channel_get_default_config(tx);
+        channel_config_set_transfer_data_size(&_tx_config, DMA_SIZE_32);
+        channel_config_set_read_increment(&_tx_config, true);
+        channel_config_set_write_increment(&_tx_config, false);
+        channel_config_set_dreq(&_tx_config, i2c_get_dreq(_i2c, true));
+
+        _rx_config = dma_channel_get_default_config(rx);
+        channel_config_set_transfer_data_size(&_rx_config, DMA_SIZE_8);
+        channel_config_set_read_increment(&_rx_config, false);
+        channel_config_set_write_increment(&_rx_config, true);
+        channel_config_set_dreq(&_rx_config, i2c_get_dreq(_i2c, false));
+
+        irq_owner[index] = this;
+        irq_set_exclusive_handler(I2C0_IRQ + index, index ? on_irq<1> : on_irq<0>);
+        irq_set_enabled(I2C0_IRQ + index, true);
+        return true;
+    }
+
+    bool has_dma() const { return _tx_dma >= 0; }
+
+    void start(const I2CTransaction& t, Complete complete, void* owner) override {
+        if (!has_dma()) {
+            I2CBackend::start(t, complete, owner);
+            return;
+        }
+
+        bool reading = t.op != I2CTransaction::Op::WRITE;
+        bool pointer = t.op != I2CTransaction::Op::RECEIVE;
+        size_t words = 0;
+        if (pointer) _cmd[words++] = t.reg;
+        for (size_t i = 0; i < t.len; i++) {
+            _cmd[words++] = reading ? I2C_IC_DATA_CMD_CMD_BITS | (i == 0 && pointer ? I2C_IC_DATA_CMD_RESTART_BITS : 0)
+                                    : t.data[i];
+        }
+        _cmd[words - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+        _complete = complete;
+        _owner = owner;
+        _len = t.len;
+        _reading = reading;
+
+        i2c_hw_t* hw = i2c_get_hw(_i2c);
+        hw->enable = 0;
+        hw->tar = t.addr;
+        hw->enable = 1;
+        hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+
+        // RX armed first: it only moves once the reads come back
+        if (reading) dma_channel_configure(_rx_dma, &_rx_config, t.data, &hw->data_cmd, t.len, true);
+        dma_channel_configure(_tx_dma, &_tx_config, &hw->data_cmd, _cmd, words, true);
+    }
+
+    void abort() override {
+        if (!has_dma()) return;
+        i2c_hw_t* hw = i2c_get_hw(_i2c);
+        hw->intr_mask = 0;
+        dma_channel_abort(_tx_dma);
+        dma_channel_abort(_rx_dma);
+        hw->enable = 0;     // Flushes the FIFOs; the next transfer re-enables
+        _complete = nullptr;
+    }
+
+private:
+    i2c_inst_t* _i2c;
+
+    int _tx_dma = -1;
+    int _rx_dma = -1;
+    dma_channel_config _tx_config = {};
+    dma_channel_config _rx_config = {};
+    uint32_t _cmd[I2CTransaction::MAX_LEN + 1] = {};
+
+    // Transaction in flight (IRQ side)
+    Complete _complete = nullptr;
+    void* _owner = nullptr;
+    size_t _len = 0;
+    bool _reading = false;
+
+    static inline PicoI2CBackend* irq_owner[2] = {};
+
+    template<uint Index>
+    static void on_irq() {
+        if (irq_owner[Index]) irq_owner[Index]->handle_irq();
+    }
+
+    void handle_irq() {
+        i2c_hw_t* hw = i2c_get_hw(_i2c);
+        uint32_t status = hw->intr_stat;
+        int result;
+
+        if (status & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+            // NAK: the controller flushed the TX FIFO and is sending STOP
+            dma_channel_abort(_tx_dma);
+            dma_channel_abort(_rx_dma);
+            while (!(hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_STOP_DET_BITS)) tight_loop_contents();
+            (void)hw->clr_tx_abrt;
+            result = PICO_ERROR_GENERIC;
+        } else if (status & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+            // The last byte may still be on its way out of the RX FIFO
+            while (_reading && dma_channel_is_busy(_rx_dma)) tight_loop_contents();
+            result = static_cast<int>(_len);
+        } else {
+            return;
+        }
+        (void)hw->clr_stop_det;
+        hw->intr_mask = 0;
+
+        Complete complete = _complete;
+        _complete = nullptr;
+        if (complete) complete(_owner, result);
+    }
+};
+
+// ============================================
+// I2C Bus
+// ============================================
+// Blocking calls and a queue of asynchronous transactions share the bus:
+// a blocking call first waits for the queue to run empty. Transactions run
+// in submission order, each started from the previous one's completion, so
+// reads of several sensors go back to back while the CPU does other work.
 class I2CBus {
 public:
-    static constexpr size_t MAX_I2C_TRANSFER = 64;
-    
-    I2CBus() : _i2c(nullptr), _initialized(false) {}
-    
+    static constexpr size_t MAX_I2C_TRANSFER = I2CTransaction::MAX_LEN;
+    static constexpr size_t QUEUE_SIZE = config::i2c::ASYNC_QUEUE;
+    static_assert(std::has_single_bit(QUEUE_SIZE), "ASYNC_QUEUE must be a power of two");
+
+    // Time spent inside transfers, for profiling how much of a task is bus time
+    struct Stats {
+        uint32_t transfers = 0;
+        uint32_t errors = 0;
+        uint64_t bytes = 0;
+        uint64_t busy_us = 0;
+    };
+
+    // Per-transaction latency: queued -> on the bus (wait), on the bus -> done
+    struct AsyncStats {
+        uint32_t completed = 0;
+        uint32_t errors = 0;
+        uint32_t rejected = 0;      // Queue full
+        uint32_t aborted = 0;       // Timed out in wait()
+        uint32_t max_depth = 0;     // Transactions queued or in flight
+        uint32_t max_wait_us = 0;
+        uint64_t total_wait_us = 0;
+        uint32_t max_bus_us = 0;
+        uint64_t total_bus_us = 0;
+
+        uint32_t mean_wait_us() const { return completed ? total_wait_us / completed : 0; }
+        uint32_t mean_bus_us() const { return completed ? total_bus_us / completed : 0; }
+    };
+
+    I2CBus() : _backend(nullptr), _initialized(false) {}
+
     bool init(i2c_inst_t* i2c_port, uint sda_pin, uint scl_pin, uint baudrate = 400000) {
         if (_initialized) return true;
-        
-        _i2c = i2c_port;
-        
+
+        _pico = PicoI2CBackend(i2c_port);
+        _backend = &_pico;
+
         // Initialize I2C
-        i2c_init(_i2c, baudrate);
-        
+        i2c_init(i2c_port, baudrate);
+
         // Setup pins
         gpio_set_function(sda_pin, GPIO_FUNC_I2C);
         gpio_set_function(scl_pin, GPIO_FUNC_I2C);
         gpio_pull_up(sda_pin);
         gpio_pull_up(scl_pin);
-        
+
+        if (config::i2c::ASYNC_DMA && !_pico.enable_dma()) {
+            printf("I2CBus: No DMA channels, asynchronous transfers will block\n");
+        }
+
         _initialized = true;
         return true;
     }
-    
+
+    // Run the drivers on another transport (host simulation, bus recorders)
+    bool init(I2CBackend* backend) {
+        if (_initialized || !backend) return _initialized;
+        _backend = backend;
+        _initialized = true;
+        return true;
+    }
+
     // Check if device is present at address
     bool device_present(uint8_t addr, uint32_t timeout_us = 100000) {
         uint8_t dummy;
         return read_timeout(addr, &dummy, 1, timeout_us) > 0;
     }
-    
+
     // Read register(s) from device
     bool read_register(uint8_t addr, uint8_t reg, uint8_t* data, size_t len) {
         if (write_blocking(addr, &reg, 1, true) < 1) {
@@ -44,49 +322,221 @@ public:
         auto res = read_blocking(addr, data, len) == (int)len;
         return res;
     }
-    
+
     // Write single register
     bool write_register(uint8_t addr, uint8_t reg, uint8_t value) {
         uint8_t buf[2] = {reg, value};
         return write_blocking(addr, buf, 2) == 2;
     }
-    
+
     // Write multiple bytes to register
     bool write_register(uint8_t addr, uint8_t reg, const uint8_t* data, size_t len) {
         if (len + 1 > MAX_I2C_TRANSFER) {
             return false;  // Transfer too large
         }
-        
+
         uint8_t buf[MAX_I2C_TRANSFER];
         buf[0] = reg;
         memcpy(buf + 1, data, len);
         return write_blocking(addr, buf, len + 1) == (int)(len + 1);
     }
-    
+
     // Raw I2C operations with timeout
     int read_timeout(uint8_t addr, uint8_t* data, size_t len, uint32_t timeout_us = 100000) {
-        return i2c_read_timeout_us(_i2c, addr, data, len, false, timeout_us);
+        return transfer(len, [&] { return _backend->read(addr, data, len, false, timeout_us); });
     }
-    
+
     int write_timeout(uint8_t addr, const uint8_t* data, size_t len, uint32_t timeout_us = 100000) {
-        return i2c_write_timeout_us(_i2c, addr, data, len, false, timeout_us);
+        return transfer(len, [&] { return _backend->write(addr, data, len, false, timeout_us); });
     }
-    
+
     // Raw I2C blocking operations
     int read_blocking(uint8_t addr, uint8_t* data, size_t len, bool nostop = false) {
-        return i2c_read_blocking(_i2c, addr, data, len, nostop);
+        return transfer(len, [&] { return _backend->read(addr, data, len, nostop, 0); });
     }
-    
+
     int write_blocking(uint8_t addr, const uint8_t* data, size_t len, bool nostop = false) {
-        return i2c_write_blocking(_i2c, addr, data, len, nostop);
+        return transfer(len, [&] { return _backend->write(addr, data, len, nostop, 0); });
     }
-    
-    i2c_inst_t* get() { return _i2c; }
+
+    // ---- Asynchronous transactions ----
+
+    // Queues t and returns at once; false if the queue is full or t is
+    // malformed or still busy
+    bool submit(I2CTransaction& t) {
+        if (!_backend || t.busy || !t.data || t.len == 0 || t.len > I2CTransaction::MAX_LEN) return false;
+
+        t.result = 0;
+        t.queued_us = time_us_64();
+
+        uint32_t status = save_and_disable_interrupts();
+        uint32_t depth = _tail - _head + (_active ? 1 : 0);
+        bool full = _tail - _head >= QUEUE_SIZE;
+        if (!full) {
+            t.busy = true;
+            _queue[_tail & (QUEUE_SIZE - 1)] = &t;
+            _tail = _tail + 1;
+            _async.max_depth = std::max(_async.max_depth, depth + 1);
+        }
+        restore_interrupts(status);
+
+        if (full) {
+            _async.rejected++;
+            return false;
+        }
+        start_next();
+        return true;
+    }
+
+    bool read_register_async(I2CTransaction& t, uint8_t addr, uint8_t reg, uint8_t* data, size_t len) {
+        t.addr = addr;
+        t.reg = reg;
+        t.op = I2CTransaction::Op::READ;
+        t.data = data;
+        t.len = len;
+        return submit(t);
+    }
+
+    bool receive_async(I2CTransaction& t, uint8_t addr, uint8_t* data, size_t len) {
+        t.addr = addr;
+        t.op = I2CTransaction::Op::RECEIVE;
+        t.data = data;
+        t.len = len;
+        return submit(t);
+    }
+
+    // Sleeps until t completes; on timeout the bus is aborted and everything
+    // queued fails with PICO_ERROR_TIMEOUT
+    bool wait(const I2CTransaction& t, uint32_t timeout_us = config::i2c::ASYNC_TIMEOUT_US) {
+        sleep_while([&] { return t.busy; }, timeout_us);
+        return t.ok();
+    }
+
+    bool wait_idle(uint32_t timeout_us = config::i2c::ASYNC_TIMEOUT_US) {
+        return sleep_while([&] { return !idle(); }, timeout_us);
+    }
+
+    bool idle() const { return !_active && _head == _tail; }
+
+    const AsyncStats& get_async_stats() const { return _async; }
+
+    i2c_inst_t* get() { return _backend == &_pico ? _pico.get() : nullptr; }
     bool is_initialized() { return _initialized; }
-    
+
+    const Stats& get_stats() const { return _stats; }
+    void reset_stats() {
+        _stats = {};
+        _async = {};
+    }
+
 private:
-    i2c_inst_t* _i2c;
+    PicoI2CBackend _pico;
+    I2CBackend* _backend;
     bool _initialized;
+    Stats _stats;
+    AsyncStats _async;
+
+    // Queue (thread side pushes, completion IRQ pops)
+    I2CTransaction* _queue[QUEUE_SIZE] = {};
+    volatile uint32_t _head = 0;
+    volatile uint32_t _tail = 0;
+    I2CTransaction* volatile _active = nullptr;
+
+    template<typename Fn>
+    int transfer(size_t len, Fn&& fn) {
+        if (!_backend) return PICO_ERROR_GENERIC;
+        if (!idle()) wait_idle();
+
+        uint64_t start = time_us_64();
+        int result = fn();
+        _stats.busy_us += time_us_64() - start;
+        count(len, result);
+        return result;
+    }
+
+    void count(size_t len, int result) {
+        _stats.transfers++;
+        if (result == (int)len) {
+            _stats.bytes += len;
+        } else {
+            _stats.errors++;
+        }
+    }
+
+    // Thread or IRQ: puts the oldest queued transaction on an idle bus
+    void start_next() {
+        uint32_t status = save_and_disable_interrupts();
+        I2CTransaction* t = nullptr;
+        if (!_active && _head != _tail) {
+            t = _queue[_head & (QUEUE_SIZE - 1)];
+            _head = _head + 1;
+            _active = t;
+        }
+        restore_interrupts(status);
+        if (!t) return;
+
+        t->start_us = time_us_64();
+        _backend->start(*t, on_complete, this);
+    }
+
+    static void on_complete(void* owner, int result) {
+        auto* bus = static_cast<I2CBus*>(owner);
+        I2CTransaction* t = bus->_active;
+        bus->_active = nullptr;
+        if (t) bus->finish(*t, result);
+        bus->start_next();
+    }
+
+    void finish(I2CTransaction& t, int result) {
+        t.end_us = time_us_64();
+        t.result = result;
+
+        _stats.busy_us += t.bus_us();
+        count(t.len, result);
+        _async.completed++;
+        if (result != (int)t.len) _async.errors++;
+        _async.max_wait_us = std::max(_async.max_wait_us, t.wait_us());
+        _async.total_wait_us += t.wait_us();
+        _async.max_bus_us = std::max(_async.max_bus_us, t.bus_us());
+        _async.total_bus_us += t.bus_us();
+
+        t.busy = false;
+        if (t.done) t.done(t);
+    }
+
+    // Fails the transaction in flight and everything queued behind it
+    void abort_all() {
+        uint32_t status = save_and_disable_interrupts();
+        _backend->abort();
+        if (_active) {
+            _async.aborted++;
+            finish(*_active, PICO_ERROR_TIMEOUT);
+            _active = nullptr;
+        }
+        while (_head != _tail) {
+            _async.aborted++;
+            I2CTransaction* t = _queue[_head & (QUEUE_SIZE - 1)];
+            _head = _head + 1;
+            finish(*t, PICO_ERROR_TIMEOUT);
+        }
+        restore_interrupts(status);
+    }
+
+    // The completion IRQ wakes __wfi() even with interrupts masked
+    template<typename Pred>
+    bool sleep_while(Pred&& busy, uint32_t timeout_us) {
+        uint64_t deadline = time_us_64() + timeout_us;
+        while (busy()) {
+            if (time_us_64() >= deadline) {
+                abort_all();
+                return false;
+            }
+            uint32_t status = save_and_disable_interrupts();
+            if (busy()) __wfi();
+            restore_interrupts(status);
+        }
+        return true;
+    }
 };
 
-} // namespace drivers
\ No newline at end of file
+} // namespace drivers
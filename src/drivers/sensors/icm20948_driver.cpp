@@ -4,123 +4,171 @@
 namespace drivers {
 
 bool ICM20948::init(I2CBus* bus) {
+    begin_init(bus);
+    return InitStep::run([this](uint64_t now_us) { return init_step(now_us); });
+}
+
+void ICM20948::begin_init(I2CBus* bus) {
+    this->i2c_bus = bus;
+    initialized = false;
+    init_phase = InitPhase::RESET;
+    init_wait_until_us = 0;
+}
+
+// Reset (100 ms), wake (20 ms), then configure
+InitStep ICM20948::init_step(uint64_t now_us) {
     using config::i2c::addresses::ICM20948_ADDR;
     using config::icm20948::ACCEL_RANGE;
     using config::icm20948::GYRO_RANGE;
-    
-    this->i2c_bus = bus;
-    
-    // Check if device is present
-    if (!i2c_bus->device_present(ICM20948_ADDR)) {
-        printf("ICM20948: Device not found at address 0x%02X\n", ICM20948_ADDR);
-        return false;
-    }
-    
-    // Select bank 0
-    if (!select_bank(0)) {
-        printf("ICM20948: Failed to select bank 0\n");
-        return false;
-    }
-    
-    // Check chip ID (should be 0xEA for ICM-20948)
-    uint8_t chip_id;
-    if (!i2c_bus->read_register(ICM20948_ADDR, REG_WHO_AM_I, &chip_id, 1)) {
-        printf("ICM20948: Failed to read chip ID\n");
-        return false;
-    }
-    
-    if (chip_id != 0xEA) {
-        printf("ICM20948: Wrong chip ID: 0x%02X (expected 0xEA)\n", chip_id);
-        return false;
-    }
-    
-    // Reset device
-    if (!i2c_bus->write_register(ICM20948_ADDR, REG_PWR_MGMT_1, 0x80)) {
-        printf("ICM20948: Failed to reset device\n");
-        return false;
+
+    if (init_phase == InitPhase::DONE) return InitStep::done(initialized);
+    if (now_us < init_wait_until_us) return InitStep::at(init_wait_until_us);
+    auto wait = [&](InitPhase next, uint64_t us) {
+        init_phase = next;
+        init_wait_until_us = now_us + us;
+        return InitStep::at(init_wait_until_us);
+    };
+    auto fail = [this] {
+        init_phase = InitPhase::DONE;
+        return InitStep::failed();
+    };
+
+    switch (init_phase) {
+    case InitPhase::RESET: {
+        // Check if device is present
+        if (!i2c_bus->device_present(ICM20948_ADDR)) {
+            printf("ICM20948: Device not found at address 0x%02X\n", ICM20948_ADDR);
+            return fail();
+        }
+        
+        // Select bank 0
+        if (!select_bank(0)) {
+            printf("ICM20948: Failed to select bank 0\n");
+            return fail();
+        }
+        
+        // Check chip ID (should be 0xEA for ICM-20948)
+        uint8_t chip_id;
+        if (!i2c_bus->read_register(ICM20948_ADDR, REG_WHO_AM_I, &chip_id, 1)) {
+            printf("ICM20948: Failed to read chip ID\n");
+            return fail();
+        }
+        
+        if (chip_id != 0xEA) {
+            printf("ICM20948: Wrong chip ID: 0x%02X (expected 0xEA)\n", chip_id);
+            return fail();
+        }
+        
+        // Reset device
+        if (!i2c_bus->write_register(ICM20948_ADDR, REG_PWR_MGMT_1, 0x80)) {
+            printf("ICM20948: Failed to reset device\n");
+            return fail();
+        }
+        return wait(InitPhase::WAKE, 100'000);
     }
-    sleep_ms(100);
-    
-    // Wake up device, auto select clock
-    if (!i2c_bus->write_register(ICM20948_ADDR, REG_PWR_MGMT_1, 0x01)) {
-        printf("ICM20948: Failed to wake device\n");
-        return false;
+
+    case InitPhase::WAKE:
+        // Wake up device, auto select clock
+        if (!i2c_bus->write_register(ICM20948_ADDR, REG_PWR_MGMT_1, 0x01)) {
+            printf("ICM20948: Failed to wake device\n");
+            return fail();
+        }
+        return wait(InitPhase::CONFIGURE, 20'000);
+
+    case InitPhase::CONFIGURE:
+    case InitPhase::DONE:
+        break;
     }
-    sleep_ms(20);
     
     // Enable all sensors
     if (!i2c_bus->write_register(ICM20948_ADDR, REG_PWR_MGMT_2, 0x00)) {
         printf("ICM20948: Failed to enable sensors\n");
-        return false;
+        return fail();
     }
     
     // OPTIMIZATION: Batch bank 2 operations
     // Select bank 2 for both accel and gyro config
     if (!select_bank(2)) {
         printf("ICM20948: Failed to select bank 2\n");
-        return false;
+        return fail();
     }
     
     // Configure accelerometer with compile-time range
     if (!i2c_bus->write_register(ICM20948_ADDR, REG_ACCEL_CONFIG, ACCEL_RANGE << 1)) {
         printf("ICM20948: Failed to configure accelerometer\n");
-        return false;
+        return fail();
     }
     
     // Configure gyroscope with compile-time range (still in bank 2)
     if (!i2c_bus->write_register(ICM20948_ADDR, REG_GYRO_CONFIG_1, GYRO_RANGE << 1)) {
         printf("ICM20948: Failed to configure gyroscope\n");
-        return false;
+        return fail();
     }
     
     // Return to bank 0 for data reading
     if (!select_bank(0)) {
         printf("ICM20948: Failed to return to bank 0\n");
-        return false;
+        return fail();
     }
     
+    init_phase = InitPhase::DONE;
     initialized = true;
     _data.valid = false;
     _data_ready = false;
     
     printf("ICM20948: Initialized successfully\n");
-    return true;
+    return InitStep::ready();
 }
 
 bool ICM20948::update() {
+    if (!request()) {
+        _data_ready = false;
+        return false;
+    }
+    return collect();
+}
+
+bool ICM20948::request() {
     using config::i2c::addresses::ICM20948_ADDR;
+
+    if (!initialized || _requested) return false;
+
+    // With the INT pin in use, skip the read unless a new sample is in
+    if (data_ready.active() && !data_ready.take(_edge_us)) return false;
+
+    // OPTIMIZATION: Only select bank 0 if not already there
+    if (current_bank != 0 && !select_bank(0)) return false;
+
+    // OPTIMIZATION: Read only accel + gyro data (12 bytes instead of 20)
+    _requested = i2c_bus->read_register_async(_read, ICM20948_ADDR, REG_ACCEL_XOUT_H, _raw, sizeof(_raw));
+    return _requested;
+}
+
+bool ICM20948::collect() {
     using config::icm20948::ACCEL_SCALE;
     using config::icm20948::GYRO_SCALE;
-    
-    if (!initialized) {
+
+    if (!_requested) {
         _data_ready = false;
         return false;
     }
-    
-    // OPTIMIZATION: Only select bank 0 if not already there
-    if (current_bank != 0) {
-        if (!select_bank(0)) {
-            _data_ready = false;
-            return false;
-        }
-    }
-    
-    // OPTIMIZATION: Read only accel + gyro data (12 bytes instead of 20)
-    uint8_t raw_data[12];
-    if (!i2c_bus->read_register(ICM20948_ADDR, REG_ACCEL_XOUT_H, raw_data, 12)) {
+    _requested = false;
+    if (!i2c_bus->wait(_read)) {
         _data_ready = false;
         return false;
     }
+    _data.time = data_ready.active() ? Timestamp::since_edge(_edge_us, _read.end_us)
+                                     : Timestamp::midpoint(_read.start_us, _read.end_us);
     
     // Parse accelerometer data (bytes 0-5)
-    int16_t accel_x_raw = utils::merge_bytes<int16_t>(raw_data[0], raw_data[1]);
-    int16_t accel_y_raw = utils::merge_bytes<int16_t>(raw_data[2], raw_data[3]);
-    int16_t accel_z_raw = utils::merge_bytes<int16_t>(raw_data[4], raw_data[5]);
+    int16_t accel_x_raw = utils::merge_bytes<int16_t>(_raw[0], _raw[1]);
+    int16_t accel_y_raw = utils::merge_bytes<int16_t>(_raw[2], _raw[3]);
+    int16_t accel_z_raw = utils::merge_bytes<int16_t>(_raw[4], _raw[5]);
     
     // Parse gyroscope data (bytes 6-11)
-    int16_t gyro_x_raw = utils::merge_bytes<int16_t>(raw_data[6], raw_data[7]);
-    int16_t gyro_y_raw = utils::merge_bytes<int16_t>(raw_data[8], raw_data[9]);
-    int16_t gyro_z_raw = utils::merge_bytes<int16_t>(raw_data[10], raw_data[11]);
+    int16_t gyro_x_raw = utils::merge_bytes<int16_t>(_raw[6], _raw[7]);
+    int16_t gyro_y_raw = utils::merge_bytes<int16_t>(_raw[8], _raw[9]);
+    int16_t gyro_z_raw = utils::merge_bytes<int16_t>(_raw[10], _raw[11]);
     
     // Convert to SI units using compile-time scale factors
     _data.accel_x = accel_x_raw * ACCEL_SCALE;
@@ -137,6 +185,151 @@ bool ICM20948::update() {
     return true;
 }
 
+// ============================================
+// Data-Ready Interrupt
+// ============================================
+// INT1 active high, push-pull, 50 µs pulse per sample (not latched, so no
+// status read is needed to re-arm it).
+bool ICM20948::enable_data_ready(uint pin, DataReady::Notify notify, void* context) {
+    using config::i2c::addresses::ICM20948_ADDR;
+
+    if (!initialized || !data_ready.start(pin, notify, context)) return false;
+
+    bool ok = select_bank(0) &&
+        i2c_bus->write_register(ICM20948_ADDR, REG_INT_PIN_CFG, 0x00) &&
+        i2c_bus->write_register(ICM20948_ADDR, REG_INT_ENABLE_1, 0x01);    // RAW_DATA_0_RDY_EN
+    if (!ok) {
+        data_ready.stop();
+        printf("ICM20948: Failed to enable the data-ready interrupt\n");
+        return false;
+    }
+    return true;
+}
+
+// ============================================
+// Output Rate
+// ============================================
+// The sample rate divider only applies with the DLPF in the path (FCHOICE),
+// so both are set here, for gyro and accel alike.
+uint8_t ICM20948::odr_divider(uint32_t odr_hz) {
+    return static_cast<uint8_t>(std::min<uint32_t>((1125 + odr_hz / 2) / odr_hz - 1, 255));
+}
+
+bool ICM20948::set_odr(uint32_t odr_hz, uint8_t dlpf_cfg) {
+    using config::i2c::addresses::ICM20948_ADDR;
+    using config::icm20948::ACCEL_RANGE;
+    using config::icm20948::GYRO_RANGE;
+
+    if (!initialized || odr_hz == 0 || odr_hz > 1125) return false;
+    uint8_t div = odr_divider(odr_hz);
+
+    bool ok = select_bank(2) &&
+        i2c_bus->write_register(ICM20948_ADDR, REG_GYRO_SMPLRT_DIV, div) &&
+        i2c_bus->write_register(ICM20948_ADDR, REG_GYRO_CONFIG_1, (dlpf_cfg << 3) | (GYRO_RANGE << 1) | 0x01) &&
+        i2c_bus->write_register(ICM20948_ADDR, REG_ACCEL_SMPLRT_DIV_1, 0) &&
+        i2c_bus->write_register(ICM20948_ADDR, REG_ACCEL_SMPLRT_DIV_2, div) &&
+        i2c_bus->write_register(ICM20948_ADDR, REG_ACCEL_CONFIG, (dlpf_cfg << 3) | (ACCEL_RANGE << 1) | 0x01) &&
+        select_bank(0);
+    if (!ok) printf("ICM20948: Failed to set the output rate\n");
+    return ok;
+}
+
+// ============================================
+// FIFO Burst Mode
+// ============================================
+// Snapshot mode: a full FIFO stops taking frames instead of overwriting
+// the oldest, so what it holds stays frame aligned and continues the
+// sequence of the previous drain.
+bool ICM20948::enable_fifo(uint32_t odr_hz) {
+    using config::i2c::addresses::ICM20948_ADDR;
+    using config::icm20948::FIFO_DLPF_CFG;
+
+    if (!set_odr(odr_hz, FIFO_DLPF_CFG)) return false;
+    uint8_t div = odr_divider(odr_hz);
+
+    bool ok = i2c_bus->write_register(ICM20948_ADDR, REG_FIFO_EN_2, 0x1E) &&     // Accel, gyro Z/Y/X
+        i2c_bus->write_register(ICM20948_ADDR, REG_FIFO_MODE, 0x01) &&     // Snapshot
+        i2c_bus->write_register(ICM20948_ADDR, REG_USER_CTRL, 0x40) &&     // FIFO_EN
+        reset_fifo();
+    if (!ok) {
+        printf("ICM20948: Failed to enable the FIFO\n");
+        return false;
+    }
+
+    fifo_clock.start(static_cast<uint32_t>(1'000'000'000ull * (1 + div) / 1125));
+    fifo_enabled = true;
+    printf("ICM20948: FIFO at %lu Hz\n", (unsigned long)(1125 / (1 + div)));
+    return true;
+}
+
+bool ICM20948::reset_fifo() {
+    using config::i2c::addresses::ICM20948_ADDR;
+    return i2c_bus->write_register(ICM20948_ADDR, REG_FIFO_RST, 0x1F) &&
+           i2c_bus->write_register(ICM20948_ADDR, REG_FIFO_RST, 0x00);
+}
+
+// One FIFO_COUNT read, one burst of whole frames, timed by the FIFO sample
+// clock.
+size_t ICM20948::read_fifo(icm20948_sample* out, size_t max) {
+    using config::i2c::addresses::ICM20948_ADDR;
+    using config::icm20948::ACCEL_SCALE;
+    using config::icm20948::GYRO_SCALE;
+
+    if (!fifo_enabled || !select_bank(0)) return 0;
+
+    uint8_t count_raw[2];
+    uint64_t start = time_us_64();
+    if (!i2c_bus->read_register(ICM20948_ADDR, REG_FIFO_COUNTH, count_raw, 2)) return 0;
+    uint64_t count_ns = Timestamp::midpoint(start, time_us_64()).us * 1000;
+
+    size_t count = ((count_raw[0] & 0x1F) << 8) | count_raw[1];
+    size_t frames = std::min(count / FIFO_FRAME, FIFO_FRAMES);
+    bool overflow = count + FIFO_FRAME > FIFO_SIZE;
+    size_t n = std::min(frames, max);
+
+    uint8_t raw[FIFO_FRAMES * FIFO_FRAME];
+    if (n && !i2c_bus->read_register(ICM20948_ADDR, REG_FIFO_R_W, raw, n * FIFO_FRAME)) {
+        reset_fifo();
+        fifo_clock.restart();
+        return 0;
+    }
+
+    fifo_stats.drains++;
+    fifo_stats.high_water = std::max<uint32_t>(fifo_stats.high_water, count);
+    if (frames == 0) return 0;
+
+    // Newest frame in the FIFO
+    uint64_t newest_ns = fifo_clock.place(frames, count_ns, overflow, fifo_stats.lost);
+    int64_t period = fifo_clock.period_ns();
+
+    for (size_t i = 0; i < n; i++) {
+        const uint8_t* f = raw + i * FIFO_FRAME;
+        out[i] = {
+            .time_us = (newest_ns - (frames - 1 - i) * period) / 1000,
+            .accel_x = utils::merge_bytes<int16_t>(f[0], f[1]) * ACCEL_SCALE,
+            .accel_y = utils::merge_bytes<int16_t>(f[2], f[3]) * ACCEL_SCALE,
+            .accel_z = utils::merge_bytes<int16_t>(f[4], f[5]) * ACCEL_SCALE,
+            .gyro_x = utils::merge_bytes<int16_t>(f[6], f[7]) * GYRO_SCALE,
+            .gyro_y = utils::merge_bytes<int16_t>(f[8], f[9]) * GYRO_SCALE,
+            .gyro_z = utils::merge_bytes<int16_t>(f[10], f[11]) * GYRO_SCALE,
+        };
+    }
+    fifo_clock.consumed(newest_ns, frames, n);
+    fifo_stats.samples += n;
+    fifo_stats.period_ns = fifo_clock.period_ns();
+
+    // Whatever came in after the FIFO filled is gone, up to the reset too;
+    // start over aligned
+    if (overflow) {
+        fifo_stats.overflows++;
+        fifo_stats.lost += static_cast<uint32_t>(frames - n);
+        reset_fifo();
+        fifo_stats.lost += static_cast<uint32_t>((time_us_64() * 1000 - count_ns + period / 2) / period);
+        fifo_clock.restart();
+    }
+    return n;
+}
+
 icm20948_data ICM20948::get_data() {
     return _data;
 }
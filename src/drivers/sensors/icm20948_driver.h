@@ -5,6 +5,10 @@
 
 // Project
 #include "i2c_bus.h"
+#include "data_ready.h"
+#include "fifo_clock.h"
+#include "drivers/init_step.h"
+#include "drivers/timestamp.h"
 
 namespace drivers {
 
@@ -13,12 +17,24 @@ namespace drivers {
 #define REG_USER_CTRL       0x03
 #define REG_PWR_MGMT_1      0x06
 #define REG_PWR_MGMT_2      0x07
-#define REG_GYRO_CONFIG_1   0x01
-#define REG_ACCEL_CONFIG    0x14
-#define REG_ACCEL_CONFIG_2  0x15
+#define REG_INT_PIN_CFG     0x0F
+#define REG_INT_ENABLE_1    0x11
+#define REG_INT_STATUS_2    0x1B
 #define REG_ACCEL_XOUT_H    0x2D
 #define REG_GYRO_XOUT_H     0x33
+#define REG_FIFO_EN_2       0x67
+#define REG_FIFO_RST        0x68
+#define REG_FIFO_MODE       0x69
+#define REG_FIFO_COUNTH     0x70
+#define REG_FIFO_R_W        0x72
 #define REG_BANK_SEL        0x7F
+// Bank 2
+#define REG_GYRO_SMPLRT_DIV 0x00
+#define REG_GYRO_CONFIG_1   0x01
+#define REG_ACCEL_SMPLRT_DIV_1 0x10
+#define REG_ACCEL_SMPLRT_DIV_2 0x11
+#define REG_ACCEL_CONFIG    0x14
+#define REG_ACCEL_CONFIG_2  0x15
 
 // Sensor data structure (temperature removed)
 struct icm20948_data {
@@ -28,9 +44,30 @@ struct icm20948_data {
     float gyro_x;   // rad/s
     float gyro_y;   // rad/s
     float gyro_z;   // rad/s
+    Timestamp time; // Midpoint of the burst read (on the bus), or the data-ready edge
     bool valid;
 };
 
+// One FIFO frame
+struct icm20948_sample {
+    uint64_t time_us;   // Reconstructed sample instant (boot µs)
+    float accel_x;      // m/s^2
+    float accel_y;
+    float accel_z;
+    float gyro_x;       // rad/s
+    float gyro_y;
+    float gyro_z;
+};
+
+struct icm20948_fifo_stats {
+    uint32_t drains = 0;
+    uint32_t samples = 0;
+    uint32_t overflows = 0;     // FIFO found full: samples were lost, the FIFO was reset
+    uint32_t lost = 0;          // Estimated samples lost to overflows
+    uint32_t high_water = 0;    // Bytes
+    uint32_t period_ns = 0;     // Measured sample period (the sensor runs on its own oscillator)
+};
+
 class ICM20948 {
 private:
     I2CBus* i2c_bus;
@@ -38,8 +75,27 @@ private:
     icm20948_data _data;
     bool _data_ready;
     uint8_t current_bank;  // Cache current bank to avoid redundant switches
-    
+    DataReady data_ready;
+
+    // Asynchronous accel + gyro read (request() -> collect())
+    I2CTransaction _read;
+    uint8_t _raw[12];
+    uint64_t _edge_us = 0;
+    bool _requested = false;
+
+    // FIFO sample clock: the period is measured over 0.9 to 7.3 s at 1125 Hz
+    bool fifo_enabled = false;
+    FifoClock fifo_clock{1024, 8192};
+    icm20948_fifo_stats fifo_stats;
+
+    // Stepwise bring-up (init_step())
+    enum class InitPhase : uint8_t { RESET, WAKE, CONFIGURE, DONE };
+    InitPhase init_phase = InitPhase::DONE;
+    uint64_t init_wait_until_us = 0;
+
     bool select_bank(uint8_t bank);
+    bool reset_fifo();
+    static uint8_t odr_divider(uint32_t odr_hz);
 
 public:
     ICM20948() : i2c_bus(nullptr), initialized(false), _data_ready(false), current_bank(0xFF) {
@@ -47,9 +103,35 @@ public:
     }
     
     bool init(I2CBus* bus);
+    void begin_init(I2CBus* bus);           // Then init_step() until it is done
+    InitStep init_step(uint64_t now_us);
     bool update();              // Reads from sensor, returns true if new data
     icm20948_data get_data();  // Returns cached data
     void clear();               // Clears data ready flag
+
+    // update() in two halves around other work: request() queues the read
+    // on the bus and returns, collect() waits for it and converts
+    bool request();
+    bool collect();
+
+    // Output rate through the DLPF and sample rate divider (1125 / (1 + div),
+    // odr_hz up to 1125). Without it the DLPF is bypassed and the registers
+    // refresh at the raw 9 kHz gyro / 4.5 kHz accel rates.
+    bool set_odr(uint32_t odr_hz, uint8_t dlpf_cfg);
+
+    // INT1 pulses at every sample; update() then reads only fresh samples.
+    // Set the rate first: INT1 pulses at whatever the output rate is.
+    bool enable_data_ready(uint pin, DataReady::Notify notify = nullptr, void* context = nullptr);
+    SampleStats get_sample_stats() const { return data_ready.get_stats(); }
+
+    // ---- FIFO burst mode ----
+    static constexpr size_t FIFO_SIZE = 512;
+    static constexpr size_t FIFO_FRAME = 12;                        // Accel + gyro, big-endian
+    static constexpr size_t FIFO_FRAMES = FIFO_SIZE / FIFO_FRAME;   // Most a drain returns
+
+    bool enable_fifo(uint32_t odr_hz);                      // After init(); odr_hz up to 1125
+    size_t read_fifo(icm20948_sample* out, size_t max);     // Oldest first
+    const icm20948_fifo_stats& get_fifo_stats() const { return fifo_stats; }
 };
 
 } // namespace drivers
\ No newline at end of file
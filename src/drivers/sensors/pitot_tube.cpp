@@ -31,54 +31,111 @@ bool PitotTube::init(I2CBus* bus, float range_psi) {
     initialized = true;
     _data.valid = false;
     _data_ready = false;
-    calibrated = false;
     
-    printf("MS4525DO: Initialized successfully (range: %.1f PSI)\n", pressure_range);
+    printf("MS4525DO: Initialized successfully (range: +/-%.1f PSI)\n", pressure_range);
     return true;
 }
 
-bool PitotTube::calibrate_zero(int num_samples) {
-    if (!initialized) {
-        return false;
-    }
-    
-    float pressure_sum = 0.0f;
-    int valid_readings = 0;
-    
-    for (int i = 0; i < num_samples; i++) {
-        uint8_t buffer[4];
-        
-        if (i2c_bus->read_blocking(config::i2c::addresses::PITOT, buffer, 4) == 4) {
-            uint8_t status = (buffer[0] & 0xC0) >> 6;
-            
-            // Only use normal readings (status = 0)
+// Type A output: 10 % of full scale at -range, 90 % at +range
+float PitotTube::pressure_pa(float counts) const {
+    using config::pitot_tube::PSI_TO_PA;
+    float psi = (counts - 1638.0f) * (2.0f * pressure_range) / (14745.0f - 1638.0f) - pressure_range;
+    return psi * PSI_TO_PA;
+}
+
+// Zero removal and airspeeds for one output, in counts (fractional when
+// filtered)
+void PitotTube::publish(float bridge_counts, float temp_counts, Timestamp time) {
+    using config::pitot_tube::PSI_TO_PA;
+    using config::pitot_tube::MS_TO_MPH;
+
+    float p = pressure_pa(bridge_counts);
+    float t = temperature_c(temp_counts);
+    bool locked = zero.locked();
+    if (!zero.add(p, t) && locked) zero_stats.rejected++;
+    float z = zero.zero(t);
+    zero_stats.zero_pa = z;
+    zero_stats.slope_pa_per_c = zero.slope();
+
+    _data.time = time;
+    _data.pressure_psi = (p - z) / PSI_TO_PA;
+    _data.temperature_c = t;
+    
+    // Calculate airspeeds (negative differential pressure reads 0)
+    airspeeds speeds = air_data.compute(p - z);
+    _data.airspeed_ms = speeds.ias_ms;
+    _data.airspeed_mph = speeds.ias_ms * MS_TO_MPH;
+    _data.cas_ms = speeds.cas_ms;
+    _data.tas_ms = speeds.tas_ms;
+    _data.mach = speeds.mach;
+    
+    _data.zeroed = zero.locked();
+    _data.valid = true;
+    _data_ready = true;
+}
+
+// One sample slot into both filters (same phase); on an output, the
+// reading it describes is published
+bool PitotTube::filter(uint64_t sample_us, uint64_t end_us) {
+    float bridge = 0.0f, temp = 0.0f;
+    bool output = bridge_filter.push(_bridge, bridge);
+    temp_filter.push(_temp, temp);
+    if (!output) return false;
+
+    // The output describes the input group_delay() slots back
+    uint64_t center = sample_us - static_cast<uint64_t>(Decimator::group_delay() * SAMPLE_US);
+    publish(bridge, temp, {center, static_cast<uint32_t>(end_us - center)});
+    return true;
+}
+
+bool PitotTube::acquire() {
+    using config::i2c::addresses::PITOT;
+    using config::pitot_tube::DECIMATION;
+
+    if (!initialized) return false;
+
+    bool produced = false;
+    if (_requested) {
+        // Still queued behind other transactions: the slot is filled below
+        if (_read.busy) return false;
+        _requested = false;
+
+        if (_read.ok()) {
+            uint64_t mid = Timestamp::midpoint(_read.start_us, _read.end_us).us;
+
+            // The filter runs on the sensor's time base: slots the task
+            // missed (held up by longer tasks) repeat the last conversion
+            uint32_t held = 0;
+            if (_have_sample) {
+                uint64_t slots = (mid - _last_read_us + SAMPLE_US / 2) / SAMPLE_US;
+                held = static_cast<uint32_t>(std::clamp<uint64_t>(slots, 1, DECIMATION) - 1);
+                sample_stats.missed += held;
+                for (uint32_t i = held; i > 0; i--) produced |= filter(mid - i * SAMPLE_US, _read.end_us);
+            }
+            _last_read_us = mid;
+
+            // Status: 0=normal, 1=command mode, 2=stale data, 3=diagnostic.
+            // A stale read repeats the last conversion as well.
+            uint8_t status = (_raw[0] & 0xC0) >> 6;
             if (status == 0) {
-                uint16_t pressure_raw = ((buffer[0] & 0x3F) << 8) | buffer[1];
-                float pressure_normalized = (float)(pressure_raw - 1638) / (14745.0f - 1638.0f);
-                pressure_sum += pressure_normalized * pressure_range;
-                valid_readings++;
+                _bridge = ((_raw[0] & 0x3F) << 8) | _raw[1];
+                _temp = (_raw[2] << 3) | ((_raw[3] & 0xE0) >> 5);
+                _have_sample = true;
+            } else if (status == 2) {
+                sample_stats.duplicates++;
+            } else {
+                zero_stats.faults++;
             }
+            if (_have_sample) produced |= filter(mid, _read.end_us);
         }
-        
-        sleep_ms(20);
-    }
-    
-    if (valid_readings < (num_samples / 2)) {
-        printf("MS4525DO: Calibration failed - insufficient valid readings\n");
-        return false;
     }
-    
-    zero_offset_psi = pressure_sum / valid_readings;
-    calibrated = true;
-    
-    printf("MS4525DO: Calibration complete (offset: %.6f PSI)\n", zero_offset_psi);
-    return true;
+
+    if (i2c_bus->receive_async(_read, PITOT, _raw, sizeof(_raw))) _requested = true;
+    return produced;
 }
 
 bool PitotTube::update() {
     using config::i2c::addresses::PITOT;
-    using config::pitot_tube::STANDARD_AIR_DENSITY;
-    using config::pitot_tube::MS_TO_MPH;
 
     if (!initialized) {
         _data_ready = false;
@@ -88,15 +145,19 @@ bool PitotTube::update() {
     uint8_t buffer[4];
     
     // Read 4 bytes from sensor
+    uint64_t start = time_us_64();
     if (i2c_bus->read_blocking(PITOT, buffer, 4) != 4) {
         _data_ready = false;
         return false;
     }
+    Timestamp time = Timestamp::midpoint(start, time_us_64());
     
     // Parse status (top 2 bits)
     uint8_t status = (buffer[0] & 0xC0) >> 6;
     
     // Status: 0=normal, 1=command mode, 2=stale data, 3=diagnostic
+    if (status == 2) sample_stats.duplicates++;
+    if (status == 3) zero_stats.faults++;
     if (status == 2 || status == 3) {
         _data_ready = false;
         return false;
@@ -108,25 +169,7 @@ bool PitotTube::update() {
     // Extract 11-bit temperature data
     uint16_t temp_raw = (buffer[2] << 3) | ((buffer[3] & 0xE0) >> 5);
     
-    // Convert pressure to PSI (10% to 90% output range)
-    float pressure_normalized = (float)(pressure_raw - 1638) / (14745.0f - 1638.0f);
-    _data.pressure_psi = pressure_normalized * pressure_range;
-    
-    // Apply calibration if available
-    if (calibrated) {
-        _data.pressure_psi -= zero_offset_psi;
-    }
-    
-    // Convert temperature to Celsius
-    _data.temperature_c = (temp_raw * 200.0f / 2047.0f) - 50.0f;
-    
-    // Calculate airspeed
-    _data.airspeed_ms = calculate_airspeed_ms(_data.pressure_psi, STANDARD_AIR_DENSITY);
-    _data.airspeed_mph = _data.airspeed_ms * MS_TO_MPH;
-    
-    _data.valid = true;
-    _data_ready = true;
-    
+    publish(pressure_raw, temp_raw, time);
     return true;
 }
 
@@ -138,18 +181,4 @@ void PitotTube::clear() {
     _data_ready = false;
 }
 
-float PitotTube::calculate_airspeed_ms(float diff_pressure_psi, float air_density) {
-    using config::pitot_tube::PSI_TO_PA;
-    // Convert PSI to Pascals
-    float diff_pressure_pa = diff_pressure_psi * PSI_TO_PA;
-    
-    // Handle negative or very small pressures
-    if (diff_pressure_pa <= 0.0f) {
-        return 0.0f;
-    }
-    
-    // Bernoulli's equation: V = √(2 * ΔP / ρ)
-    return sqrtf((2.0f * diff_pressure_pa) / air_density);
-}
-
 } // namespace drivers
\ No newline at end of file
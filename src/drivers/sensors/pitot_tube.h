@@ -5,47 +5,103 @@
 
 // Project
 #include "i2c_bus.h"
+#include "data_ready.h"
+#include "air_data.h"
+#include "cic_decimator.h"
+#include "zero_estimator.h"
+#include "drivers/timestamp.h"
 
 namespace drivers {
 
 // Sensor data structure
 struct pitot_data {
-    float pressure_psi;         // Differential pressure in PSI
+    float pressure_psi;         // Differential pressure in PSI, zero removed
     float temperature_c;        // Temperature in Celsius
-    float airspeed_ms;          // Airspeed in m/s
-    float airspeed_mph;         // Airspeed in mph
+    float airspeed_ms;          // Indicated airspeed (IAS) in m/s
+    float airspeed_mph;         // IAS in mph
+    float cas_ms;               // Calibrated airspeed in m/s
+    float tas_ms;               // True airspeed in m/s
+    float mach;
+    Timestamp time;             // Midpoint of the read (continuous: the filter's center)
+    bool zeroed;                // Zero estimate locked
     bool valid;
 };
 
+// Background zero state, for the shutdown report
+struct pitot_zero_stats {
+    float zero_pa;              // At the last reading's temperature
+    float slope_pa_per_c;
+    uint32_t rejected;          // Outputs not taken as at rest after the lock
+    uint32_t faults;            // Reads with the diagnostic status
+};
+
+// ============================================
+// MS4525DO Differential Pressure Sensor
+// ============================================
+// No register map: a 4-byte read returns the latest conversion, status
+// and 14-bit bridge, then the 11-bit die temperature. The part converts
+// every 0.5 ms by itself. Continuously (acquire() at SAMPLE_HZ) every
+// conversion is read as an asynchronous transaction and the bridge and
+// temperature counts go through a CIC decimator to the pitot rate, so a
+// record averages its period instead of catching one noisy sample; update()
+// is a single blocking read. Either way the zero comes from ZeroEstimator
+// while the aircraft is at rest, tracked over the sensor's temperature.
 class PitotTube {
 private:
+    using Decimator = CicDecimator<config::pitot_tube::CIC_ORDER, config::pitot_tube::DECIMATION>;
+    static constexpr uint32_t SAMPLE_US = 1'000'000 / config::pitot_tube::SAMPLE_HZ;
 
-    
     I2CBus* i2c_bus;
     bool initialized;
     pitot_data _data;
     bool _data_ready;
+    SampleStats sample_stats;   // No INT pin: duplicates are reads the sensor flags stale
+    pitot_zero_stats zero_stats = {};
     
-    // Calibration
-    float zero_offset_psi;
-    bool calibrated;
-    
-    // Pressure range (typically 1.0 PSI for differential sensors)
+    // Differential range: counts 1638..14745 span -range..+range
     float pressure_range;
+
+    // Continuous acquisition (acquire())
+    I2CTransaction _read;
+    uint8_t _raw[4];
+    bool _requested = false;
+    uint16_t _bridge = 0;       // Last fresh counts, held over stale reads and missed slots
+    uint16_t _temp = 0;
+    bool _have_sample = false;
+    uint64_t _last_read_us = 0;
+    Decimator bridge_filter;
+    Decimator temp_filter;
+
+    ZeroEstimator zero{
+        static_cast<uint32_t>(config::pitot_tube::ZERO_LOCK_S * config::sensors::PITOT_RATE_HZ),
+        static_cast<uint32_t>(config::pitot_tube::ZERO_MEMORY_S * config::sensors::PITOT_RATE_HZ),
+        config::pitot_tube::ZERO_REST_PA, config::pitot_tube::ZERO_TEMPCO_PA_PER_C};
     
-    float calculate_airspeed_ms(float diff_pressure_psi, float air_density);
+    // Static pressure/temperature fused in for CAS and TAS
+    AirData air_data{config::pitot_tube::COMPRESSIBLE_AIRSPEED ? AirData::Model::COMPRESSIBLE
+                                                              : AirData::Model::INCOMPRESSIBLE};
+
+    float pressure_pa(float counts) const;
+    static float temperature_c(float counts) { return counts * 200.0f / 2047.0f - 50.0f; }
+    void publish(float bridge_counts, float temp_counts, Timestamp time);
+    bool filter(uint64_t sample_us, uint64_t end_us);
 
 public:
-    PitotTube() : i2c_bus(nullptr), initialized(false), _data_ready(false), 
-                 zero_offset_psi(0.0f), calibrated(false), pressure_range(1.0f) {
+    PitotTube() : i2c_bus(nullptr), initialized(false), _data_ready(false), pressure_range(1.0f) {
         _data.valid = false;
+        _data.zeroed = false;
     }
     
     bool init(I2CBus* bus, float range_psi = 1.0f);
-    bool calibrate_zero(int num_samples = 50);  // Calibrate when stationary
+    bool acquire();                              // Continuous: call at SAMPLE_HZ, true on a new output
     bool update();                               // Reads from sensor
     pitot_data get_data();                   // Returns cached data
     void clear();                                // Clears data ready flag
+    bool set_static(float pressure_pa, float temperature_c) {   // From the barometer
+        return air_data.set_static(pressure_pa, temperature_c);
+    }
+    SampleStats get_sample_stats() const { return sample_stats; }
+    pitot_zero_stats get_zero_stats() const { return zero_stats; }
 };
 
 } // namespace drivers
\ No newline at end of file
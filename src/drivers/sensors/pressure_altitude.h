@@ -0,0 +1,42 @@
+#pragma once
+
+// NOTE: Pico SDK free so host tools and the simulator can use it as well.
+#include <cmath>
+
+#include "table_math.h"
+
+namespace drivers {
+
+// ============================================
+// Pressure Altitude
+// ============================================
+// Standard atmosphere altitude 44330 * (1 - (p / 101325)^0.1903), from a
+// table every 100 Pa over 30-110 kPa (about 9200 m down to -700 m)
+// interpolated linearly: within 1 cm of the formula in double precision,
+// for the cost of a multiply-add instead of a powf. Pressures outside the
+// table take the formula.
+namespace altitude {
+
+constexpr double SEA_LEVEL_PA = 101325.0;
+constexpr double EXPONENT = 0.1903;
+constexpr double SCALE_M = 44330.0;
+
+constexpr double reference(double pa) {
+    return SCALE_M * (1.0 - table_math::pow(pa / SEA_LEVEL_PA, EXPONENT));
+}
+
+inline constexpr table_math::Table<801> TABLE{30000.0, 100.0, reference};
+
+} // namespace altitude
+
+// Meters above the 101325 Pa level
+inline float pressure_altitude(float pressure) {
+    using namespace altitude;
+    if (!TABLE.contains(pressure)) {
+        return static_cast<float>(SCALE_M) *
+               (1.0f - powf(pressure / static_cast<float>(SEA_LEVEL_PA), static_cast<float>(EXPONENT)));
+    }
+    return TABLE(pressure);
+}
+
+} // namespace drivers
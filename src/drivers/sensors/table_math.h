@@ -0,0 +1,84 @@
+#pragma once
+
+// NOTE: Pico SDK free so host tools and the simulator can use it as well.
+#include <array>
+#include <cstddef>
+
+namespace drivers::table_math {
+
+// ============================================
+// Compile-time Function Tables
+// ============================================
+// Smooth functions the sample paths would otherwise call powf for, sampled
+// at compile time on an even grid and interpolated linearly: a multiply-add
+// and two loads, the same time for every input. std::log/std::exp are not
+// constexpr before C++26, hence ln/exp/pow here (for building tables only).
+
+constexpr double ln(double x) {
+    constexpr double LN2 = 0.693147180559945309417;
+    int k = 0;
+    while (x > 1.5) { x /= 2.0; k++; }
+    while (x < 0.75) { x *= 2.0; k--; }
+    // ln x = 2 atanh((x - 1) / (x + 1)), |y| < 0.2
+    double y = (x - 1.0) / (x + 1.0);
+    double term = y, sum = 0.0;
+    for (int n = 1; n < 40; n += 2) {
+        sum += term / n;
+        term *= y * y;
+    }
+    return 2.0 * sum + k * LN2;
+}
+
+constexpr double exp(double x) {
+    // Halve into |x| < 1/8, then square back
+    int k = 0;
+    while (x > 0.125 || x < -0.125) { x /= 2.0; k++; }
+    double term = 1.0, sum = 1.0;
+    for (int n = 1; n < 16; n++) {
+        term *= x / n;
+        sum += term;
+    }
+    while (k--) sum *= sum;
+    return sum;
+}
+
+constexpr double pow(double x, double y) { return exp(y * ln(x)); }
+
+constexpr double sqrt(double x) {
+    if (x <= 0.0) return 0.0;
+    double r = x > 1.0 ? x : 1.0;
+    for (int i = 0; i < 64; i++) r = 0.5 * (r + x / r);
+    return r;
+}
+
+// f over [x0, x0 + (N - 1) * step]
+template<size_t N>
+class Table {
+public:
+    template<typename Fn>
+    constexpr Table(double x0, double step, Fn&& f)
+        : x0(static_cast<float>(x0)), inv_step(static_cast<float>(1.0 / step)) {
+        for (size_t i = 0; i < N; i++) y[i] = static_cast<float>(f(x0 + i * step));
+    }
+
+    constexpr bool contains(float x) const {
+        float u = (x - x0) * inv_step;
+        return u >= 0.0f && u <= N - 1;
+    }
+
+    // Clamped to the ends outside the range
+    constexpr float operator()(float x) const {
+        float u = (x - x0) * inv_step;
+        if (!(u > 0.0f)) return y[0];
+        if (u >= N - 1) return y[N - 1];
+        size_t i = static_cast<size_t>(u);
+        return y[i] + (y[i + 1] - y[i]) * (u - i);
+    }
+
+private:
+    float x0;
+    float inv_step;
+    std::array<float, N> y{};
+};
+
+} // namespace drivers::table_math
@@ -0,0 +1,77 @@
+#pragma once
+
+// NOTE: Pico SDK free so host tools and the simulator can use it as well.
+#include <cstdint>
+
+namespace drivers {
+
+// ============================================
+// Background Zero Estimator
+// ============================================
+// Offset of a differential sensor learned from the readings it gives at
+// rest instead of a blocking calibration at boot. The first lock_samples
+// readings are taken as at rest (the aircraft is parked at power-up);
+// after that only readings within rest_pa of the current zero are, so
+// flight never moves it. Sums decay with a memory of `memory` readings,
+// centred on the first one to keep float precision.
+//
+// The bridge offset drifts with die temperature, mostly while the board
+// warms up on the ground: once the accepted readings span enough
+// temperature the drift slope is fitted from them and the zero follows
+// the sensor's temperature; until then the configured tempco applies.
+class ZeroEstimator {
+public:
+    static constexpr float MIN_SPREAD_C = 0.25f;    // Temperature std dev to fit the slope
+
+    constexpr ZeroEstimator(uint32_t lock_samples, uint32_t memory, float rest_pa, float tempco_pa_per_c)
+        : lock_samples(lock_samples), decay(1.0f - 1.0f / memory), rest_pa(rest_pa), tempco(tempco_pa_per_c) {}
+
+    // Returns true when the reading was taken as at rest
+    bool add(float p_pa, float t_c) {
+        if (count == 0) {
+            p0 = p_pa;
+            t0 = t_c;
+        } else if (locked()) {
+            float error = p_pa - zero(t_c);
+            if (error > rest_pa || error < -rest_pa) return false;
+        }
+        if (count < lock_samples) count++;
+
+        float dp = p_pa - p0, dt = t_c - t0;
+        w = w * decay + 1.0f;
+        sp = sp * decay + dp;
+        st = st * decay + dt;
+        stt = stt * decay + dt * dt;
+        stp = stp * decay + dt * dp;
+        return true;
+    }
+
+    bool locked() const { return count >= lock_samples; }
+
+    // Pa per °C: fitted, or the configured tempco while the readings span too
+    // little temperature
+    float slope() const {
+        if (w <= 0.0f) return tempco;
+        float mt = st / w;
+        float var = stt / w - mt * mt;
+        if (var < MIN_SPREAD_C * MIN_SPREAD_C) return tempco;
+        return (stp / w - mt * (sp / w)) / var;
+    }
+
+    float zero(float t_c) const {
+        if (w <= 0.0f) return 0.0f;
+        return p0 + sp / w + slope() * (t_c - t0 - st / w);
+    }
+
+private:
+    uint32_t lock_samples;
+    float decay;
+    float rest_pa;
+    float tempco;
+
+    uint32_t count = 0;
+    float p0 = 0.0f, t0 = 0.0f;
+    float w = 0.0f, sp = 0.0f, st = 0.0f, stt = 0.0f, stp = 0.0f;
+};
+
+} // namespace drivers
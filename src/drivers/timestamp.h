@@ -0,0 +1,37 @@
+#pragma once
+
+// NOTE: Pico SDK free so host tools and the simulator can use it as well.
+#include <algorithm>
+#include <cstdint>
+
+namespace drivers {
+
+// ============================================
+// Sample Timestamp
+// ============================================
+// When a sample was acquired, in boot microseconds (time_us_64, no wrap
+// in practice), and how long the acquisition took. For a bus read the
+// stamp is the midpoint of the transaction, where the register contents
+// were latched to within half the latency; downstream analysis can use the
+// latency to bound or correct the acquisition skew between sensors. A
+// sample taken on a data-ready interrupt is stamped at the edge instead,
+// with the latency running from the edge to the end of the read.
+struct Timestamp {
+    uint64_t us = 0;
+    uint32_t latency_us = 0;
+
+    static constexpr Timestamp midpoint(uint64_t start_us, uint64_t end_us) {
+        return {start_us + (end_us - start_us) / 2, static_cast<uint32_t>(end_us - start_us)};
+    }
+
+    static constexpr Timestamp since_edge(uint64_t edge_us, uint64_t end_us) {
+        return {edge_us, static_cast<uint32_t>(end_us - edge_us)};
+    }
+
+    // Log record width
+    constexpr uint16_t latency_u16() const {
+        return static_cast<uint16_t>(std::min<uint32_t>(latency_us, UINT16_MAX));
+    }
+};
+
+} // namespace drivers
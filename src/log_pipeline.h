@@ -0,0 +1,193 @@
+#pragma once
+
+// Project Omni-Header
+#include "config/all_headers.h"
+
+#include "config/config.h"
+#include "drivers/sdcard/sdcard.h"
+#include "log_records.h"
+#include "session_manager.h"
+#include "spsc_ring.h"
+
+namespace logging {
+
+// One slot of the inter-core queue (exactly 64 bytes)
+// A record's length follows from its type, text ends at its NUL
+struct LogEntry {
+    uint8_t type;           // FileType, or LogPipeline::DEBUG_TEXT
+    uint8_t payload[63];
+};
+static_assert(sizeof(LogEntry) == 64);
+
+// ============================================
+// Core 0 -> Core 1 Logging Pipeline
+// ============================================
+// Core 0 samples sensors and pushes fixed-size records; core 1 owns the
+// SDCard, SessionManager and all SDFiles and drains the queue into FatFs,
+// so SD busy-waits never stall sampling.
+//
+// Hand-off rules: everything SD related is set up on core 0 before
+// multicore_launch_core1(), and only touched again by core 0 after
+// isWriterDone() returns true.
+class LogPipeline {
+public:
+    static constexpr uint8_t DEBUG_TEXT = 0xFF;
+
+    struct Stats {
+        uint32_t written;       // Entries committed to an SDFile
+        uint32_t overflows;     // Entries dropped because the queue was full
+        uint32_t high_water;    // Peak queue occupancy (entries)
+        uint32_t orphaned;      // Entries whose file was not open (session change)
+        uint32_t write_errors;  // SDFile write failures
+    };
+
+private:
+    utils::SpscRing<LogEntry, config::pipeline::QUEUE_ENTRIES> ring;
+
+    // Shared flags (written by one core, read by the other)
+    std::atomic<bool> logging_active{false};        // core 1 -> core 0
+    std::atomic<bool> shutdown_requested{false};    // core 1 -> core 0
+    std::atomic<bool> stop_requested{false};        // core 0 -> core 1
+    std::atomic<bool> writer_done{false};           // core 1 -> core 0
+
+    // Consumer-owned statistics
+    uint32_t written = 0;
+    uint32_t orphaned = 0;
+    uint32_t write_errors = 0;
+
+    static size_t length(const LogEntry& entry) {
+        if (entry.type == DEBUG_TEXT) return strnlen(reinterpret_cast<const char*>(entry.payload), sizeof(entry.payload));
+        size_t size = 0;
+        records::visit(entry.type, [&](auto schema) { size = sizeof(typename decltype(schema)::Record); });
+        return size;
+    }
+
+public:
+    // ---- Producer (core 0) ----
+
+    template<FileType T>
+    bool push(const typename records::Schema<T>::Record& record) {
+        static_assert(sizeof(record) <= sizeof(LogEntry::payload), "Record too large for queue slot");
+
+        LogEntry* entry = ring.claim();
+        if (!entry) return false;
+
+        entry->type = T;
+        memcpy(entry->payload, &record, sizeof(record));
+        ring.publish();
+        __sev();  // Wake the writer
+        return true;
+    }
+
+    // Short debug.txt line from core 0 (truncated to the slot size)
+    bool pushText(const char* format, ...) {
+        LogEntry* entry = ring.claim();
+        if (!entry) return false;
+
+        va_list args;
+        va_start(args, format);
+        int len = vsnprintf(reinterpret_cast<char*>(entry->payload), sizeof(entry->payload), format, args);
+        va_end(args);
+
+        if (len < 0) return false;
+
+        entry->type = DEBUG_TEXT;
+        ring.publish();
+        __sev();
+        return true;
+    }
+
+    bool isLogging() const { return logging_active.load(std::memory_order_acquire); }
+    bool isShutdownRequested() const { return shutdown_requested.load(std::memory_order_acquire); }
+
+    // Ask the writer to drain the queue and exit
+    void requestStop() {
+        stop_requested.store(true, std::memory_order_release);
+        __sev();
+    }
+
+    bool isWriterDone() const { return writer_done.load(std::memory_order_acquire); }
+
+    // ---- Consumer (core 1) ----
+
+    // Writes up to max_entries queued entries to their files
+    size_t drain(SessionManager& sessions, drivers::SDFile* debug,
+                 size_t max_entries = config::pipeline::QUEUE_ENTRIES) {
+        size_t count = 0;
+
+        while (count < max_entries) {
+            const LogEntry* entry = ring.front();
+            if (!entry) break;
+
+            drivers::SDFile* file = (entry->type == DEBUG_TEXT)
+                ? debug
+                : sessions.getFile(static_cast<FileType>(entry->type));
+
+            if (!file || !file->isOpen()) {
+                orphaned++;
+            } else if (file->writeBytes(entry->payload, length(*entry))) {
+                written++;
+            } else {
+                write_errors++;
+            }
+
+            ring.pop();
+            count++;
+        }
+
+        return count;
+    }
+
+    // Core 1 main loop: session handling + draining until requestStop()
+    void runWriter(SessionManager& sessions, drivers::SDFile* debug) {
+        while (true) {
+            sessions.update();
+            logging_active.store(sessions.isLogging(), std::memory_order_release);
+            if (sessions.isShutdownRequested()) {
+                shutdown_requested.store(true, std::memory_order_release);
+            }
+
+            size_t drained = drain(sessions, debug);
+
+            // Queue drained: now spend time on the card for any buffer
+            // that filled up during the drain
+            if (!sessions.pollFiles() || (debug && !debug->poll())) {
+                write_errors++;
+            }
+
+            // Keep directory entries current, but not in the middle of a burst
+            if (!sessions.serviceSync(drained >= config::sdcard::SYNC_BURST_ENTRIES)) {
+                write_errors++;
+            }
+
+            if (stop_requested.load(std::memory_order_acquire) && ring.empty()) {
+                break;
+            }
+
+            if (drained == 0) {
+                // Sleep until the producer signals or the switch poll is due
+                best_effort_wfe_or_timeout(make_timeout_time_ms(1));
+            }
+        }
+
+        if (debug) {
+            Stats s = getStats();
+            debug->write("[PIPELN][--] written=%" PRIu32 " overflows=%" PRIu32 " high_water=%" PRIu32 "/%u orphaned=%" PRIu32 " errors=%" PRIu32 "\n",
+                         s.written, s.overflows, s.high_water, (unsigned)ring.capacity(), s.orphaned, s.write_errors);
+        }
+
+        writer_done.store(true, std::memory_order_release);
+    }
+
+    Stats getStats() const {
+        return Stats{
+            .written = written,
+            .overflows = ring.overflows(),
+            .high_water = ring.high_water(),
+            .orphaned = orphaned,
+            .write_errors = write_errors,
+        };
+    }
+};
+
+} // namespace logging
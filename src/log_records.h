@@ -0,0 +1,218 @@
+#pragma once
+
+// NOTE: Deliberately free of Pico SDK headers - this file is shared with the
+// host-side tools (tools/log_decoder.cpp) so both ends agree on the layout.
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cinttypes>
+#include <type_traits>
+
+namespace logging {
+
+// Session file types - easy to extend (add a Schema<> specialization below
+// and a row to the stream registry, src/log_streams.h)
+enum FileType : uint8_t {
+    FLIGHT = 0,
+    GPS,
+    PITOT,
+    IMU,
+    BARO,
+    FILE_COUNT  // Must be last
+};
+
+namespace records {
+
+// ============================================
+// Binary Log Format
+// ============================================
+// Every session file starts with one FileHeader followed by a flat array of
+// fixed-size records. All fields are little-endian (native on the RP2350).
+// Bump FORMAT_VERSION whenever any record layout changes.
+
+static constexpr uint32_t MAGIC = 0x4C534441;       // "ADSL"
+static constexpr uint16_t FORMAT_VERSION = 6;             // 2: utc_us, 3: time_us and read latency, 4: imu.bin, 5: baro.bin, 6: CAS/TAS
+
+struct [[gnu::packed]] FileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t  file_type;     // logging::FileType
+    uint8_t  reserved;
+    uint16_t header_size;   // sizeof(FileHeader), lets old decoders skip new fields
+    uint16_t record_size;   // sizeof(Schema<file_type>::Record)
+};
+
+// time_us is the boot µs at the midpoint of the sensor read and latency_us
+// its bus time (saturating); utc_us maps time_us to UTC (GPS-disciplined),
+// 0 until GPS time is known.
+struct [[gnu::packed]] FlightRecord {
+    uint64_t time_us;       // IMU read
+    int64_t  utc_us;
+    uint16_t latency_us;
+    int32_t  baro_dt_us;    // Barometer read midpoint - time_us
+    uint16_t baro_latency_us;
+    float accel_x;          // m/s^2
+    float accel_y;
+    float accel_z;
+    float gyro_x;           // rad/s
+    float gyro_y;
+    float gyro_z;
+    float altitude;         // m
+    float pressure;         // Pa
+    float temperature;      // C
+};
+
+struct [[gnu::packed]] GpsRecord {
+    uint64_t time_us;       // Navigation epoch
+    int64_t  utc_us;
+    uint16_t latency_us;    // Epoch to parse
+    int32_t  lat_e7;        // degrees * 1e7
+    int32_t  lon_e7;        // degrees * 1e7
+    int32_t  hMSL;          // mm
+    int32_t  velN;          // mm/s
+    int32_t  velE;          // mm/s
+    int32_t  velD;          // mm/s
+    int32_t  heading;       // degrees * 1e5
+    uint32_t hAcc;          // mm
+    uint32_t vAcc;          // mm
+    uint32_t sAcc;          // mm/s
+    uint32_t headingAcc;    // degrees * 1e5
+    uint8_t  valid;
+};
+
+struct [[gnu::packed]] PitotRecord {
+    uint64_t time_us;
+    int64_t  utc_us;
+    uint16_t latency_us;
+    float airspeed_ms;      // IAS
+    float airspeed_mph;
+    float pressure_psi;
+    float cas_ms;
+    float tas_ms;
+};
+
+// One on-chip FIFO sample; time_us is reconstructed from the sample clock
+// (no per-sample bus read, so no latency column).
+struct [[gnu::packed]] ImuRecord {
+    uint64_t time_us;
+    int64_t  utc_us;
+    float accel_x;          // m/s^2
+    float accel_y;
+    float accel_z;
+    float gyro_x;           // rad/s
+    float gyro_y;
+    float gyro_z;
+};
+
+// One BMP581 FIFO frame (pressure only), timed like ImuRecord.
+struct [[gnu::packed]] BaroRecord {
+    uint64_t time_us;
+    int64_t  utc_us;
+    float pressure;         // Pa
+};
+
+static_assert(sizeof(FileHeader) == 12);
+static_assert(sizeof(FlightRecord) == 60);
+static_assert(sizeof(GpsRecord) == 63);
+static_assert(sizeof(PitotRecord) == 38);
+static_assert(sizeof(ImuRecord) == 40);
+static_assert(sizeof(BaroRecord) == 20);
+
+// ============================================
+// Compile-time Schema per FileType
+// ============================================
+// csv_header/to_csv reproduce the legacy text columns after the time
+// columns; they are only used off-device by the decoder and the benchmark.
+template<FileType T> struct Schema;
+
+template<> struct Schema<FLIGHT> {
+    using Record = FlightRecord;
+    static constexpr const char* filename = "flight.bin";
+    static constexpr const char* csv_header =
+        "time_us,utc_us,latency_us,baro_dt_us,baro_latency_us,accel_x,accel_y,accel_z,gyro_x,gyro_y,gyro_z,altitude,pressure,temperature\n";
+
+    static int to_csv(const Record& r, char* out, size_t size) {
+        return snprintf(out, size, "%" PRIu64 ",%" PRId64 ",%u,%" PRId32 ",%u,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n",
+            r.time_us, r.utc_us, r.latency_us, r.baro_dt_us, r.baro_latency_us,
+            r.accel_x, r.accel_y, r.accel_z,
+            r.gyro_x, r.gyro_y, r.gyro_z,
+            r.altitude, r.pressure, r.temperature);
+    }
+};
+
+template<> struct Schema<GPS> {
+    using Record = GpsRecord;
+    static constexpr const char* filename = "gps.bin";
+    static constexpr const char* csv_header =
+        "time_us,utc_us,latency_us,latitude,longitude,altitude_mm,vel_north_mm_s,vel_east_mm_s,vel_down_mm_s,heading,h_accuracy,v_accuracy,speed_accuracy,heading_accuracy,valid\n";
+
+    static int to_csv(const Record& r, char* out, size_t size) {
+        return snprintf(out, size, "%" PRIu64 ",%" PRId64 ",%u,%.6f,%.6f,%" PRId32 ",%" PRId32 ",%" PRId32 ",%" PRId32 ",%" PRId32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%s\n",
+            r.time_us, r.utc_us, r.latency_us, r.lat_e7 / 1e7, r.lon_e7 / 1e7, r.hMSL,
+            r.velN, r.velE, r.velD, r.heading, r.hAcc, r.vAcc,
+            r.sAcc, r.headingAcc, r.valid ? "OK" : "NO");
+    }
+};
+
+template<> struct Schema<PITOT> {
+    using Record = PitotRecord;
+    static constexpr const char* filename = "pitot.bin";
+    static constexpr const char* csv_header = "time_us,utc_us,latency_us,airspeed_ms,airspeed_mph,pressure_psi,cas_ms,tas_ms\n";
+
+    static int to_csv(const Record& r, char* out, size_t size) {
+        return snprintf(out, size, "%" PRIu64 ",%" PRId64 ",%u,%.2f,%.2f,%.2f,%.2f,%.2f\n",
+            r.time_us, r.utc_us, r.latency_us, r.airspeed_ms, r.airspeed_mph, r.pressure_psi,
+            r.cas_ms, r.tas_ms);
+    }
+};
+
+template<> struct Schema<IMU> {
+    using Record = ImuRecord;
+    static constexpr const char* filename = "imu.bin";
+    static constexpr const char* csv_header = "time_us,utc_us,accel_x,accel_y,accel_z,gyro_x,gyro_y,gyro_z\n";
+
+    static int to_csv(const Record& r, char* out, size_t size) {
+        return snprintf(out, size, "%" PRIu64 ",%" PRId64 ",%.3f,%.3f,%.3f,%.4f,%.4f,%.4f\n",
+            r.time_us, r.utc_us, r.accel_x, r.accel_y, r.accel_z, r.gyro_x, r.gyro_y, r.gyro_z);
+    }
+};
+
+template<> struct Schema<BARO> {
+    using Record = BaroRecord;
+    static constexpr const char* filename = "baro.bin";
+    static constexpr const char* csv_header = "time_us,utc_us,pressure\n";
+
+    static int to_csv(const Record& r, char* out, size_t size) {
+        return snprintf(out, size, "%" PRIu64 ",%" PRId64 ",%.2f\n", r.time_us, r.utc_us, r.pressure);
+    }
+};
+
+template<FileType T>
+static inline constexpr FileHeader make_header() {
+    static_assert(std::is_trivially_copyable_v<typename Schema<T>::Record>);
+    return FileHeader{
+        .magic = MAGIC,
+        .version = FORMAT_VERSION,
+        .file_type = T,
+        .reserved = 0,
+        .header_size = sizeof(FileHeader),
+        .record_size = sizeof(typename Schema<T>::Record),
+    };
+}
+
+// Runtime FileType -> Schema<T> dispatch. Calls fn(Schema<T>{}) and returns
+// true, or returns false for an unknown type.
+template<typename Fn>
+static inline bool visit(uint8_t type, Fn&& fn) {
+    switch (type) {
+        case FLIGHT: fn(Schema<FLIGHT>{}); return true;
+        case GPS:    fn(Schema<GPS>{});    return true;
+        case PITOT:  fn(Schema<PITOT>{});  return true;
+        case IMU:    fn(Schema<IMU>{});    return true;
+        case BARO:   fn(Schema<BARO>{});   return true;
+        default:     return false;
+    }
+}
+
+} // namespace records
+} // namespace logging
@@ -0,0 +1,68 @@
+#pragma once
+
+// Project Omni-Header
+#include "config/all_headers.h"
+
+#include "config/config.h"
+#include "log_records.h"
+
+namespace logging {
+
+// ============================================
+// Log Stream Registry
+// ============================================
+// One row per session file, indexed by FileType: whether it is logged and
+// the rate its producer task runs at, both from config. SessionManager
+// opens a file per enabled stream, main() registers each producer at its
+// stream's rate, and publishing to a disabled stream compiles away. A new
+// sensor stream (HX711, BNO085) is a FileType, a Schema<> in log_records.h
+// and a row here; main() only adds the task that fills its records.
+struct StreamConfig {
+    FileType type;
+    const char* task;       // Producer task (scheduler report)
+    bool enabled;
+    uint32_t rate_hz;       // Producer task rate
+};
+
+namespace streams {
+
+static constexpr StreamConfig TABLE[FILE_COUNT] = {
+    {FLIGHT, "flight", config::streams::FLIGHT_ENABLED, config::sensors::RAW_DATA_HZ},
+    {GPS,    "gps",    config::streams::GPS_ENABLED,    config::sensors::GPS_POLL_HZ},
+    {PITOT,  "pitot",  config::streams::PITOT_ENABLED,
+        config::pitot_tube::CONTINUOUS ? config::pitot_tube::SAMPLE_HZ : config::sensors::PITOT_RATE_HZ},
+    {IMU,    "imu",    config::streams::IMU_ENABLED,
+        config::icm20948::FIFO_ENABLED ? config::icm20948::FIFO_DRAIN_HZ : config::icm20948::POLL_HZ},
+    {BARO,   "baro",   config::streams::BARO_ENABLED,
+        config::bmp581::FIFO_ENABLED ? config::bmp581::FIFO_DRAIN_HZ : config::sensors::RAW_DATA_HZ},
+};
+
+static constexpr bool indexed_by_type() {
+    for (size_t i = 0; i < FILE_COUNT; i++) {
+        if (TABLE[i].type != i) return false;
+    }
+    return true;
+}
+static_assert(indexed_by_type(), "Stream table must list every FileType in order");
+
+static constexpr const StreamConfig& get(FileType type) { return TABLE[type]; }
+static constexpr bool enabled(FileType type) { return type < FILE_COUNT && TABLE[type].enabled; }
+
+// Session file per stream: name and header from its schema
+struct StreamFile {
+    const char* filename;
+    records::FileHeader header;
+    bool enabled;
+};
+
+template<size_t... I>
+static constexpr std::array<StreamFile, FILE_COUNT> make_files(std::index_sequence<I...>) {
+    return {{{records::Schema<static_cast<FileType>(I)>::filename,
+              records::make_header<static_cast<FileType>(I)>(),
+              TABLE[I].enabled}...}};
+}
+
+static constexpr auto FILES = make_files(std::make_index_sequence<FILE_COUNT>{});
+
+} // namespace streams
+} // namespace logging
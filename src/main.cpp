@@ -8,12 +8,57 @@
 #include "drivers/sensors/bmp581_driver.h"
 #include "drivers/sensors/pitot_tube.h"
 #include "drivers/sdcard/sdcard.h"
+#include "drivers/sdcard/sd_bench.h"
 
 
 #include "config/config.h"
 
 #include "led.h"
 #include "session_manager.h"
+#include "log_records.h"
+#include "log_pipeline.h"
+#include "log_streams.h"
+#include "scheduler.h"
+#include "boot_sequencer.h"
+#include "telemetry_tap.h"
+
+// Inter-core queue lives in static SRAM, shared by both cores
+static logging::LogPipeline log_pipeline;
+
+// Optional USB mirror (core 0 only)
+static telemetry::TelemetryTap telemetry_tap;
+
+// Handed to core 1 before launch (core 1 owns these afterwards)
+struct WriterContext {
+    logging::SessionManager* sessions;
+    drivers::SDFile* debug;
+};
+static WriterContext writer_ctx;
+
+// Core 1 entry: owns SDCard/SDFile and drains the pipeline into FatFs
+void WriterCore() {
+    log_pipeline.runWriter(*writer_ctx.sessions, writer_ctx.debug);
+}
+
+// Route one record to the SD writer (while logging) and the USB tap;
+// nothing for a stream the registry leaves out
+template<logging::FileType T>
+void Publish(const typename logging::records::Schema<T>::Record& record) {
+    if constexpr (!logging::streams::enabled(T)) return;
+
+    if (log_pipeline.isLogging()) {
+        log_pipeline.push<T>(record);
+    }
+    telemetry_tap.tap<T>(record);
+}
+
+// Producer task of stream T at its registry rate, parked until its
+// device is up
+template<logging::FileType T>
+int AddStreamTask(scheduling::Scheduler& scheduler, scheduling::Scheduler::TaskFn fn) {
+    constexpr const logging::StreamConfig& stream = logging::streams::get(T);
+    return scheduler.add(stream.task, stream.rate_hz, std::move(fn), false);
+}
 
 void StartProcess() {
     stdio_init_all();
@@ -74,107 +119,372 @@ int main()
         return Error();
     }
 
-    // Create persistent debug log
-    SDFile debug;
+    // Create persistent debug log (static: SD buffers are too large for the stack)
+    static SDFile debug;
     if (!debug.open("debug.txt", true)) { // Append mode
         printf("[SDCARD][XX] Failed to create debug log\n");
         return Error();
     }
     debug.write("\n----- STARTED -----\n");
 
-    // Initialize session manager (checks toggle state at startup)
-    logging::SessionManager sessions(TOGGLE_PIN, BUTTON_PIN, sd, &debug);
+    auto& recovery = sd.getRecoveryReport();
+    if (recovery.files > 0) {
+        debug.write("[SDCARD][OK] Session %d checked: %u/%u files recovered, %" PRIu64 " stale bytes trimmed in %" PRIu32 "us\n",
+                    recovery.session, recovery.repaired, recovery.files, recovery.trimmed_bytes, recovery.time_us);
+    }
 
-    // Initialize GPS
-    drivers::GpsDriver gps;
-    gps.init(uart0, gps::RX_PIN, gps::TX_PIN, gps::USE_BINARY_UBX);
-    gps.set_led_enabled(true);
+    if (sd.buffersClusterAligned()) {
+        debug.write("[SDCARD][OK] %u B file buffers, %" PRIu32 " B clusters\n",
+                    static_cast<unsigned>(sdcard::FILE_BUFFER_SIZE), sd.getClusterBytes());
+    } else {
+        debug.write("[SDCARD][XX] %u B file buffers straddle %" PRIu32 " B clusters\n",
+                    static_cast<unsigned>(sdcard::FILE_BUFFER_SIZE), sd.getClusterBytes());
+    }
+
+    if constexpr (sdcard::RUN_WRITE_BENCH) {
+        SDBench::run(debug);
+    }
+
+    // Initialize session manager (checks toggle state at startup)
+    static logging::SessionManager sessions(TOGGLE_PIN, BUTTON_PIN, sd, &debug);
 
-    // Initialize sensors
     I2CBus i2c_bus;
     if(i2c_bus.init(i2c0, i2c::bus0::SDA, i2c::bus0::SCL, i2c::bus0::DATA_RATE))
         debug.write("[I2CBUS][OK] I2CBus initialized successfully\n");
 
+    // Devices come up in parallel from the scheduler (bring-up task below);
+    // here they only get their first step
+    drivers::GpsDriver gps;
+    gps.begin_init(uart0, gps::RX_PIN, gps::TX_PIN, gps::USE_BINARY_UBX);
+
     ICM20948 icm20948;
-    if(icm20948.init(&i2c_bus))
-        debug.write("[ICU948][OK] ICM20948 initialized successfully\n");
+    icm20948.begin_init(&i2c_bus);
 
     BMP581 bmp581;
-    if(bmp581.init(&i2c_bus))
-        debug.write("[BMP581][OK] BMP581 initialized successfully\n");
+    bmp581.begin_init(&i2c_bus);
 
     PitotTube pitot_tube;
-    if(pitot_tube.init(&i2c_bus, 1.0f))
-        debug.write("[PITOTT][OK] PitotTube initialized successfully\n");
-    sleep_ms(50);
-    if(pitot_tube.calibrate_zero(50))
-        debug.write("[PITOTT][OK] PitotTube calibrated successfully\n");
 
-    uint32_t start = to_ms_since_boot(time_us_64());
-    uint32_t now = start;
-    uint32_t last_raw = 0;
-    uint32_t last_pitot = 0;
+    // Hand SD card ownership to core 1
+    writer_ctx = {&sessions, &debug};
+    multicore_launch_core1(WriterCore);
 
-    printf("==== STARTING LOOP ====\n");
-    
-    while (true) {
-        now = to_ms_since_boot(time_us_64());
-        
-        sessions.update();
-        if (sessions.isShutdownRequested()) {
-            break;
+    // Sensor tasks, highest priority first. Sampling runs even between
+    // sessions so the USB tap can be used for ground checks. Device tasks
+    // are registered parked and activated the moment their device is up.
+    scheduling::Scheduler scheduler;
+
+    // A sensor FIFO only runs for a stream that is logged: its drain task is
+    // the stream's producer, and with the stream off the flight reads suffice
+    constexpr bool imu_fifo = config::icm20948::FIFO_ENABLED && logging::streams::enabled(FileType::IMU);
+    constexpr bool baro_fifo = config::bmp581::FIFO_ENABLED && logging::streams::enabled(FileType::BARO);
+
+    // The cycle's reads go out back to back on the bus while the previous
+    // cycle's record is published, so each record trails its samples by one
+    // flight period (it carries their timestamps). The two sensors are
+    // independent: a barometer read feeds the pitot and baro.bin on its
+    // own, and the flight row goes out whenever the IMU read, with the
+    // latest barometer sample (baro_dt_us shows its age).
+    // With the IMU on its data-ready interrupt (no FIFO) its own task claims
+    // every edge and reads the sample, and the flight row takes the newest
+    // of those instead of reading again.
+    logging::records::Schema<FileType::FLIGHT>::Record flight_record = {};
+    bool flight_pending = false;
+    bmp581_data bmp = {};
+    bool bmp_valid = false;
+    bool imu_on_irq = false;
+    bool imu_fresh = false;         // Read by the IMU task, not yet in a flight row
+
+    auto flight = [&] {
+        bool icm_requested = !imu_on_irq && icm20948.request();
+        bool bmp_requested = bmp581.request();
+
+        if (flight_pending) {
+            Publish<FileType::FLIGHT>(flight_record);
+            flight_pending = false;
         }
-        
-        // Log data if session is active
-        if (sessions.isLogging()) {
-            
-            if (now - last_raw > utils::hz_to_ms(sensors::RAW_DATA_HZ)) {
-                auto* file = sessions.getFile(FileType::FLIGHT);          
-                if (file && file->isOpen() && icm20948.update() && bmp581.update()) {
-                    auto icm = icm20948.get_data();
-                    auto bmp = bmp581.get_data();
-
-                    file->write("%" PRIu32 ",%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n",
-                        now,
-                        icm.accel_x, icm.accel_y, icm.accel_z,
-                        icm.gyro_x, icm.gyro_y, icm.gyro_z,
-                        bmp.altitude, bmp.pressure, bmp.temperature);
-
-                    last_raw = now;
-                }
+
+        if (bmp_requested && bmp581.collect()) {
+            bmp = bmp581.get_data();
+            bmp_valid = true;
+            pitot_tube.set_static(bmp.pressure, bmp.temperature);
+
+            // Without its FIFO the barometer's stream is these reads
+            if constexpr (!baro_fifo) {
+                Publish<FileType::BARO>({
+                    .time_us = bmp.time.us, .utc_us = gps.utc_us(bmp.time.us),
+                    .pressure = bmp.pressure,
+                });
+            }
+        }
+
+        bool icm_new = imu_on_irq ? std::exchange(imu_fresh, false) : icm_requested && icm20948.collect();
+        if (icm_new && bmp_valid) {
+            auto icm = icm20948.get_data();
+            flight_record = {
+                .time_us = icm.time.us, .utc_us = gps.utc_us(icm.time.us),
+                .latency_us = icm.time.latency_u16(),
+                .baro_dt_us = static_cast<int32_t>(bmp.time.us - icm.time.us),
+                .baro_latency_us = bmp.time.latency_u16(),
+                .accel_x = icm.accel_x, .accel_y = icm.accel_y, .accel_z = icm.accel_z,
+                .gyro_x = icm.gyro_x, .gyro_y = icm.gyro_y, .gyro_z = icm.gyro_z,
+                .altitude = bmp.altitude, .pressure = bmp.pressure, .temperature = bmp.temperature,
+            };
+            flight_pending = true;
+        }
+    };
+
+    // With data-ready interrupts the barometer's conversions release and
+    // stamp the flight task; without (or if the INT setup fails, or the
+    // barometer runs its FIFO rate) it polls. Both are registered; one is
+    // activated once the IMU and the barometer are up.
+    constexpr const logging::StreamConfig& flight_stream = logging::streams::get(FileType::FLIGHT);
+    constexpr bool flight_irq_possible = sensors::DATA_READY_IRQ && !baro_fifo;
+    scheduling::Scheduler::Trigger flight_trigger{&scheduler, -1};
+    if constexpr (flight_irq_possible) {
+        flight_trigger.task = scheduler.add_event(flight_stream.task, flight, false);
+    }
+    int flight_poll_task = scheduler.add(flight_stream.task, flight_stream.rate_hz, flight, false);
+
+    auto start_flight = [&](bool bmp_ok) {
+        bool flight_on_irq = flight_irq_possible && bmp_ok &&
+            bmp581.set_odr(flight_stream.rate_hz) &&
+            bmp581.enable_data_ready(pins::data_ready::BMP581, scheduling::Scheduler::Trigger::fire, &flight_trigger);
+        if (flight_on_irq) {
+            log_pipeline.pushText("[DRDYIQ][OK] Flight task on BMP581 data-ready at %" PRIu32 " Hz\n", flight_stream.rate_hz);
+            scheduler.activate(flight_trigger.task);
+        } else {
+            scheduler.activate(flight_poll_task);
+        }
+    };
+
+    // Full-rate IMU: drain the on-chip FIFO in bursts, one record per
+    // sample; without the FIFO, register reads at the stream's own rate,
+    // released by the IMU's data-ready edges when the INT setup succeeds
+    int imu_task = -1;
+    scheduling::Scheduler::Trigger imu_trigger{&scheduler, -1};
+    if constexpr (imu_fifo) {
+        imu_task = AddStreamTask<FileType::IMU>(scheduler, [&] {
+            icm20948_sample samples[ICM20948::FIFO_FRAMES];
+            size_t n = icm20948.read_fifo(samples, ICM20948::FIFO_FRAMES);
+
+            for (size_t i = 0; i < n; i++) {
+                const auto& s = samples[i];
+                Publish<FileType::IMU>({
+                    .time_us = s.time_us, .utc_us = gps.utc_us(s.time_us),
+                    .accel_x = s.accel_x, .accel_y = s.accel_y, .accel_z = s.accel_z,
+                    .gyro_x = s.gyro_x, .gyro_y = s.gyro_y, .gyro_z = s.gyro_z,
+                });
             }
+        });
+    } else if constexpr (logging::streams::enabled(FileType::IMU)) {
+        auto imu_read = [&] {
+            if (!icm20948.update()) return;
+            imu_fresh = true;
+
+            auto icm = icm20948.get_data();
+            Publish<FileType::IMU>({
+                .time_us = icm.time.us, .utc_us = gps.utc_us(icm.time.us),
+                .accel_x = icm.accel_x, .accel_y = icm.accel_y, .accel_z = icm.accel_z,
+                .gyro_x = icm.gyro_x, .gyro_y = icm.gyro_y, .gyro_z = icm.gyro_z,
+            });
+        };
+        if constexpr (sensors::DATA_READY_IRQ) {
+            imu_trigger.task = scheduler.add_event(logging::streams::get(FileType::IMU).task, imu_read, false);
+        }
+        imu_task = AddStreamTask<FileType::IMU>(scheduler, imu_read);
+    }
+
+    // Full-rate pressure: the barometer's FIFO in batches, one record per sample
+    int baro_task = -1;
+    if constexpr (baro_fifo) {
+        baro_task = AddStreamTask<FileType::BARO>(scheduler, [&] {
+            bmp581_sample samples[BMP581::FIFO_FRAMES];
+            size_t n = bmp581.read_fifo(samples, BMP581::FIFO_FRAMES);
 
-            if(gps.update()) {
-                auto data = gps.get_data();
-                auto* file = sessions.getFile(FileType::GPS);
-                if (file && file->isOpen()) {
-                    file->write("%" PRIu32 ",%" PRIu32 ",%.6f,%.6f,%d,%d,%d,%d,%d,%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%s\n",
-                        now, data.unix_time, data.lat, data.lon, data.hMSL,
-                        data.velN, data.velE, data.velD, data.heading, data.hAcc, data.vAcc, 
-                        data.sAcc, data.headingAcc, data.valid ? "OK" : "NO");
-                }
-                gps.clear();
+            for (size_t i = 0; i < n; i++) {
+                Publish<FileType::BARO>({
+                    .time_us = samples[i].time_us, .utc_us = gps.utc_us(samples[i].time_us),
+                    .pressure = samples[i].pressure,
+                });
             }
+        });
+    }
 
-            if (now - last_pitot > utils::hz_to_ms(sensors::PITOT_RATE_HZ)) {
-                auto* file = sessions.getFile(FileType::PITOT);          
-                if (file && file->isOpen() && pitot_tube.update()) {
-                    auto pitot = pitot_tube.get_data();
-                    
-                    if (pitot.valid) {
-                        file->write("%" PRIu32 ",%.2f,%.2f,%.2f,%.2f\n",
-                            now,
-                            pitot.airspeed_ms,
-                            pitot.airspeed_mph,
-                            pitot.pressure_psi);
-                    }
-                    
-                    last_pitot = now;
-                }
+    // The zero is learned in the background while parked (no boot wait)
+    bool pitot_zeroed = false;
+    constexpr bool pitot_continuous = config::pitot_tube::CONTINUOUS;
+    int pitot_task = AddStreamTask<FileType::PITOT>(scheduler, [&] {
+        if (pitot_continuous ? pitot_tube.acquire() : pitot_tube.update()) {
+            auto pitot = pitot_tube.get_data();
+            if (pitot.zeroed && !pitot_zeroed) {
+                pitot_zeroed = true;
+                log_pipeline.pushText("[PITOTT][OK] Zero %.2f Pa at %.1f C\n",
+                                      pitot_tube.get_zero_stats().zero_pa, pitot.temperature_c);
+            }
+            
+            if (pitot.valid) {
+                Publish<FileType::PITOT>({
+                    .time_us = pitot.time.us, .utc_us = gps.utc_us(pitot.time.us),
+                    .latency_us = pitot.time.latency_u16(),
+                    .airspeed_ms = pitot.airspeed_ms,
+                    .airspeed_mph = pitot.airspeed_mph,
+                    .pressure_psi = pitot.pressure_psi,
+                    .cas_ms = pitot.cas_ms, .tas_ms = pitot.tas_ms,
+                });
             }
+        }
+    });
+
+    int gps_task = AddStreamTask<FileType::GPS>(scheduler, [&] {
+        // Parse what the UART IRQ buffered since the last run
+        if (!gps.update()) return;
 
+        auto data = gps.get_data();
+        Publish<FileType::GPS>({
+            .time_us = data.time.us, .utc_us = gps.utc_us(data.time.us),
+            .latency_us = data.time.latency_u16(),
+            .lat_e7 = data.lat_e7,
+            .lon_e7 = data.lon_e7,
+            .hMSL = data.hMSL,
+            .velN = data.velN, .velE = data.velE, .velD = data.velD,
+            .heading = data.heading,
+            .hAcc = data.hAcc, .vAcc = data.vAcc,
+            .sAcc = data.sAcc, .headingAcc = data.headingAcc,
+            .valid = data.valid,
+        });
+        gps.clear();
+    });
+
+    scheduler.add("telemetry", config::telemetry::SERVICE_HZ, [&] {
+        telemetry_tap.setLogging(log_pipeline.isLogging());
+        telemetry_tap.service();
+    });
+
+    // Bring-up: each device's tasks start when it is done. The flight task
+    // needs both the IMU and the barometer.
+    scheduling::BootSequencer bringup;
+    int flight_waits_for = 2;
+    bool bmp_up = false;
+
+    bringup.add("GPS", [&](uint64_t now) { return gps.init_step(now); }, [&](bool) {
+        // Not configured still leaves the receiver's default output
+        scheduler.activate(gps_task);
+    });
+    bringup.add("ICM20948", [&](uint64_t now) { return icm20948.init_step(now); }, [&](bool ok) {
+        if (ok && imu_fifo && icm20948.enable_fifo(config::icm20948::FIFO_ODR_HZ)) {
+            log_pipeline.pushText("[ICMFIF][OK] ICM20948 FIFO at %" PRIu32 " Hz\n", config::icm20948::FIFO_ODR_HZ);
+            scheduler.activate(imu_task);
+        } else if (ok && !imu_fifo) {
+            // INT1 only at the IMU stream's rate and with a task to release;
+            // otherwise it stays off and the reads are polled
+            using config::icm20948::POLL_HZ;
+            imu_on_irq = sensors::DATA_READY_IRQ && imu_trigger.task >= 0 &&
+                icm20948.set_odr(POLL_HZ, config::icm20948::POLL_DLPF_CFG) &&
+                icm20948.enable_data_ready(pins::data_ready::ICM20948, scheduling::Scheduler::Trigger::fire, &imu_trigger);
+            if (imu_on_irq) {
+                log_pipeline.pushText("[DRDYIQ][OK] IMU task on ICM20948 data-ready at %" PRIu32 " Hz\n", POLL_HZ);
+                scheduler.activate(imu_trigger.task);
+            } else {
+                scheduler.activate(imu_task);
+            }
         }
+        if (--flight_waits_for == 0) start_flight(bmp_up);
+    });
+    bringup.add("BMP581", [&](uint64_t now) { return bmp581.init_step(now); }, [&](bool ok) {
+        bmp_up = ok;
+        if (ok && baro_fifo && bmp581.enable_fifo(config::bmp581::FIFO_ODR_HZ)) {
+            log_pipeline.pushText("[BMPFIF][OK] BMP581 FIFO at %" PRIu32 " Hz\n", config::bmp581::FIFO_ODR_HZ);
+            scheduler.activate(baro_task);
+        }
+        if (--flight_waits_for == 0) start_flight(bmp_up);
+    });
+    bringup.add("MS4525DO", [&](uint64_t) {
+        return InitStep::done(pitot_tube.init(&i2c_bus, config::pitot_tube::PRESSURE_RANGE_PSI));
+    }, [&](bool ok) {
+        if (ok) scheduler.activate(pitot_task);
+    });
+
+    // Boot timeline into debug.txt once the last device is done
+    int bringup_task = -1;
+    bringup_task = scheduler.add("bringup", sensors::BRINGUP_STEP_HZ, [&] {
+        if (!bringup.poll(scheduler.now_us())) return;
+        bringup.report([](const char* format, auto... args) {
+            log_pipeline.pushText(format, args...);
+        });
+        scheduler.deactivate(bringup_task);
+    });
+
+    printf("==== STARTING LOOP ====\n");
+
+    if (!scheduler.start()) {
+        printf("[SCHEDR][XX] Failed to start task timers\n");
+        return Error();
+    }
+    
+    while (!log_pipeline.isShutdownRequested()) {
+        scheduler.run_pending();
+        scheduler.wait();
+    }
+
+    scheduler.stop();
+    scheduler.report([](const char* format, auto... args) {
+        log_pipeline.pushText(format, args...);
+    });
+
+    auto tap = telemetry_tap.getStats();
+    log_pipeline.pushText("[TELEMT][--] sent=%" PRIu32 " dropped=%" PRIu32 "\n",
+                          tap.sent_bytes, tap.dropped_bytes);
+
+    auto bus = i2c_bus.get_stats();
+    log_pipeline.pushText("[I2CBUS][--] transfers=%" PRIu32 " errors=%" PRIu32 " bytes=%" PRIu64 " busy=%" PRIu64 "us\n",
+                          bus.transfers, bus.errors, bus.bytes, bus.busy_us);
+    auto async = i2c_bus.get_async_stats();
+    log_pipeline.pushText("[I2CDMA][--] n=%" PRIu32 " err=%" PRIu32 " full=%" PRIu32 " abort=%" PRIu32 " depth=%" PRIu32 "\n",
+                          async.completed, async.errors, async.rejected, async.aborted, async.max_depth);
+    log_pipeline.pushText("[I2CDMA][--] wait=%" PRIu32 "/%" PRIu32 "us bus=%" PRIu32 "/%" PRIu32 "us\n",
+                          async.mean_wait_us(), async.max_wait_us, async.mean_bus_us(), async.max_bus_us);
+
+    // Text slots hold 62 characters
+    auto gps_stats = gps.get_stats();
+    log_pipeline.pushText("[UARTRX][--] bytes=%" PRIu32 " irqs=%" PRIu32 " high=%" PRIu32 "\n",
+                          gps_stats.rx.bytes, gps_stats.rx.irqs, gps_stats.rx.high_water);
+    log_pipeline.pushText("[UARTRX][--] ovr=%" PRIu32 " fe=%" PRIu32 " drop=%" PRIu32 " badck=%" PRIu32 "\n",
+                          gps_stats.rx.overruns, gps_stats.rx.framing_errors, gps_stats.rx.dropped,
+                          gps_stats.checksum_errors);
+
+    auto clock = gps.get_clock().get_stats();
+    auto pps = gps.get_pps_stats();
+    log_pipeline.pushText("[GPSCLK][--] drift=%" PRId32 "ppb rms=%" PRIu32 "ns max=%" PRIu32 "ns\n",
+                          clock.drift_ppb, clock.jitter_rms_ns, clock.jitter_max_ns);
+    log_pipeline.pushText("[GPSCLK][--] pps=%" PRIu32 " ok=%" PRIu32 " rej=%" PRIu32 " miss=%" PRIu32 " drop=%" PRIu32 "\n",
+                          clock.pulses, clock.accepted, clock.rejected, clock.missed, pps.dropped);
+
+    auto report_samples = [](const char* name, const drivers::SampleStats& s) {
+        log_pipeline.pushText("[SAMPLE][--] %s edges=%" PRIu32 " missed=%" PRIu32 " dup=%" PRIu32 "\n",
+                              name, s.edges, s.missed, s.duplicates);
+    };
+    report_samples("ICM20948", icm20948.get_sample_stats());
+    report_samples("BMP581", bmp581.get_sample_stats());
+    report_samples("MS4525DO", pitot_tube.get_sample_stats());
+    auto pitot_zero = pitot_tube.get_zero_stats();
+    log_pipeline.pushText("[PITOTT][--] zero=%.2fPa slope=%.3fPa/C rej=%" PRIu32 " flt=%" PRIu32 "\n",
+                          pitot_zero.zero_pa, pitot_zero.slope_pa_per_c, pitot_zero.rejected, pitot_zero.faults);
+
+    if constexpr (imu_fifo) {
+        auto fifo = icm20948.get_fifo_stats();
+        log_pipeline.pushText("[ICMFIF][--] n=%" PRIu32 " ovf=%" PRIu32 " lost=%" PRIu32 " high=%" PRIu32 " T=%" PRIu32 "ns\n",
+                              fifo.samples, fifo.overflows, fifo.lost, fifo.high_water, fifo.period_ns);
+    }
+    if constexpr (baro_fifo) {
+        auto fifo = bmp581.get_fifo_stats();
+        log_pipeline.pushText("[BMPFIF][--] n=%" PRIu32 " ovf=%" PRIu32 " lost=%" PRIu32 " high=%" PRIu32 " T=%" PRIu32 "ns\n",
+                              fifo.samples, fifo.overflows, fifo.lost, fifo.high_water, fifo.period_ns);
+    }
 
+    // Let core 1 drain the queue, then take SD ownership back
+    log_pipeline.requestStop();
+    while (!log_pipeline.isWriterDone()) {
         sleep_ms(1);
     }
 
@@ -0,0 +1,334 @@
+#pragma once
+
+// Project Omni-Header
+#include "config/all_headers.h"
+
+namespace scheduling {
+
+// ============================================
+// Deterministic Periodic Task Scheduler
+// ============================================
+// Each task gets its own SDK repeating_timer (hardware alarm) with a
+// microsecond period. The alarm IRQ only stamps the release time and marks
+// the task pending; task bodies run in thread context from run_pending(),
+// in registration order (register the most time-critical task first).
+//
+// Event tasks have no timer: an IRQ releases them with trigger(), stamped
+// with the time of the event (e.g. a sensor's data-ready edge), so their
+// jitter is the event-to-start latency and an overrun is an event that
+// arrived before the previous one was handled.
+//
+// A task registered inactive is parked: it keeps its place in the
+// priority order but is not released until activate(), so the tasks of a
+// device still coming up can be set out before start() and switched on
+// the moment it is ready.
+//
+// Per task it tracks release jitter (start - ideal release), overruns
+// (a release that arrives while the previous one has not run yet) and a
+// log2 histogram of execution time.
+//
+// SIMULATED mode replaces the alarms with a virtual clock: simulate()
+// releases tasks in software and task bodies model their cost with
+// charge(), so rate plans can be checked on the host without hardware
+// (sim/scheduler_sim.cpp).
+class Scheduler {
+public:
+    static constexpr size_t MAX_TASKS = 10;
+    static constexpr size_t HIST_BINS = 16;     // bin i: exec time < 2^i us (last bin open)
+
+    enum class Mode { HARDWARE, SIMULATED };
+
+    using TaskFn = std::function<void()>;
+
+    struct TaskStats {
+        uint32_t runs = 0;
+        uint32_t overruns = 0;
+        uint32_t max_jitter_us = 0;
+        uint64_t total_jitter_us = 0;
+        uint32_t max_exec_us = 0;
+        uint32_t exec_hist[HIST_BINS] = {};
+
+        uint32_t mean_jitter_us() const { return runs ? total_jitter_us / runs : 0; }
+    };
+
+private:
+    struct Task {
+        const char* name = nullptr;
+        TaskFn fn;
+        uint32_t period_us = 0;
+        bool active = true;                     // false: parked until activate()
+        bool timer_armed = false;
+
+        uint64_t next_release_us = 0;           // Ideal time of the next release
+        volatile uint64_t release_us = 0;       // Ideal time of the pending release
+        std::atomic<bool> pending{false};
+
+        repeating_timer_t timer;
+        TaskStats stats;
+    };
+
+    Task tasks[MAX_TASKS];         // period_us == 0: event task
+    size_t task_count = 0;
+    Mode mode = Mode::HARDWARE;
+    bool running = false;
+
+    // Virtual clock (SIMULATED mode only)
+    uint64_t virtual_now_us = 0;
+
+    // Alarm IRQ / virtual release: mark the task due at its ideal time
+    void release(Task& task) {
+        if (task.pending.load(std::memory_order_acquire)) {
+            task.stats.overruns++;
+        } else {
+            task.release_us = task.next_release_us;
+            task.pending.store(true, std::memory_order_release);
+        }
+        task.next_release_us += task.period_us;
+    }
+
+    static bool timer_callback(repeating_timer_t* rt) {
+        auto* self = static_cast<Scheduler*>(rt->user_data);
+        for (size_t i = 0; i < self->task_count; i++) {
+            if (&self->tasks[i].timer == rt) {
+                self->release(self->tasks[i]);
+                break;
+            }
+        }
+        return true;  // Keep repeating
+    }
+
+    void execute(Task& task) {
+        uint64_t released = task.release_us;
+        task.pending.store(false, std::memory_order_release);
+
+        uint64_t start = now_us();
+        task.fn();
+        uint64_t end = now_us();
+
+        uint32_t jitter = (start > released) ? static_cast<uint32_t>(start - released) : 0;
+        uint32_t exec = static_cast<uint32_t>(end - start);
+
+        TaskStats& s = task.stats;
+        s.runs++;
+        s.total_jitter_us += jitter;
+        s.max_jitter_us = std::max(s.max_jitter_us, jitter);
+        s.max_exec_us = std::max(s.max_exec_us, exec);
+        s.exec_hist[std::min<size_t>(std::bit_width(exec), HIST_BINS - 1)]++;
+    }
+
+    // Periodic tasks: first release one period from t0
+    bool arm(Task& task, uint64_t t0) {
+        task.next_release_us = t0 + task.period_us;
+        if (mode != Mode::HARDWARE || task.period_us == 0) return true;
+
+        // Negative delay: period is measured between alarm targets, not callback ends
+        task.timer_armed = add_repeating_timer_us(-static_cast<int64_t>(task.period_us),
+                                                  timer_callback, this, &task.timer);
+        return task.timer_armed;
+    }
+
+    bool any_pending() const {
+        for (size_t i = 0; i < task_count; i++) {
+            if (tasks[i].pending.load(std::memory_order_acquire)) return true;
+        }
+        return false;
+    }
+
+public:
+    Scheduler() = default;
+    ~Scheduler() { stop(); }
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    // IRQ hook for event sources that take a function pointer and a context
+    // (see DataReady::Notify); lives as long as the source may fire
+    struct Trigger {
+        Scheduler* scheduler;
+        int task;
+
+        static void fire(void* context, uint64_t event_us) {
+            auto* t = static_cast<Trigger*>(context);
+            t->scheduler->trigger(t->task, event_us);
+        }
+    };
+
+    // Register a periodic task (before start()). Returns the task index or -1.
+    int add(const char* name, uint32_t rate_hz, TaskFn fn, bool active = true) {
+        if (running || task_count >= MAX_TASKS || rate_hz == 0) return -1;
+
+        Task& task = tasks[task_count];
+        task.name = name;
+        task.fn = std::move(fn);
+        task.period_us = utils::hz_to_us(rate_hz);
+        task.active = active;
+        task.stats = TaskStats{};
+        return static_cast<int>(task_count++);
+    }
+
+    // Register an event task, released only by trigger() (before start())
+    int add_event(const char* name, TaskFn fn, bool active = true) {
+        if (running || task_count >= MAX_TASKS) return -1;
+
+        Task& task = tasks[task_count];
+        task.name = name;
+        task.fn = std::move(fn);
+        task.period_us = 0;
+        task.active = active;
+        task.stats = TaskStats{};
+        return static_cast<int>(task_count++);
+    }
+
+    // Switch a parked task on; a periodic one is first released a period
+    // from now. Thread context, before or after start().
+    bool activate(int index) {
+        if (index < 0 || static_cast<size_t>(index) >= task_count) return false;
+        Task& task = tasks[index];
+        if (task.active) return true;
+
+        task.active = true;
+        return !running || arm(task, now_us());
+    }
+
+    // Park a task again (e.g. one-off work that has finished); a release
+    // already pending is dropped. Thread context.
+    void deactivate(int index) {
+        if (index < 0 || static_cast<size_t>(index) >= task_count) return;
+        Task& task = tasks[index];
+        if (task.timer_armed) cancel_repeating_timer(&task.timer);
+        task.timer_armed = false;
+        task.active = false;
+        task.pending.store(false, std::memory_order_release);
+    }
+
+    bool active(int index) const {
+        return index >= 0 && static_cast<size_t>(index) < task_count && tasks[index].active;
+    }
+
+    // Release an event task as of event_us. IRQ-safe; ignored until start()
+    // and while the task is parked.
+    void trigger(int index, uint64_t event_us) {
+        if (!running || index < 0 || static_cast<size_t>(index) >= task_count) return;
+        Task& task = tasks[index];
+        if (task.period_us != 0 || !task.active) return;
+        task.next_release_us = event_us;
+        release(task);
+    }
+
+    bool start(Mode m = Mode::HARDWARE) {
+        if (running) return true;
+        mode = m;
+
+        uint64_t t0 = now_us();
+        for (size_t i = 0; i < task_count; i++) {
+            Task& task = tasks[i];
+            task.pending.store(false, std::memory_order_relaxed);
+            if (task.active && !arm(task, t0)) {
+                stop();
+                return false;
+            }
+        }
+
+        running = true;
+        return true;
+    }
+
+    void stop() {
+        if (mode == Mode::HARDWARE) {
+            for (size_t i = 0; i < task_count; i++) {
+                if (tasks[i].timer_armed) cancel_repeating_timer(&tasks[i].timer);
+                tasks[i].timer_armed = false;
+            }
+        }
+        running = false;
+    }
+
+    // Run every released task once, highest priority (lowest index) first.
+    // Returns the number of tasks executed.
+    size_t run_pending() {
+        size_t executed = 0;
+        for (size_t i = 0; i < task_count; i++) {
+            if (tasks[i].pending.load(std::memory_order_acquire)) {
+                execute(tasks[i]);
+                executed++;
+                i = static_cast<size_t>(-1);  // Restart scan so higher priorities go first
+            }
+        }
+        return executed;
+    }
+
+    // Sleep until the next alarm IRQ unless work is already pending
+    void wait() {
+        uint32_t irq_state = save_and_disable_interrupts();
+        if (!any_pending()) {
+            __wfi();  // Wakes on pending IRQ even with interrupts masked
+        }
+        restore_interrupts(irq_state);
+    }
+
+    // ---- Simulation (virtual clock) ----
+
+    // Advance the virtual clock by duration_us, releasing and running tasks
+    // exactly as the alarms would. Task bodies call charge() for their cost.
+    void simulate(uint64_t duration_us) {
+        if (!running || mode != Mode::SIMULATED) return;
+
+        uint64_t end = virtual_now_us + duration_us;
+        while (virtual_now_us < end) {
+            // Release everything due by now
+            for (size_t i = 0; i < task_count; i++) {
+                while (tasks[i].period_us != 0 && tasks[i].active && tasks[i].next_release_us <= virtual_now_us) {
+                    release(tasks[i]);
+                }
+            }
+
+            if (run_pending() > 0) continue;
+
+            // Idle: jump to the next release
+            uint64_t next = end;
+            for (size_t i = 0; i < task_count; i++) {
+                if (tasks[i].period_us != 0 && tasks[i].active) next = std::min(next, tasks[i].next_release_us);
+            }
+            virtual_now_us = std::max(next, virtual_now_us);
+        }
+    }
+
+    // Consume virtual time from inside a task body (no-op on hardware)
+    void charge(uint32_t us) {
+        if (mode == Mode::SIMULATED) virtual_now_us += us;
+    }
+
+    uint64_t now_us() const {
+        return (mode == Mode::SIMULATED) ? virtual_now_us : time_us_64();
+    }
+
+    // ---- Statistics ----
+    size_t count() const { return task_count; }
+    const char* name(size_t i) const { return i < task_count ? tasks[i].name : nullptr; }
+    uint32_t period_us(size_t i) const { return i < task_count ? tasks[i].period_us : 0; }
+    const TaskStats* stats(size_t i) const { return i < task_count ? &tasks[i].stats : nullptr; }
+
+    // Emits one summary line plus the non-empty histogram bins per task.
+    // print(format, ...) must behave like printf.
+    template<typename Print>
+    void report(Print&& print) const {
+        for (size_t i = 0; i < task_count; i++) {
+            const Task& t = tasks[i];
+            const TaskStats& s = t.stats;
+            if (!t.active && s.runs == 0) continue;     // Parked and never run
+            print("[SCHEDR][--] %s n=%" PRIu32 " ovr=%" PRIu32 " jit=%" PRIu32 "/%" PRIu32 "us exe=%" PRIu32 "us\n",
+                  t.name, s.runs, s.overruns, s.mean_jitter_us(), s.max_jitter_us, s.max_exec_us);
+
+            for (size_t b = 0; b < HIST_BINS; b++) {
+                if (!s.exec_hist[b]) continue;
+                if (b < HIST_BINS - 1) {
+                    print("[SCHEDR][--] %s exe<%uus: %" PRIu32 "\n", t.name, 1u << b, s.exec_hist[b]);
+                } else {
+                    print("[SCHEDR][--] %s exe>=%uus: %" PRIu32 "\n", t.name, 1u << (b - 1), s.exec_hist[b]);
+                }
+            }
+        }
+    }
+};
+
+} // namespace scheduling
@@ -3,34 +3,23 @@
 // Project Omni-Header
 #include "config/all_headers.h"
 
+#include "config/config.h"
 #include "drivers/sdcard/sdcard.h"
 #include "led.h"
+#include "log_records.h"
+#include "log_streams.h"
 
 namespace logging {
 
 class SessionManager {
 public:
-    // Enum for file types - easy to extend
-    enum FileType {
-        FLIGHT = 0,
-        GPS,
-        PITOT,
-        FILE_COUNT  // Must be last
-    };
+    // File types and their record schemas live in log_records.h, which of
+    // them are logged in the stream registry (log_streams.h)
+    using FileType = logging::FileType;
 
 private:
-    // File configuration structure
-    struct FileConfig {
-        const char* filename;
-        const char* header;
-        bool enabled;
-    };
-    
-    static constexpr FileConfig file_configs[FILE_COUNT] = {
-        {"flight.txt", "time_ms,accel_x,accel_y,accel_z,gyro_x,gyro_y,gyro_z,altitude,pressure,temperature\n", true},
-        {"gps.txt", "time_ms,unix_time,latitude,longitude,altitude_mm,vel_north_mm_s,vel_east_mm_s,vel_down_mm_s,heading,h_accuracy,v_accuracy,speed_accuracy,heading_accuracy,valid\n", true},
-        {"pitot.txt", "time_ms,airspeed_ms,airspeed_mph,pressure_psi\n", true},
-    };
+    // Name, header and enabled flag per FileType
+    static constexpr const auto& file_configs = streams::FILES;
     
     // Pin configuration
     const uint toggle_pin;
@@ -55,16 +44,51 @@ private:
     drivers::SDCard& sd_card;
     drivers::SDFile* debug_file;
     
+    // Periodic sync: every open file is synced LOG_FLUSH_RATE_HZ times per
+    // second. Due files are taken round-robin, one tick every period/FILE_COUNT
+    // so the syncs spread out, and a tick stops once its time budget is used.
+    static constexpr uint64_t SYNC_PERIOD_US = 1000000 / config::sensors::LOG_FLUSH_RATE_HZ;
+    static constexpr uint64_t SYNC_TICK_US = SYNC_PERIOD_US / FILE_COUNT;
+    
+    uint64_t last_sync_us[FILE_COUNT] = {};
+    uint64_t next_sync_tick_us = 0;
+    int sync_cursor = 0;
+    uint32_t syncs_deferred = 0;        // Ticks skipped because of a burst
+    uint32_t sync_ticks_over_budget = 0;
+    
     // Helper to close all files
     void closeAllFiles() {
         for (int i = 0; i < FILE_COUNT; i++) {
             if (session_files[i].isOpen()) {
                 session_files[i].sync();
                 session_files[i].close();
+                reportFileStats(i);
             }
         }
     }
     
+    // Start the periodic sync schedule for a fresh session
+    void resetSyncSchedule() {
+        uint64_t now = time_us_64();
+        for (int i = 0; i < FILE_COUNT; i++) {
+            last_sync_us[i] = now;
+        }
+        next_sync_tick_us = now + SYNC_TICK_US;
+        sync_cursor = 0;
+        syncs_deferred = 0;
+        sync_ticks_over_budget = 0;
+    }
+    
+    // Write timing of a closed session file to debug.txt
+    void reportFileStats(int i) {
+        if (!debug_file) return;
+        
+        const auto& s = session_files[i].getStats();
+        debug_file->write("[SDFILE][--] %s bytes=%" PRIu64 " flushes=%" PRIu32 " max_flush=%" PRIu32 "us sync=%" PRIu32 "/%" PRIu32 "us stalls=%" PRIu32 " rate=%.2fMB/s prealloc=%d\n",
+                          file_configs[i].filename, s.bytes, s.flushes, s.max_flush_us, s.mean_sync_us(), s.max_sync_us,
+                          s.stalls, s.throughput_mbs(), s.preallocated);
+    }
+    
     // Helper to sync all files
     void syncAllFiles() {
         for (int i = 0; i < FILE_COUNT; i++) {
@@ -105,7 +129,8 @@ private:
             snprintf(file_path, sizeof(file_path), "%d/%s", current_folder_num, file_configs[i].filename);
             
             // Open file
-            if (!session_files[i].open(file_path, false)) {
+            if (!session_files[i].open(file_path, false, config::sdcard::PREALLOCATE_BYTES,
+                                       config::sdcard::JOURNAL_FILES)) {
                 if (debug_file) {
                     debug_file->write("[SESSION][XX] Failed to create %s in folder %d\n", 
                                     file_configs[i].filename, current_folder_num);
@@ -114,10 +139,11 @@ private:
                 continue;
             }
             
-            // Write header if provided
-            if (file_configs[i].header && strlen(file_configs[i].header) > 0) {
-                session_files[i].write(file_configs[i].header);
-            }
+            // Write binary file header (decoded by tools/log_decoder) and
+            // commit it with the preallocation, so a power cut from here on
+            // is recoverable
+            session_files[i].writeRecord(file_configs[i].header);
+            session_files[i].sync();
         }
         
         if (!all_success) {
@@ -125,6 +151,8 @@ private:
             return false;
         }
         
+        resetSyncSchedule();
+        
         if (debug_file) {
             debug_file->write("[SESSION][OK] Started session %d\n", current_folder_num);
         }
@@ -133,6 +161,10 @@ private:
     }
     
     void stopLogging() {
+        if (logging_active && debug_file) {
+            debug_file->write("[SESSION][--] Syncs deferred=%" PRIu32 " over_budget=%" PRIu32 "\n",
+                              syncs_deferred, sync_ticks_over_budget);
+        }
         closeAllFiles();
         logging_active = false;
         led_off();
@@ -243,6 +275,58 @@ public:
         }
     }
     
+    // Write out any buffers handed off since the last call
+    bool pollFiles() {
+        bool ok = true;
+        for (int i = 0; i < FILE_COUNT; i++) {
+            ok &= session_files[i].poll();
+        }
+        return ok;
+    }
+    
+    // Periodic sync tick; call often from the writer loop. While `burst` is
+    // set the tick is skipped unless a file is already SYNC_MAX_DEFER_MS late.
+    // Returns false if a sync failed.
+    bool serviceSync(bool burst = false) {
+        using namespace config::sdcard;
+        if (!logging_active) return true;
+        
+        uint64_t now = time_us_64();
+        if (now < next_sync_tick_us) return true;
+        
+        if (burst) {
+            uint64_t oldest = now;
+            for (int i = 0; i < FILE_COUNT; i++) {
+                if (session_files[i].isOpen()) oldest = std::min(oldest, last_sync_us[i]);
+            }
+            if (now - oldest < SYNC_PERIOD_US + SYNC_MAX_DEFER_MS * 1000ull) {
+                syncs_deferred++;
+                next_sync_tick_us = now + SYNC_TICK_US;
+                return true;
+            }
+        }
+        
+        bool ok = true;
+        int synced = 0;
+        for (int n = 0; n < FILE_COUNT; n++) {
+            int i = (sync_cursor + n) % FILE_COUNT;
+            if (!session_files[i].isOpen() || now - last_sync_us[i] < SYNC_PERIOD_US) continue;
+            
+            if (synced > 0 && time_us_64() - now >= SYNC_BUDGET_US) {
+                sync_ticks_over_budget++;
+                break;
+            }
+            
+            ok &= session_files[i].sync();
+            last_sync_us[i] = time_us_64();
+            sync_cursor = (i + 1) % FILE_COUNT;
+            synced++;
+        }
+        
+        next_sync_tick_us = now + SYNC_TICK_US;
+        return ok;
+    }
+    
     bool isLogging() const { return logging_active; }
     
     bool isShutdownRequested() const { return shutdown_requested; }
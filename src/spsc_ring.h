@@ -0,0 +1,104 @@
+#pragma once
+
+// NOTE: Pico SDK free so it can be exercised on the host as well.
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace utils {
+
+// ============================================
+// Lock-free Single-Producer/Single-Consumer Ring
+// ============================================
+// One core pushes, the other pops. Indices are free-running 32-bit counters;
+// the producer only writes `head`, the consumer only writes `tail`, so no
+// read-modify-write atomics are needed on either side.
+//
+// claim()/publish() and front()/pop() give zero-copy access to the slots.
+template<typename T, size_t N>
+class SpscRing {
+    static_assert(std::has_single_bit(N), "Capacity must be a power of two");
+    static_assert(N <= (1u << 31), "Capacity too large for 32-bit indices");
+
+private:
+    static constexpr uint32_t MASK = N - 1;
+
+    T slots[N];
+    std::atomic<uint32_t> head{0};          // Next slot to publish (producer)
+    std::atomic<uint32_t> tail{0};          // Next slot to consume (consumer)
+
+    // Statistics (producer-owned)
+    std::atomic<uint32_t> overflow_count{0};
+    std::atomic<uint32_t> high_water_mark{0};
+
+public:
+    // ---- Producer side ----
+
+    // Returns the next free slot, or nullptr if full (counted as overflow)
+    T* claim() {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        uint32_t t = tail.load(std::memory_order_acquire);
+        if (h - t >= N) {
+            overflow_count.store(overflow_count.load(std::memory_order_relaxed) + 1,
+                                 std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &slots[h & MASK];
+    }
+
+    // Makes the slot returned by claim() visible to the consumer
+    void publish() {
+        uint32_t h = head.load(std::memory_order_relaxed) + 1;
+        head.store(h, std::memory_order_release);
+
+        uint32_t used = h - tail.load(std::memory_order_relaxed);
+        if (used > high_water_mark.load(std::memory_order_relaxed)) {
+            high_water_mark.store(used, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(const T& item) {
+        T* slot = claim();
+        if (!slot) return false;
+        *slot = item;
+        publish();
+        return true;
+    }
+
+    // ---- Consumer side ----
+
+    // Returns the oldest published slot, or nullptr if empty
+    T* front() {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &slots[t & MASK];
+    }
+
+    // Releases the slot returned by front() back to the producer
+    void pop() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool pop(T& out) {
+        T* slot = front();
+        if (!slot) return false;
+        out = *slot;
+        pop();
+        return true;
+    }
+
+    // ---- Status (approximate when read from the other side) ----
+    static constexpr size_t capacity() { return N; }
+    size_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+
+    uint32_t overflows() const { return overflow_count.load(std::memory_order_relaxed); }
+    uint32_t high_water() const { return high_water_mark.load(std::memory_order_relaxed); }
+};
+
+} // namespace utils
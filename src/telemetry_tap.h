@@ -0,0 +1,156 @@
+#pragma once
+
+// Project Omni-Header
+#include "config/all_headers.h"
+
+#include "config/config.h"
+#include "log_records.h"
+
+#include "tusb.h"
+
+namespace telemetry {
+
+// ============================================
+// USB Telemetry Tap
+// ============================================
+// Optional live mirror of logged records over USB CDC, replacing the old
+// printf of every line. Records are decimated (1-in-N per stream), encoded
+// as CSV text or compact binary frames, and queued in a private ring. The
+// ring is drained by service() only as far as the CDC endpoint and the
+// byte-rate budget allow, so the tap never blocks the sampler; anything
+// that does not fit is dropped and counted.
+//
+// Binary frame: 0xA5 0x5A <FileType> <length> <record bytes>
+//
+// The mode can be switched from the host by sending 'o' (off), 't' (text)
+// or 'b' (binary) over the USB serial port.
+class TelemetryTap {
+public:
+    enum class Mode : uint8_t { OFF = 0, TEXT = 1, BINARY = 2 };
+
+    static constexpr uint8_t FRAME_SYNC_1 = 0xA5;
+    static constexpr uint8_t FRAME_SYNC_2 = 0x5A;
+
+    struct Stats {
+        uint32_t tapped;            // Records offered to the tap
+        uint32_t queued_bytes;
+        uint32_t sent_bytes;
+        uint32_t dropped_bytes;     // Ring full (host not reading or over budget)
+    };
+
+private:
+    static constexpr size_t BUFFER_SIZE = config::telemetry::BUFFER_SIZE;
+    static_assert(std::has_single_bit(BUFFER_SIZE), "Telemetry buffer must be a power of two");
+
+    uint8_t ring[BUFFER_SIZE];
+    uint32_t head = 0;      // Producer index (free running)
+    uint32_t tail = 0;      // Consumer index (free running)
+
+    Mode mode = static_cast<Mode>(config::telemetry::DEFAULT_MODE);
+    bool session_active = false;
+    uint32_t decimation_count[logging::FILE_COUNT] = {};
+
+    // Byte-rate budget (token bucket, refilled in service())
+    uint32_t tokens = 0;
+    uint64_t last_refill_us = 0;
+
+    Stats stats = {};
+
+    size_t free_space() const { return BUFFER_SIZE - (head - tail); }
+
+    // All-or-nothing enqueue so frames/lines are never split
+    bool enqueue(const void* data, size_t len) {
+        if (len > free_space()) {
+            stats.dropped_bytes += len;
+            return false;
+        }
+
+        const uint8_t* src = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < len; i++) {
+            ring[(head + i) & (BUFFER_SIZE - 1)] = src[i];
+        }
+        head += len;
+        stats.queued_bytes += len;
+        return true;
+    }
+
+    void poll_command() {
+        int c = getchar_timeout_us(0);
+        switch (c) {
+            case 'o': mode = Mode::OFF;    break;
+            case 't': mode = Mode::TEXT;   break;
+            case 'b': mode = Mode::BINARY; break;
+            default: break;
+        }
+    }
+
+public:
+    bool isActive() const {
+        return mode != Mode::OFF && (!session_active || config::telemetry::WHILE_LOGGING);
+    }
+
+    void setMode(Mode m) { mode = m; }
+    Mode getMode() const { return mode; }
+
+    // Logging sessions mute the tap unless config::telemetry::WHILE_LOGGING
+    void setLogging(bool active) { session_active = active; }
+
+    // Offer a record to the tap (cheap no-op when inactive or decimated out)
+    template<logging::FileType T>
+    void tap(const typename logging::records::Schema<T>::Record& record) {
+        using Schema = logging::records::Schema<T>;
+
+        if (!isActive()) return;
+        if (++decimation_count[T] < config::telemetry::DECIMATION) return;
+        decimation_count[T] = 0;
+        stats.tapped++;
+
+        if (mode == Mode::BINARY) {
+            uint8_t frame[4 + sizeof(record)];
+            frame[0] = FRAME_SYNC_1;
+            frame[1] = FRAME_SYNC_2;
+            frame[2] = T;
+            frame[3] = sizeof(record);
+            memcpy(frame + 4, &record, sizeof(record));
+            enqueue(frame, sizeof(frame));
+        } else {
+            char line[192];
+            int len = Schema::to_csv(record, line, sizeof(line));
+            if (len > 0) {
+                enqueue(line, std::min<size_t>(len, sizeof(line) - 1));
+            }
+        }
+    }
+
+    // Push queued bytes to USB CDC without blocking. Call periodically.
+    void service() {
+        poll_command();
+
+        uint64_t now = time_us_64();
+        uint64_t elapsed = now - last_refill_us;
+        last_refill_us = now;
+
+        uint64_t refill = elapsed * config::telemetry::MAX_BYTES_PER_SEC / 1000000;
+        tokens = std::min<uint64_t>(tokens + refill, BUFFER_SIZE);
+
+        if (head == tail || !stdio_usb_connected()) return;
+
+        // Only hand stdio as many bytes as the CDC FIFO can take right now
+        size_t budget = std::min<size_t>(tud_cdc_write_available(), tokens);
+        size_t count = std::min<size_t>(budget, head - tail);
+
+        for (size_t i = 0; i < count; i++) {
+            putchar_raw(ring[(tail + i) & (BUFFER_SIZE - 1)]);
+        }
+
+        tail += count;
+        tokens -= count;
+        stats.sent_bytes += count;
+
+        if (count) stdio_flush();
+    }
+
+    const Stats& getStats() const { return stats; }
+};
+
+} // namespace telemetry
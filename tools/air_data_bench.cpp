@@ -0,0 +1,168 @@
+// Airspeed computation (drivers::AirData): agreement with the exact
+// formulas and cost per pitot sample.
+//
+//   air_data_bench [--points N]
+//
+// Impact pressures for Mach 0.01..0.95 at 0..11 km (ISA) go through both
+// models; they have to match the closed forms in double precision:
+//   - IAS: sqrt(2 qc / 1.225), the old PitotTube value, to 1e-5
+//   - COMPRESSIBLE: TAS, CAS and Mach from the isentropic relations, to 1e-5
+//   - INCOMPRESSIBLE: TAS = sqrt(2 qc / rho), to 1e-5
+// Each model is then timed on low and on high speeds (the table lookup
+// must not make the cost depend on the input) against evaluating the
+// compressible formula with powf. The exit code is non-zero when a check
+// fails.
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "drivers/sensors/air_data.h"
+
+using drivers::AirData;
+
+namespace {
+
+struct Point {
+    float static_pa;
+    float temperature_c;
+    float qc_pa;
+    double tas_ms, cas_ms, mach;    // Exact
+};
+
+double isa_temperature_k(double h) { return 288.15 - 0.0065 * h; }
+double isa_pressure_pa(double h) { return 101325.0 * std::pow(isa_temperature_k(h) / 288.15, 5.25588); }
+
+double mach_from(double qc_p) { return std::sqrt(5.0 * (std::pow(qc_p + 1.0, 2.0 / 7.0) - 1.0)); }
+
+std::vector<Point> make_points(uint32_t count, double mach_min, double mach_max) {
+    std::mt19937 rng(1225);
+    std::uniform_real_distribution<double> altitude(0.0, 11000.0);
+    std::uniform_real_distribution<double> mach(mach_min, mach_max);
+    std::vector<Point> points;
+    for (uint32_t i = 0; i < count; i++) {
+        double h = altitude(rng);
+        double t_k = isa_temperature_k(h);
+        double p = isa_pressure_pa(h);
+        Point pt;
+        pt.static_pa = static_cast<float>(p);
+        pt.temperature_c = static_cast<float>(t_k - 273.15);
+        double m = mach(rng);
+        pt.qc_pa = static_cast<float>(p * (std::pow(1.0 + 0.2 * m * m, 3.5) - 1.0));
+
+        // From the rounded inputs, as the firmware sees them
+        double qc = pt.qc_pa, ps = pt.static_pa, tk = pt.temperature_c + 273.15;
+        pt.mach = mach_from(qc / ps);
+        pt.tas_ms = pt.mach * std::sqrt(1.4 * 287.05 * tk);
+        pt.cas_ms = AirData::A0_MS * mach_from(qc / 101325.0);
+        points.push_back(pt);
+    }
+    return points;
+}
+
+double relative(double value, double exact) { return std::fabs(value - exact) / std::max(std::fabs(exact), 1e-3); }
+
+// ============================================
+// Bench
+// ============================================
+
+template<typename Fn>
+double ns_per_sample(size_t count, Fn&& fn) {
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    size_t total = 0;
+    double elapsed_s = 0;
+    do {
+        fn();
+        total += count;
+        elapsed_s = std::chrono::duration<double>(clock::now() - start).count();
+    } while (elapsed_s < 0.2);
+    return elapsed_s * 1e9 / total;
+}
+
+// The compressible airspeeds straight from the formulas, in float
+drivers::airspeeds direct(float qc, float p, float t_c) {
+    float a = sqrtf(1.4f * 287.05f * (t_c + 273.15f));
+    float m = sqrtf(5.0f * (powf(qc / p + 1.0f, 2.0f / 7.0f) - 1.0f));
+    float cas = 340.294f * sqrtf(5.0f * (powf(qc / 101325.0f + 1.0f, 2.0f / 7.0f) - 1.0f));
+    return {sqrtf(qc * (2.0f / 1.225f)), cas, m * a, m};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t count = 20000;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--points" && i + 1 < argc) count = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else {
+            fprintf(stderr, "usage: %s [--points N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (!count) return 2;
+
+    std::vector<Point> points = make_points(count, 0.01, 0.95);
+
+    AirData compressible(AirData::Model::COMPRESSIBLE);
+    AirData incompressible(AirData::Model::INCOMPRESSIBLE);
+    double max_ias = 0.0, max_tas = 0.0, max_cas = 0.0, max_mach = 0.0, max_inc = 0.0;
+    for (const Point& pt : points) {
+        compressible.set_static(pt.static_pa, pt.temperature_c);
+        incompressible.set_static(pt.static_pa, pt.temperature_c);
+        drivers::airspeeds c = compressible.compute(pt.qc_pa);
+        drivers::airspeeds i = incompressible.compute(pt.qc_pa);
+
+        double rho = pt.static_pa / (287.05 * (pt.temperature_c + 273.15));
+        max_ias = std::max(max_ias, relative(c.ias_ms, std::sqrt(2.0 * pt.qc_pa / 1.225)));
+        max_tas = std::max(max_tas, relative(c.tas_ms, pt.tas_ms));
+        max_cas = std::max(max_cas, relative(c.cas_ms, pt.cas_ms));
+        max_mach = std::max(max_mach, relative(c.mach, pt.mach));
+        max_inc = std::max(max_inc, relative(i.tas_ms, std::sqrt(2.0 * pt.qc_pa / rho)));
+    }
+    bool ok = max_ias <= 1e-5 && max_tas <= 1e-5 && max_cas <= 1e-5 && max_mach <= 1e-5 && max_inc <= 1e-5;
+
+    // Bernoulli's error on TAS, for reference
+    double bernoulli_03 = 0.0, bernoulli_05 = 0.0;
+    for (double m : {0.3, 0.5}) {
+        double qc_p = std::pow(1.0 + 0.2 * m * m, 3.5) - 1.0;
+        double error = std::sqrt(2.0 * qc_p / (1.4 * m * m)) - 1.0;
+        (m < 0.4 ? bernoulli_03 : bernoulli_05) = error;
+    }
+
+    // Cost per sample at the barometer's static, slow and fast
+    std::vector<Point> slow = make_points(4096, 0.01, 0.1);
+    std::vector<Point> fast = make_points(4096, 0.6, 0.95);
+    compressible.set_static(90000.0f, 5.0f);
+    incompressible.set_static(90000.0f, 5.0f);
+    volatile float sink = 0.0f;
+    auto time = [&](const std::vector<Point>& set, auto&& fn) {
+        return ns_per_sample(set.size(), [&] {
+            float acc = 0.0f;
+            for (const Point& pt : set) acc += fn(pt.qc_pa).tas_ms;
+            sink = sink + acc;
+        });
+    };
+    auto run_compressible = [&](float qc) { return compressible.compute(qc); };
+    auto run_incompressible = [&](float qc) { return incompressible.compute(qc); };
+    auto run_direct = [&](float qc) { return direct(qc, 90000.0f, 5.0f); };
+
+    printf("%" PRIu32 " points, Mach 0.01..0.95, 0..11 km\n", count);
+    printf("  max relative error: IAS %.1e, TAS %.1e, CAS %.1e, Mach %.1e, incompressible TAS %.1e\n",
+           max_ias, max_tas, max_cas, max_mach, max_inc);
+    printf("  Bernoulli TAS vs isentropic: %+.2f%% at Mach 0.3, %+.2f%% at Mach 0.5\n",
+           bernoulli_03 * 100, bernoulli_05 * 100);
+    printf("per sample           %10s %10s\n", "Mach<0.1", "Mach>0.6");
+    printf("  %-18s %7.1f ns %7.1f ns\n", "formulas (powf)", time(slow, run_direct), time(fast, run_direct));
+    printf("  %-18s %7.1f ns %7.1f ns\n", "compressible", time(slow, run_compressible), time(fast, run_compressible));
+    printf("  %-18s %7.1f ns %7.1f ns\n", "incompressible", time(slow, run_incompressible),
+           time(fast, run_incompressible));
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,353 @@
+// BMP390 compensation and pressure altitude: agreement and cost per sample.
+//
+//   bmp390_compensation_bench [--calibrations N] [--samples N]
+//
+// Random parts (trimming coefficients spread around a typical one) each
+// convert raw counts over -40..85 °C and 30..125 kPa, the counts found by
+// inverting the datasheet's floating point compensation:
+//   - drivers::BMP390Compensation has to match the previous per-sample
+//     integer code (BMP390::compensate_temperature/_pressure) bit for bit
+//   - both are compared with the floating point formulation, which they
+//     must follow within 0.011 °C (they truncate to 0.01 °C)
+//     and 1 Pa
+//   - drivers::pressure_altitude (table) has to stay within 1 cm of the
+//     formula in double precision over 30..110 kPa
+// and then each path is timed, in ns and (x86) TSC cycles per sample. The
+// exit code is non-zero when a check fails.
+//
+// The host has a double precision FPU; the RP2350's Cortex-M33 only has a
+// single precision one, doubles are library calls there, so the host's
+// floating point row flatters that path.
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#include "drivers/sensors/bmp390_compensation.h"
+#include "drivers/sensors/pressure_altitude.h"
+
+using drivers::bmp390_calib;
+
+namespace {
+
+// ============================================
+// Before: the driver's per-sample integer code
+// ============================================
+namespace before {
+
+struct Compensation {
+    bmp390_calib calib;
+    int64_t t_fine = 0;
+
+    int64_t temperature(uint32_t raw_temp) {
+        int64_t partial_data1 = (int64_t)(raw_temp - ((int64_t)256 * calib.T1));
+        int64_t partial_data2 = (int64_t)(calib.T2 * partial_data1);
+        int64_t partial_data3 = (int64_t)(partial_data1 * partial_data1);
+        int64_t partial_data4 = (int64_t)partial_data3 * calib.T3;
+        int64_t partial_data5 = (int64_t)((partial_data2 * 262144) + partial_data4);
+        int64_t partial_data6 = (int64_t)(partial_data5 / 4294967296);
+        t_fine = partial_data6;
+        return (int64_t)((partial_data6 * 25) / 16384);
+    }
+
+    uint64_t pressure(uint32_t raw_press) {
+        int64_t partial_data1 = (int64_t)(t_fine * t_fine);
+        int64_t partial_data2 = (int64_t)(partial_data1 / 64);
+        int64_t partial_data3 = (int64_t)((partial_data2 * t_fine) / 256);
+        int64_t partial_data4 = (int64_t)((calib.P8 * partial_data3) / 32);
+        int64_t partial_data5 = (int64_t)((calib.P7 * partial_data1) * 16);
+        int64_t partial_data6 = (int64_t)((calib.P6 * t_fine) * 4194304);
+        int64_t offset = (int64_t)((calib.P5 * (int64_t)140737488355328) + partial_data4 + partial_data5 + partial_data6);
+
+        partial_data2 = (int64_t)((calib.P4 * partial_data3) / 32);
+        partial_data4 = (int64_t)((calib.P3 * partial_data1) * 4);
+        partial_data5 = (int64_t)((calib.P2 - 16384) * t_fine * 2097152);
+        int64_t sensitivity = (int64_t)(((calib.P1 - 16384) * (int64_t)70368744177664) + partial_data2 + partial_data4 + partial_data5);
+
+        partial_data1 = (int64_t)((sensitivity / 16777216) * raw_press);
+        partial_data2 = (int64_t)(calib.P10 * t_fine);
+        partial_data3 = (int64_t)(partial_data2 + (65536 * calib.P9));
+        partial_data4 = (int64_t)((partial_data3 * raw_press) / 8192);
+        partial_data5 = (int64_t)((raw_press * (partial_data4 / 10)) / 512) * 10;
+        partial_data6 = (int64_t)((uint64_t)raw_press * raw_press);
+        partial_data2 = (int64_t)((calib.P11 * partial_data6) / 65536);
+        partial_data3 = (int64_t)((partial_data2 * raw_press) / 128);
+        partial_data4 = (int64_t)((offset / 4) + partial_data1 + partial_data5 + partial_data3);
+        return (((uint64_t)partial_data4 * 25) / (uint64_t)1099511627776);
+    }
+};
+
+} // namespace before
+
+// ============================================
+// Floating point: datasheet section 8.4/8.6
+// ============================================
+namespace floating {
+
+double temperature(const bmp390_calib& c, double raw_t) {
+    double p1 = raw_t - c.T1 * 256.0;
+    return p1 * (c.T2 / 1073741824.0) + p1 * p1 * (c.T3 / 281474976710656.0);
+}
+
+double pressure(const bmp390_calib& c, double raw_p, double t) {
+    double p1 = (c.P1 - 16384) / 1048576.0;
+    double p2 = (c.P2 - 16384) / 536870912.0;
+    double p3 = c.P3 / 4294967296.0;
+    double p4 = c.P4 / 137438953472.0;
+    double p5 = c.P5 * 8.0;
+    double p6 = c.P6 / 64.0;
+    double p7 = c.P7 / 256.0;
+    double p8 = c.P8 / 32768.0;
+    double p9 = c.P9 / 281474976710656.0;
+    double p10 = c.P10 / 281474976710656.0;
+    double p11 = c.P11 / 36893488147419103232.0;
+
+    double out1 = p5 + p6 * t + p7 * t * t + p8 * t * t * t;
+    double out2 = raw_p * (p1 + p2 * t + p3 * t * t + p4 * t * t * t);
+    return out1 + out2 + raw_p * raw_p * (p9 + p10 * t) + raw_p * raw_p * raw_p * p11;
+}
+
+// Raw counts for a reading (Newton's method, as the simulator's model)
+template<typename Fn>
+uint32_t invert(Fn&& compensate, double target, double guess) {
+    double x = guess;
+    for (int i = 0; i < 30; i++) {
+        double y = compensate(x);
+        double slope = compensate(x + 1.0) - y;
+        if (slope == 0.0) break;
+        double step = (target - y) / slope;
+        x += step;
+        if (std::fabs(step) < 0.01) break;
+    }
+    return static_cast<uint32_t>(std::lround(std::clamp(x, 0.0, 16777215.0)));
+}
+
+} // namespace floating
+
+// ============================================
+// Vectors
+// ============================================
+
+struct Part {
+    bmp390_calib calib;
+    std::vector<uint32_t> raw_t, raw_p;
+};
+
+// The simulator's default part
+constexpr bmp390_calib TYPICAL = {27748, 18713, -7, 26810, 2742, 35, 1, 4480, 30452, 3, -6, 3963, 10, -60};
+
+// Coefficients spread around it
+bmp390_calib random_calib(std::mt19937& rng) {
+    auto spread = [&](int center, int range) {
+        return center + static_cast<int>(rng() % (2 * range + 1)) - range;
+    };
+    return {
+        .T1 = static_cast<uint16_t>(spread(27748, 1500)),
+        .T2 = static_cast<uint16_t>(spread(18713, 1500)),
+        .T3 = static_cast<int8_t>(spread(-7, 4)),
+        .P1 = static_cast<int16_t>(spread(26810, 3000)),
+        .P2 = static_cast<int16_t>(spread(2742, 1500)),
+        .P3 = static_cast<int8_t>(spread(35, 10)),
+        .P4 = static_cast<int8_t>(spread(1, 1)),
+        .P5 = static_cast<uint16_t>(spread(4480, 500)),
+        .P6 = static_cast<uint16_t>(spread(30452, 1500)),
+        .P7 = static_cast<int8_t>(spread(3, 2)),
+        .P8 = static_cast<int8_t>(spread(-6, 3)),
+        .P9 = static_cast<int16_t>(spread(3963, 800)),
+        .P10 = static_cast<int8_t>(spread(10, 5)),
+        .P11 = static_cast<int8_t>(spread(-60, 20)),
+    };
+}
+
+std::vector<Part> make_parts(uint32_t calibrations, uint32_t samples) {
+    std::mt19937 rng(390);
+    std::uniform_real_distribution<double> temp_c(-40.0, 85.0);
+    std::uniform_real_distribution<double> press_pa(30000.0, 125000.0);
+    std::vector<Part> parts(calibrations);
+    for (uint32_t k = 0; k < calibrations; k++) {
+        Part& part = parts[k];
+        part.calib = k ? random_calib(rng) : TYPICAL;
+        for (uint32_t i = 0; i < samples; i++) {
+            const bmp390_calib& c = part.calib;
+            uint32_t raw_t = floating::invert([&](double r) { return floating::temperature(c, r); }, temp_c(rng), 8.0e6);
+            double t = floating::temperature(c, raw_t);
+            uint32_t raw_p = floating::invert([&](double r) { return floating::pressure(c, r, t); }, press_pa(rng), 6.0e6);
+            part.raw_t.push_back(raw_t);
+            part.raw_p.push_back(raw_p);
+        }
+    }
+    return parts;
+}
+
+// ============================================
+// Bench
+// ============================================
+
+struct Cost {
+    double ns;
+    double cycles;      // 0 without a TSC
+};
+
+template<typename Fn>
+Cost cost_per_sample(size_t count, Fn&& fn) {
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+#ifdef HAVE_TSC
+    uint64_t tsc_start = __rdtsc();
+#endif
+    size_t total = 0;
+    double elapsed_s = 0;
+    do {
+        fn();
+        total += count;
+        elapsed_s = std::chrono::duration<double>(clock::now() - start).count();
+    } while (elapsed_s < 0.2);
+    Cost cost = {elapsed_s * 1e9 / total, 0.0};
+#ifdef HAVE_TSC
+    cost.cycles = static_cast<double>(__rdtsc() - tsc_start) / total;
+#endif
+    return cost;
+}
+
+void print_cost(const char* name, Cost cost, Cost base) {
+    printf("  %-34s %7.1f ns", name, cost.ns);
+    if (cost.cycles > 0) printf(" %7.1f cycles", cost.cycles);
+    printf("  (x%.2f)\n", base.ns / cost.ns);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t calibrations = 100;
+    uint32_t samples = 2000;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--calibrations" && i + 1 < argc) calibrations = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (a == "--samples" && i + 1 < argc) samples = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else {
+            fprintf(stderr, "usage: %s [--calibrations N] [--samples N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (!calibrations || !samples) return 2;
+
+    std::vector<Part> parts = make_parts(calibrations, samples);
+    size_t total = static_cast<size_t>(calibrations) * samples;
+
+    // Compensation: integer paths bit for bit, floating point within bounds
+    uint32_t mismatches = 0;
+    double max_temp_error = 0.0, max_press_error = 0.0;
+    for (const Part& part : parts) {
+        before::Compensation old_comp{part.calib};
+        drivers::BMP390Compensation new_comp;
+        new_comp.set_calibration(part.calib);
+        for (uint32_t i = 0; i < samples; i++) {
+            int64_t old_t = old_comp.temperature(part.raw_t[i]);
+            uint64_t old_p = old_comp.pressure(part.raw_p[i]);
+            int64_t new_t = new_comp.temperature(part.raw_t[i]);
+            uint64_t new_p = new_comp.pressure(part.raw_p[i]);
+            if ((old_t != new_t || old_p != new_p) && mismatches++ < 5) {
+                printf("  MISMATCH: raw %" PRIu32 "/%" PRIu32 ": %" PRId64 "/%" PRIu64 " vs %" PRId64 "/%" PRIu64 "\n",
+                       part.raw_t[i], part.raw_p[i], old_t, old_p, new_t, new_p);
+            }
+            double t = floating::temperature(part.calib, part.raw_t[i]);
+            double p = floating::pressure(part.calib, part.raw_p[i], t);
+            max_temp_error = std::max(max_temp_error, std::fabs(new_t / 100.0 - t));
+            max_press_error = std::max(max_press_error, std::fabs(new_p / 100.0 - p));
+        }
+    }
+    bool compensation_ok = !mismatches && max_temp_error <= 0.011 && max_press_error <= 1.0;
+
+    // Altitude: table against the formula, every ~0.3 Pa
+    double max_table_error = 0.0, max_powf_error = 0.0, worst_pa = 0.0;
+    for (float pa = 30000.0f; pa < 110000.0f; pa += 0.3f) {
+        double exact = 44330.0 * (1.0 - std::pow(pa / 101325.0, 0.1903));
+        double table_error = std::fabs(drivers::pressure_altitude(pa) - exact);
+        if (table_error > max_table_error) {
+            max_table_error = table_error;
+            worst_pa = pa;
+        }
+        double powf_m = 44330.0f * (1.0f - powf(pa / 101325.0f, 0.1903f));
+        max_powf_error = std::max(max_powf_error, std::fabs(powf_m - exact));
+    }
+    bool altitude_ok = max_table_error <= 0.01;
+
+    // Cost per sample
+    volatile uint64_t sink = 0;
+    Cost float_cost = cost_per_sample(total, [&] {
+        double acc = 0.0;
+        for (const Part& part : parts) {
+            for (uint32_t i = 0; i < samples; i++) {
+                double t = floating::temperature(part.calib, part.raw_t[i]);
+                acc += floating::pressure(part.calib, part.raw_p[i], t);
+            }
+        }
+        sink = sink + static_cast<uint64_t>(acc);
+    });
+    Cost before_cost = cost_per_sample(total, [&] {
+        uint64_t acc = 0;
+        for (const Part& part : parts) {
+            before::Compensation comp{part.calib};
+            for (uint32_t i = 0; i < samples; i++) {
+                acc += comp.temperature(part.raw_t[i]);
+                acc += comp.pressure(part.raw_p[i]);
+            }
+        }
+        sink = sink + acc;
+    });
+    Cost after_cost = cost_per_sample(total, [&] {
+        uint64_t acc = 0;
+        for (const Part& part : parts) {
+            drivers::BMP390Compensation comp;
+            comp.set_calibration(part.calib);
+            for (uint32_t i = 0; i < samples; i++) {
+                acc += comp.temperature(part.raw_t[i]);
+                acc += comp.pressure(part.raw_p[i]);
+            }
+        }
+        sink = sink + acc;
+    });
+
+    std::vector<float> pressures(4096);
+    std::mt19937 rng(101325);
+    std::uniform_real_distribution<float> press_pa(30000.0f, 110000.0f);
+    for (float& pa : pressures) pa = press_pa(rng);
+    Cost powf_cost = cost_per_sample(pressures.size(), [&] {
+        float acc = 0.0f;
+        for (float pa : pressures) acc += 44330.0f * (1.0f - powf(pa / 101325.0f, 0.1903f));
+        sink = sink + static_cast<uint64_t>(acc);
+    });
+    Cost table_cost = cost_per_sample(pressures.size(), [&] {
+        float acc = 0.0f;
+        for (float pa : pressures) acc += drivers::pressure_altitude(pa);
+        sink = sink + static_cast<uint64_t>(acc);
+    });
+
+    printf("%" PRIu32 " parts x %" PRIu32 " samples\n", calibrations, samples);
+    printf("compensation (per temperature + pressure pair):\n");
+    print_cost("floating point (datasheet)", float_cost, float_cost);
+    print_cost("before: integer, per sample", before_cost, float_cost);
+    print_cost("after: integer, hoisted calibration", after_cost, float_cost);
+    printf("  integer paths: %" PRIu32 " mismatches\n", mismatches);
+    printf("  vs floating point: max %.4f C, %.3f Pa\n", max_temp_error, max_press_error);
+    printf("pressure altitude:\n");
+    print_cost("powf", powf_cost, powf_cost);
+    print_cost("table + interpolation", table_cost, powf_cost);
+    printf("  vs double: table max %.2f mm (at %.0f Pa), powf max %.2f mm\n",
+           max_table_error * 1e3, worst_pa, max_powf_error * 1e3);
+
+    bool ok = compensation_ok && altitude_ok;
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,304 @@
+// Power-cut recovery test for journaled session files (drivers/sdcard/journal.h).
+//
+// Each trial formats a RAM disk image, leaves a deleted journaled file behind
+// (so the preallocated area holds valid-looking stale blocks), then logs a
+// session the way SDFile does: preallocate with f_expand, write sector-sized
+// blocks, sync periodically and rewind over the partial last block. The
+// image stops accepting writes after a random number of sectors, possibly in
+// the middle of a multi-sector write. The image is then remounted and the
+// file recovered with journal::recover(); the result must be an exact prefix
+// of what was logged, hold at least everything synced before the cut, and
+// contain no stale tail.
+//
+//   journal_recovery_test [trials] [seed]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "log_records.h"
+#include "drivers/sdcard/journal.h"
+
+extern "C" {
+    #include "diskio.h"
+}
+
+namespace journal = drivers::journal;
+
+// ============================================
+// RAM Disk with Power Cut
+// ============================================
+namespace disk {
+    static constexpr LBA_t SECTORS = 64u * 2048;    // 64MB
+    static std::vector<uint8_t> image(SECTORS * journal::BLOCK_SIZE);
+
+    static uint64_t sectors_written = 0;
+    static uint64_t cut_after = UINT64_MAX;         // Sector writes accepted before the cut
+
+    static bool isCut() { return sectors_written >= cut_after; }
+}
+
+extern "C" {
+    DSTATUS disk_status(BYTE) { return 0; }
+    DSTATUS disk_initialize(BYTE) { return 0; }
+
+    DRESULT disk_read(BYTE, BYTE* buff, LBA_t sector, UINT count) {
+        memcpy(buff, &disk::image[sector * journal::BLOCK_SIZE], count * journal::BLOCK_SIZE);
+        return RES_OK;
+    }
+
+    // Sectors land in order; everything past the cut is silently lost
+    DRESULT disk_write(BYTE, const BYTE* buff, LBA_t sector, UINT count) {
+        for (UINT i = 0; i < count && !disk::isCut(); i++) {
+            memcpy(&disk::image[(sector + i) * journal::BLOCK_SIZE], buff + i * journal::BLOCK_SIZE,
+                   journal::BLOCK_SIZE);
+            disk::sectors_written++;
+        }
+        return RES_OK;
+    }
+
+    DRESULT disk_ioctl(BYTE, BYTE cmd, void* buff) {
+        switch (cmd) {
+            case GET_SECTOR_COUNT: *static_cast<LBA_t*>(buff) = disk::SECTORS; return RES_OK;
+            case GET_SECTOR_SIZE:  *static_cast<WORD*>(buff) = journal::BLOCK_SIZE; return RES_OK;
+            case GET_BLOCK_SIZE:   *static_cast<DWORD*>(buff) = 1; return RES_OK;
+            default:               return RES_OK;
+        }
+    }
+
+    DWORD get_fattime(void) { return 0; }
+}
+
+// ============================================
+// Journaled Writer (same block handling as SDFile)
+// ============================================
+class JournalWriter {
+    static constexpr size_t FLUSH_BLOCKS = 16;
+
+    FIL fil;
+    uint32_t file_id;
+    std::vector<uint8_t> buffer = std::vector<uint8_t>(FLUSH_BLOCKS * journal::BLOCK_SIZE);
+    size_t pos = 0;                 // Raw bytes in buffer
+    uint32_t first_seq = 0;         // Block index of buffer[0]
+
+    bool writeOut() {
+        for (size_t b = 0; b * journal::BLOCK_SIZE < pos; b++) {
+            size_t len = std::min(pos - b * journal::BLOCK_SIZE, journal::BLOCK_SIZE);
+            journal::seal(&buffer[b * journal::BLOCK_SIZE], file_id, first_seq + b,
+                          static_cast<uint16_t>(len - journal::HEADER_SIZE));
+        }
+        UINT written;
+        return f_write(&fil, buffer.data(), pos, &written) == FR_OK && written == pos;
+    }
+
+public:
+    bool open(const char* path, uint32_t id, FSIZE_t preallocate) {
+        file_id = id;
+        pos = 0;
+        first_seq = 0;
+        if (f_open(&fil, path, FA_WRITE | FA_CREATE_ALWAYS) != FR_OK) return false;
+        return f_expand(&fil, preallocate, 1) == FR_OK;
+    }
+
+    bool append(const uint8_t* data, size_t len) {
+        while (len > 0) {
+            if (pos % journal::BLOCK_SIZE == 0) pos += journal::HEADER_SIZE;
+
+            size_t space = journal::BLOCK_SIZE - pos % journal::BLOCK_SIZE;
+            size_t n = std::min(len, space);
+            memcpy(&buffer[pos], data, n);
+            pos += n;
+            data += n;
+            len -= n;
+
+            if (pos == buffer.size()) {
+                if (!writeOut()) return false;
+                first_seq += FLUSH_BLOCKS;
+                pos = 0;
+            }
+        }
+        return true;
+    }
+
+    // Write everything, then rewind over the partial last block
+    bool sync() {
+        if (!writeOut() || f_sync(&fil) != FR_OK) return false;
+
+        size_t full = pos / journal::BLOCK_SIZE;
+        size_t keep = pos % journal::BLOCK_SIZE;
+        memmove(buffer.data(), &buffer[full * journal::BLOCK_SIZE], keep);
+        first_seq += full;
+        pos = keep;
+        return f_lseek(&fil, static_cast<FSIZE_t>(first_seq) * journal::BLOCK_SIZE) == FR_OK;
+    }
+
+    bool close() {
+        bool ok = writeOut() && f_truncate(&fil) == FR_OK;
+        return (f_close(&fil) == FR_OK) && ok;
+    }
+};
+
+// ============================================
+// Trial
+// ============================================
+static constexpr const char* PATH = "0/flight.bin";
+static constexpr FSIZE_t PREALLOCATE = 1u << 20;
+static constexpr size_t RECORDS = 8000;
+static constexpr size_t SYNC_EVERY = 700;
+
+struct Session {
+    std::vector<uint8_t> stream;    // Logical bytes logged
+    size_t synced = 0;              // Stream bytes covered by a sync that completed before the cut
+};
+
+static bool format(BYTE fmt, DWORD au) {
+    static BYTE work[FF_MAX_SS * 8];
+    MKFS_PARM opt = {fmt, 0, 0, 0, au};
+    disk::cut_after = UINT64_MAX;
+    return f_mkfs("", &opt, work, sizeof(work)) == FR_OK;
+}
+
+// Logs one session; returns false only on unexpected FatFs errors
+static bool logSession(std::mt19937& rng, uint32_t file_id, Session& s) {
+    using namespace logging::records;
+
+    JournalWriter writer;
+    f_mkdir("0");
+    if (!writer.open(PATH, file_id, PREALLOCATE)) return false;
+
+    auto header = make_header<logging::FLIGHT>();
+    s.stream.assign(reinterpret_cast<uint8_t*>(&header), reinterpret_cast<uint8_t*>(&header) + sizeof(header));
+    if (!writer.append(s.stream.data(), s.stream.size()) || !writer.sync()) return false;
+    if (!disk::isCut()) s.synced = s.stream.size();
+
+    for (size_t i = 1; i <= RECORDS; i++) {
+        uint8_t record[sizeof(FlightRecord)];
+        for (auto& b : record) b = static_cast<uint8_t>(rng());
+        s.stream.insert(s.stream.end(), record, record + sizeof(record));
+        if (!writer.append(record, sizeof(record))) return false;
+
+        if (i % SYNC_EVERY == 0) {
+            if (!writer.sync()) return false;
+            if (!disk::isCut()) s.synced = s.stream.size();
+        }
+    }
+
+    if (!writer.close()) return false;
+    if (!disk::isCut()) s.synced = s.stream.size();
+    return true;
+}
+
+static bool runTrial(std::mt19937& rng, int trial, uint64_t& cuts_in_session) {
+    FATFS fs;
+    bool exfat = trial % 2;
+    if (!format(exfat ? FM_EXFAT : FM_FAT32, exfat ? 32768 : 0)) {
+        printf("trial %d: mkfs failed\n", trial);
+        return false;
+    }
+
+    // File ids are random per file, as in SDFile (mkfs leaves older trials' blocks behind)
+    uint32_t old_id = rng() | 1;
+    uint32_t file_id = rng() | 1;
+
+    // Stale journal blocks of a deleted older file in the area about to be reused
+    f_mount(&fs, "", 1);
+    Session old;
+    if (!logSession(rng, old_id, old) || f_unlink(PATH) != FR_OK) {
+        printf("trial %d: setup failed\n", trial);
+        return false;
+    }
+    f_unmount("");
+
+    // Dry run to learn how many sectors a full session writes
+    std::vector<uint8_t> clean = disk::image;
+    uint64_t base = disk::sectors_written;
+    {
+        std::mt19937 dry = rng;
+        Session s;
+        f_mount(&fs, "", 1);
+        logSession(dry, file_id, s);
+        f_unmount("");
+    }
+    uint64_t total = disk::sectors_written - base;
+    disk::image = clean;
+
+    // Real run with a power cut somewhere inside it
+    uint64_t cut = std::uniform_int_distribution<uint64_t>(0, total)(rng);
+    disk::cut_after = disk::sectors_written + cut;
+    cuts_in_session += (cut < total);
+
+    Session s;
+    f_mount(&fs, "", 1);
+    // Past the cut FatFs reads back stale FAT sectors and may error out; only
+    // failures before it count
+    if (!logSession(rng, file_id, s) && !disk::isCut()) {
+        printf("trial %d: session write failed\n", trial);
+        return false;
+    }
+    f_unmount("");
+
+    // Reboot: remount the image as left by the cut and recover
+    disk::cut_after = UINT64_MAX;
+    f_mount(&fs, "", 1);
+
+    journal::Recovery r;
+    FRESULT fr = journal::recover(PATH, r);
+    if (fr != FR_OK && fr != FR_NO_FILE) {
+        printf("trial %d: recover failed (%d)\n", trial, fr);
+        return false;
+    }
+
+    // Recovered file must now read back cleanly end to end
+    std::vector<uint8_t> raw;
+    FIL fil;
+    if (f_open(&fil, PATH, FA_READ) == FR_OK) {
+        raw.resize(f_size(&fil));
+        UINT read = 0;
+        if (f_read(&fil, raw.data(), raw.size(), &read) != FR_OK || read != raw.size()) {
+            printf("trial %d: recovered file unreadable\n", trial);
+            f_close(&fil);
+            return false;
+        }
+        f_close(&fil);
+    }
+    f_unmount("");
+
+    std::vector<uint8_t> payload(raw.size());
+    size_t payload_size = 0;
+    size_t blocks = journal::unwrap(raw.data(), raw.size(), payload.data(), &payload_size);
+    size_t expected_blocks = (raw.size() + journal::BLOCK_SIZE - 1) / journal::BLOCK_SIZE;
+
+    bool ok = true;
+    if (blocks != expected_blocks) {
+        printf("trial %d: stale tail, %zu of %zu blocks valid\n", trial, blocks, expected_blocks);
+        ok = false;
+    }
+    if (payload_size > s.stream.size() || memcmp(payload.data(), s.stream.data(), payload_size) != 0) {
+        printf("trial %d: recovered data is not a prefix of the session\n", trial);
+        ok = false;
+    }
+    if (payload_size < s.synced) {
+        printf("trial %d: lost synced data (%zu < %zu)\n", trial, payload_size, s.synced);
+        ok = false;
+    }
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    int trials = (argc > 1) ? atoi(argv[1]) : 100;
+    uint32_t seed = (argc > 2) ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 0)) : 12345;
+
+    std::mt19937 rng(seed);
+    int failures = 0;
+    uint64_t cuts_in_session = 0;
+
+    for (int t = 0; t < trials; t++) {
+        if (!runTrial(rng, t, cuts_in_session)) failures++;
+    }
+
+    printf("%d trials (seed %u), %llu cut mid-session, %d failures\n",
+           trials, seed, static_cast<unsigned long long>(cuts_in_session), failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,122 @@
+// Converts a binary session file (flight.bin, gps.bin, pitot.bin) back into
+// the legacy CSV columns. Journaled files (drivers/sdcard/journal.h) are
+// unwrapped first; decoding stops at the first invalid block.
+//
+//   log_decoder <file.bin> [out.csv]
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "log_records.h"
+#include "drivers/sdcard/journal.h"
+
+using namespace logging;
+using namespace logging::records;
+
+template<typename S>
+static int decode(const uint8_t* data, size_t size, FILE* out, const char* path) {
+    using Record = typename S::Record;
+
+    fputs(S::csv_header, out);
+
+    Record rec;
+    char line[512];
+    size_t count = 0;
+    size_t pos = 0;
+    while (size - pos >= sizeof(rec)) {
+        memcpy(&rec, data + pos, sizeof(rec));
+        pos += sizeof(rec);
+
+        int len = S::to_csv(rec, line, sizeof(line));
+        if (len > 0) fwrite(line, 1, len, out);
+        count++;
+    }
+
+    if (pos != size) {
+        fprintf(stderr, "%s: ignoring %zu trailing bytes (partial record)\n", path, size - pos);
+    }
+    fprintf(stderr, "%s: decoded %zu records\n", path, count);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "usage: %s <file.bin> [out.csv]\n", argv[0]);
+        return 2;
+    }
+
+    FILE* in = fopen(argv[1], "rb");
+    if (!in) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    std::vector<uint8_t> data;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), in)) > 0) {
+        data.insert(data.end(), chunk, chunk + n);
+    }
+    fclose(in);
+
+    // Journaled session file: strip the block headers
+    if (data.size() >= drivers::journal::HEADER_SIZE && drivers::journal::check(data.data(), 0, 0)) {
+        std::vector<uint8_t> payload(data.size());
+        size_t payload_size = 0;
+        size_t blocks = drivers::journal::unwrap(data.data(), data.size(), payload.data(), &payload_size);
+        size_t expected = (data.size() + drivers::journal::BLOCK_SIZE - 1) / drivers::journal::BLOCK_SIZE;
+        if (blocks != expected) {
+            fprintf(stderr, "%s: journal ends at block %zu of %zu (unrecovered power cut?)\n",
+                    argv[1], blocks, expected);
+        }
+        payload.resize(payload_size);
+        data.swap(payload);
+    }
+
+    FileHeader header = {};
+    if (data.size() >= sizeof(header)) {
+        memcpy(&header, data.data(), sizeof(header));
+    }
+    if (header.magic != MAGIC) {
+        fprintf(stderr, "%s: not an ADS binary log\n", argv[1]);
+        return 1;
+    }
+
+    if (header.version != FORMAT_VERSION) {
+        fprintf(stderr, "%s: unsupported format version %u (decoder is %u)\n",
+                argv[1], header.version, FORMAT_VERSION);
+        return 1;
+    }
+
+    // Skip any header fields newer than this decoder
+    size_t start = std::max<size_t>(header.header_size, sizeof(header));
+    if (start > data.size()) start = data.size();
+
+    FILE* out = stdout;
+    if (argc == 3) {
+        out = fopen(argv[2], "w");
+        if (!out) {
+            perror(argv[2]);
+            return 1;
+        }
+    }
+
+    int result = 1;
+    bool known = visit(header.file_type, [&](auto schema) {
+        using S = decltype(schema);
+        if (header.record_size != sizeof(typename S::Record)) {
+            fprintf(stderr, "%s: record size %u does not match schema (%zu)\n",
+                    argv[1], header.record_size, sizeof(typename S::Record));
+            return;
+        }
+        result = decode<S>(data.data() + start, data.size() - start, out, argv[1]);
+    });
+
+    if (!known) {
+        fprintf(stderr, "%s: unknown file type %u\n", argv[1], header.file_type);
+    }
+
+    if (out != stdout) fclose(out);
+    return result;
+}
@@ -0,0 +1,143 @@
+// Compares the legacy printf CSV path of SDFile::write() against the binary
+// SDFile::writeRecord() path: bytes/sample and us/sample per file type.
+// Both paths feed the same 512-byte sector buffer model as SDFile.
+//
+//   log_format_bench [samples]
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "log_records.h"
+
+using namespace logging;
+using namespace logging::records;
+
+namespace {
+
+// Mirror of the SDFile buffering (flush just counts bytes)
+struct SectorBuffer {
+    static constexpr size_t BUFFER_SIZE = 512;
+    uint8_t buffer[BUFFER_SIZE];
+    size_t buffer_pos = 0;
+    size_t total = 0;
+
+    void writeBytes(const void* data, size_t len) {
+        const uint8_t* src = static_cast<const uint8_t*>(data);
+        while (len > 0) {
+            size_t to_copy = std::min(len, BUFFER_SIZE - buffer_pos);
+            memcpy(buffer + buffer_pos, src, to_copy);
+            buffer_pos += to_copy;
+            src += to_copy;
+            len -= to_copy;
+            if (buffer_pos >= BUFFER_SIZE) buffer_pos = 0;
+        }
+    }
+
+    // Same code path as SDFile::write(format, ...)
+    __attribute__((format(printf, 2, 3)))
+    void write(const char* format, ...) {
+        char temp[256];
+        va_list args;
+        va_start(args, format);
+        int len = vsnprintf(temp, sizeof(temp), format, args);
+        va_end(args);
+        if (len < 0) return;
+        if (len >= (int)sizeof(temp)) len = sizeof(temp) - 1;
+        writeBytes(temp, len);
+        total += len;
+    }
+
+    template<typename T>
+    void writeRecord(const T& record) {
+        writeBytes(&record, sizeof(T));
+        total += sizeof(T);
+    }
+};
+
+struct Result {
+    double bytes_per_sample;
+    double us_per_sample;
+};
+
+template<typename Fn>
+Result run(size_t samples, Fn&& fn) {
+    SectorBuffer buf;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < samples; i++) {
+        fn(buf, i);
+    }
+    auto end = std::chrono::steady_clock::now();
+    double us = std::chrono::duration<double, std::micro>(end - start).count();
+    return {double(buf.total) / samples, us / samples};
+}
+
+void report(const char* name, Result text, Result binary) {
+    printf("%-8s %10.1f %10.1f %12.3f %12.3f %8.1fx\n", name,
+           text.bytes_per_sample, binary.bytes_per_sample,
+           text.us_per_sample, binary.us_per_sample,
+           text.us_per_sample / binary.us_per_sample);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t samples = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 200000;
+    if (samples == 0) samples = 1;
+
+    // Pre-generate inputs so both paths format identical values
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> accel(-40.0f, 40.0f);
+    std::uniform_real_distribution<float> gyro(-9.0f, 9.0f);
+    std::vector<FlightRecord> flight(1024);
+    std::vector<GpsRecord> gps(1024);
+    std::vector<PitotRecord> pitot(1024);
+    for (size_t i = 0; i < 1024; i++) {
+        uint64_t t = i * 10'000 + 5'123'456;
+        int64_t utc = 1760000000'000000ll + static_cast<int64_t>(t) + 317;
+        flight[i] = {t, utc, 412, 1875, 236, accel(rng), accel(rng), accel(rng), gyro(rng), gyro(rng), gyro(rng),
+                     1234.5f + accel(rng), 98765.4f + accel(rng), 21.3f + gyro(rng)};
+        gps[i] = {t, utc, 41203, 334201234 + (int32_t)i, -1119345678 - (int32_t)i,
+                  356789, 1234, -567, 89, 12345678, 2500, 3500, 120, 450000, 1};
+        float ias = 45.6f + gyro(rng);
+        pitot[i] = {t, utc, 151, ias, ias * 2.237f, 0.163f, ias + 0.2f, ias * 1.072f};
+    }
+
+    printf("%zu samples per type\n\n", samples);
+    printf("per sample:\n");
+    printf("%-8s %10s %10s %12s %12s %9s\n", "type", "csv bytes", "bin bytes", "csv us", "bin us", "speedup");
+
+    report("flight",
+        run(samples, [&](SectorBuffer& b, size_t i) {
+            const auto& r = flight[i & 1023];
+            b.write("%" PRIu64 ",%" PRId64 ",%u,%" PRId32 ",%u,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n",
+                r.time_us, r.utc_us, r.latency_us, r.baro_dt_us, r.baro_latency_us, r.accel_x, r.accel_y, r.accel_z, r.gyro_x, r.gyro_y, r.gyro_z,
+                r.altitude, r.pressure, r.temperature);
+        }),
+        run(samples, [&](SectorBuffer& b, size_t i) { b.writeRecord(flight[i & 1023]); }));
+
+    report("gps",
+        run(samples, [&](SectorBuffer& b, size_t i) {
+            const auto& r = gps[i & 1023];
+            b.write("%" PRIu64 ",%" PRId64 ",%u,%.6f,%.6f,%" PRId32 ",%" PRId32 ",%" PRId32 ",%" PRId32 ",%" PRId32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%s\n",
+                r.time_us, r.utc_us, r.latency_us, r.lat_e7 / 1e7, r.lon_e7 / 1e7, r.hMSL,
+                r.velN, r.velE, r.velD, r.heading, r.hAcc, r.vAcc,
+                r.sAcc, r.headingAcc, r.valid ? "OK" : "NO");
+        }),
+        run(samples, [&](SectorBuffer& b, size_t i) { b.writeRecord(gps[i & 1023]); }));
+
+    report("pitot",
+        run(samples, [&](SectorBuffer& b, size_t i) {
+            const auto& r = pitot[i & 1023];
+            b.write("%" PRIu64 ",%" PRId64 ",%u,%.2f,%.2f,%.2f,%.2f,%.2f\n",
+                r.time_us, r.utc_us, r.latency_us, r.airspeed_ms, r.airspeed_mph, r.pressure_psi,
+                r.cas_ms, r.tas_ms);
+        }),
+        run(samples, [&](SectorBuffer& b, size_t i) { b.writeRecord(pitot[i & 1023]); }));
+
+    return 0;
+}
@@ -0,0 +1,298 @@
+// NMEA decoding cost, before and after the single-pass tokenizer
+// (nmea::Sentence) and the fixed-point field parsers: sentences/s on
+// recorded NMEA logs, or on a synthetic 10 Hz GGA/GSA/GSV/RMC/VTG session
+// when none is given.
+//
+//   nmea_parser_bench [--epochs N] [log.nmea ...]
+//
+// "before" is the previous GpsDriver path: checksum by strchr, every field
+// re-scanned from the start of the sentence, numbers through atof/double.
+// Both paths decode the same GpsData fields, which have to agree (the
+// double path within one unit of its last digit); the exit code is
+// non-zero otherwise.
+
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "drivers/gps/nmea_parser.h"
+
+namespace nmea = drivers::nmea;
+
+namespace {
+
+// Decoded fields, as GpsDriver keeps them
+struct Fix {
+    bool valid = false;
+    int32_t lat_e7 = 0;
+    int32_t lon_e7 = 0;
+    int32_t hMSL = 0;
+    int32_t gSpeed = 0;
+    int32_t heading = 0;
+    uint8_t hour = 0, min = 0, sec = 0;
+    uint8_t day = 0, month = 0;
+    uint16_t year = 0;
+};
+
+// ============================================
+// Before: per-field strchr scans and atof
+// ============================================
+namespace before {
+
+bool verify_checksum(const char* sentence) {
+    if (!sentence || sentence[0] != '$') return false;
+    const char* asterisk = std::strchr(sentence, '*');
+    if (!asterisk || std::strlen(asterisk) < 3) return false;
+
+    uint8_t calculated = 0;
+    for (const char* p = sentence + 1; p < asterisk; ++p) calculated ^= static_cast<uint8_t>(*p);
+
+    auto hex_to_val = [](char c) -> uint8_t {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return 0;
+    };
+    return calculated == ((hex_to_val(asterisk[1]) << 4) | hex_to_val(asterisk[2]));
+}
+
+bool extract_field(const char* sentence, uint8_t field_num, char* buffer, size_t buffer_size) {
+    const char* start = sentence;
+    for (uint8_t current = 0; current < field_num; current++) {
+        start = std::strchr(start, ',');
+        if (!start) return false;
+        start++;
+    }
+    const char* end = std::strchr(start, ',');
+    if (!end) {
+        end = std::strchr(start, '*');
+        if (!end) return false;
+    }
+    size_t len = std::min<size_t>(end - start, buffer_size - 1);
+    std::memcpy(buffer, start, len);
+    buffer[len] = '\0';
+    return true;
+}
+
+double parse_coordinate(const char* coord, char dir) {
+    if (std::strlen(coord) < 3) return 0.0;
+    double value = std::atof(coord);
+    int32_t degrees = static_cast<int32_t>(value / 100.0);
+    double decimal = degrees + (value - degrees * 100.0) / 60.0;
+    return (dir == 'S' || dir == 'W') ? -decimal : decimal;
+}
+
+bool parse(const char* sentence, Fix& fix) {
+    if (!verify_checksum(sentence)) return false;
+    char field[32], dir[2];
+
+    if (std::strncmp(sentence + 3, "GGA", 3) == 0) {
+        if (extract_field(sentence, 2, field, sizeof(field)) && field[0] && extract_field(sentence, 3, dir, sizeof(dir))) {
+            fix.lat_e7 = static_cast<int32_t>(std::lround(parse_coordinate(field, dir[0]) * 1e7));
+        }
+        if (extract_field(sentence, 4, field, sizeof(field)) && field[0] && extract_field(sentence, 5, dir, sizeof(dir))) {
+            fix.lon_e7 = static_cast<int32_t>(std::lround(parse_coordinate(field, dir[0]) * 1e7));
+        }
+        if (extract_field(sentence, 6, field, sizeof(field))) fix.valid = std::atoi(field) >= 1;
+        if (extract_field(sentence, 9, field, sizeof(field)) && field[0]) {
+            fix.hMSL = static_cast<int32_t>(std::atof(field) * 1000);
+        }
+    } else if (std::strncmp(sentence + 3, "RMC", 3) == 0) {
+        if (extract_field(sentence, 1, field, sizeof(field)) && field[0]) {
+            fix.hour = static_cast<uint8_t>((field[0] - '0') * 10 + (field[1] - '0'));
+            fix.min = static_cast<uint8_t>((field[2] - '0') * 10 + (field[3] - '0'));
+            fix.sec = static_cast<uint8_t>((field[4] - '0') * 10 + (field[5] - '0'));
+        }
+        if (extract_field(sentence, 9, field, sizeof(field)) && field[0]) {
+            fix.day = static_cast<uint8_t>((field[0] - '0') * 10 + (field[1] - '0'));
+            fix.month = static_cast<uint8_t>((field[2] - '0') * 10 + (field[3] - '0'));
+            fix.year = static_cast<uint16_t>(2000 + (field[4] - '0') * 10 + (field[5] - '0'));
+        }
+        if (extract_field(sentence, 7, field, sizeof(field)) && field[0]) {
+            fix.gSpeed = static_cast<int32_t>(std::atof(field) * 514.444);
+        }
+        if (extract_field(sentence, 8, field, sizeof(field)) && field[0]) {
+            fix.heading = static_cast<int32_t>(std::atof(field) * 1e5);
+        }
+    } else if (std::strncmp(sentence + 3, "VTG", 3) == 0) {
+        if (extract_field(sentence, 1, field, sizeof(field)) && field[0]) {
+            fix.heading = static_cast<int32_t>(std::atof(field) * 1e5);
+        }
+        if (extract_field(sentence, 7, field, sizeof(field)) && field[0]) {
+            fix.gSpeed = static_cast<int32_t>(std::atof(field) * 277.778);
+        }
+    }
+    return true;
+}
+
+} // namespace before
+
+// ============================================
+// After: the driver's path
+// ============================================
+namespace after {
+
+bool parse(const char* line, size_t len, Fix& fix) {
+    nmea::Sentence s;
+    if (!s.tokenize(line, len)) return false;
+
+    std::string_view type = s.type();
+    if (type == "GGA") {
+        nmea::parse_coordinate(s.field(2), s.field(3), fix.lat_e7);
+        nmea::parse_coordinate(s.field(4), s.field(5), fix.lon_e7);
+        std::string_view quality = s.field(6);
+        fix.valid = quality.size() == 1 && quality[0] >= '1' && quality[0] <= '9';
+        nmea::parse_fixed<3>(s.field(9), fix.hMSL);
+    } else if (type == "RMC") {
+        nmea::parse_time(s.field(1), fix.hour, fix.min, fix.sec);
+        nmea::parse_date(s.field(9), fix.year, fix.month, fix.day);
+        nmea::parse_knots_mm_s(s.field(7), fix.gSpeed);
+        nmea::parse_fixed<5>(s.field(8), fix.heading);
+    } else if (type == "VTG") {
+        nmea::parse_fixed<5>(s.field(1), fix.heading);
+        nmea::parse_kmh_mm_s(s.field(7), fix.gSpeed);
+    }
+    return true;
+}
+
+} // namespace after
+
+// ============================================
+// Logs
+// ============================================
+
+std::string sentence(const char* body) {
+    uint8_t cs = 0;
+    for (const char* c = body; *c; c++) cs ^= static_cast<uint8_t>(*c);
+    char line[128];
+    snprintf(line, sizeof(line), "$%s*%02X\r\n", body, cs);
+    return line;
+}
+
+// The factory output set at 10 Hz along a random walk
+std::vector<std::string> synthetic_log(uint32_t epochs) {
+    std::mt19937 rng(1);
+    std::vector<std::string> lines;
+    char body[112];
+    for (uint32_t e = 0; e < epochs; e++) {
+        unsigned s = e / 10;
+        unsigned hh = 12 + s / 3600 % 12, mm = s / 60 % 60, ss = s % 60, cs = e % 10 * 10;
+        double lat_min = 7.0 + (rng() % 1000000) / 1e6;
+        double lon_min = 31.0 + (rng() % 1000000) / 1e6;
+        double knots = (rng() % 100000) / 1000.0;
+        double course = (rng() % 36000) / 100.0;
+        double alt = 500.0 + (rng() % 100000) / 100.0;
+
+        snprintf(body, sizeof(body), "GPGGA,%02u%02u%02u.%02u,48%010.7f,N,011%010.7f,E,1,12,0.8,%.1f,M,48.0,M,,",
+                 hh, mm, ss, cs, lat_min, lon_min, alt);
+        lines.push_back(sentence(body));
+        lines.push_back(sentence("GPGSA,A,3,02,05,07,09,13,15,18,20,24,28,29,30,1.4,0.8,1.1"));
+        lines.push_back(sentence("GPGSV,3,1,12,02,45,120,42,05,60,045,44,07,30,300,38,09,15,250,35"));
+        lines.push_back(sentence("GPGSV,3,2,12,13,70,180,45,15,25,090,37,18,40,210,40,20,10,330,31"));
+        lines.push_back(sentence("GPGSV,3,3,12,24,55,010,43,28,20,160,36,29,35,270,39,30,50,060,41"));
+        snprintf(body, sizeof(body), "GPRMC,%02u%02u%02u.%02u,A,48%010.7f,N,011%010.7f,E,%.3f,%.2f,010625,,,A",
+                 hh, mm, ss, cs, lat_min, lon_min, knots, course);
+        lines.push_back(sentence(body));
+        snprintf(body, sizeof(body), "GPVTG,%.2f,T,,M,%.3f,N,%.3f,K,A", course, knots, knots * 1.852);
+        lines.push_back(sentence(body));
+    }
+    return lines;
+}
+
+bool read_log(const char* path, std::vector<std::string>& lines) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '$') lines.emplace_back(line);
+    }
+    fclose(f);
+    return true;
+}
+
+// ============================================
+// Bench
+// ============================================
+
+template<typename Fn>
+double sentences_per_s(size_t count, Fn&& fn) {
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    size_t total = 0;
+    double elapsed_s = 0;
+    do {
+        fn();
+        total += count;
+        elapsed_s = std::chrono::duration<double>(clock::now() - start).count();
+    } while (elapsed_s < 0.2);
+    return total / elapsed_s;
+}
+
+bool near(int32_t a, int32_t b) { return std::abs(static_cast<int64_t>(a) - b) <= 1; }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t epochs = 2000;
+    std::vector<const char*> paths;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--epochs" && i + 1 < argc) epochs = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (a[0] != '-') paths.push_back(argv[i]);
+        else {
+            fprintf(stderr, "usage: %s [--epochs N] [log.nmea ...]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<std::string> lines;
+    for (const char* path : paths) {
+        if (!read_log(path, lines)) {
+            fprintf(stderr, "cannot read %s\n", path);
+            return 2;
+        }
+    }
+    if (paths.empty()) lines = synthetic_log(epochs);
+    if (lines.empty()) return 2;
+
+    // Same decoded fields, sentence by sentence
+    Fix old_fix, new_fix;
+    uint32_t mismatches = 0, rejected = 0;
+    for (const auto& line : lines) {
+        bool old_ok = before::parse(line.c_str(), old_fix);
+        bool new_ok = after::parse(line.c_str(), line.size(), new_fix);
+        if (!new_ok) rejected++;
+        bool same = old_ok == new_ok && old_fix.valid == new_fix.valid &&
+                    near(old_fix.lat_e7, new_fix.lat_e7) && near(old_fix.lon_e7, new_fix.lon_e7) &&
+                    near(old_fix.hMSL, new_fix.hMSL) && near(old_fix.gSpeed, new_fix.gSpeed) &&
+                    near(old_fix.heading, new_fix.heading) && old_fix.hour == new_fix.hour &&
+                    old_fix.min == new_fix.min && old_fix.sec == new_fix.sec && old_fix.day == new_fix.day &&
+                    old_fix.month == new_fix.month && old_fix.year == new_fix.year;
+        if (!same && mismatches++ < 5) printf("  MISMATCH: %s", line.c_str());
+    }
+
+    volatile int32_t sink = 0;
+    double old_rate = sentences_per_s(lines.size(), [&] {
+        Fix fix;
+        for (const auto& line : lines) before::parse(line.c_str(), fix);
+        sink = sink + fix.lat_e7;
+    });
+    double new_rate = sentences_per_s(lines.size(), [&] {
+        Fix fix;
+        for (const auto& line : lines) after::parse(line.c_str(), line.size(), fix);
+        sink = sink + fix.lat_e7;
+    });
+
+    printf("%zu sentences (%s), %" PRIu32 " rejected\n", lines.size(), paths.empty() ? "synthetic" : "logs", rejected);
+    printf("  %-36s %10.0f sentences/s\n", "before: strchr per field + atof", old_rate);
+    printf("  %-36s %10.0f sentences/s (x%.1f)\n", "after: one-pass tokenizer + fixed", new_rate, new_rate / old_rate);
+    printf("  decoded fields: %" PRIu32 " mismatches\n", mismatches);
+    printf("%s\n", mismatches ? "FAILED" : "OK");
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,139 @@
+// Two-thread stress test for the inter-core queue (spsc_ring.h).
+//
+// A producer and a consumer thread stand in for the two cores. Each item
+// carries a sequence number and a payload derived from it, so the consumer
+// can see reordering, duplicates, gaps and torn slots. Two runs:
+//   lossless  the producer retries a full ring: every item must arrive, in
+//             order, and overflows() must equal the producer's failed claims
+//   lossy     the producer drops on a full ring (as LogPipeline does): what
+//             arrives must be in order, and received + overflows() must be
+//             everything pushed
+//
+//   spsc_ring_test [items] [seed]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+
+#include "spsc_ring.h"
+
+// Same size as a LogEntry slot, so a torn copy shows up in the payload
+struct Item {
+    uint32_t seq;
+    uint8_t payload[60];
+};
+static_assert(sizeof(Item) == 64);
+
+static constexpr size_t CAPACITY = 256;
+using Ring = utils::SpscRing<Item, CAPACITY>;
+
+static void fill(Item& item, uint32_t seq) {
+    item.seq = seq;
+    for (size_t i = 0; i < sizeof(item.payload); i++) item.payload[i] = static_cast<uint8_t>(seq * 31 + i);
+}
+
+static bool intact(const Item& item) {
+    for (size_t i = 0; i < sizeof(item.payload); i++) {
+        if (item.payload[i] != static_cast<uint8_t>(item.seq * 31 + i)) return false;
+    }
+    return true;
+}
+
+struct Result {
+    uint64_t received = 0;
+    uint64_t out_of_order = 0;      // Sequence not above the previous one
+    uint64_t gaps = 0;              // Lossless run: a sequence number skipped
+    uint64_t torn = 0;
+    uint64_t failed_claims = 0;     // Producer side
+};
+
+// Producer and consumer both pause now and then, so the ring runs full and
+// empty many times over
+static Result run(uint32_t items, bool lossless, uint32_t seed, Ring& ring) {
+    Result r;
+    std::atomic<bool> producer_done{false};
+
+    std::thread producer([&] {
+        std::mt19937 rng(seed);
+        for (uint32_t seq = 0; seq < items; seq++) {
+            for (;;) {
+                Item* slot = ring.claim();
+                if (slot) {
+                    fill(*slot, seq);
+                    ring.publish();
+                    break;
+                }
+                r.failed_claims++;
+                std::this_thread::yield();
+                if (!lossless) break;
+            }
+            if ((rng() & 0x3FFF) == 0) std::this_thread::yield();
+        }
+        producer_done.store(true, std::memory_order_release);
+    });
+
+    std::thread consumer([&] {
+        std::mt19937 rng(seed ^ 0x9E3779B9u);
+        int64_t last = -1;
+        for (;;) {
+            const Item* item = ring.front();
+            if (!item) {
+                // Nothing is published after done, so empty then is final
+                if (producer_done.load(std::memory_order_acquire) && ring.empty()) break;
+                std::this_thread::yield();
+                continue;
+            }
+
+            Item copy = *item;
+            ring.pop();
+            r.received++;
+            if (!intact(copy)) r.torn++;
+            if (static_cast<int64_t>(copy.seq) <= last) {
+                r.out_of_order++;
+            } else if (lossless && static_cast<int64_t>(copy.seq) != last + 1) {
+                r.gaps++;
+            }
+            last = std::max(last, static_cast<int64_t>(copy.seq));
+
+            if ((rng() & 0xFFF) == 0) std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    });
+
+    producer.join();
+    consumer.join();
+    return r;
+}
+
+int main(int argc, char** argv) {
+    uint32_t items = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 0)) : 2'000'000;
+    uint32_t seed = (argc > 2) ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 0)) : 12345;
+    int failures = 0;
+
+    for (bool lossless : {true, false}) {
+        static Ring ring_lossless, ring_lossy;
+        Ring& ring = lossless ? ring_lossless : ring_lossy;
+        Result r = run(items, lossless, seed, ring);
+
+        bool ok = r.out_of_order == 0 && r.torn == 0 && ring.empty() && ring.high_water() <= CAPACITY &&
+                  ring.overflows() == r.failed_claims;
+        if (lossless) {
+            ok = ok && r.received == items && r.gaps == 0;
+        } else {
+            ok = ok && r.received + ring.overflows() == items;
+        }
+
+        printf("%-8s %u pushed, %llu received, %u overflows (%llu failed claims), high water %u/%zu, "
+               "%llu out of order, %llu gaps, %llu torn: %s\n",
+               lossless ? "lossless" : "lossy", items, static_cast<unsigned long long>(r.received),
+               ring.overflows(), static_cast<unsigned long long>(r.failed_claims), ring.high_water(), CAPACITY,
+               static_cast<unsigned long long>(r.out_of_order), static_cast<unsigned long long>(r.gaps),
+               static_cast<unsigned long long>(r.torn), ok ? "OK" : "FAILED");
+        failures += !ok;
+    }
+    return failures ? 1 : 0;
+}
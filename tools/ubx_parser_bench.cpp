@@ -0,0 +1,477 @@
+// Throughput and robustness of the streaming UBX parser (ubx::Parser) on
+// receiver captures: raw UART recordings such as u-center .ubx logs, or a
+// synthetic 10 Hz NMEA + NAV-PVT/DOP/TIMEUTC/SAT session when none is
+// given.
+//
+//   ubx_parser_bench [--fuzz N] [--seed S] [--epochs N] [capture.ubx ...]
+//
+// Bench: bytes/us parsing the whole capture from one linear buffer, through
+// a UartRx-sized ring filled in random chunks (wraps included), and with
+// the previous copy-every-byte parser for comparison.
+//
+// Fuzz: N mutated copies of each capture (bit flips, lost and inserted
+// runs, fake sync headers, huge lengths, truncation). Every delivered frame
+// must carry a valid checksum and match the bytes at its offset, every
+// frame the mutations left intact must still be found, every byte must be
+// accounted for exactly once, and the ring must agree with the linear
+// buffer. The exit code is non-zero on any violation.
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "drivers/gps/ubx_parser.h"
+
+using drivers::ubx::Frame;
+using drivers::ubx::Parser;
+
+namespace {
+
+// ============================================
+// Buffers
+// ============================================
+
+// Whole capture in memory
+struct LinearBuffer {
+    const uint8_t* data;
+    uint32_t size;
+    uint32_t tail = 0;
+
+    uint32_t read_index() const { return tail; }
+    uint32_t write_index() const { return size; }
+    std::span<const uint8_t> span(uint32_t from, uint32_t to) const { return {data + from, to - from}; }
+    void release(uint32_t to) { tail = to; }
+};
+
+// Mirror of UartRx: free-running indices over a power-of-two ring
+struct RingBuffer {
+    static constexpr size_t RING_SIZE = 4096;
+    static constexpr uint32_t MASK = RING_SIZE - 1;
+    uint8_t ring[RING_SIZE];
+    uint32_t head = 0;
+    uint32_t tail = 0;
+
+    size_t fill(const uint8_t* src, size_t len) {
+        len = std::min(len, RING_SIZE - (head - tail));
+        for (size_t done = 0; done < len;) {
+            uint32_t offset = head & MASK;
+            size_t n = std::min(len - done, RING_SIZE - offset);
+            memcpy(ring + offset, src + done, n);
+            head += static_cast<uint32_t>(n);
+            done += n;
+        }
+        return len;
+    }
+
+    uint32_t read_index() const { return tail; }
+    uint32_t write_index() const { return head; }
+    std::span<const uint8_t> span(uint32_t from, uint32_t to) const {
+        uint32_t offset = from & MASK;
+        return {ring + offset, std::min<size_t>(to - from, RING_SIZE - offset)};
+    }
+    void release(uint32_t to) { tail = to; }
+};
+
+// ============================================
+// Captures
+// ============================================
+
+void ubx_frame(std::vector<uint8_t>& out, uint8_t cls, uint8_t id, const std::vector<uint8_t>& payload) {
+    size_t start = out.size();
+    out.insert(out.end(), {0xB5, 0x62, cls, id, static_cast<uint8_t>(payload.size()),
+                           static_cast<uint8_t>(payload.size() >> 8)});
+    out.insert(out.end(), payload.begin(), payload.end());
+    uint8_t ck_a = 0, ck_b = 0;
+    for (size_t i = start + 2; i < out.size(); i++) {
+        ck_a += out[i];
+        ck_b += ck_a;
+    }
+    out.push_back(ck_a);
+    out.push_back(ck_b);
+}
+
+void nmea_sentence(std::vector<uint8_t>& out, const char* body) {
+    uint8_t cs = 0;
+    for (const char* c = body; *c; c++) cs ^= static_cast<uint8_t>(*c);
+    char line[128];
+    int n = snprintf(line, sizeof(line), "$%s*%02X\r\n", body, cs);
+    out.insert(out.end(), line, line + n);
+}
+
+// 10 Hz session in the mix the driver configures: NMEA sentences from the
+// receiver's boot plus the NAV set, with payloads that vary like real ones
+std::vector<uint8_t> synthetic_capture(uint32_t epochs, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> out;
+    char body[112];
+
+    for (uint32_t e = 0; e < epochs; e++) {
+        double t = e * 0.1;
+        if (e % 10 == 0) {
+            snprintf(body, sizeof(body), "GPGGA,12%04u.00,4807.%05u,N,01131.%05u,E,1,12,0.8,%.1f,M,48.0,M,,",
+                     e / 10 % 10000, static_cast<unsigned>(rng() % 100000), static_cast<unsigned>(rng() % 100000),
+                     500.0 + t);
+            nmea_sentence(out, body);
+            nmea_sentence(out, "GPGSA,A,3,02,05,07,09,13,15,18,20,24,28,29,30,1.4,0.8,1.1");
+            snprintf(body, sizeof(body), "GPRMC,12%04u.00,A,4807.%05u,N,01131.%05u,E,%.3f,%.2f,010625,,,A",
+                     e / 10 % 10000, static_cast<unsigned>(rng() % 100000), static_cast<unsigned>(rng() % 100000),
+                     40.0 + (rng() % 1000) / 100.0, (rng() % 36000) / 100.0);
+            nmea_sentence(out, body);
+        }
+
+        std::vector<uint8_t> pvt(92);
+        for (auto& b : pvt) b = static_cast<uint8_t>(rng());
+        pvt[20] = 3;
+        pvt[21] = 0x01;
+        ubx_frame(out, 0x01, 0x07, pvt);
+
+        std::vector<uint8_t> dop(18);
+        for (auto& b : dop) b = static_cast<uint8_t>(rng() % 200);
+        ubx_frame(out, 0x01, 0x04, dop);
+
+        std::vector<uint8_t> timeutc(20);
+        for (auto& b : timeutc) b = static_cast<uint8_t>(rng());
+        ubx_frame(out, 0x01, 0x21, timeutc);
+
+        if (e % 10 == 0) {
+            size_t svs = 12 + rng() % 20;
+            std::vector<uint8_t> sat(8 + 12 * svs);
+            for (auto& b : sat) b = static_cast<uint8_t>(rng());
+            sat[5] = static_cast<uint8_t>(svs);
+            ubx_frame(out, 0x01, 0x35, sat);
+        }
+    }
+    return out;
+}
+
+bool read_capture(const char* path, std::vector<uint8_t>& out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    uint8_t chunk[65536];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) out.insert(out.end(), chunk, chunk + n);
+    fclose(f);
+    return true;
+}
+
+// ============================================
+// Parsing
+// ============================================
+
+struct Delivered {
+    uint32_t offset;
+    uint16_t length;
+    bool operator==(const Delivered&) const = default;
+};
+
+struct Result {
+    std::vector<Delivered> frames;
+    uint64_t other_bytes = 0;
+    uint64_t consumed = 0;              // Released by the parser
+    uint32_t bad_frames = 0;            // Checksum or payload mismatch against the source
+};
+
+// Delivered frame against the source bytes at its offset
+bool frame_matches(const std::vector<uint8_t>& src, const Frame& f) {
+    size_t end = static_cast<size_t>(f.offset) + f.length + 8;
+    if (end > src.size()) return false;
+    const uint8_t* p = src.data() + f.offset;
+    if (p[0] != 0xB5 || p[1] != 0x62 || p[2] != f.cls || p[3] != f.id || (p[4] | (p[5] << 8)) != f.length) return false;
+
+    uint8_t ck_a = 0, ck_b = 0;
+    for (size_t i = 2; i < f.length + 6u; i++) {
+        ck_a += p[i];
+        ck_b += ck_a;
+    }
+    if (ck_a != p[f.length + 6] || ck_b != p[f.length + 7]) return false;
+
+    for (size_t i = 0; i < f.length; i++) {
+        if (f.u8(i) != p[6 + i]) return false;
+    }
+    return f.first.size() + f.second.size() == f.length;
+}
+
+Result parse_linear(const std::vector<uint8_t>& src, bool check) {
+    Result r;
+    LinearBuffer buf{src.data(), static_cast<uint32_t>(src.size())};
+    Parser parser;
+    parser.parse(buf,
+        [&](const Frame& f) {
+            r.frames.push_back({f.offset, f.length});
+            if (check && !frame_matches(src, f)) r.bad_frames++;
+        },
+        [&](std::span<const uint8_t> other) { r.other_bytes += other.size(); });
+    r.consumed = buf.read_index();
+    return r;
+}
+
+Result parse_ring(const std::vector<uint8_t>& src, uint32_t seed, size_t max_chunk, bool check) {
+    Result r;
+    static RingBuffer buf;
+    buf = {};
+    Parser parser;
+    std::mt19937 rng(seed);
+    size_t pos = 0;
+    auto on_frame = [&](const Frame& f) {
+        r.frames.push_back({f.offset, f.length});
+        if (check && !frame_matches(src, f)) r.bad_frames++;
+    };
+    auto on_other = [&](std::span<const uint8_t> other) { r.other_bytes += other.size(); };
+
+    while (pos < src.size()) {
+        size_t chunk = std::min<size_t>(1 + rng() % max_chunk, src.size() - pos);
+        pos += buf.fill(src.data() + pos, chunk);
+        parser.parse(buf, on_frame, on_other);
+    }
+    r.consumed = buf.read_index();
+    return r;
+}
+
+// The driver's previous path: every byte copied into a 512-byte frame
+// buffer, checksum verified once the frame is complete
+uint32_t parse_legacy(const std::vector<uint8_t>& src) {
+    static uint8_t buffer[512];
+    size_t buf_pos = 0;
+    uint32_t frames = 0;
+    for (uint8_t byte : src) {
+        if (buf_pos > 0 || byte == 0xB5) {
+            if (buf_pos == 1 && byte != 0x62) {
+                buf_pos = 0;
+                continue;
+            }
+            buffer[buf_pos++] = byte;
+            if (buf_pos >= 6) {
+                uint16_t len = buffer[4] | (buffer[5] << 8);
+                if (buf_pos >= len + 8u) {
+                    uint8_t ck_a = 0, ck_b = 0;
+                    for (size_t i = 2; i < len + 6u; i++) {
+                        ck_a += buffer[i];
+                        ck_b += ck_a;
+                    }
+                    if (ck_a == buffer[len + 6] && ck_b == buffer[len + 7]) frames++;
+                    buf_pos = 0;
+                }
+            }
+            if (buf_pos >= sizeof(buffer)) buf_pos = 0;
+        }
+    }
+    return frames;
+}
+
+// ============================================
+// Bench
+// ============================================
+
+template<typename Fn>
+double bytes_per_us(size_t bytes, Fn&& fn) {
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    size_t total = 0;
+    double elapsed_us = 0;
+    do {
+        fn();
+        total += bytes;
+        elapsed_us = std::chrono::duration<double, std::micro>(clock::now() - start).count();
+    } while (elapsed_us < 200'000);
+    return total / elapsed_us;
+}
+
+void bench(const char* name, const std::vector<uint8_t>& capture) {
+    Result linear = parse_linear(capture, false);
+    printf("%s: %zu bytes, %zu UBX frames, %" PRIu64 " other bytes\n",
+           name, capture.size(), linear.frames.size(), linear.other_bytes);
+
+    volatile size_t sink = 0;
+    double lin = bytes_per_us(capture.size(), [&] { sink = sink + parse_linear(capture, false).frames.size(); });
+    double ring = bytes_per_us(capture.size(), [&] { sink = sink + parse_ring(capture, 1, 256, false).frames.size(); });
+    double legacy = bytes_per_us(capture.size(), [&] { sink = sink + parse_legacy(capture); });
+
+    printf("  %-28s %8.1f bytes/us\n", "streaming, linear buffer", lin);
+    printf("  %-28s %8.1f bytes/us (incl. ring fill)\n", "streaming, 4 KB ring", ring);
+    printf("  %-28s %8.1f bytes/us (%u frames)\n", "copy per byte (previous)", legacy, parse_legacy(capture));
+}
+
+// ============================================
+// Fuzz
+// ============================================
+
+struct Mutation {
+    std::vector<uint8_t> bytes;
+    std::vector<int64_t> new_pos;       // Original index -> mutated index, -1 if lost
+    std::vector<bool> damaged;          // Original byte changed or lost
+    std::vector<bool> gap_before;       // Bytes inserted right before the original byte
+};
+
+Mutation mutate(const std::vector<uint8_t>& src, std::mt19937& rng) {
+    Mutation m;
+    m.new_pos.assign(src.size(), -1);
+    m.damaged.assign(src.size(), false);
+    m.gap_before.assign(src.size(), false);
+    m.bytes.reserve(src.size() + 256);
+
+    std::vector<size_t> points(1 + rng() % 12);
+    for (auto& p : points) p = rng() % src.size();
+    std::sort(points.begin(), points.end());
+    size_t cut = (rng() % 4 == 0) ? rng() % src.size() : src.size();
+
+    size_t next = 0;
+    for (size_t i = 0; i < cut; i++) {
+        uint8_t byte = src[i];
+        bool lost = false;
+        while (next < points.size() && points[next] == i) {
+            next++;
+            switch (rng() % 6) {
+                case 0:                                     // Bit flip
+                    byte ^= static_cast<uint8_t>(1u << (rng() % 8));
+                    m.damaged[i] = true;
+                    break;
+                case 1: {                                   // Lost run (FIFO overrun)
+                    size_t n = 1 + rng() % 32;
+                    for (size_t j = i; j < std::min(i + n, cut); j++) m.damaged[j] = true;
+                    i = std::min(i + n, cut) - 1;
+                    lost = true;
+                    break;
+                }
+                case 2: {                                   // Inserted noise
+                    size_t n = 1 + rng() % 16;
+                    for (size_t j = 0; j < n; j++) m.bytes.push_back(static_cast<uint8_t>(rng()));
+                    m.gap_before[i] = true;
+                    break;
+                }
+                case 3: {                                   // Fake sync header, plausible length
+                    uint16_t len = static_cast<uint16_t>(rng() % 128);
+                    m.bytes.insert(m.bytes.end(), {0xB5, 0x62, 0x01, 0x07, static_cast<uint8_t>(len),
+                                                   static_cast<uint8_t>(len >> 8)});
+                    m.gap_before[i] = true;
+                    break;
+                }
+                case 4:                                     // Huge length
+                    m.bytes.insert(m.bytes.end(), {0xB5, 0x62, 0x01, 0x35, 0xFF, 0xFF});
+                    m.gap_before[i] = true;
+                    break;
+                default:                                    // Stray sync byte
+                    byte = 0xB5;
+                    m.damaged[i] = byte != src[i];
+                    break;
+            }
+            if (lost) break;
+        }
+        if (lost) continue;
+        m.new_pos[i] = static_cast<int64_t>(m.bytes.size());
+        m.bytes.push_back(byte);
+    }
+    for (size_t i = cut; i < src.size(); i++) m.damaged[i] = true;
+    return m;
+}
+
+struct FuzzTotals {
+    uint64_t runs = 0;
+    uint64_t expected = 0;
+    uint64_t found = 0;
+    uint64_t shadowed = 0;              // Behind a chance frame with a valid checksum
+    uint64_t pending = 0;               // At the cut, behind an incomplete candidate
+    uint64_t failures = 0;
+};
+
+void fuzz(const char* name, const std::vector<uint8_t>& capture, uint32_t iterations, uint32_t seed, FuzzTotals& totals) {
+    std::vector<Delivered> clean = parse_linear(capture, false).frames;
+    std::mt19937 rng(seed);
+
+    for (uint32_t it = 0; it < iterations; it++) {
+        Mutation m = mutate(capture, rng);
+        Result linear = parse_linear(m.bytes, true);
+        Result ring = parse_ring(m.bytes, static_cast<uint32_t>(rng()), 1 + rng() % 1024, true);
+        totals.runs++;
+
+        auto fail = [&](const char* what) {
+            if (totals.failures++ < 10) printf("  FAIL %s: iteration %u (seed %u): %s\n", name, it, seed, what);
+        };
+
+        if (linear.bad_frames || ring.bad_frames) fail("delivered frame does not match its bytes");
+        if (linear.frames != ring.frames || linear.other_bytes != ring.other_bytes) fail("ring and linear disagree");
+
+        uint64_t frame_bytes = 0;
+        for (const auto& f : linear.frames) frame_bytes += f.length + 8u;
+        if (frame_bytes + linear.other_bytes != linear.consumed) fail("bytes not accounted for exactly once");
+
+        // Frames the mutations did not touch
+        size_t d = 0;
+        for (const auto& f : clean) {
+            size_t end = f.offset + f.length + 8u;
+            bool intact = !m.damaged[f.offset];
+            for (size_t i = f.offset + 1; intact && i < end; i++) intact = !m.damaged[i] && !m.gap_before[i];
+            if (!intact) continue;
+
+            totals.expected++;
+            auto at = static_cast<uint32_t>(m.new_pos[f.offset]);
+            while (d < linear.frames.size() && linear.frames[d].offset < at) d++;
+            if (d < linear.frames.size() && linear.frames[d].offset == at) {
+                totals.found++;
+                continue;
+            }
+
+            // Lost only if no other frame claimed its bytes, and not held
+            // behind a candidate still waiting for the rest of its length
+            bool covered = d > 0 && linear.frames[d - 1].offset + linear.frames[d - 1].length + 8u > at;
+            if (covered) totals.shadowed++;
+            else if (at >= linear.consumed) totals.pending++;
+            else fail("intact frame not delivered");
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t iterations = 0;
+    uint32_t seed = 1;
+    uint32_t epochs = 6000;
+    std::vector<const char*> paths;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--fuzz" && i + 1 < argc) iterations = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (a == "--seed" && i + 1 < argc) seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (a == "--epochs" && i + 1 < argc) epochs = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (a[0] != '-') paths.push_back(argv[i]);
+        else {
+            fprintf(stderr, "usage: %s [--fuzz N] [--seed S] [--epochs N] [capture.ubx ...]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<std::pair<std::string, std::vector<uint8_t>>> captures;
+    for (const char* path : paths) {
+        std::vector<uint8_t> bytes;
+        if (!read_capture(path, bytes) || bytes.empty()) {
+            fprintf(stderr, "cannot read %s\n", path);
+            return 2;
+        }
+        captures.emplace_back(path, std::move(bytes));
+    }
+    if (captures.empty()) {
+        captures.emplace_back("synthetic (" + std::to_string(epochs) + " epochs at 10 Hz)",
+                              synthetic_capture(epochs, seed));
+    }
+
+    for (const auto& [name, bytes] : captures) bench(name.c_str(), bytes);
+
+    if (iterations == 0) return 0;
+
+    // Fuzz on a slice: the mutations land denser
+    FuzzTotals totals;
+    for (const auto& [name, bytes] : captures) {
+        std::vector<uint8_t> slice(bytes.begin(), bytes.begin() + std::min<size_t>(bytes.size(), 16384));
+        fuzz(name.c_str(), slice, iterations, seed, totals);
+    }
+    printf("fuzz: %" PRIu64 " runs, %" PRIu64 " of %" PRIu64 " intact frames found, %" PRIu64 " shadowed, %" PRIu64
+           " pending at the cut, %" PRIu64 " failures\n",
+           totals.runs, totals.found, totals.expected, totals.shadowed, totals.pending, totals.failures);
+    printf("%s\n", totals.failures ? "FAILED" : "OK");
+    return totals.failures ? 1 : 0;
+}